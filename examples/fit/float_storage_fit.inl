@@ -0,0 +1,196 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * float_storage_fit.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef FLOAT_STORAGE_FIT_INL_
+#define FLOAT_STORAGE_FIT_INL_
+
+/**
+ * \example float_storage_fit.inl
+ *
+ * This example fits the same normal distributed dataset stored
+ * with double and with float precision, and compares the time
+ * taken by the likelihood evaluation and the fit results.
+ * The likelihood is always accumulated in double precision,
+ * with compensated summation.
+ */
+
+#include <iostream>
+#include <assert.h>
+#include <time.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+//command line
+#include <tclap/CmdLine.h>
+
+//this lib
+#include <hydra/device/System.h>
+#include <hydra/Function.h>
+#include <hydra/LogLikelihoodFCN.h>
+#include <hydra/Parameter.h>
+#include <hydra/UserParameters.h>
+#include <hydra/Pdf.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/functions/Gaussian.h>
+
+//Minuit2
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnPrint.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnMinimize.h"
+
+using namespace ROOT::Minuit2;
+using namespace hydra::arguments;
+
+
+declarg(xvar,  double)
+declarg(xvarf, float)
+
+/*
+ * Time per likelihood evaluation, with the FCN cache disabled,
+ * and fit of the model.
+ */
+template<typename FCN>
+FunctionMinimum profile_and_fit(FCN& fcn, size_t ncalls, std::string const& label)
+{
+	fcn.GetFcnCache().SetCapacity(0);
+
+	std::vector<double> parameters{ 0.05, 1.05 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	double nll = 0;
+	for(size_t i=0; i<ncalls; i++) nll = fcn(parameters);
+
+	auto stop  = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<double, std::milli> elapsed_nll = stop - start;
+
+	fcn.GetFcnCache().SetCapacity(HYDRA_DEFAULT_CACHE_CAPACITY);
+
+	MnMigrad migrad(fcn, fcn.GetParameters().GetMnState(), MnStrategy(2));
+
+	start = std::chrono::high_resolution_clock::now();
+
+	FunctionMinimum minimum = FunctionMinimum( migrad(std::numeric_limits<unsigned int>::max(), 5));
+
+	stop  = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<double, std::milli> elapsed_fit = stop - start;
+
+	std::cout << "-----------------------------------------"<<std::endl;
+	std::cout << "| " << label << " storage"                 <<std::endl;
+	std::cout << "| NLL           = " << std::setprecision(12) << nll <<std::endl;
+	std::cout << "| Time/NLL (ms) = " << elapsed_nll.count()/ncalls <<std::endl;
+	std::cout << "| Fit time (ms) = " << elapsed_fit.count()    <<std::endl;
+	std::cout << "| Mean          = " << minimum.UserState().Value(0) << " +- " << minimum.UserState().Error(0) << std::endl;
+	std::cout << "| Sigma         = " << minimum.UserState().Value(1) << " +- " << minimum.UserState().Error(1) << std::endl;
+	std::cout << "-----------------------------------------"<<std::endl;
+
+	return minimum;
+}
+
+int main(int argv, char** argc)
+{
+	size_t nentries = 0;
+	size_t ncalls   = 0;
+
+	try {
+
+		TCLAP::CmdLine cmd("Command line arguments for ", '=');
+
+		TCLAP::ValueArg<size_t> EArg("n", "number-of-events","Number of events", true, 10e6, "size_t");
+		cmd.add(EArg);
+
+		TCLAP::ValueArg<size_t> CArg("c", "number-of-calls","Number of likelihood evaluations to profile", false, 50, "size_t");
+		cmd.add(CArg);
+
+		// Parse the argv array.
+		cmd.parse(argv, argc);
+
+		// Get the value parsed by each arg.
+		nentries = EArg.getValue();
+		ncalls   = CArg.getValue();
+
+	}
+	catch (TCLAP::ArgException &e)  {
+		std::cerr << " error: "  << e.error()
+				  << " for arg " << e.argId()
+				  << std::endl;
+	}
+
+	//-----------------
+	// some definitions
+	double min   = -6.0;
+	double max   =  6.0;
+
+	auto mean  = hydra::Parameter::Create("mean" ).Value(0.0).Error(0.0001).Limits(-1.0, 1.0);
+	auto sigma = hydra::Parameter::Create("sigma").Value(1.0).Error(0.0001).Limits(0.01, 1.5);
+
+	//same model, evaluated in double precision, for both storages
+	auto model_d = hydra::make_pdf( hydra::Gaussian<xvar>(mean, sigma),
+			hydra::AnalyticalIntegral< hydra::Gaussian<xvar> >(min, max) );
+
+	auto model_f = hydra::make_pdf( hydra::Gaussian<xvarf>(mean, sigma),
+			hydra::AnalyticalIntegral< hydra::Gaussian<xvarf> >(min, max) );
+
+	//begin raii scope
+	{
+		hydra::device::vector<xvar> dataset_d(nentries);
+
+		hydra::copy(hydra::random_range(hydra::Gaussian<xvar>(mean, sigma) , 159753, nentries ), dataset_d);
+
+		//half of the bytes per event
+		hydra::device::vector<xvarf> dataset_f(nentries);
+
+		hydra::copy(dataset_d, dataset_f);
+
+		auto fcn_d = hydra::make_loglikehood_fcn(model_d, dataset_d);
+		auto fcn_f = hydra::make_loglikehood_fcn(model_f, dataset_f);
+
+		ROOT::Minuit2::MnPrint::SetLevel(0);
+		hydra::Print::SetLevel(hydra::WARNING);
+
+		FunctionMinimum minimum_d = profile_and_fit(fcn_d, ncalls, "double");
+		FunctionMinimum minimum_f = profile_and_fit(fcn_f, ncalls, "float");
+
+		//shifts in units of the statistical error
+		for(size_t i=0; i<2; i++)
+			std::cout << "| Parameter " << i << " shift (sigma) = "
+			          << std::fabs(minimum_f.UserState().Value(i) - minimum_d.UserState().Value(i))/minimum_d.UserState().Error(i)
+			          << std::endl;
+
+	}//end raii scope
+
+	return 0;
+}
+#endif /* FLOAT_STORAGE_FIT_INL_ */
@@ -297,8 +297,8 @@ int main(int argv, char** argc)
 
 		//--------------------------------------------
 		//splot
-		//create splot
-		auto sweigts = hydra::make_splot(fcn.GetPDF(), range );
+		//create splot, caching the values of the components
+		auto sweigts = hydra::make_splot(fcn.GetPDF(), range, true );
 
 		auto covar_matrix = sweigts.GetCovMatrix();
 
@@ -323,6 +323,10 @@ int main(int argv, char** argc)
 		hydra::multiarray< double, 2, hydra::device::sys_t> data2_d(range.size());
 		hydra::copy( range ,  data2_d );
 
+		//calculate the sWeights of both species in one go
+		hydra::multiarray< double, 2, hydra::device::sys_t> sweights_d(range.size());
+		sweigts.Fill( sweights_d );
+
         //_______________________________
 		//histograms
 		size_t nbins = 100;
@@ -361,7 +365,7 @@ int main(int argv, char** argc)
 
         start_d = std::chrono::high_resolution_clock::now();
 
-        Hist_Control_1.Fill(data2_d.begin(1), data2_d.end(1), sweigts.begin(_0) );
+        Hist_Control_1.Fill(data2_d.begin(1), data2_d.end(1), sweights_d.begin(0) );
 
         end_d = std::chrono::high_resolution_clock::now();
 
@@ -375,7 +379,7 @@ int main(int argv, char** argc)
         hydra::DenseHistogram<double, 1, hydra::device::sys_t> Hist_Control_2(nbins, min, max);
 
         start_d = std::chrono::high_resolution_clock::now();
-        Hist_Control_2.Fill(data2_d.begin(1), data2_d.end(1), sweigts.begin(_1) );
+        Hist_Control_2.Fill(data2_d.begin(1), data2_d.end(1), sweights_d.begin(1) );
         end_d = std::chrono::high_resolution_clock::now();
         elapsed_d = end_d - start_d;
 
@@ -0,0 +1,36 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * coherent_sum_fit.cu
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COHERENT_SUM_FIT_CU_
+#define COHERENT_SUM_FIT_CU_
+
+
+#include <examples/phys/coherent_sum_fit.inl>
+
+
+#endif /* COHERENT_SUM_FIT_CU_ */
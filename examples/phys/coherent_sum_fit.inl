@@ -0,0 +1,402 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * coherent_sum_fit.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COHERENT_SUM_FIT_INL_
+#define COHERENT_SUM_FIT_INL_
+
+/**
+ * \example coherent_sum_fit.inl
+ *
+ * This example fits a simplified D+ -> K- pi+ pi+ isobar model
+ * with hydra::CoherentSum. The per-event amplitudes of the data and of
+ * the phase-space normalization sample are cached per resonance,
+ * so only the resonances whose mass or width changed are evaluated
+ * again, and the normalization is computed from the matrix of
+ * amplitude products. The time per likelihood evaluation is printed
+ * for steps changing only coefficients, steps changing a line-shape
+ * and for the same steps without amplitude caching.
+ */
+
+#include <iostream>
+#include <assert.h>
+#include <time.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+//command line
+#include <tclap/CmdLine.h>
+
+//hydra
+#include <hydra/device/System.h>
+#include <hydra/Function.h>
+#include <hydra/Complex.h>
+#include <hydra/Tuple.h>
+#include <hydra/LogLikelihoodFCN.h>
+#include <hydra/Parameter.h>
+#include <hydra/UserParameters.h>
+#include <hydra/CoherentSum.h>
+#include <hydra/Vector4R.h>
+#include <hydra/PhaseSpace.h>
+#include <hydra/Decays.h>
+#include <hydra/SeedRNG.h>
+#include <hydra/functions/BreitWignerLineShape.h>
+#include <hydra/functions/CosHelicityAngle.h>
+#include <hydra/functions/ZemachFunctions.h>
+
+//Minuit2
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnPrint.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnMinimize.h"
+
+declarg(Kaon , hydra::Vector4R)
+declarg(PionA, hydra::Vector4R)
+declarg(PionB, hydra::Vector4R)
+
+using namespace ROOT::Minuit2;
+using namespace hydra::arguments;
+
+//compute the Wave parity in compile time
+template<hydra::Wave L, bool Flag=(L%2)>
+struct parity;
+
+//positive
+template<hydra::Wave L>
+struct parity<L, false>: std::integral_constant<int,1>{};
+
+//negative
+template<hydra::Wave L>
+struct parity<L, true>:  std::integral_constant<int,-1>{};
+
+/*
+ * Resonant amplitude in the channels K- pi1+ and K- pi2+, symmetrized.
+ * Relativistic Breit-Wigner line-shape and Zemach angular distribution.
+ * Unlike the amplitudes in dalitz_plot.inl, the complex coefficient
+ * is not part of the amplitude: it is handled by hydra::CoherentSum.
+ */
+template<hydra::Wave L>
+class Isobar: public hydra::BaseFunctor<Isobar<L>, hydra::complex<double>(Kaon,PionA,PionB), 2>
+{
+	typedef hydra::BaseFunctor<Isobar<L>, hydra::complex<double>(Kaon,PionA,PionB), 2> super_type;
+
+	using super_type::_par;
+
+public:
+
+	Isobar() = delete;
+
+	Isobar(hydra::Parameter const& mass, hydra::Parameter const& width,
+			double mother_mass, double daugther1_mass, double daugther2_mass, double daugther3_mass, double radi):
+		super_type({mass, width}),
+		fLineShape(mass, width, mother_mass, daugther1_mass, daugther2_mass, daugther3_mass, radi)
+	{}
+
+	__hydra_dual__
+	Isobar( Isobar<L> const& other):
+		super_type(other),
+		fLineShape(other.GetLineShape())
+	{}
+
+	__hydra_dual__
+	inline Isobar<L>&
+	operator=( Isobar<L> const& other)
+	{
+		if(this==&other) return *this;
+
+		super_type::operator=(other);
+		fLineShape=other.GetLineShape();
+
+		return *this;
+	}
+
+	__hydra_dual__
+	inline hydra::BreitWignerLineShape<L,L,double> const&
+	GetLineShape() const {	return fLineShape; }
+
+	void Update() final {
+
+		fLineShape.SetParameter(0, _par[0]);
+		fLineShape.SetParameter(1, _par[1]);
+	}
+
+	__hydra_dual__
+	inline hydra::complex<double>
+	Evaluate(Kaon kaon, PionA pion1, PionB pion2)  const {
+
+		hydra::Vector4R mother = kaon + pion1 + pion2;
+		hydra::Vector4R Kpi1   = kaon + pion1;
+		hydra::Vector4R Kpi2   = kaon + pion2;
+
+		hydra::complex<double> contrib_12 = fLineShape((Kpi1).mass())*fAngularDist(fCosDecayAngle(mother, Kpi1, kaon));
+		hydra::complex<double> contrib_13 = fLineShape((Kpi2).mass())*fAngularDist(fCosDecayAngle(mother, Kpi2, pion2));
+
+		return contrib_12 + double(parity<L>::value)*contrib_13;
+	}
+
+private:
+
+	mutable hydra::BreitWignerLineShape<L,L,double> fLineShape;
+	hydra::CosHelicityAngle fCosDecayAngle;
+	hydra::ZemachFunction<L,double> fAngularDist;
+};
+
+/*
+ * Non-resonant amplitude, constant over the phase-space.
+ */
+class NonResonant: public hydra::BaseFunctor<NonResonant, hydra::complex<double>(Kaon,PionA,PionB), 0>
+{
+	typedef hydra::BaseFunctor<NonResonant, hydra::complex<double>(Kaon,PionA,PionB), 0> super_type;
+
+public:
+
+	NonResonant() = default;
+
+	__hydra_dual__
+	NonResonant( NonResonant const& other):
+		super_type(other)
+	{}
+
+	__hydra_dual__
+	NonResonant& operator=( NonResonant const& other)
+	{
+		if(this==&other) return *this;
+
+		super_type::operator=(other);
+
+		return *this;
+	}
+
+	__hydra_dual__ inline
+	hydra::complex<double> Evaluate(Kaon , PionA , PionB )  const {
+
+		return hydra::complex<double>(1.0, 0.0);
+	}
+};
+
+/*
+ * Average time of the likelihood evaluation over a list of parameter points,
+ * with the FCN cache disabled.
+ */
+template<typename FCN>
+double time_per_call(FCN& fcn, std::vector<std::vector<double>> const& points)
+{
+	fcn.GetFcnCache().SetCapacity(0);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for(auto const& point: points) fcn(point);
+
+	auto stop  = std::chrono::high_resolution_clock::now();
+
+	fcn.GetFcnCache().SetCapacity(HYDRA_DEFAULT_CACHE_CAPACITY);
+
+	std::chrono::duration<double, std::milli> elapsed = stop - start;
+
+	return elapsed.count()/points.size();
+}
+
+int main(int argv, char** argc)
+{
+	size_t nentries = 0;
+	size_t nmc = 0;
+
+	try {
+
+		TCLAP::CmdLine cmd("Command line arguments for ", '=');
+
+		TCLAP::ValueArg<size_t> EArg("n", "number-of-events","Number of events", true, 1e5, "size_t");
+		cmd.add(EArg);
+
+		TCLAP::ValueArg<size_t> MArg("m", "number-of-mc-events","Number of phase-space events for normalization", false, 1e6, "size_t");
+		cmd.add(MArg);
+
+		// Parse the argv array.
+		cmd.parse(argv, argc);
+
+		// Get the value parsed by each arg.
+		nentries = EArg.getValue();
+		nmc      = MArg.getValue();
+	}
+	catch (TCLAP::ArgException &e)  {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId()
+														<< std::endl;
+	}
+
+	double D_MASS  = 1.86959;
+	double K_MASS  = 0.493677;  // K+ mass
+	double PI_MASS = 0.13957061;// pi mass
+
+	//K*(892)
+	auto mass_892   = hydra::Parameter::Create("MASS_KST_892" ).Value(0.89555).Error(0.0001).Limits(0.85, 0.95);
+	auto width_892  = hydra::Parameter::Create("WIDTH_KST_892").Value(0.0473).Error(0.0001).Limits(0.040, 0.055);
+
+	Isobar<hydra::PWave> KST_892(mass_892, width_892, D_MASS, K_MASS, PI_MASS, PI_MASS, 5.0);
+
+	//K*0(1430)
+	auto mass_1430  = hydra::Parameter::Create("MASS_KST0_1430" ).Value(1.425).Error(0.0001).Limits(1.35, 1.50);
+	auto width_1430 = hydra::Parameter::Create("WIDTH_KST0_1430").Value(0.270).Error(0.0001).Limits(0.20, 0.35);
+
+	Isobar<hydra::SWave> KST0_1430(mass_1430, width_1430, D_MASS, K_MASS, PI_MASS, PI_MASS, 5.0);
+
+	//K*2(1430)
+	auto mass_2_1430  = hydra::Parameter::Create("MASS_KST2_1430" ).Value(1.4324).Error(0.0001).Limits(1.40, 1.46);
+	auto width_2_1430 = hydra::Parameter::Create("WIDTH_KST2_1430").Value(0.109).Error(0.0001).Limits(0.08, 0.14);
+
+	Isobar<hydra::DWave> KST2_1430(mass_2_1430, width_2_1430, D_MASS, K_MASS, PI_MASS, PI_MASS, 5.0);
+
+	NonResonant NR;
+
+	//coefficients: K*(892) fixes the phase convention
+	std::array<hydra::Parameter, 8> coefficients{
+		hydra::Parameter::Create("A_RE_KST_892"  ).Value(1.0  ).Error(0.001).Fixed(),
+		hydra::Parameter::Create("A_IM_KST_892"  ).Value(0.0  ).Error(0.001).Fixed(),
+		hydra::Parameter::Create("A_RE_KST0_1430").Value(-2.27).Error(0.001),
+		hydra::Parameter::Create("A_IM_KST0_1430").Value(-2.67).Error(0.001),
+		hydra::Parameter::Create("A_RE_KST2_1430").Value(-0.83).Error(0.001),
+		hydra::Parameter::Create("A_IM_KST2_1430").Value(-0.48).Error(0.001),
+		hydra::Parameter::Create("A_RE_NR"       ).Value(-7.02).Error(0.001),
+		hydra::Parameter::Create("A_IM_NR"       ).Value( 2.34).Error(0.001) };
+
+	hydra::Vector4R D(D_MASS, 0.0, 0.0, 0.0);
+
+	hydra::PhaseSpace<3> phsp{D_MASS, {K_MASS, PI_MASS, PI_MASS}};
+
+	//phase-space normalization sample and its weights
+	hydra::Decays<hydra::tuple<Kaon,PionA,PionB>, hydra::device::sys_t > mc(D_MASS, {K_MASS, PI_MASS, PI_MASS}, nmc);
+
+	phsp.Generate(D, mc);
+
+	auto mc_weights = mc | mc.GetEventWeightFunctor();
+
+	auto model = hydra::make_coherent_sum(coefficients, mc.begin(), mc.end(), mc_weights.begin(),
+			KST_892, KST0_1430, KST2_1430, NR);
+
+	//toy data
+	hydra::Decays<hydra::tuple<Kaon,PionA,PionB>, hydra::device::sys_t > data(D_MASS, {K_MASS, PI_MASS, PI_MASS});
+
+	{
+		hydra::Decays<hydra::tuple<Kaon,PionA,PionB>, hydra::device::sys_t > bunch(D_MASS, {K_MASS, PI_MASS, PI_MASS}, 4*nentries);
+
+		hydra::SeedRNG S{};
+
+		do {
+			phsp.SetSeed(S());
+
+			phsp.Generate(D, bunch);
+
+			auto sample = bunch.Unweight(model.GetFunctor(), -1, S());
+
+			data.insert(data.end(), sample.begin(), sample.end());
+
+		} while(data.size() < nentries );
+
+		data.erase(data.begin() + nentries, data.end());
+	}
+
+	std::cout << "Toy dataset size: " << data.size() << std::endl;
+
+	auto fcn = hydra::make_loglikehood_fcn(model, data.begin(), data.end());
+
+	//profile the likelihood evaluation
+	{
+		std::vector<double> start;
+		for(auto variable: fcn.GetParameters().GetVariables())
+			start.push_back(variable->GetValue());
+
+		std::vector<std::vector<double>> coefficient_steps, shape_steps;
+
+		for(size_t i=1; i<=10; i++){
+
+			coefficient_steps.push_back(start);
+			coefficient_steps.back()[2] *= 1.0 + 1.0e-3*i;
+
+			shape_steps.push_back(start);
+			shape_steps.back()[10] *= 1.0 + 1.0e-3*i;
+		}
+
+		//the pdf held by the FCN is a copy, with empty caches: fill them
+		fcn(start);
+
+		double coefficient_time = time_per_call(fcn, coefficient_steps);
+		double shape_time       = time_per_call(fcn, shape_steps);
+
+		fcn.SetAmplitudeCaching(false);
+
+		double uncached_time    = time_per_call(fcn, coefficient_steps);
+
+		fcn.SetAmplitudeCaching(true);
+
+		std::cout << "-----------------------------------------"<<std::endl;
+		std::cout << "| Time/NLL (ms), coefficient step: " << coefficient_time << std::endl;
+		std::cout << "| Time/NLL (ms), line-shape step : " << shape_time       << std::endl;
+		std::cout << "| Time/NLL (ms), without caching : " << uncached_time    << std::endl;
+		std::cout << "-----------------------------------------"<<std::endl;
+	}
+
+	//fit
+	MnPrint::SetLevel(0);
+
+	MnMigrad migrad(fcn, fcn.GetParameters().GetMnState(), MnStrategy(2));
+
+	std::cout << fcn.GetParameters().GetMnState() << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	FunctionMinimum minimum = FunctionMinimum( migrad(5000, 5) );
+
+	auto stop  = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<double, std::milli> elapsed = stop - start;
+
+	std::cout << "minimum: " << minimum << std::endl;
+
+	fcn.GetParameters().UpdateParameters(minimum);
+
+	//bring the normalization up to date with the fitted values
+	std::vector<double> fitted;
+	for(auto variable: fcn.GetParameters().GetVariables())
+		fitted.push_back(variable->GetValue());
+
+	fcn.GetPDF().SetParameters(fitted);
+
+	std::cout << "-----------------------------------------"<<std::endl;
+	std::cout << "| [Migrad] Time (ms) = " << elapsed.count() <<std::endl;
+	std::cout << "| Fit fractions: "                           <<std::endl;
+	std::cout << "| K*(892)   " << fcn.GetPDF().GetFitFraction(0) <<std::endl;
+	std::cout << "| K*0(1430) " << fcn.GetPDF().GetFitFraction(1) <<std::endl;
+	std::cout << "| K*2(1430) " << fcn.GetPDF().GetFitFraction(2) <<std::endl;
+	std::cout << "| NR        " << fcn.GetPDF().GetFitFraction(3) <<std::endl;
+	std::cout << "-----------------------------------------"<<std::endl;
+
+	return 0;
+}
+
+#endif /* COHERENT_SUM_FIT_INL_ */
@@ -0,0 +1,157 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * Bootstrap.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup random
+ */
+
+#ifndef BOOTSTRAP_H_
+#define BOOTSTRAP_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/BackendPolicy.h>
+#include <hydra/Types.h>
+#include <hydra/Tuple.h>
+#include <hydra/detail/Iterable_traits.h>
+#include <hydra/detail/PRNGTypedefs.h>
+#include <hydra/detail/functors/PoissonBootstrap.h>
+#include <hydra/host/System.h>
+#include <hydra/multivector.h>
+
+#include <utility>
+#include <vector>
+
+/**
+ * Maximum number of blocks the events are divided in by hydra::poisson_bootstrap.
+ */
+#ifndef HYDRA_BOOTSTRAP_MAX_BLOCKS
+#define HYDRA_BOOTSTRAP_MAX_BLOCKS 1024
+#endif
+
+/**
+ * Maximum number of partial sums (blocks x replicas x slots) held in memory by hydra::poisson_bootstrap.
+ */
+#ifndef HYDRA_BOOTSTRAP_MAX_PARTIAL_SUMS
+#define HYDRA_BOOTSTRAP_MAX_PARTIAL_SUMS (size_t(1)<<25)
+#endif
+
+namespace hydra {
+
+/**
+ * \ingroup random
+ *
+ * @brief Poisson bootstrap of a dataset, accumulating all the replicas in a single pass.
+ *
+ * Each event enters the replica r with a weight w drawn from a Poisson distribution of mean one.
+ * The weights are counter based: the weight of event i in replica r is taken from the position i
+ * of the random stream of that replica, so no index or weight array is stored, and a replica does
+ * not depend on the number of replicas requested with it.
+ *
+ * The events are divided in contiguous blocks, read once, and each event is added to the sums of
+ * every replica by calling
+ * @code
+ * accumulator(event, w, sums)
+ * @endcode
+ * where @p sums points to the @p nslots sums of the replica. The calls with w=0 are skipped.
+ *
+ * @param data dataset to resample.
+ * @param accumulator device callable adding the contribution of an event to the sums of a replica.
+ * @param nslots number of sums per replica.
+ * @param nreplicas number of replicas.
+ * @param seed seed for the underlying counter based random number generator.
+ * @return vector with nreplicas*nslots sums. The sums of replica r start at r*nslots.
+ */
+template<typename RNG=default_random_engine, typename Iterable, typename Accumulator>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value, std::vector<GReal_t>>::type
+poisson_bootstrap(Iterable&& data, Accumulator const& accumulator, size_t nslots,
+		size_t nreplicas, size_t seed=0x5a3c9e17d2b4f681);
+
+/**
+ * \ingroup random
+ *
+ * @brief Weighted mean of functor(event) for @p nreplicas Poisson bootstrap replicas of a dataset.
+ *
+ * @param data dataset to resample.
+ * @param functor quantity to average.
+ * @param nreplicas number of replicas.
+ * @param seed seed for the underlying counter based random number generator.
+ * @return host multivector with one entry (mean, sum of weights) per replica.
+ */
+template<typename RNG=default_random_engine, typename Iterable, typename Functor>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_mean(Iterable&& data, Functor const& functor, size_t nreplicas,
+		size_t seed=0x5a3c9e17d2b4f681);
+
+/**
+ * \ingroup random
+ *
+ * @brief Histograms of functor(event) for @p nreplicas Poisson bootstrap replicas of a dataset.
+ *
+ * Values outside [min, max) are not counted.
+ *
+ * @param data dataset to resample.
+ * @param functor quantity to histogram.
+ * @param nbins number of bins.
+ * @param min lower limit.
+ * @param max upper limit.
+ * @param nreplicas number of replicas.
+ * @param seed seed for the underlying counter based random number generator.
+ * @return host multivector with nreplicas*nbins entries (bin center, content). The bins of replica r start at r*nbins.
+ */
+template<typename RNG=default_random_engine, typename Iterable, typename Functor>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_histogram(Iterable&& data, Functor const& functor, size_t nbins, GReal_t min, GReal_t max,
+		size_t nreplicas, size_t seed=0x5a3c9e17d2b4f681);
+
+/**
+ * \ingroup random
+ *
+ * @brief Negative log-likelihood of a pdf for @p nreplicas Poisson bootstrap replicas of a dataset.
+ *
+ * All replicas are evaluated at the current parameters of the pdf in a single pass, so a
+ * minimizer stepping the replicas together needs one pass over the data per step.
+ *
+ * @param data dataset to resample.
+ * @param pdf normalized hydra::Pdf.
+ * @param nreplicas number of replicas.
+ * @param seed seed for the underlying counter based random number generator.
+ * @return host multivector with one entry (-sum of w*log(pdf), sum of weights) per replica.
+ */
+template<typename RNG=default_random_engine, typename Iterable, typename Pdf>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_nll(Iterable&& data, Pdf const& pdf, size_t nreplicas, size_t seed=0x5a3c9e17d2b4f681);
+
+}  // namespace hydra
+
+#include <hydra/detail/Bootstrap.inl>
+
+#endif /* BOOTSTRAP_H_ */
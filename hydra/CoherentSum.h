@@ -0,0 +1,419 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * CoherentSum.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup fit
+ */
+
+#ifndef COHERENTSUM_H_
+#define COHERENTSUM_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Complex.h>
+#include <hydra/Parameter.h>
+#include <hydra/Placeholders.h>
+#include <hydra/detail/Print.h>
+#include <hydra/detail/TypeTraits.h>
+#include <hydra/detail/Iterable_traits.h>
+#include <hydra/detail/utility/Utility_Tuple.h>
+#include <hydra/detail/AmplitudeCache.h>
+#include <hydra/detail/functors/CoherentSumFunctor.h>
+
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/inner_product.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/constant_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
+
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hydra {
+
+/**
+ * \ingroup fit
+ * \brief Pdf built as the squared modulus of a coherent sum of complex amplitudes.
+ *
+ * Given K amplitudes \f$A_k(x)\f$ and complex coefficients \f$c_k\f$, this class represents
+ * \f[ P(x) = \frac{ |\sum_k c_k A_k(x)|^2 }{ \sum_{jk} c_j c^*_k I_{jk} }, \qquad I_{jk} = \langle A_j A^*_k \rangle \f]
+ * where the average is taken over a normalization sample, typically flat phase-space events.
+ *
+ * The amplitudes of the normalization events are stored per component on the back-end of the sample,
+ * and a component is evaluated again only when its own parameters change. In that case only the row
+ * and column of \f$I_{jk}\f$ involving this component are recomputed. Steps changing only the
+ * coefficients cost \f$O(K^2)\f$ and do not touch the normalization sample.
+ *
+ * The amplitudes are functors returning hydra::complex<double> and carry only their shape parameters.
+ * The coefficients are passed as 2K hydra::Parameter, real and imaginary parts of each coefficient
+ * in sequence. One of them is usually fixed to set the overall phase and scale.
+ *
+ * The normalization sample is not copied and should be kept alive while this object is in use.
+ *
+ * \tparam IteratorN iterator over the normalization events.
+ * \tparam IteratorW iterator over the weights of the normalization events.
+ * \tparam Amplitude1 first amplitude.
+ * \tparam Amplitudes remaining amplitudes.
+ */
+template<typename IteratorN, typename IteratorW, typename Amplitude1, typename ...Amplitudes>
+class CoherentSum
+{
+
+public:
+
+	typedef typename hydra_thrust::iterator_system<IteratorN>::type system_type;
+
+	constexpr static size_t namplitudes = sizeof...(Amplitudes)+1; //!< number of amplitudes
+
+	typedef hydra_thrust::tuple<Amplitude1, Amplitudes...> amplitudes_tuple_type; //!< type of the tuple of amplitudes
+
+	typedef detail::CoherentSumFunctor<Amplitude1, Amplitudes...> functor_type;
+
+	typedef detail::AmplitudeCache<system_type, namplitudes> cache_type;
+
+	CoherentSum()=delete;
+
+	/**
+	 * \brief Ctor.
+	 * \param coefficients real and imaginary parts of the coefficients, {Re c_0, Im c_0, Re c_1, ...}.
+	 * \param begin iterator pointing to the first normalization event.
+	 * \param end iterator pointing to the end of the normalization sample.
+	 * \param wbegin iterator pointing to the weight of the first normalization event.
+	 * \param amplitude1 first amplitude.
+	 * \param amplitudes remaining amplitudes.
+	 */
+	CoherentSum(std::array<Parameter, 2*namplitudes> const& coefficients,
+			IteratorN begin, IteratorN end, IteratorW wbegin,
+			Amplitude1 const& amplitude1, Amplitudes const& ...amplitudes):
+		fAmplitudes(hydra_thrust::make_tuple(amplitude1, amplitudes...)),
+		fBegin(begin),
+		fEnd(end),
+		fWBegin(wbegin),
+		fSumOfWeights(0.0),
+		fNorm(0.0)
+	{
+		for(size_t i=0; i<2*namplitudes; i++)
+			fCoefficients[i] = coefficients[i];
+
+		size_t nentries = hydra_thrust::distance(fBegin, fEnd);
+
+		if( nentries == 0 )
+			throw std::invalid_argument("[hydra::CoherentSum]: empty normalization sample.");
+
+		fSumOfWeights = hydra_thrust::reduce(system_type(), fWBegin, fWBegin + nentries, GReal_t(0.0));
+
+		UpdateNormalization();
+	}
+
+	/**
+	 * \brief Copy constructor. The copy keeps the normalization, but not the
+	 * amplitudes of the normalization events, which are computed again on its first update.
+	 */
+	CoherentSum(CoherentSum<IteratorN, IteratorW, Amplitude1, Amplitudes...> const& other):
+		fAmplitudes(other.GetAmplitudes()),
+		fBegin(other.GetBegin()),
+		fEnd(other.GetEnd()),
+		fWBegin(other.GetWBegin()),
+		fSumOfWeights(other.GetSumOfWeights()),
+		fNorm(other.GetNorm())
+	{
+		for(size_t i=0; i<2*namplitudes; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+
+		for(size_t i=0; i<namplitudes*namplitudes; i++)
+			fIntegrals[i] = other.fIntegrals[i];
+	}
+
+	CoherentSum<IteratorN, IteratorW, Amplitude1, Amplitudes...>&
+	operator=(CoherentSum<IteratorN, IteratorW, Amplitude1, Amplitudes...> const& other)
+	{
+		if(this==&other) return *this;
+
+		fAmplitudes   = other.GetAmplitudes();
+		fBegin        = other.GetBegin();
+		fEnd          = other.GetEnd();
+		fWBegin       = other.GetWBegin();
+		fSumOfWeights = other.GetSumOfWeights();
+		fNorm         = other.GetNorm();
+
+		for(size_t i=0; i<2*namplitudes; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+
+		for(size_t i=0; i<namplitudes*namplitudes; i++)
+			fIntegrals[i] = other.fIntegrals[i];
+
+		fCache.Release();
+
+		return *this;
+	}
+
+	/**
+	 * \brief Set the coefficients and the parameters of the amplitudes and update the normalization.
+	 * @param parameters std::vector<double> containing the list of parameters passed by ROOT::Minuit2.
+	 */
+	inline void SetParameters(const std::vector<double>& parameters)
+	{
+		for(size_t i=0; i<2*namplitudes; i++)
+			fCoefficients[i].Reset(parameters);
+
+		detail::set_functors_in_tuple(fAmplitudes, parameters);
+
+		UpdateNormalization();
+	}
+
+	/**
+	 * \brief Print all registered parameters, including its value, range, name etc.
+	 */
+	inline void PrintRegisteredParameters()
+	{
+		HYDRA_CALLER ;
+		HYDRA_MSG << "Registered parameters begin:" << HYDRA_ENDL;
+
+		for(size_t i=0; i<2*namplitudes; i++)
+			HYDRA_MSG << fCoefficients[i] << HYDRA_ENDL;
+
+		detail::print_parameters_in_tuple(fAmplitudes);
+		HYDRA_MSG <<"Registered parameters end." << HYDRA_ENDL;
+	}
+
+	/**
+	 * \brief Add pointers to the coefficients and to the parameters of the amplitudes to a external list,
+	 * that will be used later to build the hydra::UserParameters instance passed to ROOT::Minuit2.
+	 */
+	inline void AddUserParameters(std::vector<hydra::Parameter*>& user_parameters)
+	{
+		for(size_t i=0; i<2*namplitudes; i++)
+			user_parameters.push_back(&fCoefficients[i]);
+
+		detail::add_parameters_in_tuple(user_parameters, fAmplitudes);
+	}
+
+	/**
+	 * \brief Complex coefficient of the amplitude @p i.
+	 */
+	inline hydra::complex<double> GetCoefficient(size_t i) const
+	{
+		return hydra::complex<double>(fCoefficients[2*i].GetValue(), fCoefficients[2*i+1].GetValue());
+	}
+
+	/**
+	 * \brief Real (@p part = 0) or imaginary (@p part = 1) part of the coefficient of the amplitude @p i.
+	 */
+	inline Parameter& Coefficient(size_t i, size_t part)
+	{
+		return fCoefficients[2*i + part];
+	}
+
+	/**
+	 * \brief Element \f$I_{jk}\f$ of the normalization matrix.
+	 */
+	inline hydra::complex<double> GetIntegral(size_t j, size_t k) const
+	{
+		return fIntegrals[j*namplitudes + k];
+	}
+
+	/**
+	 * \brief Normalization \f$\sum_{jk} c_j c^*_k I_{jk}\f$.
+	 */
+	inline GReal_t GetNorm() const { return fNorm; }
+
+	/**
+	 * \brief Fit fraction of the amplitude @p i, \f$|c_i|^2 I_{ii}\f$ over the normalization.
+	 */
+	inline GReal_t GetFitFraction(size_t i) const
+	{
+		return hydra::norm(GetCoefficient(i))*fIntegrals[i*namplitudes + i].real()/fNorm;
+	}
+
+	inline functor_type GetFunctor() const
+	{
+		hydra::complex<double> coefficients[namplitudes];
+
+		for(size_t i=0; i<namplitudes; i++)
+			coefficients[i] = GetCoefficient(i);
+
+		return functor_type(fAmplitudes, coefficients, 1.0/fNorm);
+	}
+
+	template<unsigned int I>
+	inline typename hydra_thrust::tuple_element<I, amplitudes_tuple_type>::type&
+	Amplitude(hydra::placeholders::placeholder<I>)
+	{
+		return hydra_thrust::get<I>(fAmplitudes);
+	}
+
+	inline amplitudes_tuple_type const& GetAmplitudes() const { return fAmplitudes; }
+
+	/**
+	 * \brief Amplitudes of the normalization events.
+	 */
+	inline cache_type const& GetNormalizationCache() const { return fCache; }
+
+	inline IteratorN GetBegin() const { return fBegin; }
+
+	inline IteratorN GetEnd() const { return fEnd; }
+
+	inline IteratorW GetWBegin() const { return fWBegin; }
+
+	inline GReal_t GetSumOfWeights() const { return fSumOfWeights; }
+
+	template<typename T>
+	inline GReal_t operator()(T&& x) const
+	{
+		return GetFunctor()(std::forward<T>(x));
+	}
+
+private:
+
+	void UpdateNormalization()
+	{
+		typedef detail::NormalizationRow<namplitudes> row_type;
+
+		hydra::complex<double> const* columns = fCache.Update(fAmplitudes, fBegin, fEnd);
+
+		size_t nentries = fCache.GetNumberOfEntries();
+
+		hydra_thrust::counting_iterator<size_t> first(0);
+		hydra_thrust::counting_iterator<size_t> last = first + nentries;
+
+		for(size_t j=0; j<namplitudes; j++){
+
+			if( !fCache.IsUpdated(j) ) continue;
+
+			row_type row = hydra_thrust::inner_product(system_type(), first, last, fWBegin, row_type(),
+					hydra_thrust::plus<row_type>(), detail::AmplitudeProducts<namplitudes>(columns, nentries, j));
+
+			for(size_t k=0; k<namplitudes; k++){
+
+				fIntegrals[j*namplitudes + k] = row.fValues[k]/fSumOfWeights;
+				fIntegrals[k*namplitudes + j] = hydra::conj(fIntegrals[j*namplitudes + k]);
+			}
+		}
+
+		fNorm = 0.0;
+
+		for(size_t j=0; j<namplitudes; j++){
+
+			hydra::complex<double> cj = GetCoefficient(j);
+
+			fNorm += hydra::norm(cj)*fIntegrals[j*namplitudes + j].real();
+
+			for(size_t k=j+1; k<namplitudes; k++)
+				fNorm += 2.0*(cj*hydra::conj(GetCoefficient(k))*fIntegrals[j*namplitudes + k]).real();
+		}
+	}
+
+	Parameter fCoefficients[2*namplitudes];
+	amplitudes_tuple_type fAmplitudes;
+	IteratorN fBegin;
+	IteratorN fEnd;
+	IteratorW fWBegin;
+	GReal_t fSumOfWeights;
+	GReal_t fNorm;
+	hydra::complex<double> fIntegrals[namplitudes*namplitudes];
+	cache_type fCache;
+};
+
+/**
+ * \ingroup fit
+ * \brief Build a coherent sum normalized on a sample of unweighted events.
+ * @param coefficients real and imaginary parts of the coefficients, {Re c_0, Im c_0, Re c_1, ...}.
+ * @param first iterator pointing to the first normalization event.
+ * @param last iterator pointing to the end of the normalization sample.
+ * @param amplitude1 first amplitude.
+ * @param amplitudes remaining amplitudes.
+ */
+template<typename IteratorN, typename Amplitude1, typename ...Amplitudes>
+inline typename std::enable_if< detail::is_iterator<IteratorN>::value && !detail::is_iterator<Amplitude1>::value,
+CoherentSum<IteratorN, hydra_thrust::constant_iterator<GReal_t>, Amplitude1, Amplitudes...> >::type
+make_coherent_sum(std::array<Parameter, 2*(sizeof...(Amplitudes)+1)> const& coefficients,
+		IteratorN first, IteratorN last, Amplitude1 const& amplitude1, Amplitudes const& ...amplitudes)
+{
+	return CoherentSum<IteratorN, hydra_thrust::constant_iterator<GReal_t>, Amplitude1, Amplitudes...>(coefficients,
+			first, last, hydra_thrust::constant_iterator<GReal_t>(1.0), amplitude1, amplitudes...);
+}
+
+/**
+ * \ingroup fit
+ * \brief Build a coherent sum normalized on a sample of weighted events.
+ * @param coefficients real and imaginary parts of the coefficients, {Re c_0, Im c_0, Re c_1, ...}.
+ * @param first iterator pointing to the first normalization event.
+ * @param last iterator pointing to the end of the normalization sample.
+ * @param wfirst iterator pointing to the weight of the first normalization event.
+ * @param amplitude1 first amplitude.
+ * @param amplitudes remaining amplitudes.
+ */
+template<typename IteratorN, typename IteratorW, typename Amplitude1, typename ...Amplitudes>
+inline typename std::enable_if< detail::is_iterator<IteratorN>::value && detail::is_iterator<IteratorW>::value,
+CoherentSum<IteratorN, IteratorW, Amplitude1, Amplitudes...> >::type
+make_coherent_sum(std::array<Parameter, 2*(sizeof...(Amplitudes)+1)> const& coefficients,
+		IteratorN first, IteratorN last, IteratorW wfirst, Amplitude1 const& amplitude1, Amplitudes const& ...amplitudes)
+{
+	return CoherentSum<IteratorN, IteratorW, Amplitude1, Amplitudes...>(coefficients,
+			first, last, wfirst, amplitude1, amplitudes...);
+}
+
+/**
+ * \ingroup fit
+ * \brief Build a coherent sum normalized on a sample of unweighted events stored in a "iterable".
+ */
+template<typename Iterable, typename Amplitude1, typename ...Amplitudes>
+inline typename std::enable_if< (!detail::is_iterator<Iterable>::value) && detail::is_iterable<Iterable>::value &&
+                                (!detail::is_iterable<Amplitude1>::value),
+CoherentSum<decltype(std::declval<Iterable>().begin()), hydra_thrust::constant_iterator<GReal_t>, Amplitude1, Amplitudes...> >::type
+make_coherent_sum(std::array<Parameter, 2*(sizeof...(Amplitudes)+1)> const& coefficients,
+		Iterable&& events, Amplitude1 const& amplitude1, Amplitudes const& ...amplitudes)
+{
+	return make_coherent_sum(coefficients, std::forward<Iterable>(events).begin(),
+			std::forward<Iterable>(events).end(), amplitude1, amplitudes...);
+}
+
+/**
+ * \ingroup fit
+ * \brief Build a coherent sum normalized on a sample of weighted events stored in "iterables".
+ */
+template<typename Iterable, typename IterableW, typename Amplitude1, typename ...Amplitudes>
+inline typename std::enable_if< (!detail::is_iterator<Iterable>::value) && detail::is_iterable<Iterable>::value &&
+                                (!detail::is_iterator<IterableW>::value) && detail::is_iterable<IterableW>::value,
+CoherentSum<decltype(std::declval<Iterable>().begin()), decltype(std::declval<IterableW>().begin()), Amplitude1, Amplitudes...> >::type
+make_coherent_sum(std::array<Parameter, 2*(sizeof...(Amplitudes)+1)> const& coefficients,
+		Iterable&& events, IterableW&& weights, Amplitude1 const& amplitude1, Amplitudes const& ...amplitudes)
+{
+	return make_coherent_sum(coefficients, std::forward<Iterable>(events).begin(),
+			std::forward<Iterable>(events).end(), std::forward<IterableW>(weights).begin(),
+			amplitude1, amplitudes...);
+}
+
+}  // namespace hydra
+
+#endif /* COHERENTSUM_H_ */
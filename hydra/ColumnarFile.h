@@ -0,0 +1,200 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ColumnarFile.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup generic
+ */
+
+#ifndef COLUMNARFILE_H_
+#define COLUMNARFILE_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Placeholders.h>
+#include <hydra/detail/ColumnarFormat.h>
+#include <hydra/detail/IteratorTraits.h>
+#include <hydra/detail/utility/Generic.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
+
+#include <array>
+#include <future>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace hydra {
+
+template<typename Tuple>
+class ColumnarFile;
+
+/**
+ * \ingroup generic
+ * \brief Read-only view of a dataset in the Hydra columnar format, written by hydra::ColumnarWriter.
+ *
+ * The column files are mapped in memory and exposed as raw pointers, so the data is paged in
+ * on demand and nothing is copied. The iterators are zip iterators of `T const*`, which Hydra
+ * and Thrust treat as host iterators. They can be passed as they are to hydra::make_loglikehood_fcn,
+ * hydra::Filter, hydra_thrust::transform and any other algorithm taking host ranges.
+ * Device-backend containers are filled chunk by chunk with Upload().
+ *
+ * The type signature stored in the header is checked against `T...` when the file is opened.
+ * ColumnarFile can be moved, but not copied.
+ *
+ * \tparam Tuple `hydra::tuple<T...>`, the value type of the multivector or multiarray that was written.
+ */
+template<typename ...T>
+class ColumnarFile< hydra_thrust::tuple<T...> >
+{
+	typedef detail::make_index_sequence<sizeof...(T)> indexes_type;
+
+public:
+
+	typedef hydra_thrust::tuple<T...>        value_type;
+	typedef hydra_thrust::tuple<T const*...> pointer_tuple;
+	typedef hydra_thrust::zip_iterator<pointer_tuple> iterator;
+	typedef iterator const_iterator;
+	typedef size_t size_type;
+
+	template<size_t I>
+	using column_pointer = typename hydra_thrust::tuple_element<I, pointer_tuple>::type;
+
+	ColumnarFile()=delete;
+
+	/**
+	 * @brief Map the dataset stored at @p path.
+	 */
+	explicit ColumnarFile(std::string const& path);
+
+	ColumnarFile(ColumnarFile< hydra_thrust::tuple<T...> > const& other)=delete;
+
+	ColumnarFile< hydra_thrust::tuple<T...> >&
+	operator=(ColumnarFile< hydra_thrust::tuple<T...> > const& other)=delete;
+
+	ColumnarFile(ColumnarFile< hydra_thrust::tuple<T...> >&& other);
+
+	ColumnarFile< hydra_thrust::tuple<T...> >&
+	operator=(ColumnarFile< hydra_thrust::tuple<T...> >&& other);
+
+	~ColumnarFile(){ Close(); }
+
+	/**
+	 * @brief Unmap the columns. The iterators taken before become invalid.
+	 */
+	void Close();
+
+	inline bool IsOpen() const { return fOpen; }
+
+	inline std::string const& GetPath() const { return fPath; }
+
+	inline size_type size() const { return fSize; }
+
+	inline bool empty() const { return fSize==0; }
+
+	inline iterator begin() const { return iterator( pointers(0, indexes_type{}) ); }
+
+	inline iterator end() const { return iterator( pointers(fSize, indexes_type{}) ); }
+
+	inline const_iterator cbegin() const { return begin(); }
+
+	inline const_iterator cend() const { return end(); }
+
+	template<unsigned int I>
+	inline column_pointer<I> begin(placeholders::placeholder<I>) const
+	{
+		return static_cast<column_pointer<I>>(fColumns[I]);
+	}
+
+	template<unsigned int I>
+	inline column_pointer<I> end(placeholders::placeholder<I> c) const
+	{
+		return begin(c) + fSize;
+	}
+
+	inline value_type operator[](size_t i) const { return begin()[i]; }
+
+	/**
+	 * @brief Ask the kernel to read ahead the pages of the rows [first, last).
+	 */
+	void Prefetch(size_t first, size_t last) const;
+
+	/**
+	 * @brief Copy the dataset to @p output, in chunks of @p chunk_size rows, on a separate thread.
+	 *
+	 * The pages of the next chunk are prefetched while the current one is copied, so reading
+	 * the file and transferring to the back-end overlap. The copy keeps the column files mapped
+	 * by itself, so the ColumnarFile can be closed, moved or destroyed meanwhile, but the
+	 * destination must stay alive until the returned future is ready.
+	 *
+	 * @return future holding the number of rows copied.
+	 */
+	template<typename Iterator>
+	typename std::enable_if<detail::is_iterator<Iterator>::value, std::future<size_t>>::type
+	Upload(Iterator output, size_t chunk_size=HYDRA_COLUMNAR_CHUNK_SIZE) const;
+
+	/**
+	 * @brief Resize @p container (a hydra::multivector, hydra::multiarray or any resizable container)
+	 * to size() and upload the dataset to it, as Upload(container.begin(), chunk_size).
+	 */
+	template<typename Container,
+		typename = typename std::enable_if<!detail::is_iterator<Container>::value>::type>
+	inline auto Upload(Container& container, size_t chunk_size=HYDRA_COLUMNAR_CHUNK_SIZE) const
+	-> decltype(container.resize(size_t()), std::future<size_t>())
+	{
+		container.resize(fSize);
+
+		return Upload(container.begin(), chunk_size);
+	}
+
+private:
+
+	static void prefetch(std::array<void*, sizeof...(T)> const& columns,
+			std::array<size_t, sizeof...(T)> const& lengths, size_t size, size_t first, size_t last);
+
+	template<size_t ...I>
+	inline pointer_tuple pointers(size_t offset, detail::index_sequence<I...>) const
+	{
+		return pointer_tuple( (static_cast<T const*>(fColumns[I]) + offset)... );
+	}
+
+	std::string fPath;
+	size_t fSize;
+	bool   fOpen;
+	std::array<void*,  sizeof...(T)> fColumns;
+	std::array<size_t, sizeof...(T)> fLengths;
+	std::array<std::shared_ptr<void>, sizeof...(T)> fMappings;
+};
+
+}  // namespace hydra
+
+#include <hydra/detail/ColumnarFile.inl>
+
+#endif /* COLUMNARFILE_H_ */
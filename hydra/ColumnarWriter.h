@@ -0,0 +1,171 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ColumnarWriter.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup generic
+ */
+
+#ifndef COLUMNARWRITER_H_
+#define COLUMNARWRITER_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Placeholders.h>
+#include <hydra/multivector.h>
+#include <hydra/host/System.h>
+#include <hydra/detail/ColumnarFormat.h>
+#include <hydra/detail/Iterable_traits.h>
+#include <hydra/detail/IteratorTraits.h>
+#include <hydra/detail/utility/Generic.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+namespace hydra {
+
+template<typename Tuple>
+class ColumnarWriter;
+
+/**
+ * \ingroup generic
+ * \brief Streaming writer of datasets in the Hydra columnar format, read back with hydra::ColumnarFile.
+ *
+ * The rows are gathered in a host multivector of @p buffer_size rows, which is written
+ * column by column when full. Ranges on any back-end can be appended; device data is
+ * transferred one buffer at a time.
+ * Flush() writes the pending rows and updates the header, so that the file can be opened
+ * while it is still being written. Close(), also called by the destructor, does the same and
+ * releases the files. A dataset can be reopened to append more rows.
+ * ColumnarWriter can be moved, but not copied.
+ *
+ * \tparam Tuple `hydra::tuple<T...>`, the value type of the multivector or multiarray to write.
+ */
+template<typename ...T>
+class ColumnarWriter< hydra_thrust::tuple<T...> >
+{
+	typedef detail::make_index_sequence<sizeof...(T)> indexes_type;
+	typedef hydra::multivector<hydra_thrust::tuple<T...>, hydra::host::sys_t> buffer_type;
+
+public:
+
+	typedef hydra_thrust::tuple<T...> value_type;
+	typedef size_t size_type;
+
+	ColumnarWriter()=delete;
+
+	/**
+	 * @param path location of the header file. The columns are stored in "path.0", "path.1"...
+	 * @param append if true and the dataset exists, the new rows are added after the stored ones.
+	 * Otherwise the dataset is overwritten.
+	 * @param buffer_size number of rows held in memory before writing.
+	 */
+	explicit ColumnarWriter(std::string const& path, bool append=false,
+			size_t buffer_size=HYDRA_COLUMNAR_CHUNK_SIZE);
+
+	ColumnarWriter(ColumnarWriter< hydra_thrust::tuple<T...> > const& other)=delete;
+
+	ColumnarWriter< hydra_thrust::tuple<T...> >&
+	operator=(ColumnarWriter< hydra_thrust::tuple<T...> > const& other)=delete;
+
+	ColumnarWriter(ColumnarWriter< hydra_thrust::tuple<T...> >&& other);
+
+	ColumnarWriter< hydra_thrust::tuple<T...> >&
+	operator=(ColumnarWriter< hydra_thrust::tuple<T...> >&& other);
+
+	~ColumnarWriter();
+
+	/**
+	 * @brief Append one row.
+	 */
+	void Append(value_type const& value);
+
+	/**
+	 * @brief Append the rows in [first, last).
+	 */
+	template<typename Iterator>
+	typename std::enable_if<detail::is_iterator<Iterator>::value, void>::type
+	Append(Iterator first, Iterator last);
+
+	/**
+	 * @brief Append all rows of @p data, as a hydra::multivector or hydra::multiarray.
+	 */
+	template<typename Iterable>
+	inline typename std::enable_if<
+		 (detail::is_iterable<Iterable>::value) &&
+		!(detail::is_iterator<Iterable>::value), void>::type
+	Append(Iterable&& data)
+	{
+		Append(std::forward<Iterable>(data).begin(), std::forward<Iterable>(data).end());
+	}
+
+	/**
+	 * @brief Write the buffered rows and update the header.
+	 */
+	void Flush();
+
+	/**
+	 * @brief Flush and close the files.
+	 */
+	void Close();
+
+	inline bool IsOpen() const { return fOpen; }
+
+	inline std::string const& GetPath() const { return fPath; }
+
+	/**
+	 * @brief Number of rows appended so far, including the ones still in the buffer.
+	 */
+	inline size_type size() const { return fWritten + fBuffered; }
+
+private:
+
+	void Write();
+
+	template<size_t ...I>
+	bool WriteColumns(detail::index_sequence<I...>);
+
+	std::string fPath;
+	size_t fWritten;
+	size_t fBuffered;
+	bool   fOpen;
+	buffer_type fBuffer;
+	std::array<std::FILE*, sizeof...(T)> fFiles;
+};
+
+}  // namespace hydra
+
+#include <hydra/detail/ColumnarWriter.inl>
+
+#endif /* COLUMNARWRITER_H_ */
@@ -38,10 +38,12 @@
 #include <hydra/Algorithm.h>
 #include <hydra/Zip.h>
 #include <hydra/Complex.h>
+#include <hydra/MemoryPool.h>
 #include <hydra/detail/Convolution.inl>
 #include <hydra/detail/ArgumentTraits.h>
 #include <hydra/detail/external/hydra_thrust/transform.h>
 #include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
 #include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
 #include <hydra/detail/external/hydra_thrust/memory.h>
 #include <hydra/detail/external/hydra_thrust/system/cuda/detail/execution_policy.h>
@@ -51,115 +53,133 @@
 
 namespace hydra {
 
-template<detail::Backend BACKEND, detail::FFTCalculator FFTBackend,  typename Functor, typename Kernel, typename Iterable,
-     typename T = typename detail::stripped_type<typename hydra_thrust::iterator_traits<decltype(std::declval<Iterable>().begin())>::value_type>::type,
-     typename USING_CUDA_BACKEND = typename std::conditional< std::is_convertible<detail::BackendPolicy<BACKEND>,hydra_thrust::system::cuda::tag >::value, std::integral_constant<int, 1>,std::integral_constant<int, 0>>::type,
-     typename USING_CUFFT = typename std::conditional< FFTBackend==detail::CuFFT, std::integral_constant<int, 1>,std::integral_constant<int, 0>>::type,
-     typename GPU_DATA = typename std::conditional< std::is_convertible<typename hydra_thrust::iterator_system< decltype(std::declval<Iterable>().begin())>::type,
-                        hydra_thrust::system::cuda::tag>::value
-         , std::integral_constant<int, 1>, std::integral_constant<int, 0> >::type>
-inline typename std::enable_if<std::is_floating_point<T>::value  && hydra::detail::is_iterable<Iterable>::value
-                   // && (USING_CUDA_BACKEND::value == USING_CUFFT::value)
-                   //  && (USING_CUDA_BACKEND::value == GPU_DATA::value),
-,void>::type
-convolute(detail::BackendPolicy<BACKEND> policy, detail::FFTPolicy<T, FFTBackend> fft_policy,
-		  Functor const& functor, Kernel const& kernel,
-		  T min,  T max, Iterable&& output, bool power_up=true ){
+namespace detail {
 
+namespace convolution {
 
-	typedef hydra::complex<double> complex_type;
+/*
+ * Sample on 2*nsamples points and store the nsamples+1 coefficients
+ * of the real to complex transform of the samples in spectrum.
+ */
+template<detail::Backend BACKEND, detail::FFTCalculator FFTBackend, typename T,
+         typename Sampler, typename ComplexIterator>
+inline void forward_transform(detail::BackendPolicy<BACKEND> policy, detail::FFTPolicy<T, FFTBackend>,
+		Sampler const& sampler, int nsamples, ComplexIterator spectrum)
+{
 	typedef typename detail::FFTPolicy<T, FFTBackend>::R2C _RealToComplexFFT;
-	typedef typename detail::FFTPolicy<T, FFTBackend>::C2R _ComplexToRealFFT;
 
+	auto samples = hydra::detail::get_temporary_buffer<T>(policy, 2*nsamples);
 
-	if(power_up) {
-		std::forward<Iterable>(output).resize(
-				hydra::detail::convolution::upper_power_of_two(std::forward<Iterable>(output).size()));
-	}
-
-	int nsamples = std::forward<Iterable>(output).size();
-
-	T delta = (max - min)/(nsamples);
-
-	auto complex_buffer  = hydra_thrust::get_temporary_buffer<complex_type>(policy, nsamples+1);
-	auto kernel_samples  = hydra_thrust::get_temporary_buffer<T>(policy, 2*nsamples);
-	auto functor_samples = hydra_thrust::get_temporary_buffer<T>(policy, 2*nsamples);
-
-	//
-
-	auto counting_samples = range(0, 2*nsamples);
-
-	// sample kernel
-	auto kernel_sampler = hydra::detail::convolution::KernelSampler<Kernel>(kernel, nsamples, delta);
+	auto counting_samples = hydra::range(0, 2*nsamples);
 
 	hydra_thrust::transform(policy, counting_samples.begin(), counting_samples.end(),
-			kernel_samples.first , kernel_sampler);
-
+			samples.first , sampler);
 
-	//auto norm_factor = hydra_thrust::reduce(policy, kernel_samples.first, kernel_samples.first + kernel_samples.second );
+	auto fft = _RealToComplexFFT( samples.second );
 
+	fft.LoadInputData( samples.second, samples.first);
+	fft.Execute();
 
-	// sample function
-	auto functor_sampler = hydra::detail::convolution::FunctorSampler<Functor>(functor, nsamples,  min, delta);
+	auto fft_output = fft.GetOutputData();
 
-	hydra_thrust::transform( policy, counting_samples.begin(), counting_samples.end(),
-			functor_samples.first, functor_sampler);
+	hydra_thrust::copy(policy, fft_output.first, fft_output.first + fft_output.second, spectrum);
 
-	//norm_factor *= hydra_thrust::reduce(policy, functor_samples.first, functor_samples.first + functor_samples.second );
-
-	//transform kernel
-	auto fft_kernel = _RealToComplexFFT( kernel_samples.second );
-
-	fft_kernel.LoadInputData( kernel_samples.second, kernel_samples.first);
-	fft_kernel.Execute();
-
-	auto fft_kernel_output =  fft_kernel.GetOutputData();
-	auto fft_kernel_range  = make_range( fft_kernel_output.first,
-			fft_kernel_output.first + fft_kernel_output.second);
-
-	//transform functor
-	auto fft_functor = _RealToComplexFFT( functor_samples.second );
+	hydra::detail::return_temporary_buffer( policy, samples.first );
+}
 
-	fft_functor.LoadInputData(functor_samples.second,functor_samples.first);
-	fft_functor.Execute();
+/*
+ * Multiply the spectra of functor and kernel, transform the product back
+ * and store the nsamples normalized values in output.
+ */
+template<detail::Backend BACKEND, detail::FFTCalculator FFTBackend, typename T,
+         typename ComplexIterator, typename Iterable>
+inline void inverse_transform(detail::BackendPolicy<BACKEND> policy, detail::FFTPolicy<T, FFTBackend>,
+		ComplexIterator functor_spectrum, ComplexIterator kernel_spectrum, int nsamples, Iterable&& output)
+{
+	typedef hydra::complex<T> complex_type;
+	typedef typename detail::FFTPolicy<T, FFTBackend>::C2R _ComplexToRealFFT;
 
-	auto fft_functor_output =  fft_functor.GetOutputData();
-	auto fft_functor_range  = make_range( fft_functor_output.first,
-			fft_functor_output.first + fft_functor_output.second);
+	auto complex_buffer  = hydra::detail::get_temporary_buffer<complex_type>(policy, nsamples+1);
 
 	//element wise product
-	auto ffts = hydra::zip(fft_functor_range,  fft_kernel_range );
-
+	auto ffts = hydra::zip(make_range(functor_spectrum, functor_spectrum + nsamples + 1),
+			make_range(kernel_spectrum, kernel_spectrum + nsamples + 1) );
 
 	hydra_thrust::transform( policy, ffts.begin(),  ffts.end(),
 			complex_buffer.first, detail::convolution::MultiplyFFT<T>());
 
 	//transform product back to real
-
-
 	auto fft_product = _ComplexToRealFFT( 2*complex_buffer.second-2 );
 
-
 	fft_product.LoadInputData(complex_buffer.second, complex_buffer.first);
 	fft_product.Execute();
 
 	auto fft_product_output =  fft_product.GetOutputData();
 
-
 	T n = 2*complex_buffer.second-2;
 
 	auto normalize_fft =  detail::convolution::NormalizeFFT<T>(n);
 
-    	auto first = hydra_thrust::make_transform_iterator( fft_product_output.first,normalize_fft);
-    	auto last  = hydra_thrust::make_transform_iterator(fft_product_output.first + nsamples+1,normalize_fft);
+	auto first = hydra_thrust::make_transform_iterator( fft_product_output.first,normalize_fft);
+	auto last  = hydra_thrust::make_transform_iterator(fft_product_output.first + nsamples,normalize_fft);
 
 	auto fft_product_range = make_range(first, last);
 
 	hydra::copy(fft_product_range,  std::forward<Iterable>(output));
 
-	hydra_thrust::return_temporary_buffer( policy,  complex_buffer.first  );
-	hydra_thrust::return_temporary_buffer( policy,  kernel_samples.first  );
-	hydra_thrust::return_temporary_buffer( policy, functor_samples.first  );
+	hydra::detail::return_temporary_buffer( policy,  complex_buffer.first  );
+}
+
+}  // namespace convolution
+
+}  // namespace detail
+
+template<detail::Backend BACKEND, detail::FFTCalculator FFTBackend,  typename Functor, typename Kernel, typename Iterable,
+     typename T = typename detail::stripped_type<typename hydra_thrust::iterator_traits<decltype(std::declval<Iterable>().begin())>::value_type>::type,
+     typename USING_CUDA_BACKEND = typename std::conditional< std::is_convertible<detail::BackendPolicy<BACKEND>,hydra_thrust::system::cuda::tag >::value, std::integral_constant<int, 1>,std::integral_constant<int, 0>>::type,
+     typename USING_CUFFT = typename std::conditional< FFTBackend==detail::CuFFT, std::integral_constant<int, 1>,std::integral_constant<int, 0>>::type,
+     typename GPU_DATA = typename std::conditional< std::is_convertible<typename hydra_thrust::iterator_system< decltype(std::declval<Iterable>().begin())>::type,
+                        hydra_thrust::system::cuda::tag>::value
+         , std::integral_constant<int, 1>, std::integral_constant<int, 0> >::type>
+inline typename std::enable_if<std::is_floating_point<T>::value  && hydra::detail::is_iterable<Iterable>::value
+                   // && (USING_CUDA_BACKEND::value == USING_CUFFT::value)
+                   //  && (USING_CUDA_BACKEND::value == GPU_DATA::value),
+,void>::type
+convolute(detail::BackendPolicy<BACKEND> policy, detail::FFTPolicy<T, FFTBackend> fft_policy,
+		  Functor const& functor, Kernel const& kernel,
+		  T min,  T max, Iterable&& output, bool power_up=true ){
+
+
+	typedef hydra::complex<T> complex_type;
+
+	if(power_up) {
+		std::forward<Iterable>(output).resize(
+				hydra::detail::convolution::upper_power_of_two(std::forward<Iterable>(output).size()));
+	}
+
+	int nsamples = std::forward<Iterable>(output).size();
+
+	T delta = (max - min)/(nsamples);
+
+	auto kernel_spectrum  = hydra::detail::get_temporary_buffer<complex_type>(policy, nsamples+1);
+	auto functor_spectrum = hydra::detail::get_temporary_buffer<complex_type>(policy, nsamples+1);
+
+	// sample and transform kernel
+	hydra::detail::convolution::forward_transform(policy, fft_policy,
+			hydra::detail::convolution::KernelSampler<Kernel>(kernel, nsamples, delta),
+			nsamples, kernel_spectrum.first);
+
+	// sample and transform function
+	hydra::detail::convolution::forward_transform(policy, fft_policy,
+			hydra::detail::convolution::FunctorSampler<Functor>(functor, nsamples,  min, delta),
+			nsamples, functor_spectrum.first);
+
+	// multiply and transform back
+	hydra::detail::convolution::inverse_transform(policy, fft_policy,
+			functor_spectrum.first, kernel_spectrum.first, nsamples, std::forward<Iterable>(output));
+
+	hydra::detail::return_temporary_buffer( policy,  kernel_spectrum.first  );
+	hydra::detail::return_temporary_buffer( policy, functor_spectrum.first  );
 }
 
 
@@ -40,6 +40,7 @@
 #include <hydra/detail/external/hydra_thrust/execution_policy.h>
 #include <hydra/detail/external/hydra_thrust/binary_search.h>
 #include <hydra/detail/external/hydra_thrust/extrema.h>
+#include <hydra/Spiline.h>
 #include <math.h>
 #include <algorithm>
 
@@ -62,12 +63,21 @@ grid points. The method gives exact results if the data points
 correspond to a second-order polynomial.
 
 Reference: M. Steffen, Astron. Astrophys. 239, 443—450 (1990).
+
+The coefficients of the cubic in each interval are calculated once, when the
+points are set, so an evaluation costs the interval search and a polynomial.
+On evenly spaced abscissae the interval is found with O(1) arithmetic.
+
+The template parameters are the number of points, the argument type and the
+signature, as for the other functors. The argument is selected by type, not by the
+former ArgIndex parameter: code written as CubicSpiline<N, 0> should declare an
+argument with declarg() and use CubicSpiline<N, MyArg>.
 */
 
 
 
-template<size_t N, unsigned int ArgIndex=0>
-class CubicSpiline: public BaseFunctor<CubicSpiline<N, ArgIndex>, GReal_t , 0>
+template<size_t N, typename ArgType=double, typename Signature=double(ArgType)>
+class CubicSpiline: public BaseFunctor<CubicSpiline<N, ArgType, Signature>, Signature, 0>
 {
 
 public:
@@ -77,39 +87,53 @@ public:
 
 	template<typename Iterator1, typename Iterator2>
 	CubicSpiline( Iterator1 xbegin, Iterator2 ybegin ):
-	BaseFunctor<CubicSpiline<N, ArgIndex>, GReal_t , 0>()
+	BaseFunctor<CubicSpiline<N, ArgType, Signature>, Signature, 0>()
 	{
 		//populates fH and fX
 		hydra_thrust::copy( ybegin, ybegin+N,  fD );
 		hydra_thrust::copy( xbegin, xbegin+N,  fX);
 
+		UpdateGrid();
+		UpdateCoefficients(0, N-1);
 	}
 
 	__hydra_host__ __hydra_device__
-	CubicSpiline(CubicSpiline<N, ArgIndex> const& other ):
-	BaseFunctor<CubicSpiline<N, ArgIndex>, double, 0>(other)
+	CubicSpiline(CubicSpiline<N, ArgType, Signature> const& other ):
+	BaseFunctor<CubicSpiline<N, ArgType, Signature>, Signature, 0>(other),
+	fUniform(other.IsUniform()),
+	fInvDelta(other.fInvDelta)
 	{
 #pragma unroll
 		for(size_t i =0; i< N; i++){
 
 			fD[i] = other.GetD()[i];
 			fX[i] = other.GetX()[i];
+			fC[i] = other.fC[i];
+			fB[i] = other.fB[i];
+			fA[i] = other.fA[i];
 		}
 	}
 
 	__hydra_host__ __hydra_device__ inline
-	CubicSpiline<N>& operator=(CubicSpiline<N, ArgIndex> const& other )
+	CubicSpiline<N, ArgType, Signature>& operator=(CubicSpiline<N, ArgType, Signature> const& other )
 	{
 		if(this == &other) return *this;
 
-		BaseFunctor<CubicSpiline<N, ArgIndex>, double, 0>::operator=(other);
+		BaseFunctor<CubicSpiline<N, ArgType, Signature>, Signature, 0>::operator=(other);
 
 #pragma unroll
 		for(size_t i =0; i< N; i++){
 
 			fD[i] = other.GetD()[i];
 			fX[i] = other.GetX()[i];
+			fC[i] = other.fC[i];
+			fB[i] = other.fB[i];
+			fA[i] = other.fA[i];
 		}
+
+		fUniform  = other.IsUniform();
+		fInvDelta = other.fInvDelta;
+
 		return *this;
 	}
 
@@ -121,6 +145,7 @@ public:
 	__hydra_host__ __hydra_device__
 	inline void SetD(unsigned int i, GReal_t value)  {
 		fD[i]=value;
+		UpdateCoefficients(i>2 ? i-2 : 0, i+1);
 	}
 
 	__hydra_host__ __hydra_device__
@@ -131,26 +156,24 @@ public:
 	__hydra_host__ __hydra_device__
 		inline void SetX(unsigned int i, GReal_t value)  {
 			fX[i]=value;
+			UpdateGrid();
+			UpdateCoefficients(i>2 ? i-2 : 0, i+1);
 		}
 
-	template<typename T>
+	/**
+	 * @brief True if the abscissae are evenly spaced.
+	 */
 	__hydra_host__ __hydra_device__
-	inline double Evaluate(unsigned int n, T*x)  const {
-
-		GReal_t X  = x[ArgIndex];
-
-		GReal_t r = X<=fX[0]?fD[0]: X>=fX[N-1] ? fD[N-1] :spiline( X);
-
-		return  CHECK_VALUE( r, "r=%f",r) ;
+	inline bool IsUniform() const {
+		return fUniform;
 	}
 
-	template<typename T>
 	__hydra_host__ __hydra_device__
-	inline double Evaluate(T x)  const {
+	inline double Evaluate(ArgType x)  const {
 
-		GReal_t X  = hydra::get<ArgIndex>(x); //mass
+		GReal_t X  = x;
 
-		GReal_t r = X<=fX[0]?fD[0]: X>=fX[N-1] ? fD[N-1] :spiline(X);
+		GReal_t r = X<=fX[0]?fD[0]: X>=fX[N-1] ? fD[N-1] :spiline( X);
 
 		return  CHECK_VALUE( r, "r=%f",r) ;
 	}
@@ -160,58 +183,33 @@ private:
 	__hydra_host__ __hydra_device__
 	inline double spiline( const double x) const
 	{
-		using hydra_thrust::min;
-
-		const size_t i = hydra_thrust::distance(fX,
-							hydra_thrust::lower_bound(hydra_thrust::seq, fX, fX +N, x));
-		//--------------------
-
-		const double y_i = fD[i], y_ip = fD[i+1],y_ipp = fD[i+2], y_im = fD[i-1] ;
-
-		const double x_i = fX[i], x_ip = fX[i+1],x_ipp = fX[i+2], x_im = fX[i-1] ;
-
-		//calculates s
-		const double  h_i  = x_ip -x_i;
-		const double  h_ip = x_ipp -x_ip;
-		const double  h_im = x_i  -x_im;
+		const size_t i = detail::spiline::locate(fX, N, fUniform, fInvDelta, x);
 
-		const double  s_i  = (y_ip - y_i)/h_i;
-		const double  s_ip = (y_ipp - y_ip)/h_ip;
-		const double  s_im = (y_i - y_im)/h_im;
-
-		const double p_i  = i==0 ? ( s_i*(1 + h_i/(h_i + h_ip)) - s_ip*h_i/(h_i + h_ip) ):
-					i==N-2 ? ( s_i*(1 + h_i/(h_i + h_im)) - s_im*h_i/(h_i + h_im) )
-				: (s_im*h_i + s_i*h_im)/(h_i+ h_im);
-
-		const double p_ip = (s_i*h_ip + s_ip*h_i)/(h_ip+ h_i);
-
-
-		// calculates c
-
-		const double c_i =  i==0  ? (copysign(1.0, p_i ) + copysign(1.0, s_i ))
-				*min( fabs(s_i) , 0.5*fabs(p_i) ):
-				i==N-2 ? (copysign(1.0, p_i ) + copysign(1.0, s_i ))
-						*min( fabs(s_i) , 0.5*fabs(p_i) ):
-					(copysign(1.0, s_im ) + copysign(1.0, s_i ))
-				        *min(min(fabs(s_im), fabs(s_i)), 0.5*fabs(p_i) );
-
-		const double c_ip =  (copysign(1.0, s_i ) + copysign(1.0, s_ip ))
-									*min(min(fabs(s_ip), fabs(s_i)), 0.5*fabs(p_ip) );
-
-		//calculates b
-		const double b_i =  (-2*c_i - c_ip - 3*s_i)/h_i;
-
-		//calculates a
-		const double a_i = (c_i + c_ip - 2*s_i)/(h_i*h_i);
+		return detail::spiline::horner(x - fX[i], fA[i], fB[i], fC[i], fD[i]);
+	}
 
-		//--------------------
-		const double X = (x-fX[i]);
+	__hydra_host__ __hydra_device__
+	inline void UpdateGrid()
+	{
+		fUniform  = detail::spiline::is_uniform(fX, N);
+		fInvDelta = (N-1)/(fX[N-1] - fX[0]);
+	}
 
-		return X*( X*(a_i*X + b_i) + c_i) + y_i;
+	//coefficients of the intervals first..last (clamped to N-2)
+	__hydra_host__ __hydra_device__
+	inline void UpdateCoefficients(size_t first, size_t last)
+	{
+		for(size_t i=first; i<=last && i<N-1; i++)
+			detail::spiline::coefficients(fX, fD, i, N, fC[i], fB[i], fA[i]);
 	}
 
 	GReal_t fX[N];
 	GReal_t fD[N];
+	GReal_t fC[N];
+	GReal_t fB[N];
+	GReal_t fA[N];
+	bool    fUniform;
+	GReal_t fInvDelta;
 
 };
 
@@ -39,6 +39,7 @@
 #include <hydra/PhaseSpace.h>
 #include <hydra/detail/FunctorTraits.h>
 #include <hydra/detail/CompositeTraits.h>
+#include <hydra/detail/UnweightCompaction.h>
 
 
 namespace hydra {
@@ -260,6 +261,49 @@ public :
 	 hydra::Range<iterator>>::type
 	 Unweight( Functor  const& functor, double weight=-1.0, size_t seed=0x39abdc4529b1661c);
 
+	 /**
+	  * @brief Out-of-place unweighting with respect to the phase-space weight.
+	  *
+	  * The accepted events are appended to @p output, which can live on another back-end.
+	  * This container is not modified. The events are processed in chunks of at most
+	  * @p chunk_size: the weights are computed once per chunk, the accepted events are
+	  * flagged, their positions in the output are obtained by a prefix sum of the flags
+	  * and they are scattered there. The accepted events, in the original order, are the
+	  * same selected by Unweight(seed).
+	  *
+	  * @param output container receiving the accepted events.
+	  * @param seed seed of the accept/reject stream.
+	  * @param chunk_size maximum number of events processed at once.
+	  * @return range with the events appended to @p output.
+	  */
+	 template<hydra::detail::Backend BACKEND2>
+	 hydra::Range<typename Decays<tuple_type, hydra::detail::BackendPolicy<BACKEND2>>::iterator>
+	 Unweight( Decays<tuple_type, hydra::detail::BackendPolicy<BACKEND2>>& output,
+			 size_t seed=0x180ec6d33cfd0aba, size_t chunk_size=HYDRA_UNWEIGHT_CHUNK_SIZE);
+
+	 /**
+	  * @brief Out-of-place unweighting with respect to the phase-space weight times @p functor.
+	  *
+	  * Same as above. If @p max_weight is not positive, the weights of all events are
+	  * computed once and stored, one double per event, to find the maximum weight.
+	  * The accepted events are the same selected by Unweight(functor, max_weight, seed).
+	  *
+	  * @param functor the event weights are multiplied by this functor.
+	  * @param output container receiving the accepted events.
+	  * @param max_weight maximum weight.
+	  * @param seed seed of the accept/reject stream.
+	  * @param chunk_size maximum number of events processed at once.
+	  * @return range with the events appended to @p output.
+	  */
+	 template<typename Functor, hydra::detail::Backend BACKEND2>
+	 typename std::enable_if<
+	 detail::is_hydra_functor<Functor>::value ||
+	 detail::is_hydra_lambda<Functor>::value  ||
+	 detail::is_hydra_composite_functor<Functor>::value ,
+	 hydra::Range<typename Decays<tuple_type, hydra::detail::BackendPolicy<BACKEND2>>::iterator>>::type
+	 Unweight( Functor  const& functor, Decays<tuple_type, hydra::detail::BackendPolicy<BACKEND2>>& output,
+			 double max_weight=-1.0, size_t seed=0x39abdc4529b1661c, size_t chunk_size=HYDRA_UNWEIGHT_CHUNK_SIZE);
+
 	/**
 	 * Add a decay to the container, increasing
 	 * its size by one element.
@@ -634,6 +678,11 @@ double GetMotherMass() const
 
 private:
 
+	template<typename WeightFunctor, typename Container>
+	hydra::Range<decltype(std::declval<Container&>().begin())>
+	UnweightInto(WeightFunctor const& weight_functor, Container& output,
+			double max_weight, size_t seed, size_t chunk_size);
+
 	double PDK(const double a, const double b, const double c) const {
 		//the PDK function
 		GReal_t x = (a - b - c) * (a + b + c) * (a - b + c) * (a + b - c);
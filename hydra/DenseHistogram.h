@@ -37,6 +37,7 @@
 #include <hydra/detail/functors/GetBinCenter.h>
 #include <hydra/Range.h>
 #include <hydra/Algorithm.h>
+#include <hydra/detail/HistogramFill.h>
 
 #include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
 
@@ -80,7 +81,8 @@ public:
 
 	explicit DenseHistogram( std::array<size_t, N> grid,
 			std::array<T, N> const& lowerlimits,   std::array<T, N> const& upperlimits):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -94,7 +96,8 @@ public:
 
 	explicit DenseHistogram( size_t (&grid)[N],
 			T (&lowerlimits)[N],   T (&upperlimits)[N] ):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -108,7 +111,8 @@ public:
 
 	template<typename Int, typename = typename std::enable_if<std::is_integral<Int>::value, void>::type>
 	DenseHistogram( std::array<Int, N> grid, std::array<T, N> const& lowerlimits,   std::array<T, N> const& upperlimits):
-					fNBins(1)
+					fNBins(1),
+					fAccumulate(false)
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i]=grid[i];
@@ -122,7 +126,8 @@ public:
 
 	template<typename Int, typename = typename std::enable_if<std::is_integral<Int>::value, void>::type>
 	DenseHistogram( Int (&grid)[N],	T (&lowerlimits)[N],   T (&upperlimits)[N] ):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i]=grid[i];
@@ -138,7 +143,8 @@ public:
 
 
 	DenseHistogram(DenseHistogram< T, N, hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional> const& other ):
-			fContents(other.GetContents())
+			fContents(other.GetContents()),
+			fAccumulate(other.IsAccumulating())
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i] = other.GetGrid(i);
@@ -150,7 +156,8 @@ public:
 		}
 
 	DenseHistogram(DenseHistogram< T, N, hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional>&& other ):
-			fContents(std::move(other.GetContents()))
+			fContents(std::move(other.GetContents())),
+			fAccumulate(other.IsAccumulating())
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i] = other.GetGrid(i);
@@ -174,6 +181,7 @@ public:
 		}
 
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
@@ -191,6 +199,7 @@ public:
 		}
 
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
@@ -198,7 +207,8 @@ public:
 
 	template<hydra::detail::Backend BACKEND2>
 	DenseHistogram(DenseHistogram< T, N, hydra::detail::BackendPolicy<BACKEND2>, detail::multidimensional> const& other ):
-			fContents(other.GetContents())
+			fContents(other.GetContents()),
+			fAccumulate(other.IsAccumulating())
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i] = other.GetGrid(i);
@@ -221,6 +231,7 @@ public:
 		}
 
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
@@ -249,6 +260,22 @@ public:
 		return fNBins;
 	}
 
+	 /**
+	  * If accumulation is enabled, successive calls to Fill add
+	  * to the current contents instead of replacing them.
+	  */
+	 inline bool IsAccumulating() const {
+		return fAccumulate;
+	}
+
+	 inline void SetAccumulate(bool accumulate) {
+		fAccumulate = accumulate;
+	}
+
+	 inline void Reset() {
+		hydra_thrust::fill(fContents.begin(), fContents.end(), 0.0);
+	}
+
 	 inline 	size_t GetBin( size_t  (&bins)[N]){
 
 		size_t bin=0;
@@ -460,6 +487,29 @@ public:
 	inline  DenseHistogram<T,N, hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional>&
 	Fill(detail::BackendPolicy<BACKEND2> const& exec_policy, Iterator1 begin, Iterator1 end, Iterator2 wbegin);
 
+	/**
+	 * Streams the data through the fixed size \p buffer. The \p generator is called as
+	 * generator(buffer.begin(), buffer.size()), writes the next chunk into the buffer
+	 * and returns its size. The stream ends when it returns zero.
+	 */
+	template<typename Generator, typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+	DenseHistogram<T,N, hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+	Fill(Generator&& generator, Iterable&& buffer);
+
+	/**
+	 * Streams the data and the weights through the fixed size buffers \p buffer and \p wbuffer.
+	 * The \p generator is called as generator(buffer.begin(), wbuffer.begin(), buffer.size()).
+	 */
+	template<typename Generator, typename Iterable1, typename Iterable2>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+	hydra::detail::is_iterable<Iterable2>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+	                                  decltype(std::declval<Iterable2&>().begin())>::value,
+	DenseHistogram<T,N, hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+	Fill(Generator&& generator, Iterable1&& buffer, Iterable2&& wbuffer);
+
 
 
 private:
@@ -594,6 +644,7 @@ private:
 	size_t   fNBins;
 	storage_t fContents;
 	system_t fSystem;
+	bool     fAccumulate;
 
 };
 
@@ -628,7 +679,8 @@ public:
 		fLowerLimits(lowerlimits),
 		fUpperLimits(upperlimits),
 		fNBins(grid),
-		fContents( grid+2 )
+		fContents( grid+2 ),
+		fAccumulate(false)
 	{}
 
 
@@ -637,7 +689,8 @@ public:
 		fGrid(other.GetGrid()),
 		fLowerLimits(other.GetLowerLimits()),
 		fUpperLimits(other.GetUpperLimits()),
-		fNBins(other.GetNBins())
+		fNBins(other.GetNBins()),
+		fAccumulate(other.IsAccumulating())
 	{}
 
 	DenseHistogram(DenseHistogram< T,1,  hydra::detail::BackendPolicy<BACKEND>,detail::unidimensional >&& other ):
@@ -645,7 +698,8 @@ public:
 			fGrid(other.GetGrid()),
 			fLowerLimits(other.GetLowerLimits()),
 			fUpperLimits(other.GetUpperLimits()),
-			fNBins(other.GetNBins())
+			fNBins(other.GetNBins()),
+			fAccumulate(other.IsAccumulating())
 		{}
 
 
@@ -660,6 +714,7 @@ public:
 		fLowerLimits = other.GetLowerLimits();
 		fUpperLimits = other.GetUpperLimits();
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 
 		return *this;
 	}
@@ -674,6 +729,7 @@ public:
 		fLowerLimits = other.GetLowerLimits();
 		fUpperLimits = other.GetUpperLimits();
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 
 		return *this;
 	}
@@ -684,7 +740,8 @@ public:
 		fGrid(other.GetGrid()),
 		fLowerLimits(other.GetLowerLimits()),
 		fUpperLimits(other.GetUpperLimits()),
-		fNBins(other.GetNBins())
+		fNBins(other.GetNBins()),
+		fAccumulate(other.IsAccumulating())
 	{}
 
 	template<hydra::detail::Backend BACKEND2>
@@ -696,6 +753,7 @@ public:
 		fLowerLimits = other.GetLowerLimits();
 		fUpperLimits = other.GetUpperLimits();
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 
 		return *this;
 	}
@@ -724,6 +782,22 @@ public:
 		return fNBins;
 	}
 
+	/**
+	 * If accumulation is enabled, successive calls to Fill add
+	 * to the current contents instead of replacing them.
+	 */
+	bool IsAccumulating() const {
+		return fAccumulate;
+	}
+
+	void SetAccumulate(bool accumulate) {
+		fAccumulate = accumulate;
+	}
+
+	void Reset() {
+		hydra_thrust::fill(fContents.begin(), fContents.end(), 0.0);
+	}
+
 	double GetBinContent(size_t i){
 
 		return (i<=fNBins+1) ?
@@ -821,6 +895,29 @@ public:
 	inline DenseHistogram<T,1, hydra::detail::BackendPolicy<BACKEND>, detail::unidimensional>&
 	Fill(detail::BackendPolicy<BACKEND2> const& exec_policy,Iterator1 begin, Iterator1 end, Iterator2 wbegin);
 
+	/**
+	 * Streams the data through the fixed size \p buffer. The \p generator is called as
+	 * generator(buffer.begin(), buffer.size()), writes the next chunk into the buffer
+	 * and returns its size. The stream ends when it returns zero.
+	 */
+	template<typename Generator, typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+	DenseHistogram<T,1, hydra::detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+	Fill(Generator&& generator, Iterable&& buffer);
+
+	/**
+	 * Streams the data and the weights through the fixed size buffers \p buffer and \p wbuffer.
+	 * The \p generator is called as generator(buffer.begin(), wbuffer.begin(), buffer.size()).
+	 */
+	template<typename Generator, typename Iterable1, typename Iterable2>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+	hydra::detail::is_iterable<Iterable2>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+	                                  decltype(std::declval<Iterable2&>().begin())>::value,
+	DenseHistogram<T,1, hydra::detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+	Fill(Generator&& generator, Iterable1&& buffer, Iterable2&& wbuffer);
+
 
 
 private:
@@ -831,6 +928,7 @@ private:
 	size_t   fNBins;
 	storage_t fContents;
 	system_t fSystem;
+	bool     fAccumulate;
 
 };
 
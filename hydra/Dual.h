@@ -0,0 +1,375 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * Dual.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup fit
+ */
+
+#ifndef DUAL_H_
+#define DUAL_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+
+#include <cmath>
+#include <ostream>
+
+namespace hydra {
+
+namespace dual {
+
+/**
+ * \ingroup fit
+ * \brief Forward-mode dual number carrying a value and its derivatives with respect to N variables.
+ *
+ * Arithmetic and the elementary functions below propagate the derivatives by the chain rule,
+ * so code templated on the floating point type computes a function and its gradient
+ * in a single evaluation. Call the math functions unqualified, after `using std::exp;` etc.,
+ * so the same code compiles for `double` and `hydra::Dual`. The overloads live in `hydra::dual`,
+ * next to the type, and are found by argument-dependent lookup: they do not hide `::exp` etc.
+ * for the rest of the hydra namespace.
+ *
+ * \tparam T floating point type.
+ * \tparam N number of variables.
+ */
+template<typename T, size_t N>
+class Dual
+{
+
+public:
+
+	typedef T value_type;
+
+	static const size_t size = N;
+
+	__hydra_host__ __hydra_device__
+	Dual():
+		fValue(0)
+	{
+		for(size_t i=0; i<N; i++) fDerivatives[i]=0;
+	}
+
+	/**
+	 * @brief Constant: all derivatives are zero.
+	 */
+	__hydra_host__ __hydra_device__
+	Dual(T value):
+		fValue(value)
+	{
+		for(size_t i=0; i<N; i++) fDerivatives[i]=0;
+	}
+
+	/**
+	 * @brief Independent variable @p variable, with unit derivative with respect to itself.
+	 */
+	__hydra_host__ __hydra_device__
+	Dual(T value, size_t variable):
+		fValue(value)
+	{
+		for(size_t i=0; i<N; i++) fDerivatives[i]= i==variable;
+	}
+
+	__hydra_host__ __hydra_device__
+	Dual(Dual<T,N> const& other):
+		fValue(other.fValue)
+	{
+		for(size_t i=0; i<N; i++) fDerivatives[i]=other.fDerivatives[i];
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator=(Dual<T,N> const& other)
+	{
+		if(this == &other) return *this;
+
+		fValue = other.fValue;
+
+		for(size_t i=0; i<N; i++) fDerivatives[i]=other.fDerivatives[i];
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline T Value() const { return fValue; }
+
+	__hydra_host__ __hydra_device__
+	inline T Derivative(size_t i) const { return fDerivatives[i]; }
+
+	__hydra_host__ __hydra_device__
+	inline T const* GetDerivatives() const { return fDerivatives; }
+
+	__hydra_host__ __hydra_device__
+	inline void SetValue(T value) { fValue=value; }
+
+	__hydra_host__ __hydra_device__
+	inline void SetDerivative(size_t i, T value) { fDerivatives[i]=value; }
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator+=(Dual<T,N> const& other)
+	{
+		fValue += other.fValue;
+		for(size_t i=0; i<N; i++) fDerivatives[i] += other.fDerivatives[i];
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator-=(Dual<T,N> const& other)
+	{
+		fValue -= other.fValue;
+		for(size_t i=0; i<N; i++) fDerivatives[i] -= other.fDerivatives[i];
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator*=(Dual<T,N> const& other)
+	{
+		for(size_t i=0; i<N; i++)
+			fDerivatives[i] = fDerivatives[i]*other.fValue + fValue*other.fDerivatives[i];
+		fValue *= other.fValue;
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator/=(Dual<T,N> const& other)
+	{
+		T inv = T(1)/other.fValue;
+		fValue *= inv;
+		for(size_t i=0; i<N; i++)
+			fDerivatives[i] = (fDerivatives[i] - fValue*other.fDerivatives[i])*inv;
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator+=(T other)
+	{
+		fValue += other;
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator-=(T other)
+	{
+		fValue -= other;
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator*=(T other)
+	{
+		fValue *= other;
+		for(size_t i=0; i<N; i++) fDerivatives[i] *= other;
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N>& operator/=(T other)
+	{
+		T inv = T(1)/other;
+		return (*this)*=inv;
+	}
+
+	/**
+	 * @brief Function of this number, given the value @p f and the first derivative @p df at Value().
+	 */
+	__hydra_host__ __hydra_device__
+	inline Dual<T,N> Chain(T f, T df) const
+	{
+		Dual<T,N> r(f);
+		for(size_t i=0; i<N; i++) r.fDerivatives[i] = df*fDerivatives[i];
+		return r;
+	}
+
+private:
+
+	T fValue;
+	T fDerivatives[N];
+};
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator+(Dual<T,N> const& x) { return x; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator-(Dual<T,N> const& x) { return x.Chain(-x.Value(), T(-1)); }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator+(Dual<T,N> x, Dual<T,N> const& y) { return x+=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator+(Dual<T,N> x, typename Dual<T,N>::value_type y) { return x+=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator+(typename Dual<T,N>::value_type x, Dual<T,N> y) { return y+=x; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator-(Dual<T,N> x, Dual<T,N> const& y) { return x-=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator-(Dual<T,N> x, typename Dual<T,N>::value_type y) { return x-=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator-(typename Dual<T,N>::value_type x, Dual<T,N> const& y) { return (-y)+=x; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator*(Dual<T,N> x, Dual<T,N> const& y) { return x*=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator*(Dual<T,N> x, typename Dual<T,N>::value_type y) { return x*=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator*(typename Dual<T,N>::value_type x, Dual<T,N> y) { return y*=x; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator/(Dual<T,N> x, Dual<T,N> const& y) { return x/=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator/(Dual<T,N> x, typename Dual<T,N>::value_type y) { return x/=y; }
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> operator/(typename Dual<T,N>::value_type x, Dual<T,N> const& y)
+{
+	T inv = T(1)/y.Value();
+	return y.Chain(x*inv, -x*inv*inv);
+}
+
+// comparisons act on the values, so branches follow the same path as with T
+#define HYDRA_DUAL_COMPARISON(OP)\
+template<typename T, size_t N>\
+__hydra_host__ __hydra_device__ \
+inline bool operator OP(Dual<T,N> const& x, Dual<T,N> const& y) { return x.Value() OP y.Value(); }\
+template<typename T, size_t N>\
+__hydra_host__ __hydra_device__ \
+inline bool operator OP(Dual<T,N> const& x, typename Dual<T,N>::value_type y) { return x.Value() OP y; }\
+template<typename T, size_t N>\
+__hydra_host__ __hydra_device__ \
+inline bool operator OP(typename Dual<T,N>::value_type x, Dual<T,N> const& y) { return x OP y.Value(); }
+
+HYDRA_DUAL_COMPARISON(<)
+HYDRA_DUAL_COMPARISON(>)
+HYDRA_DUAL_COMPARISON(<=)
+HYDRA_DUAL_COMPARISON(>=)
+HYDRA_DUAL_COMPARISON(==)
+HYDRA_DUAL_COMPARISON(!=)
+
+#undef HYDRA_DUAL_COMPARISON
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> exp(Dual<T,N> const& x)
+{
+	T f = ::exp(x.Value());
+	return x.Chain(f, f);
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> log(Dual<T,N> const& x)
+{
+	return x.Chain(::log(x.Value()), T(1)/x.Value());
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> sqrt(Dual<T,N> const& x)
+{
+	T f = ::sqrt(x.Value());
+	return x.Chain(f, T(0.5)/f);
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> pow(Dual<T,N> const& x, typename Dual<T,N>::value_type y)
+{
+	T f = ::pow(x.Value(), y);
+	return x.Chain(f, y*::pow(x.Value(), y - T(1)));
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> pow(Dual<T,N> const& x, Dual<T,N> const& y)
+{
+	return exp(y*log(x));
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> pow(typename Dual<T,N>::value_type x, Dual<T,N> const& y)
+{
+	T f = ::pow(x, y.Value());
+	return y.Chain(f, f*::log(x));
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> sin(Dual<T,N> const& x)
+{
+	return x.Chain(::sin(x.Value()), ::cos(x.Value()));
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> cos(Dual<T,N> const& x)
+{
+	return x.Chain(::cos(x.Value()), -::sin(x.Value()));
+}
+
+template<typename T, size_t N>
+__hydra_host__ __hydra_device__
+inline Dual<T,N> atan(Dual<T,N> const& x)
+{
+	return x.Chain(::atan(x.Value()), T(1)/(T(1) + x.Value()*x.Value()));
+}
+
+template<typename T, size_t N>
+inline std::ostream& operator<<(std::ostream& os, Dual<T,N> const& x)
+{
+	os << "{" << x.Value() << "; ";
+	for(size_t i=0; i<N; i++) os << (i ? ", " : "") << x.Derivative(i);
+	return os << "}";
+}
+
+}  // namespace dual
+
+using dual::Dual;
+
+}  // namespace hydra
+
+#endif /* DUAL_H_ */
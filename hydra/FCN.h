@@ -40,6 +40,8 @@
 #include <hydra/detail/Print.h>
 #include <hydra/UserParameters.h>
 #include <hydra/detail/EstimatorTraits.h>
+#include <hydra/detail/FunctorTraits.h>
+#include <hydra/detail/BoundedCache.h>
 
 #include <hydra/detail/external/hydra_thrust/distance.h>
 #include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
@@ -47,15 +49,36 @@
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 
 #include <Minuit2/FCNBase.h>
+#include <Minuit2/FCNGradientBase.h>
 #include <unordered_map>
 #include <vector>
 #include <cassert>
 #include <utility>
 #include <limits>
+#include <cmath>
+#include <type_traits>
 
 
+/*
+ * Number of parameter points evaluated per event by the multi-point FCN evaluation.
+ */
+#ifndef HYDRA_FCN_BATCH_SIZE
+#define HYDRA_FCN_BATCH_SIZE 8
+#endif
+
+/*
+ * When set, FCNs of single pdfs without analytical gradient give Minuit
+ * central-difference gradients from the multi-point evaluation.
+ */
+#ifndef HYDRA_FCN_BATCHED_GRADIENT
+#define HYDRA_FCN_BATCHED_GRADIENT 0
+#endif
+
 namespace hydra {
 
+template<typename FUNCTOR, typename INTEGRATOR>
+class Pdf;
+
 namespace detail {
 
 template<typename ArgType>
@@ -72,6 +95,65 @@ struct FCNWeightsReducerUnary: public hydra_thrust::unary_function<ArgType, doub
 
 };
 
+template<typename PDF>
+struct is_differentiable_pdf: std::false_type {};
+
+template<typename Functor, typename Integrator>
+struct is_differentiable_pdf< hydra::Pdf<Functor, Integrator> >:
+	is_differentiable_functor<Functor> {};
+
+/*
+ * Only single pdfs have the multi-point evaluation, LogLikelihoodFCN::Eval(points).
+ */
+template<typename PDF>
+struct has_batched_gradient: std::false_type {};
+
+template<typename Functor, typename Integrator>
+struct has_batched_gradient< hydra::Pdf<Functor, Integrator> >:
+	std::integral_constant<bool, HYDRA_FCN_BATCHED_GRADIENT> {};
+
+/*
+ * Minuit2 interface of the FCN: models whose functor supports the evaluation
+ * with dual parameters provide the gradient, and so do single pdfs when
+ * HYDRA_FCN_BATCHED_GRADIENT is set, using central differences evaluated in
+ * one data pass. The others fall back to the finite differences computed by Minuit.
+ */
+template<typename PDF>
+using fcn_minuit_base = typename std::conditional<
+		is_differentiable_pdf<PDF>::value || has_batched_gradient<PDF>::value,
+		ROOT::Minuit2::FCNGradientBase, ROOT::Minuit2::FCNBase>::type;
+
+/*
+ * Points for the central differences of the FCN with respect to the free
+ * parameters: for the k-th free parameter, points 2k and 2k+1 are shifted
+ * by +steps[k] and -steps[k] along parameters[indexes[k]].
+ */
+inline void numerical_gradient_points(const std::vector<double>& parameters,
+		const std::vector<hydra::Parameter*>& variables,
+		std::vector<std::vector<double>>& points,
+		std::vector<size_t>& indexes, std::vector<double>& steps)
+{
+	for(auto variable: variables){
+
+		if( variable->IsFixed() ) continue;
+
+		size_t index = variable->GetIndex();
+
+		GReal_t h = 1.0e-5*(std::fabs(parameters[index]) + variable->GetError());
+
+		if( h == 0.0 ) h = 1.0e-8;
+
+		points.push_back(parameters);
+		points.back()[index] += h;
+
+		points.push_back(parameters);
+		points.back()[index] -= h;
+
+		indexes.push_back(index);
+		steps.push_back(h);
+	}
+}
+
 } //namespace detail
 
 /**
@@ -34,6 +34,7 @@
  */
 #include <hydra/detail/FFTPolicy.h>
 #include<hydra/detail/fftw/WrappersFFTW.h>
+#include<hydra/detail/fftw/PlanCacheFFTW.h>
 #include<hydra/detail/fftw/BaseFFTW.h>
 #include<hydra/detail/fftw/ComplexToRealFFTW.h>
 #include<hydra/detail/fftw/RealToComplexFFTW.h>
@@ -296,8 +296,75 @@ public:
 		return  call(z);
 	}
 
+	/**
+	 * \brief Evaluates the functor with its parameters replaced by @p par.
+	 *
+	 * With hydra::Dual numbers seeded on the parameters, the result carries
+	 * the derivatives of the functor with respect to them. This requires
+	 * `Functor` to implement the parameter-generic evaluation
+	 * \code{.cpp}
+	 * template<typename Real>
+	 * __hydra_host__ __hydra_device__
+	 * Real EvaluateWithParameters(Real const* par, Args... x) const;
+	 * \endcode
+	 * (see detail::is_differentiable_functor). The arguments are taken as in the
+	 * call operator: a pack of arguments or one tuple containing them.
+	 */
+	template<typename Real, typename T>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if<
+	( detail::is_tuple_type< typename std::decay<T>::type >::value )                 &&
+	(!detail::is_tuple_of_function_arguments< typename std::decay<T>::type >::value),
+	Real >::type
+	CallWithParameters( Real const* par, T x )  const
+	{
+		return  raw_call_with_parameters(par, x, detail::make_index_sequence<Functor::arity>{});
+	}
+
+	template<typename Real, typename T>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if<
+	( detail::is_tuple_type< typename std::decay<T>::type >::value ) &&
+	( detail::is_tuple_of_function_arguments< typename std::decay<T>::type >::value),
+	Real >::type
+	CallWithParameters( Real const* par, T x )  const
+	{
+		return  call_with_parameters(par, x, detail::make_index_sequence<Functor::arity>{});
+	}
+
+	template<typename Real, typename ...T>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if<
+	(sizeof...(T)==arity) &&
+	detail::all_true<(!detail::is_tuple_type< typename std::decay<T>::type >::value)...>::value,
+	Real >::type
+	CallWithParameters( Real const* par, T ...x )  const
+	{
+		return  raw_call_with_parameters(par, hydra_thrust::make_tuple(x...),
+				detail::make_index_sequence<Functor::arity>{});
+	}
+
 private:
 
+	template<typename Real, typename T, size_t ...I>
+	__hydra_host__ __hydra_device__
+	inline Real call_with_parameters(Real const* par, T x, detail::index_sequence<I...> ) const
+	{
+		return static_cast<const Functor*>(this)->EvaluateWithParameters(par,
+				detail::get_tuple_element<
+				typename hydra_thrust::tuple_element<I, argument_type>::type >(x)...);
+	}
+
+	template<typename Real, typename T, size_t ...I>
+	__hydra_host__ __hydra_device__
+	inline Real raw_call_with_parameters(Real const* par, T x, detail::index_sequence<I...> ) const
+	{
+		return static_cast<const Functor*>(this)->EvaluateWithParameters(par,
+				static_cast<typename hydra_thrust::tuple_element<I, argument_type>::type>(
+				hydra_thrust::get<I>(x))...);
+	}
+
+
 	template<typename T, size_t ...I>
 	__hydra_host__ __hydra_device__
 	inline  return_type call_helper(T x, detail::index_sequence<I...> ) const
@@ -37,12 +37,15 @@
 #include <hydra/Types.h>
 #include <hydra/GaussKronrodRules.h>
 #include <hydra/detail/functors/ProcessGaussKronrodAdaptiveQuadrature.h>
-#include <hydra/multivector.h>
 #include <hydra/Integrator.h>
 #include <hydra/Placeholders.h>
 
 #include <hydra/detail/Print.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 
@@ -64,6 +67,10 @@ class GaussKronrodAdaptiveQuadrature;
  *  @tparam NBIN  Maximum number of multidimensional subdivisions of the integration region.
  *  @tparam BACKEND parallel back end. Can be hydra::omp::sys , hydra::cuda::sys , hydra::tbb::sys , hydra::cpp::sys ,hydra::host::sys and hydra::device::sys
  *
+ *  The sub-intervals are kept in a heap ordered by error. Each iteration splits the ones with the largest
+ *  errors, up to GetSplitsPerIteration(), and evaluates only the new sub-intervals, reducing the rule calls
+ *  on the back-end. A batch of integrals can be calculated at once with Integrate(begin, end).
+ *
 [*Description mostly copied From Wikipedia*](https://en.wikipedia.org/wiki/Gauss%E2%80%93Kronrod_quadrature_formula)
 
 ###Introduction###
@@ -110,51 +117,20 @@ public Integral< GaussKronrodAdaptiveQuadrature<NRULE, NBIN, hydra::detail::Back
 	 * nodes
 	 */
 	typedef hydra_thrust::tuple<
-			GBool_t, // process
-			GUInt_t,  // bin
+			GUInt_t, // integral
 			double,  // lower
 			double,  // upper
 			double,  // integral
 			double   // error
 			> node_t;
 
-	typedef hydra_thrust::host_vector<node_t>   node_list_h;
-	//typedef multivector<node_list_h> node_table_h;
-	typedef multivector<node_t, hydra::host::sys_t> node_table_h;
-	/*
-	 * parameters
-	 */
-	typedef hydra_thrust::tuple<
-			GUInt_t,// bin ,
-			double, // abscissa_X_P
-			double, // abscissa_X_M
-			double, // Jacobian
-			double, // rule_GaussKronrod_Weight
-			double  // rule_Gauss_Weight
-			> parameters_t;
-
-	typedef std::vector<parameters_t>   parameters_list_h;
-	typedef typename system_t::template container<parameters_t> parameters_list_d;
-
-	typedef multivector<parameters_t, hydra::host::sys_t> parameters_table_h;
-	typedef multivector<parameters_t, hydra::detail::BackendPolicy<BACKEND>> parameters_table_d;
-
+	typedef std::vector<node_t> node_table_h;
 
 	/*
-	 * call results
+	 * index of a node and its error, ordered by error
 	 */
-	typedef hydra_thrust::tuple<
-			GUInt_t, // bin
-			double,  // gauss
-			double   // kronrod
-			> call_t;
-
-	typedef std::vector<call_t>   call_list_h;
-	typedef typename system_t::template container<call_t> call_list_d;
-
-	typedef multivector<call_t,hydra::host::sys_t > call_table_h;
-	typedef multivector<call_t,hydra::detail::BackendPolicy<BACKEND>> call_table_d;
-
+	typedef std::pair<double, size_t> heap_entry_t;
+	typedef std::vector<heap_entry_t> node_heap_h;
 
 public:
 
@@ -170,15 +146,17 @@ public:
 	 * Self-adaptive Gauss-Kronrod quadrature constructor taking the integration region and the tolerance as parameters.
 	 * @param xlower - lower range limit
 	 * @param xupper - upper range limit
-	 * @param tolerance - maximum absolute error
+	 * @param tolerance - maximum relative error
+	 * @param nsplits - maximum number of sub-intervals split per iteration
 	 */
-	GaussKronrodAdaptiveQuadrature(GReal_t xlower, GReal_t xupper, GReal_t tolerance=1e-15):
+	GaussKronrodAdaptiveQuadrature(GReal_t xlower, GReal_t xupper, GReal_t tolerance=1e-15, size_t nsplits=8):
 		fIterationNumber(0),
 		fXLower(xlower),
 		fXUpper(xupper),
 		fMaxRelativeError( tolerance ),
+		fSplitsPerIteration( nsplits > 0 ? nsplits : 1 ),
 		fRule(GaussKronrodRuleSelector<NRULE>().fRule)
-	{ InitNodes(); }
+	{ }
 
 
 	/**
@@ -191,10 +169,9 @@ public:
 			fXLower(other.GetXLower() ),
 			fXUpper(other.GetXUpper()),
 			fMaxRelativeError(other.GetMaxRelativeError() ),
+			fSplitsPerIteration(other.GetSplitsPerIteration() ),
 			fRule(other.GetRule())
-		{
-			InitNodes();
-		}
+		{ }
 
 	/**
 	 * @brief Copy constructor
@@ -207,10 +184,9 @@ public:
 				fXLower(other.GetXLower() ),
 				fXUpper(other.GetXUpper()),
 				fMaxRelativeError(other.GetMaxRelativeError() ),
+				fSplitsPerIteration(other.GetSplitsPerIteration() ),
 				fRule(other.GetRule())
-			{
-				InitNodes();
-			}
+			{ }
 
 
     /**
@@ -227,8 +203,9 @@ public:
 		this->fXLower = other.GetXLower() ;
 		this->fXUpper = other.GetXUpper();
 		this->fMaxRelativeError = other.GetMaxRelativeError() ;
+		this->fSplitsPerIteration = other.GetSplitsPerIteration() ;
 		this->fRule=other.GetRule();
-		this->InitNodes();
+		this->fNodesTable.clear();
 
 		return *this;
 	}
@@ -243,14 +220,13 @@ public:
 	template< hydra::detail::Backend  BACKEND2>
 	GaussKronrodAdaptiveQuadrature&  operator= ( GaussKronrodAdaptiveQuadrature<NRULE,NBIN, hydra::detail::BackendPolicy<BACKEND2>> const& other )
 		{
-			if(this ==&other) return *this;
-
 			this->fIterationNumber = other.GetIterationNumber() ;
 			this->fXLower = other.GetXLower() ;
 			this->fXUpper = other.GetXUpper();
 			this->fMaxRelativeError = other.GetMaxRelativeError() ;
+			this->fSplitsPerIteration = other.GetSplitsPerIteration() ;
 			this->fRule=other.GetRule();
-			this->InitNodes();
+			this->fNodesTable.clear();
 
 			return *this;
 		}
@@ -264,6 +240,20 @@ public:
 	template<typename FUNCTOR>
 	std::pair<GReal_t, GReal_t> Integrate(FUNCTOR const& functor);
 
+	/**
+	 * @brief Integrate a batch of functors of the same type over the same interval.
+	 *
+	 * The integrals are refined independently, but the new sub-intervals of all
+	 * of them are evaluated together, in a single launch per iteration.
+	 * Useful to integrate a function at many parameter points.
+	 *
+	 * @param begin iterator pointing to the first functor.
+	 * @param end iterator pointing to the past-the-end functor.
+	 * @return std::vector<std::pair<GReal_t, GReal_t>> with the value and error of each integral.
+	 */
+	template<typename Iterator>
+	std::vector<std::pair<GReal_t, GReal_t>> Integrate(Iterator begin, Iterator end);
+
 
 	/**
 	 * @brief Print integration limits, list of nodes ... to std::cout.
@@ -278,16 +268,16 @@ public:
 		HYDRA_MSG << "#Nodes: " << nNodes << HYDRA_ENDL;
 		for(size_t i=0; i< nNodes; i++ ){
 			auto node = this->fNodesTable[i];
-			HYDRA_MSG <<std::setprecision(50)<< "Node ID #" << hydra_thrust::get<1>(node) <<" Interval ["
-					  << hydra_thrust::get<2>(node)
+			HYDRA_MSG <<std::setprecision(50)<< "Node ID #" << i <<" Interval ["
+					  << hydra_thrust::get<1>(node)
 					  <<", "
-					  << hydra_thrust::get<3>(node)
+					  << hydra_thrust::get<2>(node)
 					  << "] Result ["
-					  << hydra_thrust::get<4>(node)
+					  << hydra_thrust::get<3>(node)
 					  << ", "
-					  << hydra_thrust::get<5>(node)
+					  << hydra_thrust::get<4>(node)
 					  << "]"
-					  << " Process  "
+					  << " Integral  "
 					  << hydra_thrust::get<0>(node)
 					  << HYDRA_ENDL;
 		}
@@ -314,7 +304,6 @@ public:
 	void SetXLower(GReal_t xLower)
 	{
 		fXLower = xLower;
-		InitNodes();
 	}
 
 	GReal_t GetXUpper() const
@@ -325,22 +314,33 @@ public:
 	void SetXUpper(GReal_t xUpper)
 	{
 		fXUpper = xUpper;
-		InitNodes();
 	}
 
-	const GaussKronrodRule<NRULE>& GetRule() const
+	/**
+	 * @brief Maximum number of sub-intervals, those with the largest errors,
+	 * split per iteration and integral.
+	 */
+	size_t GetSplitsPerIteration() const
 	{
-		return fRule;
+		return fSplitsPerIteration;
 	}
 
-private:
+	void SetSplitsPerIteration(size_t nsplits)
+	{
+		fSplitsPerIteration = nsplits > 0 ? nsplits : 1;
+	}
 
 	GUInt_t GetIterationNumber() const
 	{
 		return fIterationNumber;
 	}
 
-	std::pair<GReal_t, GReal_t> Accumulate();
+	const GaussKronrodRule<NRULE>& GetRule() const
+	{
+		return fRule;
+	}
+
+private:
 
 	GReal_t GetError( GReal_t delta)
 	{
@@ -348,91 +348,33 @@ private:
 				std::pow(200.0*std::fabs(delta ), 1.5));
 	}
 
-
-	void InitNodes()
+	void InitNodes(size_t nintegrals)
 	{
 		GReal_t delta = (fXUpper - fXLower)/NBIN;
-		fNodesTable.resize(NBIN);
 
-		for(size_t i=0; i<NBIN; i++ )
-		{
-			auto node = this->fNodesTable[i];
-			hydra_thrust::get<0>(node) = 	1;
-			hydra_thrust::get<1>(node) = 	i;
-			hydra_thrust::get<2>(node) = 	this->fXLower + i*delta;
-			hydra_thrust::get<3>(node) = 	this->fXLower + (i+1)*delta;
-			hydra_thrust::get<4>(node) = 	0.0;
-			hydra_thrust::get<5>(node) = 	0.0;
-		}
-
-	}
-
-	size_t CountNodesToProcess()
-	{
-		auto begin = fNodesTable.begin( placeholders::_0);
-		auto end   = fNodesTable.end( placeholders::_0);
+		fNodesTable.clear();
+		fNodesTable.reserve(nintegrals*NBIN);
 
-	    size_t n=0;
-		for(auto i = begin; i!=end; i++)
-		if(*i)n++;
-		return n;
+		for(size_t integral=0; integral<nintegrals; integral++ )
+			for(size_t i=0; i<NBIN; i++ )
+				fNodesTable.push_back( node_t(integral, this->fXLower + i*delta,
+						this->fXLower + (i+1)*delta, 0.0, 0.0) );
 	}
 
-	void SetParametersTable( )
-	{
-
-		size_t nNodes =  CountNodesToProcess();
-
-		fParametersTable.clear();
-		fParametersTable.resize(nNodes*(NRULE+1)/2);
-		parameters_table_h temp_table(nNodes*(NRULE+1)/2);
-
-		//for(size_t i=0; i<nNodes; i++)
-		size_t i=0;
-		for(auto node : fNodesTable)
-		{
-
-			if(!hydra_thrust::get<0>(node)) 	continue;
-
-			for(size_t call=0; call<(NRULE+1)/2; call++)
-			{
-				GReal_t abscissa_X_P = 0;
-				GReal_t abscissa_X_M = 0;
-				GReal_t jacobian = 0;
-				GReal_t fLowerLimits= hydra_thrust::get<2>(node);
-				GReal_t fUpperLimits= hydra_thrust::get<3>(node);
-
-				hydra_thrust::tie(abscissa_X_P, abscissa_X_M, jacobian)
-				= fRule.GetAbscissa(call , fLowerLimits, fUpperLimits);
+	template<typename INTEGRAND>
+	std::vector<std::pair<GReal_t, GReal_t>> IntegrateNodes(INTEGRAND const& integrand, size_t nintegrals);
 
-				GReal_t rule_GaussKronrod_Weight   = fRule.KronrodWeight[call];
-				GReal_t rule_Gauss_Weight                = fRule.GaussWeight[call];
-
-				size_t index = call*nNodes + i;
-
-				temp_table[index]= parameters_t(hydra_thrust::get<1>(node), abscissa_X_P, abscissa_X_M,
-						jacobian, rule_GaussKronrod_Weight, rule_Gauss_Weight);
-			}
-
-			i++;
-		}
-
-	//	for(auto row: temp_table) std::cout << row << std::endl;
-		hydra_thrust::copy( temp_table.begin(), temp_table.end(),
-				fParametersTable.begin() );
-
-	}
+	template<typename INTEGRAND>
+	void ProcessNodes(INTEGRAND const& integrand, std::vector<size_t> const& nodes);
 
-	void UpdateNodes();
+	bool SplitNodes(node_heap_h& heap, GReal_t tolerance, std::vector<size_t>& nodes);
 
 	GUInt_t fIterationNumber;
 	GReal_t fXLower;
 	GReal_t fXUpper;
 	GReal_t fMaxRelativeError;
+	size_t  fSplitsPerIteration;
 	node_table_h  fNodesTable;
-	parameters_table_d fParametersTable;
-	call_table_h fCallTableHost;
-	call_table_d fCallTableDevice;
 
 	GaussKronrodRule<NRULE> fRule;
 
@@ -139,7 +139,7 @@ struct GaussKronrodRule
 
 	__hydra_host__  __hydra_device__
 	inline hydra_thrust::tuple<GReal_t, GReal_t, GReal_t>
-	GetAbscissa(size_t index, GReal_t xlower, GReal_t xupper  )
+	GetAbscissa(size_t index, GReal_t xlower, GReal_t xupper  ) const
 		{
 
 		GReal_t a = (xupper - xlower)/2.0;
@@ -47,6 +47,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace hydra {
 
@@ -55,10 +56,12 @@ class  GenzMalikQuadrature;
 
 /**
  * \ingroup numerical_integration
- * \brief Non-adaptive Genz-Malik multidimensional quadrature
+ * \brief Adaptive Genz-Malik multidimensional quadrature
  *
- * Non-adaptive Genz-Malik multidimensional quadrature. This algorithm follows the original paper prescription
- * but does not implement the subdivision strategy yet.
+ * Genz-Malik multidimensional quadrature. The integration region is divided in boxes, to which the
+ * degree 7 rule is applied. While the relative error is larger than requested, the fraction of boxes
+ * with largest errors is split in halves along the axis of largest fourth difference. The selection,
+ * split and evaluation of the new boxes run on the back-end; boxes that are not split keep their results.
  * A. C. Genz and A. A. Malik, "An adaptive algorithm for numeric integration over an N-dimensional rectangular region," J. Comput. Appl. Math. 6 (4), 295–302 (1980).
  * J. Berntsen, T. O. Espelid, and A. Genz, "An adaptive algorithm for the approximate calculation of multiple integrals," ACM Trans. Math. Soft. 17 (4), 437–451 (1991)
  */
@@ -101,7 +104,10 @@ public:
 			GReal_t fraction=0.25,
 			GReal_t relative_error=0.001):
 				fRelativeError(relative_error),
-				fFraction(fraction)
+				fFraction(fraction),
+				fNBoxes(0),
+				fNBoxesProcessed(0),
+				fElapsedTime(0)
 	{
 		SetGeometry(LowerLimit, UpperLimit, grid);
 	}
@@ -121,7 +127,10 @@ public:
 			GReal_t fraction=0.25,
 			GReal_t relative_error=0.001):
 				fRelativeError(relative_error),
-				fFraction(fraction)
+				fFraction(fraction),
+				fNBoxes(0),
+				fNBoxesProcessed(0),
+				fElapsedTime(0)
 	{ SetGeometry(LowerLimit, UpperLimit, nboxes); }
 
 	/**
@@ -138,7 +147,10 @@ public:
 			GReal_t fraction=0.25,
 			GReal_t relative_error=0.001):
 				fRelativeError(relative_error),
-				fFraction(fraction)
+				fFraction(fraction),
+				fNBoxes(0),
+				fNBoxesProcessed(0),
+				fElapsedTime(0)
 	{ SetGeometry(LowerLimit, UpperLimit, grid); }
 
 
@@ -156,7 +168,10 @@ public:
 			GReal_t fraction=0.25,
 			GReal_t relative_error=0.001):
 				fRelativeError(relative_error),
-				fFraction(fraction)
+				fFraction(fraction),
+				fNBoxes(0),
+				fNBoxesProcessed(0),
+				fElapsedTime(0)
 	{ SetGeometry(LowerLimit, UpperLimit, nboxes); }
 
 
@@ -209,6 +224,57 @@ public:
 
 	}
 
+	/**
+	 * Number of iterations of the last integration, including the evaluation of the initial boxes.
+	 */
+	size_t GetNumberOfIterations() const {
+		return fIterationTimes.size();
+	}
+
+	/**
+	 * Wall time, in milliseconds, of each iteration of the last integration.
+	 */
+	const std::vector<GReal_t>& GetIterationTimes() const {
+		return fIterationTimes;
+	}
+
+	/**
+	 * Mean wall time, in milliseconds, of the iterations of the last integration.
+	 */
+	GReal_t GetMeanIterationTime() const {
+		return fIterationTimes.size() > 0 ? fElapsedTime/fIterationTimes.size() : 0.0;
+	}
+
+	/**
+	 * Number of boxes at the end of the last integration.
+	 */
+	size_t GetNumberOfBoxes() const {
+		return fNBoxes;
+	}
+
+	/**
+	 * Number of boxes evaluated per second in the last integration.
+	 */
+	GReal_t GetBoxesPerSecond() const {
+		return fElapsedTime > 0 ? 1000.0*fNBoxesProcessed/fElapsedTime : 0.0;
+	}
+
+	GReal_t GetRelativeError() const {
+		return fRelativeError;
+	}
+
+	void SetRelativeError(GReal_t relative_error) {
+		fRelativeError = relative_error;
+	}
+
+	GReal_t GetFraction() const {
+		return fFraction;
+	}
+
+	void SetFraction(GReal_t fraction) {
+		fFraction = fraction;
+	}
+
 	const box_list_type& GetBoxList() const {
 		return fBoxList;
 	}
@@ -231,7 +297,10 @@ public:
 private:
 
 	template<typename FUNCTOR, typename Vector>
-	void AdaptiveIntegration(FUNCTOR const& functor, Vector& BoxList);
+	size_t AdaptiveIntegration(FUNCTOR const& functor, Vector& BoxList);
+
+	template<typename Vector>
+	GReal_t GetSplitThreshold(Vector const& BoxList, size_t& nsplit);
 
 	template<typename Vector>
 	std::pair<GReal_t, GReal_t> CalculateIntegral( Vector const& BoxList);
@@ -248,8 +317,6 @@ private:
 	void SetGeometry(const GReal_t (&LowerLimit)[N],
 			         const GReal_t (&UpperLimit)[N], size_t nboxes=10);
 
-	template<typename Vector>
-	void SplitBoxes( Vector& boxes, size_t n );
 
 	void GetGrid( size_t nboxes , std::array<size_t, N>& grid )
 	{
@@ -259,9 +326,12 @@ private:
 
 	}
 
-
 	GReal_t fRelativeError;
 	GReal_t fFraction;
+	size_t  fNBoxes;
+	size_t  fNBoxesProcessed;
+	GReal_t fElapsedTime;
+	std::vector<GReal_t> fIterationTimes;
 	GenzMalikRule<  N,  hydra::detail::BackendPolicy<BACKEND>> fGenzMalikRule;
 	box_list_type fBoxList;
 
@@ -34,6 +34,7 @@
 #include <hydra/Pdf.h>
 #include <hydra/PDFSumExtendable.h>
 #include <hydra/PDFSumNonExtendable.h>
+#include <hydra/CoherentSum.h>
 #include <hydra/detail/HistogramTraits.h>
 #include <hydra/detail/Iterable_traits.h>
 
@@ -79,6 +80,13 @@ class LogLikelihoodFCN< PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>;
 template<typename ...Pdfs, typename IteratorD , typename ...IteratorW>
 class LogLikelihoodFCN< PDFSumNonExtendable<Pdfs...>, IteratorD, IteratorW...>;
 
+/**
+ * \ingroup fit
+ * \brief LogLikehood object for coherent sums of amplitudes, with the per-event amplitudes cached.
+ */
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename IteratorD , typename ...IteratorW>
+class LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, IteratorD, IteratorW...>;
+
 /**
  * \ingroup fit
  * \brief Conveniency function to build up loglikehood fcns
@@ -124,6 +132,20 @@ inline typename std::enable_if< hydra::detail::is_iterator<Iterator>::value && d
 LogLikelihoodFCN< PDFSumNonExtendable<Pdfs...>, Iterator,Iterators...  >>::type
 make_loglikehood_fcn(PDFSumNonExtendable<Pdfs...>const& pdf, Iterator first, Iterator last, Iterators... weights);
 
+/**
+ * \ingroup fit
+ * \brief Conveniency function to build up loglikehood fcns
+ * @param pdf hydra::CoherentSum object
+ * @param first iteraror pointing to begin of data range
+ * @param last iteraror pointing to end of data range
+ * @param weights iteraror pointing to begin of weights range
+ * @return
+ */
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename Iterator, typename ...Iterators >
+inline typename std::enable_if< hydra::detail::is_iterator<Iterator>::value && detail::are_iterators<Iterators...>::value,
+LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, Iterator, Iterators... >>::type
+make_loglikehood_fcn(CoherentSum<IteratorN, IteratorWN, Amplitudes...> const& pdf, Iterator first, Iterator last, Iterators... weights);
+
 
 //----------------------------------------
 //interface to iterables
@@ -188,6 +210,25 @@ LogLikelihoodFCN<  PDFSumNonExtendable<Pdfs...>, decltype(std::declval< Iterable
                      decltype(std::declval< Iterables>().begin())... > >::type
 make_loglikehood_fcn(PDFSumNonExtendable<Pdfs...> const& functor, Iterable&& points, Iterables&&... weights );
 
+/**
+ * \ingroup fit
+ * \brief Conveniency function to build up loglikehood fcns
+ * @param pdf hydra::CoherentSum object
+ * @param points "iterable" storing the data
+ * @param weights "iterables" storing the weights
+ * @return
+ */
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename Iterable, typename ...Iterables>
+inline typename std::enable_if< (!detail::is_iterator<Iterable>::value) &&
+								((sizeof...(Iterables)==0) || !detail::are_iterators<Iterables...>::value) &&
+								(!hydra::detail::is_hydra_dense_histogram< typename std::remove_reference<Iterable>::type>::value) &&
+								(!hydra::detail::is_hydra_sparse_histogram<typename std::remove_reference<Iterable>::type>::value) &&
+								hydra::detail::is_iterable<Iterable>::value &&
+								detail::are_iterables<Iterables...>::value,
+LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, decltype(std::declval< Iterable>().begin()),
+                     decltype(std::declval< Iterables>().begin())... > >::type
+make_loglikehood_fcn(CoherentSum<IteratorN, IteratorWN, Amplitudes...> const& pdf, Iterable&& points, Iterables&&... weights );
+
 
 
 
@@ -247,5 +288,6 @@ make_loglikehood_fcn(PDFSumNonExtendable<Pdfs...> const& pdf, Histogram const&
 #include<hydra/detail/LogLikelihoodFCN1.inl>
 #include<hydra/detail/LogLikelihoodFCN2.inl>
 #include<hydra/detail/LogLikelihoodFCN3.inl>
+#include<hydra/detail/LogLikelihoodFCN4.inl>
 
 #endif /* LOGLIKELIHOODFCN2_H_ */
@@ -0,0 +1,374 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * MemoryPool.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef MEMORYPOOL_H_
+#define MEMORYPOOL_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/BackendPolicy.h>
+#include <hydra/detail/Print.h>
+
+#include <hydra/detail/external/hydra_thrust/memory.h>
+#include <hydra/detail/external/hydra_thrust/execution_policy.h>
+
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * Default maximum number of bytes kept cached by each hydra::MemoryPool.
+ */
+#ifndef HYDRA_MEMORY_POOL_HIGH_WATER_MARK
+#define HYDRA_MEMORY_POOL_HIGH_WATER_MARK (size_t(1)<<30)
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Memory space of an execution policy, following the chain of tag types
+ * (e.g. omp::par -> omp::tag -> cpp::tag) up to a tag that is its own.
+ * The host systems (CPP, OMP and TBB) allocate with the same malloc and
+ * end up sharing the cpp tag.
+ */
+template<typename Policy, typename Enable=void>
+struct memory_system
+{
+	typedef Policy type;
+};
+
+template<typename Policy>
+struct memory_system<Policy,
+	typename std::enable_if< !std::is_same<typename Policy::tag_type, Policy>::value >::type >
+{
+	typedef typename memory_system<typename Policy::tag_type>::type type;
+};
+
+}  // namespace detail
+
+/**
+ * \ingroup generic
+ * \brief Caching allocator for the temporary buffers of a memory space.
+ *
+ * Requests are rounded up to size classes (multiples of a quarter of the largest power of two
+ * not exceeding the request, with a minimum of 256 bytes) and returned blocks are kept in free
+ * lists, so that a later request of the same class reuses the block instead of calling the
+ * back-end allocator. Blocks are cached while the total cached size stays below the high-water
+ * mark; beyond it, returned blocks are freed. Release() frees all cached blocks.
+ *
+ * There is one pool per memory space, shared by all threads, obtained with
+ * hydra::memory_pool(policy), e.g. hydra::memory_pool(hydra::device::sys).
+ * The pool is never destroyed, so buffers can be returned from static destructors.
+ *
+ * \tparam MemorySystem system tag of the memory space.
+ */
+template<typename MemorySystem>
+class MemoryPool
+{
+
+public:
+
+	MemoryPool(MemoryPool<MemorySystem> const&)=delete;
+
+	MemoryPool<MemorySystem>& operator=(MemoryPool<MemorySystem> const&)=delete;
+
+	static MemoryPool<MemorySystem>& Instance()
+	{
+		static MemoryPool<MemorySystem>* pool = new MemoryPool<MemorySystem>();
+
+		return *pool;
+	}
+
+	/**
+	 * @brief Get a block of at least \p nbytes bytes.
+	 */
+	void* Allocate(size_t nbytes)
+	{
+		size_t size = SizeClass(nbytes);
+
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		void* block = nullptr;
+
+		auto search = fFree.find(size);
+
+		if( search != fFree.end() && !search->second.empty() ){
+
+			block = search->second.back();
+			search->second.pop_back();
+
+			fBytesCached -= size;
+			++fHits;
+		}
+		else {
+
+			block = NewBlock(size);
+
+			if( block == nullptr ){
+
+				//free the cached blocks and try again
+				ReleaseBlocks();
+
+				block = NewBlock(size);
+
+				if( block == nullptr ) throw std::bad_alloc();
+			}
+
+			++fMisses;
+		}
+
+		fInUse[block] = size;
+		fBytesInUse  += size;
+
+		if( fBytesInUse + fBytesCached > fPeakBytes )
+			fPeakBytes = fBytesInUse + fBytesCached;
+
+		return block;
+	}
+
+	/**
+	 * @brief Give back a block obtained with Allocate(). Blocks of other origin
+	 * are reported as an error and not freed.
+	 */
+	void Deallocate(void* block)
+	{
+		if( block == nullptr ) return;
+
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		auto search = fInUse.find(block);
+
+		if( search == fInUse.end() ){
+
+			//not allocated by this pool, or already given back: left to its owner
+			HYDRA_LOG(ERROR, "hydra::MemoryPool::Deallocate: the block was not allocated by this pool.")
+
+			assert( false && "hydra::MemoryPool::Deallocate: the block was not allocated by this pool." );
+
+			return;
+		}
+
+		size_t size = search->second;
+
+		fInUse.erase(search);
+		fBytesInUse -= size;
+
+		if( fBytesCached + size <= fHighWaterMark ){
+
+			fFree[size].push_back(block);
+			fBytesCached += size;
+		}
+		else FreeBlock(block);
+	}
+
+	/**
+	 * @brief Free all the cached blocks. Blocks in use are not affected.
+	 */
+	void Release()
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		ReleaseBlocks();
+	}
+
+	inline size_t GetHighWaterMark() const { return fHighWaterMark; }
+
+	/**
+	 * @brief Set the maximum number of bytes kept cached, freeing cached blocks,
+	 * largest first, until the cached size is below it. Zero disables caching.
+	 */
+	void SetHighWaterMark(size_t nbytes)
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		fHighWaterMark = nbytes;
+
+		for(auto it = fFree.rbegin(); it != fFree.rend() && fBytesCached > fHighWaterMark; ++it){
+
+			while( !it->second.empty() && fBytesCached > fHighWaterMark ){
+
+				FreeBlock(it->second.back());
+				it->second.pop_back();
+
+				fBytesCached -= it->first;
+			}
+		}
+	}
+
+	/**
+	 * @brief Number of bytes held in the free lists.
+	 */
+	inline size_t GetBytesCached() const { return fBytesCached; }
+
+	/**
+	 * @brief Number of bytes handed out and not yet returned.
+	 */
+	inline size_t GetBytesInUse() const { return fBytesInUse; }
+
+	/**
+	 * @brief Largest number of bytes, in use plus cached, held by the pool.
+	 */
+	inline size_t GetPeakBytes() const { return fPeakBytes; }
+
+	inline size_t GetHits() const { return fHits; }
+
+	inline size_t GetMisses() const { return fMisses; }
+
+	/**
+	 * @brief Fraction of the requests served from the free lists.
+	 */
+	inline double GetHitRate() const
+	{
+		return fHits + fMisses > 0 ? double(fHits)/(fHits + fMisses) : 0.0;
+	}
+
+	void ResetCounters()
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		fHits      = 0;
+		fMisses    = 0;
+		fPeakBytes = fBytesInUse + fBytesCached;
+	}
+
+	/**
+	 * @brief Size, in bytes, of the blocks used to serve a request of \p nbytes bytes.
+	 */
+	static size_t SizeClass(size_t nbytes)
+	{
+		if( nbytes <= 256 ) return 256;
+
+		size_t power = 1;
+
+		while( power <= nbytes/2 ) power <<= 1;
+
+		size_t step = power/4;
+
+		return ((nbytes + step - 1)/step)*step;
+	}
+
+private:
+
+	MemoryPool():
+		fHighWaterMark(HYDRA_MEMORY_POOL_HIGH_WATER_MARK),
+		fBytesCached(0),
+		fBytesInUse(0),
+		fPeakBytes(0),
+		fHits(0),
+		fMisses(0)
+	{}
+
+	void* NewBlock(size_t size)
+	{
+		void* block = nullptr;
+
+		try {
+			block = hydra_thrust::raw_pointer_cast( hydra_thrust::malloc(MemorySystem(), size) );
+		}
+		catch(...) {
+			block = nullptr;
+		}
+
+		return block;
+	}
+
+	void FreeBlock(void* block)
+	{
+		hydra_thrust::free(MemorySystem(), hydra_thrust::pointer<void, MemorySystem>(block));
+	}
+
+	void ReleaseBlocks()
+	{
+		for(auto& free_list: fFree)
+			for(auto block: free_list.second)
+				FreeBlock(block);
+
+		fFree.clear();
+		fBytesCached = 0;
+	}
+
+	std::mutex fMutex;
+	std::map<size_t, std::vector<void*>> fFree;
+	std::unordered_map<void*, size_t> fInUse;
+	size_t fHighWaterMark;
+	size_t fBytesCached;
+	size_t fBytesInUse;
+	size_t fPeakBytes;
+	size_t fHits;
+	size_t fMisses;
+};
+
+/**
+ * \ingroup generic
+ * \brief Memory pool serving the temporary buffers of the memory space of \p policy.
+ */
+template<typename DerivedPolicy>
+inline MemoryPool<typename detail::memory_system<DerivedPolicy>::type>&
+memory_pool(hydra_thrust::detail::execution_policy_base<DerivedPolicy> const&)
+{
+	return MemoryPool<typename detail::memory_system<DerivedPolicy>::type>::Instance();
+}
+
+namespace detail {
+
+/*
+ * Drop-in replacements for hydra_thrust::get_temporary_buffer and
+ * hydra_thrust::return_temporary_buffer, served by hydra::MemoryPool.
+ * Buffers must be returned with a policy of the same memory space.
+ */
+template<typename T, typename DerivedPolicy>
+inline hydra_thrust::pair<hydra_thrust::pointer<T,DerivedPolicy>,
+	typename hydra_thrust::pointer<T,DerivedPolicy>::difference_type>
+get_temporary_buffer(hydra_thrust::detail::execution_policy_base<DerivedPolicy> const& policy,
+		typename hydra_thrust::pointer<T,DerivedPolicy>::difference_type n)
+{
+	typedef hydra_thrust::pointer<T,DerivedPolicy> pointer_type;
+	typedef typename pointer_type::difference_type difference_type;
+
+	void* block = hydra::memory_pool(policy).Allocate( (n > 0 ? n : 1)*sizeof(T) );
+
+	return hydra_thrust::pair<pointer_type, difference_type>(pointer_type(static_cast<T*>(block)), n);
+}
+
+template<typename DerivedPolicy, typename Pointer>
+inline void return_temporary_buffer(hydra_thrust::detail::execution_policy_base<DerivedPolicy> const& policy,
+		Pointer p)
+{
+	hydra::memory_pool(policy).Deallocate( static_cast<void*>(hydra_thrust::raw_pointer_cast(p)) );
+}
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* MEMORYPOOL_H_ */
@@ -38,6 +38,7 @@
 #include <hydra/detail/IntegratorTraits.h>
 #include <hydra/detail/FunctorTraits.h>
 #include <hydra/detail/CompositeTraits.h>
+#include <hydra/detail/BoundedCache.h>
 
 #include <hydra/detail/external/hydra_thrust/iterator/detail/tuple_of_iterator_references.h>
 #include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
@@ -46,7 +47,7 @@
 #include <utility>
 #include <initializer_list>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 
 namespace hydra
@@ -89,7 +90,7 @@ public:
 	Pdf(FUNCTOR const& functor,  INTEGRATOR const& integrator):
 	fIntegrator(integrator),
 	fFunctor(functor),
-	fNormCache(std::unordered_map<size_t, std::pair<GReal_t, GReal_t>>() )
+	fNormCache()
 	{Normalize();}
 
 
@@ -215,17 +216,29 @@ public:
 	{
 		size_t key = fFunctor.GetParametersKey();
 
-		auto search = fNormCache.find(key);
-		if (search != fNormCache.end() && fNormCache.size()>0) {
+		std::vector<double> parameters;
+
+		if( fNormCache.IsVerifying() ){
+
+			std::vector<hydra::Parameter*> _parameters;
+			fFunctor.AddUserParameters(_parameters);
+
+			for(size_t i=0; i< _parameters.size(); i++)
+				parameters.push_back( *(_parameters[i]) );
+		}
+
+		std::pair<GReal_t, GReal_t> norm;
+
+		if ( fNormCache.Get(key, parameters, norm) ) {
 
 			//std::cout << "found in cache "<< key << std::endl;
-			std::tie(fNorm, fNormError) = search->second;
+			std::tie(fNorm, fNormError) = norm;
 
 		}
 		else {
 
 			std::tie(fNorm, fNormError) =  fIntegrator(fFunctor) ;
-			fNormCache[key] = std::make_pair(fNorm, fNormError);
+			fNormCache.Insert(key, parameters, std::make_pair(fNorm, fNormError));
 		}
 		fFunctor.SetNorm(1.0/fNorm);
 	}
@@ -234,9 +247,18 @@ public:
 
 	/**
 	 * @brief Get cache table of normalization factors.
-	 * @return std::unordered_map<size_t,std::pair<GReal_t,GReal_t> > instance with the cache table.
+	 * @return hydra::detail::BoundedCache<std::pair<GReal_t,GReal_t>> instance with the cache table.
+	 */
+	 const detail::BoundedCache<std::pair<GReal_t,GReal_t>>& GetNormCache()const 	{
+		return fNormCache;
+	}
+
+	/**
+	 * @brief Get cache table of normalization factors, to set its capacity,
+	 * enable the verification of the parameters or read the hit/miss counters.
+	 * @return hydra::detail::BoundedCache<std::pair<GReal_t,GReal_t>> instance with the cache table.
 	 */
-	 const std::unordered_map<size_t,std::pair<GReal_t,GReal_t> >& GetNormCache()const 	{
+	 detail::BoundedCache<std::pair<GReal_t,GReal_t>>& GetNormCache() 	{
 		return fNormCache;
 	}
 
@@ -282,7 +304,7 @@ private:
   	mutable INTEGRATOR fIntegrator;
 	GReal_t fNorm;
 	GReal_t fNormError;
-	std::unordered_map<size_t, std::pair<GReal_t, GReal_t>> fNormCache;
+	detail::BoundedCache<std::pair<GReal_t, GReal_t>> fNormCache;
 
 };
 
@@ -50,6 +50,9 @@
 #include <hydra/detail/functors/CheckEnergy.h>
 #include <hydra/Tuple.h>
 #include <hydra/detail/Hash.h>
+#include <hydra/detail/FunctorTraits.h>
+#include <hydra/detail/CompositeTraits.h>
+#include <hydra/detail/UnweightCompaction.h>
 #include <hydra/Random.h>
 #include <hydra/Decays.h>
 
@@ -275,6 +278,61 @@ public:
 					 hydra::Range<decltype(std::declval<Iterable>().begin())>>::type
 	Generate( IterableMothers&& mothers, Iterable&& daughters);
 
+	// Streaming unweighted generation ------------------------------------------
+
+	/**
+	 * @brief Generate @p ntrials phase-space events for a mother particle, in chunks
+	 * on the back-end of @p policy, and append to @p output the ones accepted with
+	 * respect to the phase-space weight.
+	 *
+	 * At most @p chunk_size trial events, with their weights, are held in memory.
+	 * The weight of each event is kept from the generation, the accepted events are
+	 * flagged, their positions in the output are obtained by a prefix sum of the flags
+	 * and they are scattered there. With the same generator seed and the same @p seed,
+	 * the accepted events are the ones that Decays::Unweight(seed) selects after
+	 * generating all trials at once.
+	 *
+	 * @param policy back-end of the trial events.
+	 * @param mother mother particle.
+	 * @param ntrials number of trial events.
+	 * @param output container receiving the accepted events, on any back-end.
+	 * @param seed seed of the accept/reject stream.
+	 * @param chunk_size maximum number of trial events held in memory.
+	 * @return range with the events appended to @p output.
+	 */
+	template<typename Container, hydra::detail::Backend BACKEND>
+	typename std::enable_if< hydra::detail::is_iterable<Container>::value,
+		hydra::Range<decltype(std::declval<Container&>().begin())>>::type
+	GenerateUnweighted(hydra::detail::BackendPolicy<BACKEND> const& policy, Vector4R const& mother,
+			size_t ntrials, Container& output, size_t seed=0x180ec6d33cfd0aba,
+			size_t chunk_size=HYDRA_UNWEIGHT_CHUNK_SIZE);
+
+	/**
+	 * @brief Same as above, with the phase-space weight multiplied by @p functor.
+	 *
+	 * If @p max_weight is not positive, the trials are generated twice:
+	 * a first pass finds the maximum weight without storing the events.
+	 *
+	 * @param policy back-end of the trial events.
+	 * @param mother mother particle.
+	 * @param ntrials number of trial events.
+	 * @param functor the event weights are multiplied by this functor.
+	 * @param output container receiving the accepted events, on any back-end.
+	 * @param max_weight maximum weight.
+	 * @param seed seed of the accept/reject stream.
+	 * @param chunk_size maximum number of trial events held in memory.
+	 * @return range with the events appended to @p output.
+	 */
+	template<typename Functor, typename Container, hydra::detail::Backend BACKEND>
+	typename std::enable_if< hydra::detail::is_iterable<Container>::value &&
+		(detail::is_hydra_functor<Functor>::value ||
+		 detail::is_hydra_lambda<Functor>::value  ||
+		 detail::is_hydra_composite_functor<Functor>::value),
+		hydra::Range<decltype(std::declval<Container&>().begin())>>::type
+	GenerateUnweighted(hydra::detail::BackendPolicy<BACKEND> const& policy, Vector4R const& mother,
+			size_t ntrials, Functor const& functor, Container& output, double max_weight=-1.0,
+			size_t seed=0x39abdc4529b1661c, size_t chunk_size=HYDRA_UNWEIGHT_CHUNK_SIZE);
+
 	//--------------------------------------------------------------------------
 
 
@@ -335,6 +393,10 @@ private:
 
 	inline bool EnergyChecker( Vector4R const& mother) const;
 
+	template<typename Trials, typename Pointer, hydra::detail::Backend BACKEND>
+	inline void GenerateChunk(hydra::detail::BackendPolicy<BACKEND> const& policy, Vector4R const& mother,
+			Trials& trials, Pointer weights, size_t first, size_t n) const;
+
 
 
 	size_t  fSeed;///< seed.
@@ -40,8 +40,11 @@
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 #include <hydra/PlainState.h>
 #include <hydra/detail/functors/ProcessCallsPlain.h>
+#include <hydra/ScrambledSobol.h>
 #include <utility>
 #include <vector>
+#include <memory>
+#include <stdexcept>
 #include <hydra/Integrator.h>
 #include <hydra/Random.h>
 
@@ -92,7 +95,9 @@ public:
 				fNCalls(calls),
 				fResult(0),
 				fAbsError(0),
-				fVolume(1.0)
+				fVolume(1.0),
+				fQMCMode(QMC_NONE),
+				fReplicas(HYDRA_QMC_REPLICAS)
 	{
 
 		fVolume=1.0;
@@ -117,7 +122,9 @@ public:
 		fNCalls(calls),
 		fResult(0),
 		fAbsError(0),
-		fVolume(1.0)
+		fVolume(1.0),
+		fQMCMode(QMC_NONE),
+		fReplicas(HYDRA_QMC_REPLICAS)
 	{
 
 		fVolume=1.0;
@@ -138,7 +145,9 @@ public:
 		fAbsError(other.GetAbsError() ),
 		fVolume(other.GetVolume()),
 		fDeltaX(other.GetDeltaX()),
-		fXLow(other.GetXLow())
+		fXLow(other.GetXLow()),
+		fQMCMode(other.GetQMCMode()),
+		fReplicas(other.GetReplicas())
 	{ }
 
 	Plain<N, hydra::detail::BackendPolicy<BACKEND>, GRND>&
@@ -153,6 +162,8 @@ public:
 		this->fVolume = other.GetVolume();
 		this->fDeltaX = other.GetDeltaX();
 		this->fXLow   = other.GetXLow();
+		this->fQMCMode  = other.GetQMCMode();
+		this->fReplicas = other.GetReplicas();
 
 		return *this;
 	}
@@ -165,7 +176,9 @@ public:
 	fAbsError(other.GetAbsError() ),
 	fVolume(other.GetVolume()),
 	fDeltaX(other.GetDeltaX()),
-	fXLow(other.GetXLow())
+	fXLow(other.GetXLow()),
+	fQMCMode(other.GetQMCMode()),
+	fReplicas(other.GetReplicas())
 	{ }
 
 	template<hydra::detail::Backend BACKEND2>
@@ -181,6 +194,8 @@ public:
 		this->fVolume = other.GetVolume() ;
 		this->fDeltaX = other.GetDeltaX() ;
 		this->fXLow   = other.GetXLow();
+		this->fQMCMode  = other.GetQMCMode();
+		this->fReplicas = other.GetReplicas();
 
 		return *this;
 	}
@@ -277,10 +292,42 @@ public:
 		fSeed = seed;
 	}
 
+	/**
+	 * @brief Sample randomized Sobol points instead of pseudo-random ones.
+	 *
+	 * The calls are split in @p replicas independent randomizations of the first
+	 * GetNCalls()/replicas points of the Sobol sequence; the result is the average of
+	 * the replica estimates and the error is the standard error of that average.
+	 * Powers of two make the best use of the sequence. The direction numbers are
+	 * stored once in the back-end and shared by all integrators of the same dimension.
+	 *
+	 * @param mode hydra::QMC_DIGITAL_SHIFT, hydra::QMC_OWEN or hydra::QMC_NONE to go back to Monte Carlo.
+	 * @param replicas number of randomizations, at least two.
+	 */
+	inline void SetQMC(QMCMode_t mode, size_t replicas=HYDRA_QMC_REPLICAS) {
+
+		if( mode != QMC_NONE && replicas < 2 )
+			throw std::invalid_argument("[hydra::Plain]: QMC integration needs at least two replicas.");
+
+		fQMCMode  = mode;
+		fReplicas = replicas;
+	}
+
+	inline QMCMode_t GetQMCMode() const {
+		return fQMCMode;
+	}
+
+	inline size_t GetReplicas() const {
+		return fReplicas;
+	}
+
 	//PlainState *fState;
 
 private:
 
+	template<typename FUNCTOR>
+	inline std::pair<GReal_t, GReal_t>  IntegrateQMC(FUNCTOR const& fFunctor );
+
 	size_t  fSeed;
 	size_t  fNCalls;
 	GReal_t fResult;
@@ -288,6 +335,9 @@ private:
 	GReal_t fVolume;
 	vector_t fDeltaX;
 	vector_t fXLow;
+	QMCMode_t fQMCMode;
+	size_t    fReplicas;
+	std::shared_ptr<typename system_t::template container<uint64_t> const> fDirections;
 
 };
 
@@ -70,6 +70,20 @@ PlainState():
     fMax(other.fMax  )
        {}
 
+    __hydra_host__ __hydra_device__
+    inline PlainState& operator=( PlainState const& other)
+    {
+    	if(this == &other) return *this;
+
+    	fN    = other.fN;
+    	fMean = other.fMean;
+    	fM2   = other.fM2;
+    	fMin  = other.fMin;
+    	fMax  = other.fMax;
+
+    	return *this;
+    }
+
 
 
     __hydra_host__ __hydra_device__ inline
@@ -49,6 +49,7 @@
 //
 #include <hydra/detail/external/hydra_thrust/copy.h>
 #include <hydra/detail/external/hydra_thrust/tabulate.h>
+#include <hydra/detail/external/hydra_thrust/for_each.h>
 #include <hydra/detail/external/hydra_thrust/random.h>
 #include <hydra/detail/external/hydra_thrust/distance.h>
 #include <hydra/detail/external/hydra_thrust/extrema.h>
@@ -56,10 +57,22 @@
 #include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
 #include <hydra/detail/external/hydra_thrust/system/detail/generic/select_system.h>
 #include <hydra/detail/external/hydra_thrust/partition.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/constant_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
+#include <hydra/detail/external/hydra_thrust/system/cuda/detail/execution_policy.h>
 
 #include <array>
 #include <utility>
 
+/**
+ * Maximum number of trials held in memory by the exact-count
+ * versions of hydra::sample and hydra::unweight.
+ */
+#ifndef HYDRA_SAMPLE_MAX_BATCH
+#define HYDRA_SAMPLE_MAX_BATCH 4194304
+#endif
+
 namespace hydra{
 
 namespace detail {
@@ -538,6 +551,116 @@ sample( Iterable&& output ,
 		typename Functor::argument_type const& min,typename Functor::argument_type  const& max,
 		Functor const& functor, size_t seed=0xb56c4feeef1b, size_t rng_jump=0 );
 
+/**
+ * \ingroup random
+ *
+ * @brief Append exactly @p nevents values distributed according a user defined distribution to a container.
+ *
+ * Trials are generated in batches, sized from the running acceptance rate and bounded by @p max_batch,
+ * so the memory in use does not depend on @p nevents beyond the output itself.
+ * The maximum of the distribution is estimated on the fly. If a batch raises it, the events accepted
+ * before are thinned with probability old_max/new_max, which keeps the sample unbiased.
+ * If no trial is accepted in the first full batch of @p max_batch trials, e.g. because the functor is
+ * not positive anywhere in the region, the sampling stops and nothing is appended.
+ *
+ * @param output container the generated values are appended to. It needs to support size() and resize().
+ * @param nevents number of values to generate.
+ * @param min lower limit of sampling region
+ * @param max upper limit of sampling region.
+ * @param functor distribution to be sampled
+ * @param rng_seed seed for the underlying pseudo-random number generator
+ * @param rng_jump sequence offset for the underlying pseudo-random number generator
+ * @param max_batch maximum number of trials per batch.
+ * @return range with the appended values
+ */
+template<typename RNG=default_random_engine, typename Functor, typename Container>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+sample(Container& output, size_t nevents, double min, double max,
+		Functor const& functor, size_t seed=0xb56c4feeef1b, size_t rng_jump=0,
+		size_t max_batch=HYDRA_SAMPLE_MAX_BATCH);
+
+/**
+ * \ingroup random
+ *
+ * @brief Append exactly @p nevents values distributed according a user defined distribution to a container.
+ *
+ * Multidimensional version. See the one dimensional version for details.
+ *
+ * @param output container the generated values are appended to. It needs to support size() and resize().
+ * @param nevents number of values to generate.
+ * @param min array of lower limits of sampling region
+ * @param max array of upper limits of sampling region.
+ * @param functor distribution to be sampled
+ * @param rng_seed seed for the underlying pseudo-random number generator
+ * @param rng_jump sequence offset for the underlying pseudo-random number generator
+ * @param max_batch maximum number of trials per batch.
+ * @return range with the appended values
+ */
+template<typename RNG=default_random_engine, typename Functor, typename Container, size_t N>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+sample(Container& output, size_t nevents,
+		std::array<double,N>const& min, std::array<double,N>const& max,
+		Functor const& functor, size_t seed=0xb56c4feeef1b, size_t rng_jump=0,
+		size_t max_batch=HYDRA_SAMPLE_MAX_BATCH);
+
+/**
+ * \ingroup random
+ *
+ * @brief Append to a container up to @p nevents entries of a dataset, unweighted according to @p functor.
+ *
+ * The dataset is processed in batches of at most @p max_batch entries, stopping as soon as @p nevents
+ * entries are accepted. Fewer entries are appended if the dataset is exhausted before.
+ * If @p max_pdf is not set, the maximum is estimated on the fly, as in the exact-count hydra::sample.
+ *
+ * @param data dataset to unweight.
+ * @param output container the accepted entries are appended to. It needs to support size() and resize().
+ * @param nevents number of entries to accept.
+ * @param functor weight of the entries.
+ * @param max_pdf maximum pdf value for accept-reject method.
+ * @param rng_seed seed for the underlying pseudo-random number generator
+ * @param rng_jump sequence offset for the underlying pseudo-random number generator
+ * @param max_batch maximum number of entries per batch.
+ * @return range with the appended entries.
+ */
+template<typename RNG=default_random_engine, typename Functor, typename Iterable, typename Container>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Iterable>::value &&
+detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+unweight(Iterable&& data, Container& output, size_t nevents, Functor const& functor,
+		double max_pdf=-1.0, size_t rng_seed=0x8ec74d321e6b5a27, size_t rng_jump=0,
+		size_t max_batch=HYDRA_SAMPLE_MAX_BATCH);
+
+/**
+ * \ingroup random
+ *
+ * @brief Append to a container up to @p nevents entries of a dataset, unweighted according to @p weights.
+ *
+ * See the version taking a functor for details.
+ *
+ * @param data dataset to unweight.
+ * @param weights weights of the entries.
+ * @param output container the accepted entries are appended to. It needs to support size() and resize().
+ * @param nevents number of entries to accept.
+ * @param max_pdf maximum pdf value for accept-reject method.
+ * @param rng_seed seed for the underlying pseudo-random number generator
+ * @param rng_jump sequence offset for the underlying pseudo-random number generator
+ * @param max_batch maximum number of entries per batch.
+ * @return range with the appended entries.
+ */
+template<typename RNG=default_random_engine, typename IterableData, typename IterableWeight, typename Container>
+typename std::enable_if<
+detail::random::is_iterable<IterableData>::value && detail::random::is_iterable<IterableWeight>::value &&
+detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+unweight(IterableData&& data, IterableWeight&& weights, Container& output, size_t nevents,
+		double max_pdf=-1.0, size_t rng_seed=0x8ec74d321e6b5a27, size_t rng_jump=0,
+		size_t max_batch=HYDRA_SAMPLE_MAX_BATCH);
+
 /**
  * \ingroup random
  *
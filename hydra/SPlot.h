@@ -40,13 +40,28 @@
 #include <hydra/PDFSumExtendable.h>
 #include <hydra/detail/AddPdfBase.h>
 #include <hydra/Tuple.h>
+#include <hydra/multivector.h>
+#include <hydra/Range.h>
+#include <hydra/Placeholders.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/Iterable_traits.h>
+#include <hydra/detail/IteratorTraits.h>
+#include <hydra/detail/TupleTraits.h>
 #include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
 #include <hydra/detail/functors/ProcessSPlot.h>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <initializer_list>
+#include <memory>
 #include <utility>
 
 namespace hydra {
@@ -60,6 +75,13 @@ namespace hydra {
  *  The sPlots are applicable in the context extended Likelihood fits, which are performed
  *  on the data sample to determine the yields of the various sources.
  *
+ *  The s-weights of all species can be written in one go into a container, using Fill(), which
+ *  evaluates each event once for all species. If the component values are cached at construction,
+ *  the covariance matrix and the component values are obtained in the same pass over the data
+ *  and Fill() does not evaluate the components again.
+ *  For samples that do not fit in the memory of a back-end, the constructor and Fill() taking a
+ *  back-end policy and a chunk size process the data one chunk at a time on that back-end.
+ *
  *  This class requires Eigen (http://eigen.tuxfamily.org/index.php?title=Main_Page).
  *
  *  Reference:  Nucl.Instrum.Meth.A555:356-369,2005
@@ -73,6 +95,13 @@ class SPlot: public detail::AddPdfBase<PDF1,PDF2,PDFs...>
 	//will fail
 	typedef typename detail::AddPdfBase<PDF1,PDF2,PDFs...>::type base_type;
     typedef typename hydra_thrust::iterator_system<Iterator>::type system_type;
+    typedef typename hydra_thrust::iterator_traits<Iterator>::value_type data_value_type;
+
+    //chunks are staged in SoA layout if the events are tuples
+    template<hydra::detail::Backend BACKEND, typename T>
+    using staging_container = typename std::conditional<detail::is_tuple<T>::value,
+    		hydra::multivector<T, hydra::detail::BackendPolicy<BACKEND>>,
+    		typename hydra::detail::BackendPolicy<BACKEND>::template container<T> >::type;
 
 public:
 
@@ -109,17 +138,13 @@ public:
 		fFunctors( pdf.GetFunctors()),
 		fCovMatrix( Eigen::Matrix<double, npdfs, npdfs>{} ),
 	    fBegin( iterator( first, transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
-		fEnd (iterator( last , transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} )))
-
+		fEnd (iterator( last , transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
+		fNEntries(0)
 	{
 		for(size_t i=0;i<npdfs; i++)
 			fCoefficients[i] = pdf.GetCoefficient(i);
 
-		//fCovMatrix << 0.0, 0.0, 0.0, 0.0;
-
-
 		Eigen::Matrix<double, npdfs, npdfs>  init = Eigen::Matrix<double, npdfs, npdfs>::Zero();
-		//init << 0.0, 0.0, 0.0, 0.0;
 
 		fCovMatrix = hydra_thrust::transform_reduce(system_type(), first, last,
 				detail::CovMatrixUnary<
@@ -128,12 +153,120 @@ public:
 				 typename PDFs::functor_type...>(fCoefficients, fFunctors ),
 				 init, detail::CovMatrixBinary() );
 
-		Eigen::Matrix<double, npdfs, npdfs> inverseCovMatrix = fCovMatrix.inverse();
+		SetIterators(first, last);
+	}
 
-		fBegin = iterator( first, transformer(fCoefficients, fFunctors, inverseCovMatrix ));
-		fEnd   = iterator( last , transformer(fCoefficients, fFunctors, inverseCovMatrix ));
+    /**
+     * SPlot constructor, optionally caching the values of the components.
+     *
+     * If @p cache_components is true, the values of the components for each event are stored
+     * on the back-end of the data (npdfs doubles per event) in the same pass that builds the
+     * covariance matrix. Fill() then reads them instead of evaluating the components again.
+     *
+     * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> object, already optimized.
+     * @param first Iterator pointing to the beginning of the data range used to optimize ```pdf```
+     * @param last  Iterator pointing to the end of the data range used to optimize ```pdf```.
+     * @param cache_components store the component values.
+     */
+	SPlot( PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterator first, Iterator last,
+			bool cache_components):
+		fPDFs( pdf.GetPDFs() ),
+		fFunctors( pdf.GetFunctors()),
+		fCovMatrix( Eigen::Matrix<double, npdfs, npdfs>{} ),
+	    fBegin( iterator( first, transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
+		fEnd (iterator( last , transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
+		fNEntries(0)
+	{
+		for(size_t i=0;i<npdfs; i++)
+			fCoefficients[i] = pdf.GetCoefficient(i);
+
+		Eigen::Matrix<double, npdfs, npdfs>  init = Eigen::Matrix<double, npdfs, npdfs>::Zero();
+
+		size_t nentries = hydra_thrust::distance(first, last);
+
+		if( cache_components && nentries > 0 ){
+
+			GReal_t* columns = hydra_thrust::raw_pointer_cast(
+					hydra::detail::get_temporary_buffer<GReal_t>(system_type(), npdfs*nentries).first);
+
+			fColumns  = std::shared_ptr<GReal_t>(columns, [](GReal_t* p){
+				hydra::detail::return_temporary_buffer(system_type(), p); });
+			fNEntries = nentries;
+
+			hydra_thrust::counting_iterator<size_t> index(0);
 
+			fCovMatrix = hydra_thrust::transform_reduce(system_type(),
+					hydra_thrust::make_zip_iterator(hydra_thrust::make_tuple(index, first)),
+					hydra_thrust::make_zip_iterator(hydra_thrust::make_tuple(index + nentries, last)),
+					detail::CovMatrixStore<
+					 typename PDF1::functor_type,
+					 typename PDF2::functor_type,
+					 typename PDFs::functor_type...>(fCoefficients, fFunctors, columns, nentries ),
+					 init, detail::CovMatrixBinary() );
+		}
+		else {
+
+			fCovMatrix = hydra_thrust::transform_reduce(system_type(), first, last,
+					detail::CovMatrixUnary<
+					 typename PDF1::functor_type,
+					 typename PDF2::functor_type,
+					 typename PDFs::functor_type...>(fCoefficients, fFunctors ),
+					 init, detail::CovMatrixBinary() );
+		}
 
+		SetIterators(first, last);
+	}
+
+    /**
+     * SPlot constructor for samples larger than the memory of a back-end.
+     *
+     * The data is copied to @p policy in chunks of @p chunk_size events, where the
+     * contributions to the covariance matrix are calculated. At most @p chunk_size events are
+     * held on the back-end at any time.
+     *
+     * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> object, already optimized.
+     * @param first Iterator pointing to the beginning of the data range used to optimize ```pdf```
+     * @param last  Iterator pointing to the end of the data range used to optimize ```pdf```.
+     * @param policy back-end where the calculation runs.
+     * @param chunk_size number of events per chunk.
+     */
+	template<hydra::detail::Backend BACKEND>
+	SPlot( PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterator first, Iterator last,
+			hydra::detail::BackendPolicy<BACKEND> const& policy, size_t chunk_size):
+		fPDFs( pdf.GetPDFs() ),
+		fFunctors( pdf.GetFunctors()),
+		fCovMatrix( Eigen::Matrix<double, npdfs, npdfs>::Zero() ),
+	    fBegin( iterator( first, transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
+		fEnd (iterator( last , transformer(  pdf.GetFunctors(), Eigen::Matrix<double, npdfs, npdfs>{} ))),
+		fNEntries(0)
+	{
+		typedef staging_container<BACKEND, data_value_type> staging_type;
+
+		for(size_t i=0;i<npdfs; i++)
+			fCoefficients[i] = pdf.GetCoefficient(i);
+
+		size_t nentries = hydra_thrust::distance(first, last);
+
+		chunk_size = std::max<size_t>(1, std::min(chunk_size, nentries));
+
+		staging_type staging(chunk_size);
+
+		auto cov_matrix = detail::CovMatrixUnary<
+				 typename PDF1::functor_type,
+				 typename PDF2::functor_type,
+				 typename PDFs::functor_type...>(fCoefficients, fFunctors );
+
+		for(size_t begin=0; begin < nentries; begin += chunk_size){
+
+			size_t count = std::min(chunk_size, nentries - begin);
+
+			hydra_thrust::copy(first + begin, first + begin + count, staging.begin());
+
+			fCovMatrix += hydra_thrust::transform_reduce(policy, staging.begin(), staging.begin() + count,
+					cov_matrix, Eigen::Matrix<double, npdfs, npdfs>::Zero().eval(), detail::CovMatrixBinary() );
+		}
+
+		SetIterators(first, last);
 	}
 
 	/**
@@ -144,9 +277,11 @@ public:
 	SPlot(SPlot<Iterator, PDF1, PDF2, PDFs...> const& other ):
 		fPDFs(other.GetPDFs() ),
 		fFunctors(other.GetFunctors()),
+	    fCovMatrix(other.GetCovMatrix() ),
     	fBegin(other.begin()),
 	    fEnd(other.end()),
-	    fCovMatrix(other.GetCovMatrix() )
+	    fColumns(other.fColumns),
+	    fNEntries(other.fNEntries)
 	{
 		for( size_t i=0; i< npdfs; i++ ){
 			fCoefficients[i]=other.GetCoefficient(i);
@@ -168,6 +303,8 @@ public:
 		fBegin=other.begin();
 		fEnd=other.end();
 		fCovMatrix=other.GetCovMatrix();
+		fColumns=other.fColumns;
+		fNEntries=other.fNEntries;
 
 		for( size_t i=0; i< npdfs; i++ ){
 			fCoefficients[i]=other.GetCoefficient(i);
@@ -212,6 +349,91 @@ public:
 		return fCovMatrix;
 	}
 
+	/**
+	 * Check if the values of the components are cached.
+	 */
+	inline bool IsCached() const {
+
+		return fNEntries > 0;
+	}
+
+	/**
+	 * Write the s-weights of all PDFs for each event to @p output, e.g. the begin of a
+	 * hydra::multivector<hydra::tuple<double,...>> on the back-end of the data,
+	 * evaluating each event once for all species.
+	 *
+	 * @param output iterator to a range of size equal to the data.
+	 * @return iterator to the end of the written range.
+	 */
+	template<typename OutputIterator>
+	inline typename std::enable_if<detail::is_iterator<OutputIterator>::value, OutputIterator>::type
+	Fill(OutputIterator output) const {
+
+		if( IsCached() ){
+
+			hydra_thrust::counting_iterator<size_t> index(0);
+
+			return hydra_thrust::transform(system_type(), index, index + fNEntries, output,
+					detail::SWeightsColumns<npdfs>(fCoefficients, fColumns.get(), fNEntries,
+							fCovMatrix.inverse().eval()) );
+		}
+
+		return hydra_thrust::copy(system_type(), fBegin, fEnd, output);
+	}
+
+	/**
+	 * Write the s-weights of all PDFs for each event to the container @p output,
+	 * which should have the size of the data.
+	 */
+	template<typename Iterable>
+	inline typename std::enable_if<detail::is_iterable<Iterable>::value &&
+	                              !detail::is_iterator<Iterable>::value, void>::type
+	Fill(Iterable&& output) const {
+
+		Fill(std::forward<Iterable>(output).begin());
+	}
+
+	/**
+	 * Write the s-weights of all PDFs for each event to @p output, calculating them on
+	 * @p policy in chunks of @p chunk_size events. At most @p chunk_size events and
+	 * s-weights are held on the back-end at any time.
+	 *
+	 * @param policy back-end where the calculation runs.
+	 * @param output iterator to a range of size equal to the data.
+	 * @param chunk_size number of events per chunk.
+	 * @return iterator to the end of the written range.
+	 */
+	template<hydra::detail::Backend BACKEND, typename OutputIterator>
+	OutputIterator Fill(hydra::detail::BackendPolicy<BACKEND> const& policy, OutputIterator output,
+			size_t chunk_size) const {
+
+		typedef staging_container<BACKEND, data_value_type> staging_type;
+		typedef staging_container<BACKEND, value_type> sweights_type;
+
+		Iterator first = fBegin.base();
+		size_t nentries = hydra_thrust::distance(fBegin, fEnd);
+
+		chunk_size = std::max<size_t>(1, std::min(chunk_size, nentries));
+
+		staging_type  staging(chunk_size);
+		sweights_type sweights(chunk_size);
+
+		for(size_t begin=0; begin < nentries; begin += chunk_size){
+
+			size_t count = std::min(chunk_size, nentries - begin);
+
+			hydra_thrust::copy(first + begin, first + begin + count, staging.begin());
+
+			hydra_thrust::copy(policy, hydra_thrust::make_transform_iterator(staging.begin(), fBegin.functor()),
+					hydra_thrust::make_transform_iterator(staging.begin() + count, fBegin.functor()),
+					sweights.begin());
+
+			output = hydra_thrust::copy(sweights.begin(), sweights.begin() + count, output);
+		}
+
+		return output;
+	}
+
 	/**
 	 * Get an iterator pointing to beginning of the range of the s-weights corresponding to the PDF i.
 	 * @param hydra placeholder (_0, _1, ..., _N)
@@ -305,6 +527,14 @@ public:
 
 private:
 
+	void SetIterators(Iterator first, Iterator last) {
+
+		Eigen::Matrix<double, npdfs, npdfs> inverseCovMatrix = fCovMatrix.inverse();
+
+		fBegin = iterator( first, transformer(fCoefficients, fFunctors, inverseCovMatrix ));
+		fEnd   = iterator( last , transformer(fCoefficients, fFunctors, inverseCovMatrix ));
+	}
+
 	Parameter           fCoefficients[npdfs];
 	pdfs_tuple_type     fPDFs;
 	functors_tuple_type fFunctors;
@@ -313,6 +543,10 @@ private:
 	iterator fBegin;
 	iterator fEnd;
 
+	//component values, column major, shared by the copies
+	std::shared_ptr<GReal_t> fColumns;
+	size_t fNEntries;
+
 };
 
 /**
@@ -331,6 +565,62 @@ make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterator first, Ite
  return 	SPlot<Iterator, PDF1, PDF2, PDFs...>(pdf, first,last);
 }
 
+/**
+ * Convenience function for instantiating SPlot objects using type deduction
+ *
+ * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> optimized object
+ * @param first iterator pointing to beginning of the data range.
+ * @param last iterator pointing to end of the data  range.
+ * @param cache_components store the values of the components for SPlot::Fill.
+ * @return
+ */
+template <typename Iterator, typename PDF1,  typename PDF2, typename ...PDFs>
+typename std::enable_if< detail::is_iterator<Iterator>::value,
+                 SPlot<Iterator, PDF1, PDF2, PDFs...> >::type
+make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterator first, Iterator last,
+		bool cache_components) {
+
+ return 	SPlot<Iterator, PDF1, PDF2, PDFs...>(pdf, first,last, cache_components);
+}
+
+/**
+ * Convenience function for instantiating SPlot objects using type deduction,
+ * processing the data in chunks on another back-end.
+ *
+ * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> optimized object
+ * @param first iterator pointing to beginning of the data range.
+ * @param last iterator pointing to end of the data  range.
+ * @param policy back-end where the calculation runs.
+ * @param chunk_size number of events per chunk.
+ * @return
+ */
+template <typename Iterator, hydra::detail::Backend BACKEND, typename PDF1,  typename PDF2, typename ...PDFs>
+typename std::enable_if< detail::is_iterator<Iterator>::value,
+                 SPlot<Iterator, PDF1, PDF2, PDFs...> >::type
+make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterator first, Iterator last,
+		hydra::detail::BackendPolicy<BACKEND> const& policy, size_t chunk_size) {
+
+ return 	SPlot<Iterator, PDF1, PDF2, PDFs...>(pdf, first,last, policy, chunk_size);
+}
+
+/**
+ * Convenience function for instantiating SPlot objects using type deduction
+ *
+ * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> optimized object
+ * @param data iterable representing the data-range
+ * @param cache_components store the values of the components for SPlot::Fill.
+ * @return
+ */
+template <typename Iterable, typename PDF1,  typename PDF2, typename ...PDFs>
+typename std::enable_if< detail::is_iterable<Iterable>::value,
+                  SPlot< decltype(std::declval<Iterable>().begin()), PDF1, PDF2, PDFs...> >::type
+make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterable&& data, bool cache_components){
+
+ return 	SPlot< decltype(std::declval<Iterable>().begin()) ,
+		                 PDF1, PDF2, PDFs...>(pdf, std::forward<Iterable>(data).begin(),
+		  	  	  	  	  	  	  	  	  std::forward<Iterable>(data).end(), cache_components);
+}
+
 /**
  * Convenience function for instantiating SPlot objects using type deduction
  *
@@ -348,6 +638,27 @@ make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterable&& data){
 		  	  	  	  	  	  	  	  	  std::forward<Iterable>(data).end());
 }
 
+/**
+ * Convenience function for instantiating SPlot objects using type deduction,
+ * processing the data in chunks on another back-end.
+ *
+ * @param pdf PDFSumExtendable<PDF1, PDF2, PDFs...> optimized object
+ * @param data iterable representing the data-range
+ * @param policy back-end where the calculation runs.
+ * @param chunk_size number of events per chunk.
+ * @return
+ */
+template <typename Iterable, hydra::detail::Backend BACKEND, typename PDF1,  typename PDF2, typename ...PDFs>
+typename std::enable_if< detail::is_iterable<Iterable>::value,
+                  SPlot< decltype(std::declval<Iterable>().begin()), PDF1, PDF2, PDFs...> >::type
+make_splot(PDFSumExtendable<PDF1, PDF2, PDFs...> const& pdf, Iterable&& data,
+		hydra::detail::BackendPolicy<BACKEND> const& policy, size_t chunk_size){
+
+ return 	SPlot< decltype(std::declval<Iterable>().begin()) ,
+		                 PDF1, PDF2, PDFs...>(pdf, std::forward<Iterable>(data).begin(),
+		  	  	  	  	  	  	  	  	  std::forward<Iterable>(data).end(), policy, chunk_size);
+}
+
 }  // namespace hydra
 
 #endif /* SPLOT_H_ */
@@ -32,6 +32,7 @@
 #include <hydra/detail/Config.h>
 #include <hydra/detail/BackendPolicy.h>
 #include <hydra/Types.h>
+#include <hydra/MemoryPool.h>
 
 #include <hydra/detail/external/hydra_thrust/memory.h>
 #include <memory>
@@ -43,6 +44,11 @@ namespace hydra {
 template<typename T, typename BACKEND>
 class ScopedBuffer;
 
+/**
+ * \ingroup generic
+ * \brief Temporary buffer of \p n elements, taken from the hydra::MemoryPool of the back-end
+ * on construction and given back on destruction. ScopedBuffer can be moved, but not copied.
+ */
 template<typename T,detail::Backend BACKEND>
 class ScopedBuffer<T, detail::BackendPolicy<BACKEND> >
 {
@@ -56,25 +62,36 @@ public:
 	ScopedBuffer(size_t n):
 		fSize(n)
 	{
-		auto policy = detail::BackendPolicy<BACKEND>{};
-		auto buffer = hydra_thrust::get_temporary_buffer<T>(policy, size);
+		auto buffer = detail::get_temporary_buffer<T>(system_type(), n);
 		fPointer    = buffer.first;
-
 	}
 
-	ScopedBuffer(ScopedBuffer<T, detail::BackendPolicy<BACKEND>> const& other):
+	ScopedBuffer(ScopedBuffer<T, detail::BackendPolicy<BACKEND>> const& other)=delete;
+
+	ScopedBuffer<T, detail::BackendPolicy<BACKEND>>&
+	operator=(ScopedBuffer<T, detail::BackendPolicy<BACKEND>> const& other)=delete;
+
+	ScopedBuffer(ScopedBuffer<T, detail::BackendPolicy<BACKEND>>&& other):
 		fSize( other.GetSize()),
 		fPointer( other.GetPointer())
-	{}
+	{
+		other.fSize    = 0;
+		other.fPointer = pointer_type();
+	}
 
 	ScopedBuffer<T, detail::BackendPolicy<BACKEND>>&
-	operator=(ScopedBuffer<T, detail::BackendPolicy<BACKEND>> const& other){
+	operator=(ScopedBuffer<T, detail::BackendPolicy<BACKEND>>&& other){
 
-		if(this!=&other) return *this;
+		if(this==&other) return *this;
+
+		Dispose();
 
 		fSize    = other.GetSize();
 		fPointer = other.GetPointer();
 
+		other.fSize    = 0;
+		other.fPointer = pointer_type();
+
 		return *this;
 	}
 
@@ -90,13 +107,20 @@ public:
 
 	~ScopedBuffer(){
 
-		using hydra_thrust::return_temporary_buffer;
-
-		return_temporary_buffer(system_type(), fPointer);
+		Dispose();
 	}
 
 private:
 
+	void Dispose()
+	{
+		if( fPointer != pointer_type() )
+			detail::return_temporary_buffer(system_type(), fPointer);
+
+		fSize    = 0;
+		fPointer = pointer_type();
+	}
+
 	size_t    fSize;
 	pointer_type fPointer;
 };
@@ -0,0 +1,227 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ScrambledSobol.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup numerical_integration
+ */
+
+#ifndef SCRAMBLEDSOBOL_H_
+#define SCRAMBLEDSOBOL_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/BackendPolicy.h>
+#include <hydra/Types.h>
+#include <hydra/Sobol.h>
+#include <hydra/detail/random/splitmix.h>
+#include <hydra/detail/external/hydra_thrust/memory.h>
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+/*
+ * Default number of independent randomizations used to estimate
+ * the error of quasi-Monte Carlo integrals.
+ */
+#ifndef HYDRA_QMC_REPLICAS
+#define HYDRA_QMC_REPLICAS 16
+#endif
+
+#ifndef HYDRA_QMC_SEED
+#define HYDRA_QMC_SEED 159753456852
+#endif
+
+namespace hydra {
+
+/**
+ * \ingroup numerical_integration
+ * \brief Point sets used by hydra::Plain and hydra::Vegas.
+ */
+enum QMCMode_t {
+
+	QMC_NONE          = 0, ///< pseudo-random points drawn from the engine (default).
+	QMC_DIGITAL_SHIFT = 1, ///< Sobol points XOR'ed with a random 64-bit shift per dimension.
+	QMC_OWEN          = 2  ///< Sobol points with hash-based nested uniform (Owen) scrambling.
+};
+
+namespace detail {
+
+/*
+ * Direction numbers of the first N dimensions of the Sobol lattice, stored in
+ * the back-end with the layout of sobol_lattice (bits[N*k + dim]).
+ * The table is built once per dimension and back-end and shared read-only by
+ * every integrator holding the returned pointer.
+ */
+template<size_t N, hydra::detail::Backend BACKEND>
+inline std::shared_ptr<typename hydra::detail::BackendPolicy<BACKEND>::template container<uint64_t> const>
+sobol_directions(hydra::detail::BackendPolicy<BACKEND> const&)
+{
+	typedef typename hydra::detail::BackendPolicy<BACKEND>::template container<uint64_t> storage_t;
+	typedef sobol_lattice<uint64_t, N, 64u, default_sobol_table> lattice_t;
+
+	static std::mutex guard;
+	static std::weak_ptr<storage_t const> cache;
+
+	std::lock_guard<std::mutex> lock(guard);
+
+	std::shared_ptr<storage_t const> directions = cache.lock();
+
+	if( !directions ){
+
+		//the lattice is 64*N words, too large for the stack in high dimension
+		std::unique_ptr<lattice_t> lattice(new lattice_t());
+
+		directions = std::make_shared<storage_t const>(lattice->GetBits(),
+				lattice->GetBits() + lattice_t::storage_size);
+
+		cache = directions;
+	}
+
+	return directions;
+}
+
+/*
+ * Randomized Sobol point generator. The point \p index is computed directly from
+ * the Gray code of the index, so the functor only carries a pointer to the direction
+ * numbers and one scrambling key per dimension. Each seed defines an independent
+ * randomization (replica) of the same point set.
+ */
+template<size_t N>
+class ScrambledSobol
+{
+
+public:
+
+	ScrambledSobol():
+		fDirections(nullptr),
+		fMode(QMC_NONE)
+	{
+		for(size_t j=0; j<N; j++) fKeys[j]=0;
+	}
+
+	ScrambledSobol(uint64_t const* directions, uint64_t seed, QMCMode_t mode):
+		fDirections(directions),
+		fMode(mode)
+	{
+		for(size_t j=0; j<N; j++) fKeys[j] = hydra::random::splitmix<uint64_t>(seed);
+	}
+
+	__hydra_host__ __hydra_device__
+	ScrambledSobol( ScrambledSobol<N> const& other):
+		fDirections(other.fDirections),
+		fMode(other.fMode)
+	{
+		for(size_t j=0; j<N; j++) fKeys[j] = other.fKeys[j];
+	}
+
+	__hydra_host__ __hydra_device__
+	ScrambledSobol<N>& operator=( ScrambledSobol<N> const& other)
+	{
+		if(this == &other) return *this;
+
+		fDirections = other.fDirections;
+		fMode = other.fMode;
+
+		for(size_t j=0; j<N; j++) fKeys[j] = other.fKeys[j];
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline bool IsEnabled() const { return fMode != QMC_NONE && fDirections != nullptr; }
+
+	/*
+	 * Coordinates in [0,1) of the point \p index.
+	 */
+	__hydra_host__ __hydra_device__
+	inline void operator()(size_t index, GReal_t (&u)[N]) const
+	{
+		uint64_t x[N];
+
+		for(size_t j=0; j<N; j++) x[j]=0;
+
+		uint64_t code = index ^ (index >> 1);
+
+		for(size_t k=0; code != 0; k++, code >>= 1)
+		{
+			if( code & 1 )
+				for(size_t j=0; j<N; j++) x[j] ^= fDirections[N*k + j];
+		}
+
+		for(size_t j=0; j<N; j++)
+		{
+			uint64_t y = fMode == QMC_OWEN ? nested_scramble(x[j], fKeys[j]) : x[j]^fKeys[j];
+
+			u[j] = (y >> 11)*1.1102230246251565404e-16; // 2^-53
+		}
+	}
+
+private:
+
+	__hydra_host__ __hydra_device__
+	static inline uint64_t reverse_bits(uint64_t x)
+	{
+		x = ((x >> 1)  & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+		x = ((x >> 2)  & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+		x = ((x >> 4)  & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+		x = ((x >> 8)  & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+		x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+
+		return (x >> 32) | (x << 32);
+	}
+
+	/*
+	 * Laine-Karras style permutation on the reversed digits: additions and
+	 * products by even constants only propagate towards higher bits, so each
+	 * output digit is the input digit flipped by a hash of the more significant
+	 * ones, which is a nested uniform scrambling (B. Burley, JCGT 10, 2020).
+	 */
+	__hydra_host__ __hydra_device__
+	static inline uint64_t nested_scramble(uint64_t x, uint64_t key)
+	{
+		x  = reverse_bits(x);
+		x += key;
+		x ^= x * 0x6c50b47cdb2e4b1eULL;
+		x ^= x * 0xb82f1e52c7afe638ULL;
+		x ^= x * 0xc7afe6388d22f6e6ULL;
+		x ^= x * 0x8d22f6e66c50b47cULL;
+
+		return reverse_bits(x);
+	}
+
+	uint64_t const* fDirections;
+	uint64_t  fKeys[N];
+	QMCMode_t fMode;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* SCRAMBLEDSOBOL_H_ */
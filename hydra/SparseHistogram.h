@@ -34,17 +34,22 @@
 #include <hydra/Types.h>
 #include <hydra/detail/Dimensionality.h>
 #include <hydra/detail/functors/GetBinCenter.h>
+#include <hydra/detail/functors/GetSparseBinContent.h>
 #include <hydra/Range.h>
 #include <hydra/Algorithm.h>
+#include <hydra/detail/HistogramFill.h>
 
 #include <type_traits>
 #include <utility>
 #include <array>
+#include <algorithm>
 
 
 #include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
 #include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
 #include <hydra/detail/external/hydra_thrust/find.h>
+#include <hydra/detail/external/hydra_thrust/binary_search.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
 
 namespace hydra {
 
@@ -94,7 +99,8 @@ public:
 
 	explicit SparseHistogram( std::array<size_t , N> const& grid,
 			std::array<T, N> const& lowerlimits,   std::array<T, N> const& upperlimits):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -107,7 +113,8 @@ public:
 
 	explicit SparseHistogram( size_t (&grid)[N],
 			T (&lowerlimits)[N],   T (&upperlimits)[N] ):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -121,7 +128,8 @@ public:
 	template<typename Int, typename = typename std::enable_if<std::is_integral<Int>::value, void>::type>
 	SparseHistogram( std::array<Int , N> const& grid,
 			std::array<T, N> const& lowerlimits,   std::array<T, N> const& upperlimits):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -135,7 +143,8 @@ public:
 	template<typename Int, typename = typename std::enable_if<std::is_integral<Int>::value, void>::type>
 	SparseHistogram( Int (&grid)[N],
 			T (&lowerlimits)[N],   T (&upperlimits)[N] ):
-				fNBins(1)
+				fNBins(1),
+				fAccumulate(false)
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i]=grid[i];
@@ -161,12 +170,14 @@ public:
 		}
 
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
 	SparseHistogram(SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional> const& other ):
 			fContents(other.GetContents()),
-			fBins(other.GetBins())
+			fBins(other.GetBins()),
+			fAccumulate(other.IsAccumulating())
 		{
 			for( size_t i=0; i<N; i++){
 				fGrid[i] = other.GetGrid(i);
@@ -193,13 +204,15 @@ public:
 		}
 
 		fNBins= other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
 	template<hydra::detail::Backend BACKEND2>
 	SparseHistogram(SparseHistogram<T, N,  detail::BackendPolicy<BACKEND2>, detail::multidimensional> const& other ):
 		fContents(other.GetContents()),
-		fBins(other.GetBins())
+		fBins(other.GetBins()),
+		fAccumulate(other.IsAccumulating())
 	{
 		for( size_t i=0; i<N; i++){
 			fGrid[i] = other.GetGrid(i);
@@ -245,6 +258,24 @@ public:
 		return fNBins;
 	}
 
+	/**
+	 * If accumulation is enabled, successive calls to Fill merge
+	 * the new bins into the current ones instead of replacing them.
+	 */
+	inline bool IsAccumulating() const {
+		return fAccumulate;
+	}
+
+	inline void SetAccumulate(bool accumulate) {
+		fAccumulate = accumulate;
+	}
+
+	inline void Reset() {
+		fBins.clear();
+		fContents.clear();
+		fNBins = 0;
+	}
+
 	template<typename Int,
 			typename = typename std::enable_if<std::is_integral<Int>::value, void>::type>
 	inline 	size_t GetBin( Int  (&bins)[N]){
@@ -299,11 +330,7 @@ public:
 
 		get_global_bin( bins,  bin);
 
-		size_t index = std::distance(fBins.begin(),
-								std::find(fBins.begin(),fBins.end(), bin));
-
-				return  (index < fBins.size() ) ?
-								fContents.begin()[index] : 0.0;
+		return GetBinContent(bin);
 	}
 
 	inline double GetBinContent(std::array<size_t, N> const& bins){
@@ -312,10 +339,7 @@ public:
 
 		get_global_bin( bins,  bin);
 
-		size_t index = hydra_thrust::distance(fBins.begin(),
-				hydra_thrust::find(fSystem , fBins.begin(),fBins.end(), bin));
-
-		return (index < fBins.size() ) ? fContents.begin()[index] : 0.0;
+		return GetBinContent(bin);
 	}
 
 
@@ -327,21 +351,47 @@ public:
 
 			get_global_bin( bins,  bin);
 
-			size_t index = hydra_thrust::distance(fBins.begin(),
-					hydra_thrust::find(fSystem , fBins.begin(),fBins.end(), bin));
-
-			return (index < fBins.size() ) ? fContents.begin()[index] : 0.0;
+			return GetBinContent(bin);
 		}
 
 
-
+	/*
+	 * The bins are kept sorted, so the lookup is a binary search.
+	 */
 	inline double GetBinContent( size_t  bin){
 
-		size_t index = std::distance(fBins.begin(),
-				std::find(fBins.begin(),fBins.end(), bin));
+		keys_iterator it = hydra_thrust::lower_bound(fSystem,
+				fBins.begin(), fBins.end(), bin);
+
+		return  ( it != fBins.end() && *it == bin ) ?
+				fContents.begin()[ hydra_thrust::distance(fBins.begin(), it) ] : 0.0;
+	}
+
+	/*
+	 * Looks up the contents of all global bins in [first, last) in a single
+	 * parallel pass on the histogram's back-end. The bin indexes
+	 * need to be accessible from that back-end.
+	 */
+	template<typename Iterator, typename OutputIterator>
+	inline OutputIterator GetBinContents(Iterator first, Iterator last, OutputIterator output) {
 
-		return  (index < fBins.size() ) ?
-				fContents.begin()[index] : 0.0;
+		return hydra_thrust::transform(fSystem, first, last, output,
+				detail::GetSparseBinContent( hydra_thrust::raw_pointer_cast(fBins.data()),
+						hydra_thrust::raw_pointer_cast(fContents.data()), fBins.size()));
+	}
+
+	template<typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value,
+	storage_data_t>::type
+	GetBinContents(Iterable&& bins) {
+
+		storage_data_t contents( hydra_thrust::distance(
+				std::forward<Iterable>(bins).begin(), std::forward<Iterable>(bins).end()) );
+
+		GetBinContents( std::forward<Iterable>(bins).begin(),
+				std::forward<Iterable>(bins).end(), contents.begin());
+
+		return contents;
 	}
 
 	inline Range<data_iterator> GetBinsContents() const {
@@ -433,6 +483,29 @@ public:
 	inline SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>&
 	Fill(detail::BackendPolicy<BACKEND2> const& exec_policy, Iterator1 begin, Iterator1 end, Iterator2 wbegin);
 
+	/**
+	 * Streams the data through the fixed size \p buffer. The \p generator is called as
+	 * generator(buffer.begin(), buffer.size()), writes the next chunk into the buffer
+	 * and returns its size. The stream ends when it returns zero.
+	 */
+	template<typename Generator, typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+	SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+	Fill(Generator&& generator, Iterable&& buffer);
+
+	/**
+	 * Streams the data and the weights through the fixed size buffers \p buffer and \p wbuffer.
+	 * The \p generator is called as generator(buffer.begin(), wbuffer.begin(), buffer.size()).
+	 */
+	template<typename Generator, typename Iterable1, typename Iterable2>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+	hydra::detail::is_iterable<Iterable2>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+	                                  decltype(std::declval<Iterable2&>().begin())>::value,
+	SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+	Fill(Generator&& generator, Iterable1&& buffer, Iterable2&& wbuffer);
+
 
 
 private:
@@ -566,6 +639,7 @@ private:
 	storage_data_t fContents;
 	storage_keys_t fBins;
 	system_t fSystem;
+	bool     fAccumulate;
 
 };
 
@@ -611,16 +685,19 @@ public:
 		fGrid(grid),
 		fLowerLimits(lowerlimits),
 		fUpperLimits(upperlimits),
-		fNBins(grid)
+		fNBins(grid),
+		fAccumulate(false)
 	{}
 
 
 	SparseHistogram(SparseHistogram<T,1, detail::BackendPolicy<BACKEND>,detail::unidimensional > const& other ):
 		fContents(other.GetContents()),
+		fBins(other.GetBins()),
 		fGrid(other.GetGrid()),
 		fLowerLimits(other.GetLowerLimits()),
 		fUpperLimits(other.GetUpperLimits()),
-		fNBins(other.GetNBins())
+		fNBins(other.GetNBins()),
+		fAccumulate(other.IsAccumulating())
 	{}
 
 	SparseHistogram<T,1, detail::BackendPolicy<BACKEND>,detail::unidimensional >&
@@ -628,20 +705,24 @@ public:
 	{
 		if(this==&other) return *this;
 		fContents = other.GetContents();
+		fBins = other.GetBins();
 		fGrid = other.GetGrid();
 		fLowerLimits = other.GetLowerLimits();
 		fUpperLimits = other.GetUpperLimits();
 		fNBins = other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
 	template<hydra::detail::Backend BACKEND2>
 	SparseHistogram(SparseHistogram<T,1, detail::BackendPolicy<BACKEND2>,detail::unidimensional > const& other ):
 		fContents(other.GetContents()),
+		fBins(other.GetBins()),
 		fGrid(other.GetGrid()),
 		fLowerLimits(other.GetLowerLimits()),
 		fUpperLimits(other.GetUpperLimits()),
-		fNBins(other.GetNBins())
+		fNBins(other.GetNBins()),
+		fAccumulate(other.IsAccumulating())
 	{}
 
 	template<hydra::detail::Backend BACKEND2>
@@ -650,10 +731,12 @@ public:
 	{
 		if(this==&other) return *this;
 		fContents = other.GetContents();
+		fBins = other.GetBins();
 		fGrid = other.GetGrid();
 		fLowerLimits = other.GetLowerLimits();
 		fUpperLimits = other.GetUpperLimits();
 		fNBins = other.GetNBins();
+		fAccumulate = other.IsAccumulating();
 		return *this;
 	}
 
@@ -691,14 +774,61 @@ public:
 		return fNBins;
 	}
 
+	/**
+	 * If accumulation is enabled, successive calls to Fill merge
+	 * the new bins into the current ones instead of replacing them.
+	 */
+	bool IsAccumulating() const {
+		return fAccumulate;
+	}
+
+	void SetAccumulate(bool accumulate) {
+		fAccumulate = accumulate;
+	}
 
+	void Reset() {
+		fBins.clear();
+		fContents.clear();
+		fNBins = 0;
+	}
+
+
+	/*
+	 * The bins are kept sorted, so the lookup is a binary search.
+	 */
 	double GetBinContent( size_t  bin) {
 
-		size_t index = std::distance(fBins.begin(),
-				std::find(fBins.begin(),fBins.end(), bin));
+		keys_iterator it = std::lower_bound(fBins.begin(), fBins.end(), bin);
+
+		return  ( it != fBins.end() && *it == bin ) ?
+				fContents.begin()[ std::distance(fBins.begin(), it) ] : 0.0;
+	}
+
+	/*
+	 * Looks up the contents of all bins in [first, last) in a single
+	 * parallel pass on the histogram's back-end. The 1D histogram is stored
+	 * in host memory, so the bin indexes need to be accessible from the host
+	 * and the back-end needs to run on it.
+	 */
+	template<typename Iterator, typename OutputIterator>
+	inline OutputIterator GetBinContents(Iterator first, Iterator last, OutputIterator output) {
 
-		return  ( bin< fBins.size() ) ?
-				fContents.begin()[bin] : 0.0;
+		return hydra_thrust::transform(fSystem, first, last, output,
+				detail::GetSparseBinContent( fBins.data(), fContents.data(), fBins.size()));
+	}
+
+	template<typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value,
+	storage_data_t>::type
+	GetBinContents(Iterable&& bins) {
+
+		storage_data_t contents( hydra_thrust::distance(
+				std::forward<Iterable>(bins).begin(), std::forward<Iterable>(bins).end()) );
+
+		GetBinContents( std::forward<Iterable>(bins).begin(),
+				std::forward<Iterable>(bins).end(), contents.begin());
+
+		return contents;
 	}
 
 	inline Range<hydra_thrust::transform_iterator<detail::GetBinCenter<T,1>, keys_iterator> >
@@ -789,6 +919,29 @@ public:
 	SparseHistogram<T,1, detail::BackendPolicy<BACKEND>,detail::unidimensional >&
 	Fill(detail::BackendPolicy<BACKEND2> const& exec_policy, Iterator1 begin, Iterator1 end, Iterator2 wbegin);
 
+	/**
+	 * Streams the data through the fixed size \p buffer. The \p generator is called as
+	 * generator(buffer.begin(), buffer.size()), writes the next chunk into the buffer
+	 * and returns its size. The stream ends when it returns zero.
+	 */
+	template<typename Generator, typename Iterable>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+	SparseHistogram<T,1, detail::BackendPolicy<BACKEND>,detail::unidimensional >& >::type
+	Fill(Generator&& generator, Iterable&& buffer);
+
+	/**
+	 * Streams the data and the weights through the fixed size buffers \p buffer and \p wbuffer.
+	 * The \p generator is called as generator(buffer.begin(), wbuffer.begin(), buffer.size()).
+	 */
+	template<typename Generator, typename Iterable1, typename Iterable2>
+	inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+	hydra::detail::is_iterable<Iterable2>::value &&
+	hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+	                                  decltype(std::declval<Iterable2&>().begin())>::value,
+	SparseHistogram<T,1, detail::BackendPolicy<BACKEND>,detail::unidimensional >& >::type
+	Fill(Generator&& generator, Iterable1&& buffer, Iterable2&& wbuffer);
+
 
 
 private:
@@ -802,6 +955,7 @@ private:
 	storage_data_t fContents;
 	storage_keys_t fBins;
 	system_t fSystem;
+	bool     fAccumulate;
 };
 
 /**
@@ -0,0 +1,429 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * SpilineTable.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef SPILINETABLE_H_
+#define SPILINETABLE_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/BackendPolicy.h>
+#include <hydra/Types.h>
+#include <hydra/Function.h>
+#include <hydra/Spiline.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/Iterable_traits.h>
+#include <hydra/detail/utility/CheckValue.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/for_each.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+
+namespace hydra {
+
+namespace detail {
+
+	namespace spiline {
+
+		/*
+		 * Coefficients of the interval t%(n-1) of the row t/(n-1) of a table.
+		 * The rows are the ordinates along the first axis, stored contiguously.
+		 */
+		struct TableRowCoefficients
+		{
+			TableRowCoefficients(GReal_t const* x, size_t n, GReal_t const* d,
+					GReal_t* c, GReal_t* b, GReal_t* a):
+				fX(x), fN(n), fD(d), fC(c), fB(b), fA(a)
+			{}
+
+			__hydra_host__ __hydra_device__
+			TableRowCoefficients(TableRowCoefficients const& other):
+				fX(other.fX), fN(other.fN), fD(other.fD), fC(other.fC), fB(other.fB), fA(other.fA)
+			{}
+
+			__hydra_host__ __hydra_device__
+			inline void operator()(size_t t) const
+			{
+				size_t row = t/(fN-1);
+				size_t i   = t%(fN-1);
+				size_t k   = row*fN + i;
+
+				coefficients(fX, fD + row*fN, i, fN, fC[k], fB[k], fA[k]);
+			}
+
+			GReal_t const* fX;
+			size_t   fN;
+			GReal_t const* fD;
+			GReal_t* fC;
+			GReal_t* fB;
+			GReal_t* fA;
+		};
+
+	}  // namespace spiline
+
+}  // namespace detail
+
+/**
+ * \class SpilineTable
+ *
+ * Monotone cubic interpolation (M. Steffen, Astron. Astrophys. 239, 443—450 (1990))
+ * of a table of points in one, two or three dimensions, with the coefficients of the cubics
+ * calculated once, on the back-end, and stored as columns (structure of arrays).
+ *
+ * The table is built from the abscissae of each axis and the ordinates, with the first axis
+ * running fastest: the ordinate of the node (i0, i1, i2) is y[i0 + n0*(i1 + n1*i2)].
+ * The polynomials along the first axis are tabulated for every row of the grid. In two and
+ * three dimensions, the interpolant is built by successive one-dimensional interpolations:
+ * the tabulated rows are evaluated at the four nearest nodes of each remaining axis and
+ * interpolated across them.
+ *
+ * On evenly spaced axes the interval containing a point is found with O(1) arithmetic,
+ * otherwise with a binary search. Points outside the grid are clamped to its border.
+ *
+ * The table lives in a buffer of the back-end memory pool, owned by the host copies of the
+ * object: copying is cheap, the copies share the buffer and the last one to be destroyed
+ * returns it to the pool. The copies made in device code only refer to the table, so they
+ * must not outlive the host object they come from.
+ *
+ * \tparam Backend back-end holding the table.
+ * \tparam ArgTypes types of the arguments, one per dimension.
+ */
+template<typename Backend, typename ...ArgTypes>
+class SpilineTable;
+
+template<detail::Backend BACKEND, typename ...ArgTypes>
+class SpilineTable<detail::BackendPolicy<BACKEND>, ArgTypes...>:
+	public BaseFunctor<SpilineTable<detail::BackendPolicy<BACKEND>, ArgTypes...>, double(ArgTypes...), 0>
+{
+	typedef BaseFunctor<SpilineTable<detail::BackendPolicy<BACKEND>, ArgTypes...>, double(ArgTypes...), 0> super_type;
+
+	typedef detail::BackendPolicy<BACKEND> system_type;
+	typedef typename std::remove_const<decltype(std::declval<system_type>().backend)>::type raw_system_type;
+	typedef std::shared_ptr<GReal_t> owner_type;
+
+	static const size_t D = sizeof...(ArgTypes);
+
+	static_assert( D > 0 && D < 4, "hydra::SpilineTable supports one, two and three dimensions." );
+
+public:
+
+	SpilineTable() = delete;
+
+	/**
+	 * @brief One dimensional table.
+	 * @param x abscissae.
+	 * @param y ordinates.
+	 */
+	template<typename Iterable1, typename Iterable2, size_t M=D,
+		typename=typename std::enable_if< M==1 &&
+			detail::is_iterable<Iterable1>::value && detail::is_iterable<Iterable2>::value>::type>
+	SpilineTable(Iterable1&& x, Iterable2&& y):
+		super_type()
+	{
+		Build( {{ ToHost(std::forward<Iterable1>(x)) }}, std::forward<Iterable2>(y));
+	}
+
+	/**
+	 * @brief Two dimensional table.
+	 * @param x0 abscissae of the first axis.
+	 * @param x1 abscissae of the second axis.
+	 * @param y ordinates, y[i0 + n0*i1].
+	 */
+	template<typename Iterable1, typename Iterable2, typename Iterable3, size_t M=D,
+		typename=typename std::enable_if< M==2 &&
+			detail::is_iterable<Iterable1>::value && detail::is_iterable<Iterable2>::value &&
+			detail::is_iterable<Iterable3>::value>::type>
+	SpilineTable(Iterable1&& x0, Iterable2&& x1, Iterable3&& y):
+		super_type()
+	{
+		Build( {{ ToHost(std::forward<Iterable1>(x0)), ToHost(std::forward<Iterable2>(x1)) }},
+				std::forward<Iterable3>(y));
+	}
+
+	/**
+	 * @brief Three dimensional table.
+	 * @param x0 abscissae of the first axis.
+	 * @param x1 abscissae of the second axis.
+	 * @param x2 abscissae of the third axis.
+	 * @param y ordinates, y[i0 + n0*(i1 + n1*i2)].
+	 */
+	template<typename Iterable1, typename Iterable2, typename Iterable3, typename Iterable4, size_t M=D,
+		typename=typename std::enable_if< M==3 &&
+			detail::is_iterable<Iterable1>::value && detail::is_iterable<Iterable2>::value &&
+			detail::is_iterable<Iterable3>::value && detail::is_iterable<Iterable4>::value>::type>
+	SpilineTable(Iterable1&& x0, Iterable2&& x1, Iterable3&& x2, Iterable4&& y):
+		super_type()
+	{
+		Build( {{ ToHost(std::forward<Iterable1>(x0)), ToHost(std::forward<Iterable2>(x1)),
+				ToHost(std::forward<Iterable3>(x2)) }}, std::forward<Iterable4>(y));
+	}
+
+	__hydra_host__ __hydra_device__
+	SpilineTable(SpilineTable<system_type, ArgTypes...> const& other):
+		super_type(other),
+		fData(other.GetData()),
+		fOwner(nullptr),
+		fNNodes(other.GetNumberOfNodes()),
+		fTable(other.fTable)
+	{
+#ifndef __CUDA_ARCH__
+		if( other.fOwner ) fOwner = new owner_type(*other.fOwner);
+#endif
+
+		for(size_t i=0; i<D; i++){
+
+			fN[i]        = other.fN[i];
+			fAxis[i]     = other.fAxis[i];
+			fStride[i]   = other.fStride[i];
+			fUniform[i]  = other.fUniform[i];
+			fInvDelta[i] = other.fInvDelta[i];
+		}
+	}
+
+	__hydra_host__ __hydra_device__
+	inline SpilineTable<system_type, ArgTypes...>&
+	operator=(SpilineTable<system_type, ArgTypes...> const& other)
+	{
+		if(this == &other) return *this;
+
+		super_type::operator=(other);
+
+#ifndef __CUDA_ARCH__
+		delete fOwner;
+
+		fOwner = other.fOwner ? new owner_type(*other.fOwner) : nullptr;
+#endif
+
+		fData   = other.GetData();
+		fNNodes = other.GetNumberOfNodes();
+		fTable  = other.fTable;
+
+		for(size_t i=0; i<D; i++){
+
+			fN[i]        = other.fN[i];
+			fAxis[i]     = other.fAxis[i];
+			fStride[i]   = other.fStride[i];
+			fUniform[i]  = other.fUniform[i];
+			fInvDelta[i] = other.fInvDelta[i];
+		}
+
+		return *this;
+	}
+
+	/**
+	 * @brief Evaluate the interpolant on each entry of @p input, writing the results to @p output.
+	 * The entries are the arguments of the table: values in one dimension, tuples otherwise.
+	 */
+	template<typename Iterable1, typename Iterable2>
+	inline typename std::enable_if< detail::is_iterable<Iterable1>::value &&
+		detail::is_iterable<Iterable2>::value, void>::type
+	Interpolate(Iterable1&& input, Iterable2&& output) const
+	{
+		hydra_thrust::transform(system_type(), std::forward<Iterable1>(input).begin(),
+				std::forward<Iterable1>(input).end(), std::forward<Iterable2>(output).begin(), *this);
+	}
+
+	__hydra_host__ __hydra_device__
+	inline double Evaluate(ArgTypes... x) const
+	{
+		GReal_t X[D] = { GReal_t(x)... };
+		size_t  I[D];
+
+		for(size_t i=0; i<D; i++){
+
+			GReal_t const* axis = fData + fAxis[i];
+
+			X[i] = X[i] < axis[0] ? axis[0] : X[i] > axis[fN[i]-1] ? axis[fN[i]-1] : X[i];
+			I[i] = detail::spiline::locate(axis, fN[i], fUniform[i], fInvDelta[i], X[i]);
+		}
+
+		double r = Interpolate<D-1>(X, I, 0);
+
+		return CHECK_VALUE( r, "r=%f", r);
+	}
+
+	__hydra_host__ __hydra_device__
+	~SpilineTable()
+	{
+#ifndef __CUDA_ARCH__
+		delete fOwner;
+#endif
+	}
+
+	/**
+	 * @brief True if the abscissae of the axis @p i are evenly spaced.
+	 */
+	__hydra_host__ __hydra_device__
+	inline bool IsUniform(size_t i) const {
+		return fUniform[i];
+	}
+
+	__hydra_host__ __hydra_device__
+	inline size_t GetNumberOfNodes(size_t i) const {
+		return fN[i];
+	}
+
+	__hydra_host__ __hydra_device__
+	inline size_t GetNumberOfNodes() const {
+		return fNNodes;
+	}
+
+	/**
+	 * @brief Raw pointer to the table: the axes, followed by the columns of
+	 * ordinates and of the first, second and third order coefficients.
+	 */
+	__hydra_host__ __hydra_device__
+	inline GReal_t* GetData() const {
+		return fData;
+	}
+
+private:
+
+	template<typename Iterable>
+	static std::vector<GReal_t> ToHost(Iterable&& x)
+	{
+		std::vector<GReal_t> result( hydra_thrust::distance(std::forward<Iterable>(x).begin(),
+				std::forward<Iterable>(x).end()) );
+
+		hydra_thrust::copy(std::forward<Iterable>(x).begin(), std::forward<Iterable>(x).end(), result.begin());
+
+		return result;
+	}
+
+	template<typename Iterable>
+	void Build(std::array<std::vector<GReal_t>, D> const& axes, Iterable&& y)
+	{
+		fData   = nullptr;
+		fOwner  = nullptr;
+		fNNodes = 0;
+		fTable  = 0;
+
+		for(size_t i=0; i<D; i++)
+			if( axes[i].size() < 2 )
+				throw std::invalid_argument("[hydra::SpilineTable]: each axis needs at least two nodes.");
+
+		size_t naxes = 0;
+		fNNodes = 1;
+
+		for(size_t i=0; i<D; i++){
+
+			fN[i] = axes[i].size();
+			fAxis[i]     = naxes;
+			fStride[i]   = i < 2 ? 1 : fN[1];
+			fUniform[i]  = detail::spiline::is_uniform(axes[i].begin(), fN[i]);
+			fInvDelta[i] = (fN[i] - 1)/(axes[i][fN[i]-1] - axes[i][0]);
+
+			naxes   += fN[i];
+			fNNodes *= fN[i];
+		}
+
+		if( size_t(hydra_thrust::distance(std::forward<Iterable>(y).begin(), std::forward<Iterable>(y).end())) != fNNodes )
+			throw std::invalid_argument("[hydra::SpilineTable]: the number of ordinates does not match the size of the grid.");
+
+		fTable = naxes;
+
+		//axes, ordinates and the three columns of coefficients
+		fData = hydra_thrust::raw_pointer_cast(
+				hydra::detail::get_temporary_buffer<GReal_t>(raw_system_type(), naxes + 4*fNNodes).first );
+
+		fOwner = new owner_type(fData, [](GReal_t* p){
+			hydra::detail::return_temporary_buffer(raw_system_type(), p); });
+
+		hydra_thrust::pointer<GReal_t, raw_system_type> data(fData);
+
+		for(size_t i=0; i<D; i++)
+			hydra_thrust::copy(axes[i].begin(), axes[i].end(), data + fAxis[i]);
+
+		hydra_thrust::copy(std::forward<Iterable>(y).begin(), std::forward<Iterable>(y).end(), data + fTable);
+
+		size_t nintervals = (fNNodes/fN[0])*(fN[0] - 1);
+
+		hydra_thrust::for_each(system_type(), hydra_thrust::counting_iterator<size_t>(0),
+				hydra_thrust::counting_iterator<size_t>(nintervals),
+				detail::spiline::TableRowCoefficients(fData + fAxis[0], fN[0], fData + fTable,
+						fData + fTable + fNNodes, fData + fTable + 2*fNNodes, fData + fTable + 3*fNNodes));
+	}
+
+	//tabulated polynomial along the first axis
+	template<size_t A>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if<A==0, double>::type
+	Interpolate(GReal_t const* X, size_t const* I, size_t row) const
+	{
+		const size_t k = row*fN[0] + I[0];
+
+		GReal_t const* d = fData + fTable;
+
+		return detail::spiline::horner(X[0] - fData[fAxis[0] + I[0]],
+				d[k + 3*fNNodes], d[k + 2*fNNodes], d[k + fNNodes], d[k]);
+	}
+
+	//interpolation across the axis A of the values at its nearest nodes
+	template<size_t A>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if<(A>0), double>::type
+	Interpolate(GReal_t const* X, size_t const* I, size_t row) const
+	{
+		GReal_t const* axis = fData + fAxis[A];
+
+		const size_t i  = I[A];
+		const size_t lo = i > 0 ? i - 1 : 0;
+		const size_t hi = i + 2 < fN[A] ? i + 2 : fN[A] - 1;
+
+		GReal_t y[4];
+
+		for(size_t j=lo; j<=hi; j++)
+			y[j-lo] = Interpolate<A-1>(X, I, row + j*fStride[A]);
+
+		double c, b, a;
+
+		detail::spiline::coefficients(axis + lo, y, i - lo, hi - lo + 1, c, b, a);
+
+		return detail::spiline::horner(X[A] - axis[i], a, b, c, y[i-lo]);
+	}
+
+	GReal_t* fData;
+	owner_type* fOwner; //held by the host copies only, to keep the table device copyable
+	size_t   fNNodes;
+	size_t   fTable;
+	size_t   fN[D];
+	size_t   fAxis[D];
+	size_t   fStride[D];
+	bool     fUniform[D];
+	GReal_t  fInvDelta[D];
+};
+
+}  // namespace hydra
+
+#endif /* SPILINETABLE_H_ */
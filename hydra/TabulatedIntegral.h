@@ -0,0 +1,226 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * TabulatedIntegral.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup numerical_integration
+ */
+
+#ifndef TABULATEDINTEGRAL_H_
+#define TABULATEDINTEGRAL_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Integrator.h>
+#include <hydra/detail/Print.h>
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+/**
+ * Number of consecutive tables discarded, because another parameter of the functor changed,
+ * before serving as many interpolations as the integrator calls they cost, after which
+ * hydra::TabulatedIntegral stops tabulating and calls the wrapped integrator directly.
+ */
+#ifndef HYDRA_TABULATED_INTEGRAL_MAX_REBUILDS
+#define HYDRA_TABULATED_INTEGRAL_MAX_REBUILDS 3
+#endif
+
+namespace hydra {
+
+/**
+ * \ingroup numerical_integration
+ *
+ * @brief Integral of a functor tabulated on a grid of values of some of its parameters.
+ *
+ * The integral is calculated with the underlying integrator on the nodes of a regular
+ * grid spanned by @p N parameters of the functor, and interpolated inside the cells with
+ * monotone cubics (as hydra::spiline) through the four nearest nodes along each parameter.
+ * It is meant to normalize shapes whose integral is expensive, like hydra::Ipatia, in fits
+ * where these parameters float.
+ *
+ * The nodes are calculated when a cell is visited for the first time, and each cell is
+ * validated once, comparing the interpolation with the integral at its center and halfway
+ * between the center and each face.
+ * If twice the largest relative difference is above the tolerance, or the parameters fall outside the
+ * grid, the underlying integrator is called instead.
+ * The table is rebuilt whenever one of the other parameters of the functor changes.
+ * The tabulation is therefore not suited to fits where an untabulated parameter floats:
+ * each step would pay for the nodes and the validation of a new table. After
+ * HYDRA_TABULATED_INTEGRAL_MAX_REBUILDS consecutive tables discarded before serving as many
+ * interpolations as the integrator calls they cost, the tabulation is bypassed and every call
+ * goes to the underlying integrator, until Reset() is called.
+ *
+ * \tparam Integrator underlying integrator.
+ * \tparam N number of tabulated parameters.
+ */
+template<typename Integrator, size_t N>
+class TabulatedIntegral: public Integral< TabulatedIntegral<Integrator, N> >
+{
+	struct node_type
+	{
+		GReal_t fValue;
+		GReal_t fError;
+	};
+
+	struct cell_type
+	{
+		bool    fValid;
+		GReal_t fDeviation;
+	};
+
+public:
+
+	TabulatedIntegral()=delete;
+
+	/**
+	 * @param integrator underlying integrator.
+	 * @param parameters indexes of the tabulated parameters, as in functor.GetParameter(i).
+	 * @param min lower limit of each tabulated parameter.
+	 * @param max upper limit of each tabulated parameter.
+	 * @param nodes number of nodes along each tabulated parameter (at least two).
+	 * @param tolerance maximum relative deviation of the interpolation in a cell.
+	 *
+	 * The other parameters of the functor are expected to stay fixed, see the class description.
+	 */
+	TabulatedIntegral(Integrator const& integrator, std::array<size_t, N> const& parameters,
+			std::array<GReal_t, N> const& min, std::array<GReal_t, N> const& max,
+			std::array<size_t, N> const& nodes, GReal_t tolerance=1.0e-6);
+
+	TabulatedIntegral(TabulatedIntegral<Integrator, N> const& other);
+
+	TabulatedIntegral<Integrator, N>&
+	operator=(TabulatedIntegral<Integrator, N> const& other);
+
+	template<typename Functor>
+	std::pair<GReal_t, GReal_t> Integrate(Functor const& functor);
+
+	/**
+	 * @brief Discard the nodes and the validation of the cells.
+	 */
+	inline void Clear()
+	{
+		fNodes.clear();
+		fCells.clear();
+		fNUses = 0;
+	}
+
+	/**
+	 * @brief Discard the table and resume the tabulation if it was bypassed.
+	 */
+	inline void Reset()
+	{
+		Clear();
+		fNRebuilds = 0;
+		fBypassed  = false;
+	}
+
+	/**
+	 * @brief True if the table was rebuilt too often and the calls go
+	 * directly to the underlying integrator.
+	 */
+	inline bool IsBypassed() const { return fBypassed; }
+
+	inline Integrator const& GetIntegrator() const { return fIntegrator; }
+
+	inline Integrator& GetIntegrator() { return fIntegrator; }
+
+	inline GReal_t GetTolerance() const { return fTolerance; }
+
+	inline void SetTolerance(GReal_t tolerance)
+	{
+		fTolerance = tolerance;
+		fCells.clear();
+	}
+
+	/**
+	 * @brief Number of nodes calculated with the underlying integrator.
+	 */
+	inline size_t GetNumberOfNodes() const { return fNodes.size(); }
+
+	/**
+	 * @brief Number of calls served by interpolation.
+	 */
+	inline size_t GetNumberOfInterpolations() const { return fNInterpolations; }
+
+	/**
+	 * @brief Number of calls passed to the underlying integrator, outside the grid
+	 * or in cells failing the validation.
+	 */
+	inline size_t GetNumberOfFallbacks() const { return fNFallbacks; }
+
+	void Print() const;
+
+private:
+
+	template<typename Functor>
+	size_t OtherParametersKey(Functor const& functor) const;
+
+	template<typename Functor>
+	node_type const& Node(Functor const& functor, std::array<size_t, N> const& index);
+
+	template<typename Functor>
+	cell_type const& Cell(Functor const& functor, std::array<size_t, N> const& index);
+
+	template<typename Functor>
+	inline node_type Interpolate(Functor const& functor, std::array<size_t, N> const& index,
+			std::array<GReal_t, N> const& t)
+	{
+		std::array<size_t, N> node_index(index);
+
+		return Interpolate(functor, index, t, node_index, N);
+	}
+
+	//interpolation across the parameters axis-1, axis-2, ..., 0
+	template<typename Functor>
+	node_type Interpolate(Functor const& functor, std::array<size_t, N> const& index,
+			std::array<GReal_t, N> const& t, std::array<size_t, N>& node_index, size_t axis);
+
+	Integrator fIntegrator;
+	std::array<size_t, N>  fParameters;
+	std::array<GReal_t, N> fMin;
+	std::array<GReal_t, N> fMax;
+	std::array<size_t, N>  fNNodes;
+	GReal_t fTolerance;
+	size_t  fKey;
+	size_t  fNInterpolations;
+	size_t  fNFallbacks;
+	size_t  fNUses;
+	size_t  fNRebuilds;
+	bool    fBypassed;
+	std::unordered_map<size_t, node_type> fNodes;
+	std::unordered_map<size_t, cell_type> fCells;
+};
+
+}  // namespace hydra
+
+#include <hydra/detail/TabulatedIntegral.inl>
+
+#endif /* TABULATEDINTEGRAL_H_ */
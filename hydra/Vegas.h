@@ -37,8 +37,11 @@
 #include <hydra/Types.h>
 #include <hydra/VegasState.h>
 #include <hydra/detail/functors/ProcessCallsVegas.h>
+#include <hydra/ScrambledSobol.h>
 #include <hydra/Integrator.h>
 #include <utility>
+#include <memory>
+#include <stdexcept>
 #include <hydra/detail/external/hydra_thrust/random.h>
 #include <hydra/Random.h>
 
@@ -79,7 +82,12 @@ public:
 
 	Vegas(std::array<GReal_t,N> const& xlower,	std::array<GReal_t,N> const& xupper, size_t ncalls):
 		Integral<Vegas<N, hydra::detail::BackendPolicy<BACKEND>,GRND>>(),
-		fState(xlower,xupper)
+		fState(xlower,xupper),
+		fNSlots(0),
+		fQMCMode(QMC_NONE),
+		fQMCSeed(HYDRA_QMC_SEED),
+		fQMCPass(0),
+		fQMCReplicas(HYDRA_QMC_REPLICAS)
 		{
 		fState.SetCalls(ncalls);
 		}
@@ -87,14 +95,24 @@ public:
 
 	Vegas(VegasState<N, hydra::detail::BackendPolicy<BACKEND>> const& state):
 		Integral<Vegas<N, hydra::detail::BackendPolicy<BACKEND>,GRND>>(),
-		fState(state)
+		fState(state),
+		fNSlots(0),
+		fQMCMode(QMC_NONE),
+		fQMCSeed(HYDRA_QMC_SEED),
+		fQMCPass(0),
+		fQMCReplicas(HYDRA_QMC_REPLICAS)
 		{}
 
 
 
 	Vegas( Vegas< N, hydra::detail::BackendPolicy<BACKEND>, GRND> const& other):
 	Integral<Vegas<N, hydra::detail::BackendPolicy<BACKEND>,GRND>>(),
-	fState(other.GetState())
+	fState(other.GetState()),
+	fNSlots(0),
+	fQMCMode(other.GetQMCMode()),
+	fQMCSeed(other.GetQMCSeed()),
+	fQMCPass(0),
+	fQMCReplicas(other.GetQMCReplicas())
 	{}
 
 	Vegas< N, hydra::detail::BackendPolicy<BACKEND>, GRND>&
@@ -103,6 +121,10 @@ public:
 		if(this == &other) return *this;
 
 		this->fState =other.GetState();
+		this->fQMCMode =other.GetQMCMode();
+		this->fQMCSeed =other.GetQMCSeed();
+		this->fQMCPass =0;
+		this->fQMCReplicas =other.GetQMCReplicas();
 		return *this;
 
 	}
@@ -111,7 +133,12 @@ public:
 	template< hydra::detail::Backend  BACKEND2, typename GRND2>
 	Vegas( Vegas< N, hydra::detail::BackendPolicy<BACKEND2>, GRND2> const& other):
 	Integral<Vegas<N, hydra::detail::BackendPolicy<BACKEND>,GRND>>(),
-	fState(other.GetState())
+	fState(other.GetState()),
+	fNSlots(0),
+	fQMCMode(other.GetQMCMode()),
+	fQMCSeed(other.GetQMCSeed()),
+	fQMCPass(0),
+	fQMCReplicas(other.GetQMCReplicas())
 	{}
 
 	template< hydra::detail::Backend  BACKEND2, typename GRND2>
@@ -121,6 +148,10 @@ public:
 		if(this == &other) return *this;
 
 		this->fState =other.GetState();
+		this->fQMCMode =other.GetQMCMode();
+		this->fQMCSeed =other.GetQMCSeed();
+		this->fQMCPass =0;
+		this->fQMCReplicas =other.GetQMCReplicas();
 		return *this;
 
 	}
@@ -150,6 +181,58 @@ public:
 	template<typename FUNCTOR>
 	inline std::pair<GReal_t, GReal_t> Integrate(FUNCTOR const& fFunctor);
 
+	/**
+	 * @brief Sample randomized Sobol points instead of pseudo-random ones.
+	 *
+	 * The points are not stratified in boxes: the calls of each iteration are split in
+	 * \p replicas independent randomizations of the sequence, each one an estimate
+	 * of the integral over the current grid. The iteration result is their mean and its
+	 * error the standard error of the mean, as for hydra::Plain. Each pass over the grid
+	 * draws new randomizations, so the iterations remain independent estimates and
+	 * their combination and chi2 keep the usual meaning.
+	 *
+	 * @param mode hydra::QMC_DIGITAL_SHIFT, hydra::QMC_OWEN or hydra::QMC_NONE to go back to Monte Carlo.
+	 * @param seed seed of the randomizations.
+	 * @param replicas number of randomizations per iteration, at least two.
+	 */
+	inline void SetQMC(QMCMode_t mode, size_t seed=HYDRA_QMC_SEED, size_t replicas=HYDRA_QMC_REPLICAS)
+	{
+		if( mode != QMC_NONE && replicas < 2 )
+			throw std::invalid_argument("[hydra::Vegas]: at least two QMC replicas are needed to estimate the error.");
+
+		fQMCMode = mode;
+		fQMCSeed = seed;
+		fQMCPass = 0;
+		fQMCReplicas = replicas;
+	}
+
+	inline QMCMode_t GetQMCMode() const {
+		return fQMCMode;
+	}
+
+	inline size_t GetQMCSeed() const {
+		return fQMCSeed;
+	}
+
+	inline size_t GetQMCReplicas() const {
+		return fQMCReplicas;
+	}
+
+	/**
+	 * @brief Release the scratch buffers used to accumulate the grid distribution.
+	 *
+	 * The buffers are kept between calls to Integrate, so successive integrations
+	 * with the same number of calls do not reallocate them.
+	 */
+	inline void ReleaseBuffers()
+	{
+		fFValInput=rvector_backend();
+		fGlobalBinInput=uvector_backend();
+		fFValOutput=rvector_backend();
+		fGlobalBinOutput=uvector_backend();
+		fDistributionSlots=rvector_backend();
+	}
+
 private:
 
 
@@ -165,7 +248,9 @@ private:
 	void RefineGrid();
 
 	template<typename FUNCTOR>
-	void ProcessFuncionCalls(FUNCTOR const& functor, GBool_t training,GReal_t& integral, GReal_t& tss);
+	void ProcessFuncionCalls(FUNCTOR const& functor, GBool_t training,GReal_t& integral, GReal_t& variance);
+
+	void UpdateDistribution();
 
 
 	inline GReal_t GetCoordinate(const GUInt_t i, const GUInt_t j) const {
@@ -198,6 +283,13 @@ private:
 	uvector_backend fGlobalBinInput;
 	rvector_backend fFValOutput;
 	uvector_backend fGlobalBinOutput;
+	rvector_backend fDistributionSlots;
+	size_t fNSlots;
+	QMCMode_t fQMCMode;
+	size_t    fQMCSeed;
+	size_t    fQMCPass;
+	size_t    fQMCReplicas;
+	std::shared_ptr<typename system_t::template container<uint64_t> const> fDirections;
 };
 
 }
@@ -425,6 +425,7 @@ public:
 
 	inline void StoreIterationDuration(const GReal_t timing) { fIterationDuration.push_back(timing);}
 	inline void StoreFunctionCallsDuration(const GReal_t timing) { fFunctionCallsDuration.push_back(timing);}
+	inline void StoreGridUpdateDuration(const GReal_t timing) { fGridUpdateDuration.push_back(timing);}
 
 	inline const std::vector<GReal_t>& GetXLow() const { return fXLow; }
 
@@ -509,6 +510,18 @@ public:
 		fFunctionCallsDuration = functionCallsDuration;
 	}
 
+	/**
+	 * @brief Time per iteration (ms) spent building the grid distribution from
+	 * the function calls and refining the grid.
+	 */
+	std::vector<GReal_t> const& GetGridUpdateDuration() const {
+		return fGridUpdateDuration;
+	}
+
+	void SetGridUpdateDuration(std::vector<GReal_t> gridUpdateDuration) {
+		fGridUpdateDuration = gridUpdateDuration;
+	}
+
 	GBool_t IsTrainedGridFrozen() const {
 		return fTrainedGridFrozen;
 	}
@@ -554,7 +567,8 @@ private:
 	std::vector<GReal_t> fCumulatedResult; ///< vector of cumulated results per iteration
 	std::vector<GReal_t> fCumulatedSigma; ///< vector of cumulated sigmas per iteration
 	std::vector<GReal_t> fIterationDuration; ///< vector with the time per iteration
-	std::vector<GReal_t> fFunctionCallsDuration; ///< vector with the time per iteration
+	std::vector<GReal_t> fFunctionCallsDuration; ///< vector with the time spent in function calls per iteration
+	std::vector<GReal_t> fGridUpdateDuration; ///< vector with the time spent updating the grid per iteration
 
 	//mc_host_vector<GUInt_t> fBox;
 
@@ -0,0 +1,234 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * AmplitudeCache.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup fit
+ */
+
+#ifndef AMPLITUDECACHE_H_
+#define AMPLITUDECACHE_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Complex.h>
+#include <hydra/Parameter.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/utility/DataRange.h>
+
+#include <hydra/detail/external/hydra_thrust/memory.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/detail/type_traits.h>
+
+#include <array>
+#include <vector>
+
+namespace hydra {
+
+namespace detail {
+
+/**
+ * \ingroup fit
+ * \brief Per-event complex amplitudes of the components of a coherent sum.
+ *
+ * Same layout and policy as ComponentDensityCache: one column per amplitude,
+ * allocated on the back-end of the events, recomputed only when the parameters
+ * of the amplitude change. IsUpdated(i) tells if the column i was recomputed
+ * by the last call to Update, so quantities derived from the columns can be
+ * refreshed incrementally. All columns are recomputed if the cache is updated
+ * on another range of events; if the content of the same range is modified,
+ * call Invalidate().
+ *
+ * Copies do not share the buffer; they start empty and are filled on the first update.
+ *
+ * \tparam System back-end of the events.
+ * \tparam N number of amplitudes.
+ */
+template<typename System, size_t N>
+class AmplitudeCache
+{
+	typedef hydra::complex<double> value_type;
+	typedef hydra_thrust::pointer<value_type, System> pointer_type;
+
+public:
+
+	AmplitudeCache():
+		fColumns(),
+		fNEntries(0),
+		fNUpdates(0),
+		fRange()
+	{
+		Invalidate();
+	}
+
+	AmplitudeCache(AmplitudeCache<System, N> const&):
+		fColumns(),
+		fNEntries(0),
+		fNUpdates(0),
+		fRange()
+	{
+		Invalidate();
+	}
+
+	AmplitudeCache<System, N>&
+	operator=(AmplitudeCache<System, N> const& other)
+	{
+		if(this==&other) return *this;
+
+		Release();
+
+		return *this;
+	}
+
+	~AmplitudeCache()
+	{
+		Release();
+	}
+
+	/**
+	 * @brief Bring the columns up to date with the amplitude functors.
+	 * @return raw pointer to the first column. The column of the i-th
+	 * amplitude starts at i*GetNumberOfEntries().
+	 */
+	template<typename Functors, typename Iterator>
+	inline value_type const* Update(Functors const& functors, Iterator begin, Iterator end)
+	{
+		size_t nentries = hydra_thrust::distance(begin, end);
+
+		if( nentries != fNEntries ){
+
+			Release();
+
+			if( nentries > 0 )
+				fColumns = hydra::detail::get_temporary_buffer<value_type>(System(), N*nentries).first;
+
+			fNEntries = nentries;
+		}
+
+		//the columns hold the amplitudes of other events
+		if( fRange.Rebind(begin, end) ) Invalidate();
+
+		UpdateColumns(functors, begin, end);
+
+		return hydra_thrust::raw_pointer_cast(fColumns);
+	}
+
+	/**
+	 * @brief Mark all columns to be recomputed on the next update.
+	 */
+	inline void Invalidate()
+	{
+		for(size_t i=0; i<N; i++){
+			fValid[i]   = false;
+			fUpdated[i] = false;
+			fStates[i].clear();
+		}
+	}
+
+	/**
+	 * @brief Free the buffer. It is allocated again on the next update.
+	 */
+	inline void Release()
+	{
+		if( fNEntries > 0 )
+			hydra::detail::return_temporary_buffer(System(), fColumns);
+
+		fColumns  = pointer_type();
+		fNEntries = 0;
+
+		fRange.Reset();
+		Invalidate();
+	}
+
+	inline size_t GetNumberOfEntries() const { return fNEntries; }
+
+	/**
+	 * @brief Number of columns computed since construction.
+	 */
+	inline size_t GetNumberOfUpdates() const { return fNUpdates; }
+
+	/**
+	 * @brief True if the column @p i was recomputed by the last update.
+	 */
+	inline bool IsUpdated(size_t i) const { return fUpdated[i]; }
+
+private:
+
+	template<size_t I=0, typename Functors, typename Iterator>
+	inline typename hydra_thrust::detail::enable_if<(I == N), void>::type
+	UpdateColumns(Functors const&, Iterator, Iterator)
+	{}
+
+	template<size_t I=0, typename Functors, typename Iterator>
+	inline typename hydra_thrust::detail::enable_if<(I < N), void>::type
+	UpdateColumns(Functors const& functors, Iterator begin, Iterator end)
+	{
+		typedef typename hydra_thrust::tuple_element<I, Functors>::type functor_type;
+
+		functor_type functor = hydra_thrust::get<I>(functors);
+
+		std::vector<hydra::Parameter*> parameters;
+		functor.AddUserParameters(parameters);
+
+		std::vector<GReal_t> state;
+		state.reserve(parameters.size());
+
+		for(auto parameter: parameters)
+			state.push_back(parameter->GetValue());
+
+		fUpdated[I] = !fValid[I] || state != fStates[I];
+
+		if( fUpdated[I] ){
+
+			hydra_thrust::transform(System(), begin, end, fColumns + I*fNEntries, functor);
+
+			fStates[I] = state;
+			fValid[I]  = true;
+
+			++fNUpdates;
+		}
+
+		UpdateColumns<I+1>(functors, begin, end);
+	}
+
+	pointer_type fColumns;
+	size_t fNEntries;
+	size_t fNUpdates;
+	DataRange fRange;
+	std::array<bool, N> fValid;
+	std::array<bool, N> fUpdated;
+	std::array<std::vector<GReal_t>, N> fStates;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* AMPLITUDECACHE_H_ */
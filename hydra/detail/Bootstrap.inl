@@ -0,0 +1,154 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * Bootstrap.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef BOOTSTRAP_INL_
+#define BOOTSTRAP_INL_
+
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/external/hydra_thrust/memory.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+#include <hydra/detail/external/hydra_thrust/for_each.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
+
+#include <algorithm>
+
+namespace hydra {
+
+template<typename RNG, typename Iterable, typename Accumulator>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value, std::vector<GReal_t>>::type
+poisson_bootstrap(Iterable&& data, Accumulator const& accumulator, size_t nslots,
+		size_t nreplicas, size_t seed)
+{
+	typedef decltype(std::forward<Iterable>(data).begin()) iterator_type;
+	typedef typename hydra_thrust::iterator_system<iterator_type>::type system_type;
+
+	std::vector<GReal_t> result(nreplicas*nslots, 0.0);
+
+	auto first = std::forward<Iterable>(data).begin();
+	auto last  = std::forward<Iterable>(data).end();
+
+	size_t nevents = hydra_thrust::distance(first, last);
+
+	if( nevents==0 || nreplicas*nslots==0 ) return result;
+
+	//each block holds the partial sums of all replicas
+	size_t stride  = nreplicas*nslots;
+	size_t nblocks = std::min<size_t>(HYDRA_BOOTSTRAP_MAX_BLOCKS, HYDRA_BOOTSTRAP_MAX_PARTIAL_SUMS/stride);
+	nblocks = std::max<size_t>(1, std::min(nblocks, nevents));
+
+	size_t block_size = (nevents + nblocks - 1)/nblocks;
+	nblocks = (nevents + block_size - 1)/block_size;
+
+	auto partial_sums = hydra::detail::get_temporary_buffer<GReal_t>(system_type(), nblocks*stride);
+	auto sums         = hydra::detail::get_temporary_buffer<GReal_t>(system_type(), stride);
+
+	hydra_thrust::for_each(system_type(), hydra_thrust::counting_iterator<size_t>(0),
+			hydra_thrust::counting_iterator<size_t>(nblocks),
+			detail::PoissonBootstrapBlock<RNG, iterator_type, Accumulator>(first, nevents, block_size,
+					nreplicas, nslots, seed, hydra_thrust::raw_pointer_cast(partial_sums.first), accumulator));
+
+	hydra_thrust::transform(system_type(), hydra_thrust::counting_iterator<size_t>(0),
+			hydra_thrust::counting_iterator<size_t>(stride), sums.first,
+			detail::SumPoissonBootstrapBlocks(hydra_thrust::raw_pointer_cast(partial_sums.first), nblocks, stride));
+
+	hydra_thrust::copy(sums.first, sums.first + stride, result.begin());
+
+	hydra::detail::return_temporary_buffer(system_type(), partial_sums.first);
+	hydra::detail::return_temporary_buffer(system_type(), sums.first);
+
+	return result;
+}
+
+template<typename RNG, typename Iterable, typename Functor>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_mean(Iterable&& data, Functor const& functor, size_t nreplicas, size_t seed)
+{
+	auto sums = poisson_bootstrap<RNG>(std::forward<Iterable>(data),
+			detail::BootstrapMeanAccumulator<Functor>(functor), 2, nreplicas, seed);
+
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t> result;
+	result.reserve(nreplicas);
+
+	for(size_t replica=0; replica<nreplicas; replica++){
+
+		GReal_t sum  = sums[2*replica];
+		GReal_t sumw = sums[2*replica + 1];
+
+		result.push_back( hydra::make_tuple( sumw > 0 ? sum/sumw : 0.0, sumw) );
+	}
+
+	return result;
+}
+
+template<typename RNG, typename Iterable, typename Functor>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_histogram(Iterable&& data, Functor const& functor, size_t nbins, GReal_t min, GReal_t max,
+		size_t nreplicas, size_t seed)
+{
+	auto sums = poisson_bootstrap<RNG>(std::forward<Iterable>(data),
+			detail::BootstrapHistogramAccumulator<Functor>(functor, nbins, min, max), nbins, nreplicas, seed);
+
+	GReal_t delta = (max - min)/nbins;
+
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t> result;
+	result.reserve(nreplicas*nbins);
+
+	for(size_t replica=0; replica<nreplicas; replica++)
+		for(size_t bin=0; bin<nbins; bin++)
+			result.push_back( hydra::make_tuple( min + (bin + 0.5)*delta, sums[replica*nbins + bin]) );
+
+	return result;
+}
+
+template<typename RNG, typename Iterable, typename Pdf>
+typename std::enable_if<hydra::detail::is_iterable<Iterable>::value,
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t>>::type
+bootstrap_nll(Iterable&& data, Pdf const& pdf, size_t nreplicas, size_t seed)
+{
+	typedef typename Pdf::functor_type functor_type;
+
+	auto sums = poisson_bootstrap<RNG>(std::forward<Iterable>(data),
+			detail::BootstrapLogLikelihoodAccumulator<functor_type>(pdf.GetFunctor()), 2, nreplicas, seed);
+
+	hydra::multivector<hydra::tuple<GReal_t,GReal_t>, hydra::host::sys_t> result;
+	result.reserve(nreplicas);
+
+	for(size_t replica=0; replica<nreplicas; replica++)
+		result.push_back( hydra::make_tuple( -sums[2*replica], sums[2*replica + 1]) );
+
+	return result;
+}
+
+}  // namespace hydra
+
+#endif /* BOOTSTRAP_INL_ */
@@ -0,0 +1,252 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * BoundedCache.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup fit
+ */
+
+#ifndef BOUNDEDCACHE_H_
+#define BOUNDEDCACHE_H_
+
+#include <hydra/detail/Config.h>
+
+#include <list>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+/**
+ * Default number of entries kept by the caches of hydra::FCN and hydra::Pdf.
+ */
+#ifndef HYDRA_DEFAULT_CACHE_CAPACITY
+#define HYDRA_DEFAULT_CACHE_CAPACITY 1024
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+/**
+ * \ingroup fit
+ * \brief Least recently used cache of values keyed on the hash of a parameter vector.
+ *
+ * The cache holds at most GetCapacity() entries, evicting the least recently used one
+ * when full. A capacity of zero disables caching. If verification is enabled, the full
+ * parameter vector is stored with each entry and compared on lookup, so a hash collision
+ * is counted as a miss instead of returning the value of a different point.
+ *
+ * \tparam Value type of the cached values.
+ */
+template<typename Value>
+class BoundedCache
+{
+	struct entry_type
+	{
+		size_t fKey;
+		std::vector<double> fParameters;
+		Value fValue;
+	};
+
+	typedef std::list<entry_type> list_type;
+	typedef std::unordered_map<size_t, typename list_type::iterator> index_type;
+
+public:
+
+	BoundedCache(size_t capacity=HYDRA_DEFAULT_CACHE_CAPACITY, bool verify=false):
+		fCapacity(capacity),
+		fVerify(verify),
+		fHits(0),
+		fMisses(0),
+		fCollisions(0)
+	{}
+
+	BoundedCache(BoundedCache<Value> const& other):
+		fEntries(other.fEntries),
+		fCapacity(other.fCapacity),
+		fVerify(other.fVerify),
+		fHits(other.fHits),
+		fMisses(other.fMisses),
+		fCollisions(other.fCollisions)
+	{
+		BuildIndex();
+	}
+
+	BoundedCache<Value>& operator=(BoundedCache<Value> const& other)
+	{
+		if(this==&other) return *this;
+
+		fEntries    = other.fEntries;
+		fCapacity   = other.fCapacity;
+		fVerify     = other.fVerify;
+		fHits       = other.fHits;
+		fMisses     = other.fMisses;
+		fCollisions = other.fCollisions;
+
+		BuildIndex();
+
+		return *this;
+	}
+
+	/**
+	 * @brief Look up the value stored for \p key and \p parameters.
+	 * @return true and sets \p value on a hit.
+	 */
+	inline bool Get(size_t key, std::vector<double> const& parameters, Value& value)
+	{
+		auto search = fIndex.find(key);
+
+		if( search == fIndex.end() ){
+			++fMisses;
+			return false;
+		}
+
+		if( fVerify && search->second->fParameters != parameters ){
+			++fMisses;
+			++fCollisions;
+			return false;
+		}
+
+		fEntries.splice(fEntries.begin(), fEntries, search->second);
+		value = search->second->fValue;
+		++fHits;
+
+		return true;
+	}
+
+	/**
+	 * @brief Store \p value for \p key and \p parameters, evicting the least
+	 * recently used entry if the cache is full.
+	 */
+	inline void Insert(size_t key, std::vector<double> const& parameters, Value const& value)
+	{
+		if( fCapacity==0 ) return;
+
+		auto search = fIndex.find(key);
+
+		if( search != fIndex.end() ){
+
+			fEntries.splice(fEntries.begin(), fEntries, search->second);
+		}
+		else {
+
+			if( fEntries.size() >= fCapacity ) Evict(fEntries.size() - fCapacity + 1);
+
+			fEntries.push_front(entry_type());
+			fIndex[key] = fEntries.begin();
+		}
+
+		entry_type& entry = fEntries.front();
+
+		entry.fKey   = key;
+		entry.fValue = value;
+
+		if( fVerify ) entry.fParameters = parameters;
+		else entry.fParameters.clear();
+	}
+
+	inline void Clear()
+	{
+		fEntries.clear();
+		fIndex.clear();
+	}
+
+	inline void ResetCounters()
+	{
+		fHits = 0;
+		fMisses = 0;
+		fCollisions = 0;
+	}
+
+	inline size_t GetSize() const { return fEntries.size(); }
+
+	inline size_t GetCapacity() const { return fCapacity; }
+
+	/**
+	 * @brief Set the maximum number of entries, evicting the least recently
+	 * used ones if the cache holds more.
+	 */
+	inline void SetCapacity(size_t capacity)
+	{
+		fCapacity = capacity;
+
+		if( fEntries.size() > fCapacity ) Evict(fEntries.size() - fCapacity);
+	}
+
+	inline bool IsVerifying() const { return fVerify; }
+
+	/**
+	 * @brief Enable or disable the comparison of the full parameter vector on lookup.
+	 * Changing it clears the cache, as the stored entries may lack the parameters.
+	 */
+	inline void SetVerify(bool verify)
+	{
+		if( verify != fVerify ) Clear();
+
+		fVerify = verify;
+	}
+
+	inline size_t GetHits() const { return fHits; }
+
+	inline size_t GetMisses() const { return fMisses; }
+
+	inline size_t GetCollisions() const { return fCollisions; }
+
+private:
+
+	inline void Evict(size_t n)
+	{
+		for(size_t i=0; i<n && !fEntries.empty(); i++){
+
+			fIndex.erase(fEntries.back().fKey);
+			fEntries.pop_back();
+		}
+	}
+
+	inline void BuildIndex()
+	{
+		fIndex.clear();
+
+		for(auto it = fEntries.begin(); it != fEntries.end(); ++it)
+			fIndex[it->fKey] = it;
+	}
+
+	list_type  fEntries;
+	index_type fIndex;
+	size_t fCapacity;
+	bool   fVerify;
+	size_t fHits;
+	size_t fMisses;
+	size_t fCollisions;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* BOUNDEDCACHE_H_ */
@@ -0,0 +1,224 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ColumnarFile.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COLUMNARFILE_INL_
+#define COLUMNARFILE_INL_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+//POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace hydra {
+
+template<typename ...T>
+ColumnarFile< hydra_thrust::tuple<T...> >::ColumnarFile(std::string const& path):
+	fPath(path),
+	fSize(0),
+	fOpen(false)
+{
+	fColumns.fill(nullptr);
+	fLengths.fill(0);
+
+	auto header = detail::columnar::read_header(path);
+
+	detail::columnar::check_signature(path, header,
+			std::vector<detail::columnar::signature_type>{ detail::columnar::signature<T>()... });
+
+	fSize = header.fNRows;
+	fOpen = true;
+
+	const size_t sizes[sizeof...(T)] = { sizeof(T)... };
+
+	for(size_t i=0; i<sizeof...(T); i++){
+
+		std::string column = detail::columnar::column_path(path, i);
+
+		int fd = ::open(column.c_str(), O_RDONLY);
+
+		if( fd < 0 ){
+
+			Close();
+			throw std::runtime_error("[hydra::ColumnarFile]: can not open column file " + column);
+		}
+
+		struct stat status;
+
+		fLengths[i] = fSize*sizes[i];
+
+		if( ::fstat(fd, &status) != 0 || size_t(status.st_size) < fLengths[i] ){
+
+			::close(fd);
+			fLengths[i] = 0;
+			Close();
+			throw std::runtime_error("[hydra::ColumnarFile]: column file " + column + " is truncated.");
+		}
+
+		if( fLengths[i] > 0 ){
+
+			void* map = ::mmap(nullptr, fLengths[i], PROT_READ, MAP_SHARED, fd, 0);
+
+			if( map == MAP_FAILED ){
+
+				::close(fd);
+				fLengths[i] = 0;
+				Close();
+				throw std::runtime_error("[hydra::ColumnarFile]: can not map column file " + column);
+			}
+
+			::madvise(map, fLengths[i], MADV_SEQUENTIAL);
+
+			const size_t length = fLengths[i];
+
+			//unmapped when the last owner, the file or a running upload, releases it
+			fMappings[i] = std::shared_ptr<void>(map, [length](void* address){ ::munmap(address, length); });
+			fColumns[i]  = map;
+		}
+
+		//the mapping holds its own reference to the file
+		::close(fd);
+	}
+}
+
+template<typename ...T>
+ColumnarFile< hydra_thrust::tuple<T...> >::ColumnarFile(ColumnarFile< hydra_thrust::tuple<T...> >&& other):
+	fPath(other.GetPath()),
+	fSize(other.size()),
+	fOpen(other.IsOpen()),
+	fColumns(other.fColumns),
+	fLengths(other.fLengths),
+	fMappings(std::move(other.fMappings))
+{
+	other.fColumns.fill(nullptr);
+	other.fLengths.fill(0);
+	other.fSize = 0;
+	other.fOpen = false;
+}
+
+template<typename ...T>
+ColumnarFile< hydra_thrust::tuple<T...> >&
+ColumnarFile< hydra_thrust::tuple<T...> >::operator=(ColumnarFile< hydra_thrust::tuple<T...> >&& other)
+{
+	if(this==&other) return *this;
+
+	Close();
+
+	fPath    = other.GetPath();
+	fSize    = other.size();
+	fOpen    = other.IsOpen();
+	fColumns = other.fColumns;
+	fLengths = other.fLengths;
+	fMappings = std::move(other.fMappings);
+
+	other.fColumns.fill(nullptr);
+	other.fLengths.fill(0);
+	other.fSize = 0;
+	other.fOpen = false;
+
+	return *this;
+}
+
+template<typename ...T>
+void ColumnarFile< hydra_thrust::tuple<T...> >::Close()
+{
+	for(size_t i=0; i<sizeof...(T); i++){
+
+		fMappings[i].reset();
+		fColumns[i] = nullptr;
+		fLengths[i] = 0;
+	}
+
+	fSize = 0;
+	fOpen = false;
+}
+
+template<typename ...T>
+void ColumnarFile< hydra_thrust::tuple<T...> >::Prefetch(size_t first, size_t last) const
+{
+	prefetch(fColumns, fLengths, fSize, first, last);
+}
+
+template<typename ...T>
+void ColumnarFile< hydra_thrust::tuple<T...> >::prefetch(std::array<void*, sizeof...(T)> const& columns,
+		std::array<size_t, sizeof...(T)> const& lengths, size_t size, size_t first, size_t last)
+{
+	last = std::min(last, size);
+
+	if( first >= last ) return;
+
+	const size_t page  = ::sysconf(_SC_PAGESIZE);
+	const size_t sizes[sizeof...(T)] = { sizeof(T)... };
+
+	for(size_t i=0; i<sizeof...(T); i++){
+
+		if( columns[i] == nullptr ) continue;
+
+		//madvise wants page aligned addresses
+		size_t begin = (first*sizes[i]/page)*page;
+		size_t end   = std::min(last*sizes[i], lengths[i]);
+
+		::madvise(static_cast<char*>(columns[i]) + begin, end - begin, MADV_WILLNEED);
+	}
+}
+
+template<typename ...T>
+template<typename Iterator>
+typename std::enable_if<detail::is_iterator<Iterator>::value, std::future<size_t>>::type
+ColumnarFile< hydra_thrust::tuple<T...> >::Upload(Iterator output, size_t chunk_size) const
+{
+	if( chunk_size == 0 )
+		throw std::invalid_argument("[hydra::ColumnarFile]: chunk size must be positive.");
+
+	//the task owns copies of the mappings, so it does not depend on this object
+	return std::async(std::launch::async,
+			[data = begin(), size = fSize, columns = fColumns, lengths = fLengths, mappings = fMappings,
+			 output, chunk_size]()
+	{
+		prefetch(columns, lengths, size, 0, chunk_size);
+
+		for(size_t first=0; first < size; first += chunk_size){
+
+			size_t last = std::min(first + chunk_size, size);
+
+			prefetch(columns, lengths, size, last, last + chunk_size);
+
+			hydra_thrust::copy(data + first, data + last, output + first);
+		}
+
+		return size;
+	});
+}
+
+}  // namespace hydra
+
+#endif /* COLUMNARFILE_INL_ */
@@ -0,0 +1,227 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ColumnarFormat.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COLUMNARFORMAT_H_
+#define COLUMNARFORMAT_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef HYDRA_COLUMNAR_CHUNK_SIZE
+#define HYDRA_COLUMNAR_CHUNK_SIZE 1048576
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+namespace columnar {
+
+/*
+ * A dataset stored at "path" is made of a small header file, "path" itself,
+ * and one raw column file per tuple element, "path.0", "path.1"...
+ * Each column file holds the elements of the column back to back, so once
+ * mapped its content is an aligned C array. The header is written after the
+ * columns, so its number of rows never exceeds what is on disk.
+ *
+ * header layout:
+ * char     magic[8]      "HYDRACOL"
+ * uint32_t version
+ * uint32_t byte order   (0x01020304 as written by the producer)
+ * uint64_t number of columns
+ * uint64_t number of rows
+ * per column: uint32_t kind, uint32_t size of the element in bytes
+ */
+
+static const char     magic[8]   = {'H','Y','D','R','A','C','O','L'};
+static const uint32_t version    = 1;
+static const uint32_t byte_order = 0x01020304;
+
+enum kind_type : uint32_t { Opaque=0, Boolean=1, Signed=2, Unsigned=3, Floating=4 };
+
+struct signature_type
+{
+	uint32_t fKind;
+	uint32_t fSize;
+};
+
+struct header_type
+{
+	uint64_t fNRows;
+	std::vector<signature_type> fColumns;
+};
+
+template<typename T>
+inline signature_type signature()
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+			"[hydra::ColumnarFile]: the columns must have trivially copyable types.");
+
+	uint32_t kind = std::is_same<T, bool>::value ? Boolean :
+			std::is_floating_point<T>::value ? Floating :
+			std::is_integral<T>::value ? (std::is_signed<T>::value ? Signed : Unsigned) : Opaque;
+
+	return signature_type{ kind, uint32_t(sizeof(T)) };
+}
+
+inline std::string column_path(std::string const& path, size_t column)
+{
+	return path + "." + std::to_string(column);
+}
+
+inline bool header_exists(std::string const& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+
+	if( file == NULL ) return false;
+
+	std::fclose(file);
+
+	return true;
+}
+
+/*
+ * The header is written to a temporary file renamed over the previous one,
+ * so that readers never see a truncated or partially written header.
+ */
+inline void write_header(std::string const& path, header_type const& header)
+{
+	std::string temporary = path + ".tmp";
+
+	std::FILE* file = std::fopen(temporary.c_str(), "wb");
+
+	if( file == NULL )
+		throw std::runtime_error("[hydra::ColumnarWriter]: can not open header file " + temporary);
+
+	uint64_t ncolumns = header.fColumns.size();
+
+	bool status = std::fwrite(magic, sizeof(magic), 1, file) == 1;
+	status = status && std::fwrite(&version,        sizeof(version),        1, file) == 1;
+	status = status && std::fwrite(&byte_order,     sizeof(byte_order),     1, file) == 1;
+	status = status && std::fwrite(&ncolumns,       sizeof(ncolumns),       1, file) == 1;
+	status = status && std::fwrite(&header.fNRows,  sizeof(header.fNRows),  1, file) == 1;
+
+	for(auto const& column: header.fColumns){
+
+		status = status && std::fwrite(&column.fKind, sizeof(column.fKind), 1, file) == 1;
+		status = status && std::fwrite(&column.fSize, sizeof(column.fSize), 1, file) == 1;
+	}
+
+	status = (std::fclose(file) == 0) && status;
+
+	status = status && std::rename(temporary.c_str(), path.c_str()) == 0;
+
+	if( !status ){
+
+		std::remove(temporary.c_str());
+
+		throw std::runtime_error("[hydra::ColumnarWriter]: can not write header file " + path);
+	}
+}
+
+inline header_type read_header(std::string const& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+
+	if( file == NULL )
+		throw std::runtime_error("[hydra::ColumnarFile]: can not open header file " + path);
+
+	char     file_magic[8];
+	uint32_t file_version    = 0;
+	uint32_t file_byte_order = 0;
+	uint64_t ncolumns = 0;
+
+	header_type header{};
+
+	bool status = std::fread(file_magic, sizeof(file_magic), 1, file) == 1;
+	status = status && std::fread(&file_version,    sizeof(file_version),    1, file) == 1;
+	status = status && std::fread(&file_byte_order, sizeof(file_byte_order), 1, file) == 1;
+	status = status && std::fread(&ncolumns,        sizeof(ncolumns),        1, file) == 1;
+	status = status && std::fread(&header.fNRows,   sizeof(header.fNRows),   1, file) == 1;
+
+	status = status && std::memcmp(file_magic, magic, sizeof(magic)) == 0;
+	status = status && ncolumns < 4096;
+
+	if( status ){
+
+		header.fColumns.resize(ncolumns);
+
+		for(auto& column: header.fColumns){
+
+			status = status && std::fread(&column.fKind, sizeof(column.fKind), 1, file) == 1;
+			status = status && std::fread(&column.fSize, sizeof(column.fSize), 1, file) == 1;
+		}
+	}
+
+	std::fclose(file);
+
+	if( !status )
+		throw std::runtime_error("[hydra::ColumnarFile]: " + path + " is not a Hydra columnar file.");
+
+	if( file_version != version )
+		throw std::runtime_error("[hydra::ColumnarFile]: unsupported format version in " + path);
+
+	if( file_byte_order != byte_order )
+		throw std::runtime_error("[hydra::ColumnarFile]: " + path + " was written with a different byte order.");
+
+	return header;
+}
+
+/*
+ * check the type signature of the file against the columns
+ * requested by the user.
+ */
+inline void check_signature(std::string const& path, header_type const& header,
+		std::vector<signature_type> const& columns)
+{
+	if( header.fColumns.size() != columns.size() )
+		throw std::runtime_error("[hydra::ColumnarFile]: " + path + " has "
+				+ std::to_string(header.fColumns.size()) + " columns, "
+				+ std::to_string(columns.size()) + " were requested.");
+
+	for(size_t i=0; i<columns.size(); i++)
+		if( header.fColumns[i].fKind != columns[i].fKind || header.fColumns[i].fSize != columns[i].fSize )
+			throw std::runtime_error("[hydra::ColumnarFile]: type of column "
+					+ std::to_string(i) + " of " + path + " does not match the requested type.");
+}
+
+}  // namespace columnar
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* COLUMNARFORMAT_H_ */
@@ -0,0 +1,237 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ColumnarWriter.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COLUMNARWRITER_INL_
+#define COLUMNARWRITER_INL_
+
+#include <algorithm>
+#include <stdexcept>
+#include <hydra/detail/Print.h>
+
+//POSIX
+#include <unistd.h>
+
+namespace hydra {
+
+template<typename ...T>
+ColumnarWriter< hydra_thrust::tuple<T...> >::ColumnarWriter(std::string const& path, bool append,
+		size_t buffer_size):
+	fPath(path),
+	fWritten(0),
+	fBuffered(0),
+	fOpen(false),
+	fBuffer(buffer_size)
+{
+	fFiles.fill(NULL);
+
+	if( buffer_size == 0 )
+		throw std::invalid_argument("[hydra::ColumnarWriter]: buffer size must be positive.");
+
+	const std::vector<detail::columnar::signature_type> signature{ detail::columnar::signature<T>()... };
+	const size_t sizes[sizeof...(T)] = { sizeof(T)... };
+
+	append = append && detail::columnar::header_exists(path);
+
+	if( append ){
+
+		auto header = detail::columnar::read_header(path);
+
+		detail::columnar::check_signature(path, header, signature);
+
+		fWritten = header.fNRows;
+	}
+
+	for(size_t i=0; i<sizeof...(T); i++){
+
+		std::string column = detail::columnar::column_path(path, i);
+
+		//drop whatever an interrupted writer left after the last flushed row
+		bool restored = !append || ::truncate(column.c_str(), off_t(fWritten*sizes[i])) == 0;
+
+		fFiles[i] = restored ? std::fopen(column.c_str(), append ? "ab" : "wb") : NULL;
+
+		if( fFiles[i] == NULL ){
+
+			for(auto file: fFiles) if( file != NULL ) std::fclose(file);
+
+			throw std::runtime_error("[hydra::ColumnarWriter]: can not open column file " + column);
+		}
+	}
+
+	fOpen = true;
+
+	detail::columnar::write_header(path, detail::columnar::header_type{ fWritten, signature });
+}
+
+template<typename ...T>
+ColumnarWriter< hydra_thrust::tuple<T...> >::ColumnarWriter(ColumnarWriter< hydra_thrust::tuple<T...> >&& other):
+	fPath(other.GetPath()),
+	fWritten(other.fWritten),
+	fBuffered(other.fBuffered),
+	fOpen(other.IsOpen()),
+	fBuffer(std::move(other.fBuffer)),
+	fFiles(other.fFiles)
+{
+	other.fFiles.fill(NULL);
+	other.fWritten  = 0;
+	other.fBuffered = 0;
+	other.fOpen     = false;
+}
+
+template<typename ...T>
+ColumnarWriter< hydra_thrust::tuple<T...> >&
+ColumnarWriter< hydra_thrust::tuple<T...> >::operator=(ColumnarWriter< hydra_thrust::tuple<T...> >&& other)
+{
+	if(this==&other) return *this;
+
+	Close();
+
+	fPath     = other.GetPath();
+	fWritten  = other.fWritten;
+	fBuffered = other.fBuffered;
+	fOpen     = other.IsOpen();
+	fBuffer   = std::move(other.fBuffer);
+	fFiles    = other.fFiles;
+
+	other.fFiles.fill(NULL);
+	other.fWritten  = 0;
+	other.fBuffered = 0;
+	other.fOpen     = false;
+
+	return *this;
+}
+
+template<typename ...T>
+ColumnarWriter< hydra_thrust::tuple<T...> >::~ColumnarWriter()
+{
+	try {
+
+		Close();
+	}
+	catch(std::exception const& e){
+
+		HYDRA_LOG(ERROR, e.what() )
+	}
+}
+
+template<typename ...T>
+void ColumnarWriter< hydra_thrust::tuple<T...> >::Append(value_type const& value)
+{
+	if( !fOpen )
+		throw std::runtime_error("[hydra::ColumnarWriter]: " + fPath + " is closed.");
+
+	fBuffer.begin()[fBuffered] = value;
+
+	if( ++fBuffered == fBuffer.size() ) Write();
+}
+
+template<typename ...T>
+template<typename Iterator>
+typename std::enable_if<detail::is_iterator<Iterator>::value, void>::type
+ColumnarWriter< hydra_thrust::tuple<T...> >::Append(Iterator first, Iterator last)
+{
+	if( !fOpen )
+		throw std::runtime_error("[hydra::ColumnarWriter]: " + fPath + " is closed.");
+
+	size_t n = hydra_thrust::distance(first, last);
+
+	while( n > 0 ){
+
+		size_t count = std::min(n, fBuffer.size() - fBuffered);
+
+		hydra_thrust::copy(first, first + count, fBuffer.begin() + fBuffered);
+
+		first     += count;
+		n         -= count;
+		fBuffered += count;
+
+		if( fBuffered == fBuffer.size() ) Write();
+	}
+}
+
+template<typename ...T>
+void ColumnarWriter< hydra_thrust::tuple<T...> >::Flush()
+{
+	if( !fOpen ) return;
+
+	Write();
+
+	bool status = true;
+
+	for(auto file: fFiles) status = (std::fflush(file) == 0) && status;
+
+	if( !status )
+		throw std::runtime_error("[hydra::ColumnarWriter]: can not flush the columns of " + fPath);
+
+	//the header goes after the columns are on disk
+	detail::columnar::write_header(fPath, detail::columnar::header_type{ fWritten,
+		std::vector<detail::columnar::signature_type>{ detail::columnar::signature<T>()... } });
+}
+
+template<typename ...T>
+void ColumnarWriter< hydra_thrust::tuple<T...> >::Close()
+{
+	if( !fOpen ) return;
+
+	Flush();
+
+	for(auto& file: fFiles){
+
+		std::fclose(file);
+		file = NULL;
+	}
+
+	fOpen = false;
+}
+
+template<typename ...T>
+void ColumnarWriter< hydra_thrust::tuple<T...> >::Write()
+{
+	if( fBuffered == 0 ) return;
+
+	if( !WriteColumns(indexes_type{}) )
+		throw std::runtime_error("[hydra::ColumnarWriter]: can not write the columns of " + fPath);
+
+	fWritten += fBuffered;
+	fBuffered = 0;
+}
+
+template<typename ...T>
+template<size_t ...I>
+bool ColumnarWriter< hydra_thrust::tuple<T...> >::WriteColumns(detail::index_sequence<I...>)
+{
+	bool status[sizeof...(T)] = {
+		(std::fwrite( &(*fBuffer.begin(placeholders::placeholder<I>())), sizeof(T), fBuffered, fFiles[I]) == fBuffered)...
+	};
+
+	return std::all_of(status, status + sizeof...(T), [](bool s){ return s; });
+}
+
+}  // namespace hydra
+
+#endif /* COLUMNARWRITER_INL_ */
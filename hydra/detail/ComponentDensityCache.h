@@ -0,0 +1,256 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * ComponentDensityCache.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup fit
+ */
+
+#ifndef COMPONENTDENSITYCACHE_H_
+#define COMPONENTDENSITYCACHE_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Parameter.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/utility/DataRange.h>
+
+#include <hydra/detail/external/hydra_thrust/memory.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/detail/type_traits.h>
+
+#include <array>
+#include <vector>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Evaluates a pdf functor including its normalization,
+ * as in AddPdfFunctor.
+ */
+template<typename Functor>
+struct NormalizedComponent
+{
+	NormalizedComponent(Functor const& functor):
+		fFunctor(functor),
+		fNorm(functor.GetNorm())
+	{}
+
+	__hydra_host__ __hydra_device__
+	NormalizedComponent(NormalizedComponent<Functor> const& other):
+		fFunctor(other.fFunctor),
+		fNorm(other.fNorm)
+	{}
+
+	template<typename Type>
+	__hydra_host__ __hydra_device__
+	inline GReal_t operator()(Type&& x) const
+	{
+		return fNorm*fFunctor(x);
+	}
+
+	Functor fFunctor;
+	GReal_t fNorm;
+};
+
+/**
+ * \ingroup fit
+ * \brief Per-event densities of the components of a pdf sum.
+ *
+ * The normalized density of each component is stored in a column of a
+ * buffer allocated on the back-end of the data. On each update, a column
+ * is recomputed only if the parameters or the normalization of its
+ * component changed, so steps varying only the coefficients do not
+ * evaluate the components again. All columns are recomputed if the cache is
+ * updated on another range of data; if the content of the same range is modified,
+ * call Invalidate().
+ *
+ * Copies do not share the buffer; they start empty and are filled on the first update.
+ *
+ * \tparam System back-end of the data.
+ * \tparam N number of components.
+ */
+template<typename System, size_t N>
+class ComponentDensityCache
+{
+	typedef hydra_thrust::pointer<GReal_t, System> pointer_type;
+
+public:
+
+	ComponentDensityCache():
+		fColumns(),
+		fNEntries(0),
+		fNUpdates(0),
+		fRange()
+	{
+		Invalidate();
+	}
+
+	ComponentDensityCache(ComponentDensityCache<System, N> const&):
+		fColumns(),
+		fNEntries(0),
+		fNUpdates(0),
+		fRange()
+	{
+		Invalidate();
+	}
+
+	ComponentDensityCache<System, N>&
+	operator=(ComponentDensityCache<System, N> const& other)
+	{
+		if(this==&other) return *this;
+
+		Release();
+
+		return *this;
+	}
+
+	~ComponentDensityCache()
+	{
+		Release();
+	}
+
+	/**
+	 * @brief Bring the columns up to date with the component functors.
+	 * @return raw pointer to the first column. The column of the i-th
+	 * component starts at i*GetNumberOfEntries().
+	 */
+	template<typename Functors, typename Iterator>
+	inline GReal_t const* Update(Functors const& functors, Iterator begin, Iterator end)
+	{
+		size_t nentries = hydra_thrust::distance(begin, end);
+
+		if( nentries != fNEntries ){
+
+			Release();
+
+			if( nentries > 0 )
+				fColumns = hydra::detail::get_temporary_buffer<GReal_t>(System(), N*nentries).first;
+
+			fNEntries = nentries;
+		}
+
+		//the columns hold the densities of other data
+		if( fRange.Rebind(begin, end) ) Invalidate();
+
+		UpdateColumns(functors, begin, end);
+
+		return hydra_thrust::raw_pointer_cast(fColumns);
+	}
+
+	/**
+	 * @brief Mark all columns to be recomputed on the next update.
+	 */
+	inline void Invalidate()
+	{
+		for(size_t i=0; i<N; i++){
+			fValid[i] = false;
+			fStates[i].clear();
+		}
+	}
+
+	/**
+	 * @brief Free the buffer. It is allocated again on the next update.
+	 */
+	inline void Release()
+	{
+		if( fNEntries > 0 )
+			hydra::detail::return_temporary_buffer(System(), fColumns);
+
+		fColumns  = pointer_type();
+		fNEntries = 0;
+
+		fRange.Reset();
+		Invalidate();
+	}
+
+	inline size_t GetNumberOfEntries() const { return fNEntries; }
+
+	/**
+	 * @brief Number of columns computed since construction.
+	 */
+	inline size_t GetNumberOfUpdates() const { return fNUpdates; }
+
+private:
+
+	template<size_t I=0, typename Functors, typename Iterator>
+	inline typename hydra_thrust::detail::enable_if<(I == N), void>::type
+	UpdateColumns(Functors const&, Iterator, Iterator)
+	{}
+
+	template<size_t I=0, typename Functors, typename Iterator>
+	inline typename hydra_thrust::detail::enable_if<(I < N), void>::type
+	UpdateColumns(Functors const& functors, Iterator begin, Iterator end)
+	{
+		typedef typename hydra_thrust::tuple_element<I, Functors>::type functor_type;
+
+		functor_type functor = hydra_thrust::get<I>(functors);
+
+		//parameters and normalization of the component
+		std::vector<hydra::Parameter*> parameters;
+		functor.AddUserParameters(parameters);
+
+		std::vector<GReal_t> state;
+		state.reserve(parameters.size() + 1);
+
+		for(auto parameter: parameters)
+			state.push_back(parameter->GetValue());
+
+		state.push_back(functor.GetNorm());
+
+		if( !fValid[I] || state != fStates[I] ){
+
+			hydra_thrust::transform(System(), begin, end, fColumns + I*fNEntries,
+					NormalizedComponent<functor_type>(functor));
+
+			fStates[I] = state;
+			fValid[I]  = true;
+
+			++fNUpdates;
+		}
+
+		UpdateColumns<I+1>(functors, begin, end);
+	}
+
+	pointer_type fColumns;
+	size_t fNEntries;
+	size_t fNUpdates;
+	DataRange fRange;
+	std::array<bool, N> fValid;
+	std::array<std::vector<GReal_t>, N> fStates;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* COMPONENTDENSITYCACHE_H_ */
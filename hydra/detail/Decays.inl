@@ -34,6 +34,7 @@
 #include <hydra/Vector4R.h>
 #include <hydra/Tuple.h>
 #include <hydra/Function.h>
+#include <hydra/MemoryPool.h>
 
 namespace hydra {
 
@@ -431,7 +432,7 @@ Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<Backend>>::Unwei
 	hydra_thrust::counting_iterator < size_t > first(0);
 	hydra_thrust::counting_iterator < size_t > last(ntrials);
 
-	auto sequence = hydra_thrust::get_temporary_buffer<size_t>(system_type(), ntrials);
+	auto sequence = hydra::detail::get_temporary_buffer<size_t>(system_type(), ntrials);
 	hydra_thrust::copy(first, last, sequence.first);
 
 	//re-sort the container to build up un-weighted sample
@@ -446,7 +447,7 @@ Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<Backend>>::Unwei
 
 	auto end_of_range = hydra_thrust::distance(start, middle);
 
-	hydra_thrust::return_temporary_buffer(system_type(), sequence.first  );
+	hydra::detail::return_temporary_buffer(system_type(), sequence.first  );
 
 	//done!
 	//return (size_t) hydra_thrust::distance(begin(), middle);
@@ -480,7 +481,7 @@ typedef detail::FlagDaugthers< reweight_functor> tagger_type;
 	hydra_thrust::counting_iterator < size_t > first(0);
 	hydra_thrust::counting_iterator < size_t > last(ntrials);
 
-	auto sequence  = hydra_thrust::get_temporary_buffer<size_t>(system_type(), ntrials);
+	auto sequence  = hydra::detail::get_temporary_buffer<size_t>(system_type(), ntrials);
 	hydra_thrust::copy(first, last, sequence.first);
 
 	//--------------------
@@ -502,7 +503,7 @@ typedef detail::FlagDaugthers< reweight_functor> tagger_type;
 
 	auto end_of_range = hydra_thrust::distance(start, middle);
 
-	hydra_thrust::return_temporary_buffer(system_type(), sequence.first  );
+	hydra::detail::return_temporary_buffer(system_type(), sequence.first  );
 
 	//done!
 
@@ -511,6 +512,76 @@ typedef detail::FlagDaugthers< reweight_functor> tagger_type;
 }
 
 
+template<typename ...Particles,   hydra::detail::Backend Backend>
+template<hydra::detail::Backend BACKEND2>
+hydra::Range<typename Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<BACKEND2>>::iterator>
+Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<Backend>>::Unweight(
+		Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<BACKEND2>>& output,
+		size_t seed, size_t chunk_size)
+{
+	return UnweightInto(this->GetEventWeightFunctor(), output, fMaxWeight, seed, chunk_size);
+}
+
+template<typename ...Particles,   hydra::detail::Backend Backend>
+template<typename Functor, hydra::detail::Backend BACKEND2>
+typename std::enable_if<
+ 	detail::is_hydra_functor<Functor>::value ||
+ 	detail::is_hydra_lambda<Functor>::value  ||
+ 	detail::is_hydra_composite_functor<Functor>::value,
+	hydra::Range<typename Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<BACKEND2>>::iterator>>::type
+Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<Backend>>::Unweight( Functor  const& functor,
+		Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<BACKEND2>>& output,
+		double max_weight, size_t seed, size_t chunk_size)
+{
+	return UnweightInto(this->GetEventWeightFunctor(functor), output, max_weight, seed, chunk_size);
+}
+
+template<typename ...Particles,   hydra::detail::Backend Backend>
+template<typename WeightFunctor, typename Container>
+hydra::Range<decltype(std::declval<Container&>().begin())>
+Decays<hydra::tuple<Particles...>, hydra::detail::BackendPolicy<Backend>>::UnweightInto(WeightFunctor const& weight_functor,
+		Container& output, double max_weight, size_t seed, size_t chunk_size)
+{
+	system_type system;
+
+	size_t ntrials = fDecays.size();
+	size_t offset  = output.size();
+
+	chunk_size = chunk_size > 0 ? chunk_size : 1;
+
+	if( ntrials==0 ) return hydra::make_range(output.begin() + offset, output.end());
+
+	//without the maximum, the weights of all events are stored, to be computed only once
+	bool estimate = !(max_weight > 0.0);
+
+	size_t nweights = estimate || ntrials < chunk_size ? ntrials : chunk_size;
+
+	auto weights = hydra::detail::get_temporary_buffer<double>(system, nweights);
+
+	if( estimate ){
+
+		hydra_thrust::transform(system, fDecays.begin(), fDecays.end(), weights.first, weight_functor);
+
+		max_weight = *(hydra_thrust::max_element(system, weights.first, weights.first + ntrials));
+	}
+
+	for(size_t first = 0; first < ntrials; first += chunk_size ){
+
+		size_t n = chunk_size < ntrials - first ? chunk_size : ntrials - first;
+
+		auto chunk = fDecays.begin() + first;
+
+		if( !estimate )
+			hydra_thrust::transform(system, chunk, chunk + n, weights.first, weight_functor);
+
+		detail::append_accepted(system, chunk, estimate ? weights.first + first : weights.first, n, first,
+				max_weight, seed, output);
+	}
+
+	hydra::detail::return_temporary_buffer(system, weights.first);
+
+	return hydra::make_range(output.begin() + offset, output.end());
+}
 
 }  // namespace hydra
 
@@ -34,6 +34,7 @@
 #include <hydra/detail/external/hydra_thrust/gather.h>
 #include <hydra/detail/external/hydra_thrust/scatter.h>
 #include <hydra/detail/functors/GetGlobalBin.h>
+#include <hydra/detail/HistogramFill.h>
 #include <hydra/detail/utility/Utility_Tuple.h>
 #include <hydra/Distance.h>
 #include <hydra/detail/external/hydra_thrust/iterator/constant_iterator.h>
@@ -41,6 +42,8 @@
 #include <hydra/detail/external/hydra_thrust/system/detail/generic/select_system.h>
 #include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
 
+#include <stdexcept>
+
 namespace hydra {
 
 template< typename T, size_t N, hydra::detail::Backend BACKEND>
@@ -57,51 +60,12 @@ DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem, system1, system2 ))>::type common_system_t;
 
-
-    //----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of weights
-
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-
-	hydra_thrust::sort_by_key(key_buffer.first, key_buffer.first + key_buffer.second, weights.first );
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, wbegin, fContents.begin(), fAccumulate);
 
-
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(), key_buffer.first,
-			key_buffer.first + key_buffer.second, weights.first, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::scatter( common_system_t(),  reduced_values.first, reduced_end.second,
-			reduced_keys.first,bin_contents.first );
-
-	hydra_thrust::copy(bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-
-    return *this;
+	return *this;
 }
 
 
@@ -120,51 +84,12 @@ DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy,fSystem, system1, system2 ))>::type common_system_t;
 
-
-    //----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of weights
-
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-
-	hydra_thrust::sort_by_key(key_buffer.first, key_buffer.first + key_buffer.second, weights.first );
-
-
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, wbegin, fContents.begin(), fAccumulate);
 
-	hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(), keys_begin, keys_end, weights.first,
-    		reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::scatter( common_system_t(),  reduced_values.first, reduced_end.second,
-			reduced_keys.first,bin_contents.first );
-
-	hydra_thrust::copy(bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-
-    return *this;
+	return *this;
 }
 
 
@@ -180,47 +105,12 @@ DenseHistogram<T, N,  hydra::detail::BackendPolicy<BACKEND>, detail::multidimens
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem, system1 ))>::type common_system_t;
 
+	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-		typedef hydra_thrust::pointer<T, common_system_t> buffer_t;
-
-		size_t data_size = hydra_thrust::distance(begin, end);
-
-		auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
-
-		auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-		auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-		auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-
-		hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-		hydra_thrust::sort(key_buffer.first, key_buffer.first+data_size);
-
-
-		//bins content
-		auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-		auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-		auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-		auto weights         = hydra_thrust::constant_iterator<double>(1.0);
-
-		auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-				key_buffer.first, key_buffer.first+data_size,
-				weights, reduced_keys.first, reduced_values.first);
-
-		hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-		hydra_thrust::scatter( common_system_t(),  reduced_values.first, reduced_end.second,
-			  reduced_keys.first, bin_contents.first );
-
-		hydra_thrust::copy(bin_contents.first ,
-				bin_contents.first+ bin_contents.second,  fContents.begin());
-
-	    // deallocate storage with hydra_thrust::return_temporary_buffer
-		hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-		hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-	    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fContents.begin(), fAccumulate);
 
-	    return *this;
+	return *this;
 }
 
 template<typename T, size_t N, hydra::detail::Backend BACKEND>
@@ -228,53 +118,19 @@ template<hydra::detail::Backend BACKEND2, typename Iterator>
 DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>&
 DenseHistogram<T, N,  hydra::detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(detail::BackendPolicy<BACKEND2> const& exec_policy, Iterator begin, Iterator end )
 {
+	using hydra_thrust::system::detail::generic::select_system;
 	typedef  typename hydra_thrust::iterator_system<Iterator>::type system1_t;
-		system1_t system1;
-
-		typedef  typename hydra_thrust::detail::remove_reference<
-					decltype(select_system(exec_policy,fSystem, system1))>::type common_system_t;
-
-		typedef hydra_thrust::pointer<T, common_system_t> buffer_t;
-
-		size_t data_size = hydra_thrust::distance(begin, end);
-
-		auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
-
-		auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-		auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-		auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-
-		hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-		hydra_thrust::sort(key_buffer.first, key_buffer.first+data_size);
-
-
-		//bins content
-		auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-		auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-		auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-		auto weights         = hydra_thrust::constant_iterator<double>(1.0);
-
-		auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-				key_buffer.first, key_buffer.first+data_size,
-				weights, reduced_keys.first, reduced_values.first);
-
-		hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-		hydra_thrust::scatter( common_system_t(),  reduced_values.first, reduced_end.second,
-			  reduced_keys.first, bin_contents.first );
+	system1_t system1;
 
+	typedef  typename hydra_thrust::detail::remove_reference<
+			decltype(select_system(exec_policy,fSystem, system1))>::type common_system_t;
 
-		hydra_thrust::copy(bin_contents.first ,
-				bin_contents.first+ bin_contents.second,  fContents.begin());
+	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	    // deallocate storage with hydra_thrust::return_temporary_buffer
-		hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-		hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-	    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fContents.begin(), fAccumulate);
 
-	    return *this;
+	return *this;
 }
 
 
@@ -290,107 +146,37 @@ DenseHistogram< T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fi
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem, system1 ))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort(key_buffer.first, key_buffer.first+data_size );
-
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fContents.begin(), fAccumulate);
 
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-	auto  weights    = hydra_thrust::constant_iterator<size_t>(1.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-	hydra_thrust::scatter( common_system_t(), reduced_values.first, reduced_end.second,
-		  reduced_keys.first, bin_contents.first);
-
-	hydra_thrust::copy(bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
-
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-    return *this;
+	return *this;
 }
 
 
-
-
 template<typename T, hydra::detail::Backend BACKEND>
 template<hydra::detail::Backend BACKEND2, typename Iterator>
 DenseHistogram< T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional>&
 DenseHistogram< T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(detail::BackendPolicy<BACKEND2> const& exec_policy,
 		Iterator begin, Iterator end )
 {
+	using hydra_thrust::system::detail::generic::select_system;
 	typedef  typename hydra_thrust::iterator_system<Iterator>::type system1_t;
 	system1_t system1;
 
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy, fSystem,system1))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort(key_buffer.first, key_buffer.first+data_size );
-
-
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-	auto  weights    = hydra_thrust::constant_iterator<size_t>(1.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights, reduced_keys.first, reduced_values.first);
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fContents.begin(), fAccumulate);
 
-	hydra_thrust::fill(bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-	hydra_thrust::scatter( common_system_t(), reduced_values.first, reduced_end.second,
-		  reduced_keys.first, bin_contents.first);
-
-	hydra_thrust::copy(bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
-
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-    return *this;
+	return *this;
 }
 
 
-
 template<typename T, hydra::detail::Backend BACKEND>
 template<typename Iterator1, typename Iterator2>
 DenseHistogram<T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional>&
@@ -405,53 +191,15 @@ DenseHistogram<T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fil
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem,system1, system2 ))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(),  keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key(common_system_t(), key_buffer.first, key_buffer.first+data_size, weights.first);
-
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights.first, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::fill( common_system_t(), bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
-
-	hydra_thrust::scatter( common_system_t(), reduced_values.first, reduced_end.second,
-		  reduced_keys.first, bin_contents.first);
-
-	hydra_thrust::copy( bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, wbegin, fContents.begin(), fAccumulate);
 
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-    return *this;
+	return *this;
 }
 
 
-
-
 template<typename T, hydra::detail::Backend BACKEND>
 template<hydra::detail::Backend BACKEND2, typename Iterator1, typename Iterator2>
 DenseHistogram<T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional >&
@@ -467,48 +215,106 @@ DenseHistogram<T,1, detail::BackendPolicy<BACKEND>, detail::unidimensional >::Fi
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy, fSystem,system1, system2 ))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
+	detail::fill_histogram(common_system_t(), fContents.size(), key_functor,
+			begin, end, wbegin, fContents.begin(), fAccumulate);
+
+	return *this;
+}
+
+template<typename T, size_t N, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(Generator&& generator, Iterable&& buffer)
+{
+	if( !fAccumulate ) Reset();
+
+	detail::AccumulateGuard guard(fAccumulate);
+
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
+	size_t chunk_size = 0;
 
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
+	while( (chunk_size = generator(buffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size);
 
-	hydra_thrust::copy(common_system_t(),  keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key(common_system_t(), key_buffer.first, key_buffer.first+data_size, weights.first);
+	return *this;
+}
+
+template<typename T, size_t N, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable1, typename Iterable2>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+hydra::detail::is_iterable<Iterable2>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+                                  decltype(std::declval<Iterable2&>().begin())>::value,
+DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+DenseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(Generator&& generator,
+		Iterable1&& buffer, Iterable2&& wbuffer)
+{
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
 
-	//bins content
-	auto bin_contents    = hydra_thrust::get_temporary_buffer<double>(common_system_t(), fContents.size());
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
+	if( size_t(hydra_thrust::distance(wbuffer.begin(), wbuffer.end())) < capacity )
+		throw std::invalid_argument("hydra::DenseHistogram::Fill: the weight buffer is smaller than the data buffer.");
 
+	if( !fAccumulate ) Reset();
 
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights.first, reduced_keys.first, reduced_values.first);
+	detail::AccumulateGuard guard(fAccumulate);
+
+	size_t chunk_size = 0;
+
+	while( (chunk_size = generator(buffer.begin(), wbuffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size, wbuffer.begin());
+
+	return *this;
+}
+
+template<typename T, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+DenseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+DenseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(Generator&& generator, Iterable&& buffer)
+{
+	if( !fAccumulate ) Reset();
+
+	detail::AccumulateGuard guard(fAccumulate);
+
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
+	size_t chunk_size = 0;
+
+	while( (chunk_size = generator(buffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size);
+
+	return *this;
+}
+
+template<typename T, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable1, typename Iterable2>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+hydra::detail::is_iterable<Iterable2>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+                                  decltype(std::declval<Iterable2&>().begin())>::value,
+DenseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+DenseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(Generator&& generator,
+		Iterable1&& buffer, Iterable2&& wbuffer)
+{
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
 
-	hydra_thrust::fill( common_system_t(), bin_contents.first, bin_contents.first+bin_contents.second, 0.0);
+	if( size_t(hydra_thrust::distance(wbuffer.begin(), wbuffer.end())) < capacity )
+		throw std::invalid_argument("hydra::DenseHistogram::Fill: the weight buffer is smaller than the data buffer.");
 
-	hydra_thrust::scatter( common_system_t(), reduced_values.first, reduced_end.second,
-		  reduced_keys.first, bin_contents.first);
+	if( !fAccumulate ) Reset();
 
-	hydra_thrust::copy( common_system_t(), bin_contents.first ,
-			bin_contents.first+ bin_contents.second,  fContents.begin());
+	detail::AccumulateGuard guard(fAccumulate);
 
+	size_t chunk_size = 0;
 
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), bin_contents.first );
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
+	while( (chunk_size = generator(buffer.begin(), wbuffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size, wbuffer.begin());
 
-    return *this;
+	return *this;
 }
 
 /*
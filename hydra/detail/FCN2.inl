@@ -39,10 +39,11 @@ namespace hydra {
  * \tparam Iterators more iterators pointing to weights, cache etc.
  */
 template< template<typename ...> class Estimator, typename PDF, typename Iterator>
-class FCN<Estimator<PDF,Iterator>, true>: public ROOT::Minuit2::FCNBase
+class FCN<Estimator<PDF,Iterator>, true>: public detail::fcn_minuit_base<PDF>
 {
 
 	typedef Estimator<PDF,Iterator> estimator_type;
+	typedef detail::fcn_minuit_base<PDF> minuit_base_type;
 
 public:
 
@@ -55,7 +56,7 @@ public:
 	fBegin(begin ),
 	fEnd(end),
 	fErrorDef(0.5),
-	fFCNCache(std::unordered_map<size_t, GReal_t>()),
+	fFCNCache(),
 	fFCNMaxValue(std::numeric_limits<GReal_t>::min())
 	{
 		fDataSize = hydra_thrust::distance(fBegin, fEnd);
@@ -64,7 +65,7 @@ public:
 
 
 	FCN(FCN<estimator_type, true> const& other):
-	ROOT::Minuit2::FCNBase(other),
+	minuit_base_type(other),
 	fDataSize(other.GetDataSize()),
 	fPDF(other.GetPDF()),
 	fBegin(other.GetBegin()),
@@ -82,7 +83,7 @@ public:
 
 		if( this==&other ) return this;
 
-		ROOT::Minuit2::FCNBase::operator=(other);
+		minuit_base_type::operator=(other);
 		fDataSize = other.GetDataSize();
 		fPDF   = other.GetPDF();
 		fBegin = other.GetBegin();
@@ -129,6 +130,109 @@ public:
 
 	}
 
+	/**
+	 * @brief Gradient of the FCN with respect to the Minuit parameters.
+	 *
+	 * The FCN derives from ROOT::Minuit2::FCNGradientBase, and Minuit uses this gradient
+	 * instead of its own finite differences, when the functor of the model implements
+	 * `EvaluateWithParameters` (see hydra::BaseFunctor::CallWithParameters). The value and
+	 * all the derivatives then come out of the same pass over the data. Only hydra::Gaussian
+	 * and hydra::Exponential implement it among the shipped functors. For the other single
+	 * pdfs, HYDRA_FCN_BATCHED_GRADIENT enables the same interface using NumericalGradient().
+	 * Sums of pdfs (PDFSumExtendable, PDFSumNonExtendable) and composite pdfs derive from
+	 * ROOT::Minuit2::FCNBase, and Minuit falls back to its numerical gradient.
+	 */
+	std::vector<double> Gradient(const std::vector<double>& parameters) const {
+
+		return GetGradient(parameters, detail::is_differentiable_pdf<PDF>{});
+	}
+
+	/**
+	 * @brief Values of the FCN at the parameter points @p points.
+	 *
+	 * The model is evaluated at HYDRA_FCN_BATCH_SIZE points per event, so the dataset is
+	 * read once per batch of points instead of once per point. Values found in the FCN
+	 * cache are not recomputed and the new ones are stored in it.
+	 */
+	std::vector<GReal_t> GetFCNValues(const std::vector<std::vector<double>>& points) const {
+
+		std::vector<GReal_t> values(points.size(), 0.0);
+
+		std::vector<std::vector<double>> missing;
+		std::vector<size_t> positions;
+
+		for(size_t i=0; i<points.size(); i++){
+
+			size_t key = hydra::detail::hash_range(points[i].begin(), points[i].end());
+
+			if( fFCNCache.Get(key, points[i], values[i]) ) continue;
+
+			missing.push_back(points[i]);
+			positions.push_back(i);
+		}
+
+		if( !missing.empty() ){
+
+			std::vector<double> computed = static_cast<const estimator_type*>(this)->Eval(missing);
+
+			for(size_t i=0; i<missing.size(); i++)
+				values[positions[i]] = computed[i];
+		}
+
+		//the invalid values are replaced by the largest one, including those of this batch
+		for(auto value: values)
+			if( std::isnormal(value) && value > fFCNMaxValue ) fFCNMaxValue=value;
+
+		for(auto& value: values)
+			if( !std::isnormal(value) ) value = fFCNMaxValue;
+
+		for(size_t i=0; i<missing.size(); i++){
+
+			size_t key = hydra::detail::hash_range(missing[i].begin(), missing[i].end());
+
+			fFCNCache.Insert(key, missing[i], values[positions[i]]);
+		}
+
+		return values;
+	}
+
+	/**
+	 * @brief Central-difference gradient of the FCN, with the 2N points
+	 * of the N free parameters evaluated by GetFCNValues.
+	 */
+	std::vector<double> NumericalGradient(const std::vector<double>& parameters) const {
+
+		std::vector<std::vector<double>> points;
+		std::vector<size_t> indexes;
+		std::vector<double> steps;
+
+		detail::numerical_gradient_points(parameters, fUserParameters.GetVariables(),
+				points, indexes, steps);
+
+		std::vector<GReal_t> values = GetFCNValues(points);
+
+		std::vector<double> gradient(parameters.size(), 0.0);
+
+		for(size_t k=0; k<indexes.size(); k++)
+			gradient[indexes[k]] = (values[2*k] - values[2*k+1])/(2.0*steps[k]);
+
+		return gradient;
+	}
+
+	/**
+	 * @brief Likelihood scan: values of the FCN at @p parameters, with the parameter
+	 * of index @p index set to each element of @p values.
+	 */
+	std::vector<GReal_t> Scan(const std::vector<double>& parameters, size_t index,
+			const std::vector<double>& values) const {
+
+		std::vector<std::vector<double>> points(values.size(), parameters);
+
+		for(size_t i=0; i<values.size(); i++) points[i][index] = values[i];
+
+		return GetFCNValues(points);
+	}
+
 	//this class
 	GReal_t GetErrorDef() const {
 		return fErrorDef;
@@ -142,12 +246,17 @@ public:
 		return fEnd;
 	}
 
+	//the cached FCN values belong to the previous data
 	void SetBegin(Iterator begin) {
 		fBegin = begin;
+		fDataSize = hydra_thrust::distance(fBegin, fEnd);
+		fFCNCache.Clear();
 	}
 
 	void SetEnd(Iterator end) {
 		fEnd = end;
+		fDataSize = hydra_thrust::distance(fBegin, fEnd);
+		fFCNCache.Clear();
 	}
 
 	PDF& GetPDF() {
@@ -195,41 +304,73 @@ public:
 			fFCNMaxValue = fcnMaxValue;
 		}
 
-private:
-
-	std::unordered_map<size_t, GReal_t>& GetFcnCache() const {
+	/**
+	 * @brief Bounded cache of FCN values, keyed on the hash of the parameters.
+	 * Use it to set the capacity, enable verification of the full parameter
+	 * vector and read the hit/miss counters.
+	 */
+	hydra::detail::BoundedCache<GReal_t>& GetFcnCache() const {
 		return fFCNCache;
 	}
 
-	void SetFcnCache(std::unordered_map<size_t, GReal_t> fcnCache) {
+	void SetFcnCache(hydra::detail::BoundedCache<GReal_t> const& fcnCache) {
 		fFCNCache = fcnCache;
 	}
 
-	GReal_t GetFCNValue(const std::vector<double>& parameters) const {
+private:
+
+	std::vector<double> GetGradient(const std::vector<double>& parameters, std::false_type) const {
+
+		return NumericalGradient(parameters);
+	}
+
+	std::vector<double> GetGradient(const std::vector<double>& parameters, std::true_type) const {
+
+		std::vector<double> gradient(parameters.size(), 0.0);
+
+		GReal_t fcn_value = static_cast<const estimator_type*>(this)->EvalGradient(parameters, gradient);
+
+		if(!std::isnormal(fcn_value)){
+
+			if (INFO >= Print::Level()  )
+			{
+				std::ostringstream stringStream;
+				stringStream << "NaN found. Returning null gradient." << std::endl;
+				HYDRA_LOG(INFO, stringStream.str().c_str() )
+			}
+
+			return std::vector<double>(parameters.size(), 0.0);
+		}
 
 		size_t key = hydra::detail::hash_range(parameters.begin(),parameters.end());
 
-		auto search = fFCNCache.find(key);
+		fFCNCache.Insert(key, parameters, fcn_value);
+
+		return gradient;
+	}
+
+	GReal_t GetFCNValue(const std::vector<double>& parameters) const {
+
+		size_t key = hydra::detail::hash_range(parameters.begin(),parameters.end());
 
 		GReal_t value = 0.0;
 
-		if (search != fFCNCache.end() && fFCNCache.size()>0) {
+		if ( fFCNCache.Get(key, parameters, value) ) {
 
 			if (INFO >= Print::Level()  )
 			{
 				std::ostringstream stringStream;
 				stringStream <<" Found in cache: key "
-						     <<  search->first
-						     << " value "
-						     << search->second << std::endl;
+						<<  key
+						<< " value "
+						<< value << std::endl;
 				HYDRA_LOG(INFO, stringStream.str().c_str() )
 			}
-
-			value = search->second;
 		}
 		else {
 			value = EvalFCN(parameters);
-			fFCNCache[key] = value;
+
+			fFCNCache.Insert(key, parameters, value);
 
 			if (INFO >= Print::Level()  )
 			{
@@ -262,7 +403,7 @@ private:
     GReal_t  fErrorDef;
     mutable GReal_t   fFCNMaxValue;
     hydra::UserParameters fUserParameters ;
-    mutable std::unordered_map<size_t, GReal_t> fFCNCache;
+    mutable hydra::detail::BoundedCache<GReal_t> fFCNCache;
 
 
 };
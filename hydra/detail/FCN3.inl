@@ -34,15 +34,30 @@
 #define FCN3_INL_
 
 #include <algorithm>
-#include <future>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include <hydra/detail/EstimatorTraits.h>
+#include <hydra/detail/WorkerPool.h>
+#include <hydra/detail/utility/Exception.h>
 
 namespace hydra {
 
 /**
  * \ingroup fit
+ * \brief Simultaneous FCN, summing up the values of a set of FCNs.
+ *
+ * By default, the sub-FCNs are evaluated concurrently by a pool of threads kept alive
+ * with the object, one per sub-FCN. On the OMP and TBB back-ends, each sub-FCN runs with
+ * its share of the cores, set with SetThreads(...); by default the cores are split evenly.
+ * With SetSequential(true), the sub-FCNs are evaluated one after the other in the calling
+ * thread, each one using all the cores.
+ * The time spent in each sub-FCN is recorded and can be used to rebalance the cores with
+ * RebalanceThreads().
+ *
  * \tparam Estimators estimator base classes
  */
 template<typename ...ESTIMATORS>
@@ -59,20 +74,35 @@ public:
 
 	FCN( FCN<ESTIMATORS>const&... fcns):
 		fErrorDef(0.5),
-		fFCNS( hydra_thrust::make_tuple( fcns...))
+		fFCNS( hydra_thrust::make_tuple( fcns...)),
+		fSequential(false),
+		fThreads(nfcns, 0),
+		fNCalls(nfcns, 0),
+		fTotalTime(nfcns, 0.0),
+		fMaxTime(nfcns, 0.0)
 	{
 		std::initializer_list<double> error_defs{fcns.GetErrorDef()...};
 
 		fErrorDef = *std::min_element( error_defs.begin(),  error_defs.end());
 
+		size_t ncores = std::thread::hardware_concurrency();
+
+		for(size_t i=0; i<nfcns; i++)
+			fThreads[i] = ncores/nfcns > 0 ? ncores/nfcns : 1;
+
 		LoadFCNParameters();
 	}
 
 
 	FCN(FCN<estimator_type, false> const& other):
 		ROOT::Minuit2::FCNBase(other),
+		fErrorDef(other.GetErrorDef()),
 		fFCNS(other.GetFCNS()),
-		fErrorDef(other.GetErrorDef())
+		fSequential(other.IsSequential()),
+		fThreads(other.GetThreads()),
+		fNCalls(nfcns, 0),
+		fTotalTime(nfcns, 0.0),
+		fMaxTime(nfcns, 0.0)
 	{
 		LoadFCNParameters();
 	}
@@ -87,6 +117,9 @@ public:
 		ROOT::Minuit2::FCNBase::operator=(other);
 		fFCNS=other.GetFCNS();
 		fErrorDef=other.GetErrorDef();
+		fSequential=other.IsSequential();
+		fThreads=other.GetThreads();
+		ResetTimers();
 		LoadFCNParameters();
 
 		return  *this;
@@ -120,6 +153,97 @@ public:
 		return fErrorDef;
 	}
 
+	/**
+	 * \brief Evaluate the sub-FCNs one after the other in the calling thread,
+	 * each one with all the cores, instead of concurrently.
+	 */
+	void SetSequential(bool sequential) {
+		fSequential = sequential;
+	}
+
+	bool IsSequential() const {
+		return fSequential;
+	}
+
+	/**
+	 * \brief Set the number of OMP or TBB threads given to each sub-FCN
+	 * when they are evaluated concurrently. Zero means no limit.
+	 */
+	void SetThreads(std::vector<size_t> const& threads) {
+
+		if( threads.size() != nfcns ){
+
+			HYDRA_EXCEPTION("hydra::FCN : the number of thread counts differs from the number of FCNs. Returning without doing nothing.");
+			return;
+		}
+
+		fThreads = threads;
+	}
+
+	std::vector<size_t> const& GetThreads() const {
+		return fThreads;
+	}
+
+	/**
+	 * \brief Split the cores among the sub-FCNs proportionally to
+	 * the mean time spent in each one so far.
+	 */
+	void RebalanceThreads() {
+
+		double total = 0.0;
+
+		for(size_t i=0; i<nfcns; i++)
+			total += GetMeanTime(i);
+
+		if( !(total > 0.0) ) return;
+
+		size_t ncores = std::thread::hardware_concurrency();
+
+		for(size_t i=0; i<nfcns; i++){
+
+			size_t n = size_t( ncores*GetMeanTime(i)/total + 0.5 );
+
+			fThreads[i] = n > 0 ? n : 1;
+		}
+	}
+
+	/**
+	 * \brief Number of evaluations of the i-th sub-FCN.
+	 */
+	size_t GetNumberOfCalls(size_t i) const {
+		return fNCalls[i];
+	}
+
+	/**
+	 * \brief Total time, in milliseconds, spent evaluating the i-th sub-FCN.
+	 */
+	double GetTotalTime(size_t i) const {
+		return fTotalTime[i];
+	}
+
+	/**
+	 * \brief Mean time, in milliseconds, of the evaluations of the i-th sub-FCN.
+	 */
+	double GetMeanTime(size_t i) const {
+		return fNCalls[i] > 0 ? fTotalTime[i]/fNCalls[i] : 0.0;
+	}
+
+	/**
+	 * \brief Longest evaluation, in milliseconds, of the i-th sub-FCN.
+	 */
+	double GetMaxTime(size_t i) const {
+		return fMaxTime[i];
+	}
+
+	void ResetTimers() {
+
+		for(size_t i=0; i<nfcns; i++){
+			fNCalls[i]    = 0;
+			fTotalTime[i] = 0.0;
+			fMaxTime[i]   = 0.0;
+		}
+	}
+
 	virtual double operator()(std::vector<double> const& parameters) const {
 
 		return InvokeFCNS(parameters);
@@ -153,39 +277,73 @@ private:
 	}
 
 	template<size_t I>
-	typename std::enable_if< (I==nfcns), void>::type
-	add_tasks( std::vector<double> const& parameters, std::vector<std::future<double>>&  ) const {}
+	typename std::enable_if< (I==nfcns), double>::type
+	invoke_fcn_helper(size_t, std::vector<double> const&) const { return 0.0; }
 
 	template<size_t I=0>
-	typename std::enable_if< (I<nfcns), void>::type
-	add_tasks(std::vector<double> const& parameters, std::vector<std::future<double>>& tasks ) const
+	typename std::enable_if< (I<nfcns), double>::type
+	invoke_fcn_helper(size_t i, std::vector<double> const& parameters) const
+	{
+		return i==I ? hydra_thrust::get<I>(fFCNS)(parameters) : invoke_fcn_helper<I+1>(i, parameters);
+	}
+
+	double InvokeFCN(size_t i, std::vector<double> const& parameters) const
 	{
-		tasks.push_back(std::async(
-				std::launch::async,
-				[this](std::vector<double> const& p) {
-		        	return hydra_thrust::get<I>(fFCNS)(p);
-		        },
-				parameters ) );
+		auto start = std::chrono::high_resolution_clock::now();
 
-		add_tasks<I+1>(parameters, tasks );
+		double result = invoke_fcn_helper(i, parameters);
+
+		auto stop = std::chrono::high_resolution_clock::now();
+
+		double elapsed = std::chrono::duration<double, std::milli>(stop - start).count();
+
+		//each sub-FCN is evaluated by a single thread at a time
+		fNCalls[i]    += 1;
+		fTotalTime[i] += elapsed;
+		fMaxTime[i]    = elapsed > fMaxTime[i] ? elapsed : fMaxTime[i];
+
+		return result;
 	}
 
 	double InvokeFCNS(std::vector<double> const& parameters) const
 	{
-		 std::vector<std::future<double>> tasks;
-		 add_tasks( parameters,  tasks);
-		 double result = 0;
-		 for(auto& partial_result: tasks){
-			 partial_result.wait();
-			 result += partial_result.get();
-		 }
-		 return result;
+		double result = 0;
+
+		if( fSequential || nfcns==1 ){
+
+			for(size_t i=0; i<nfcns; i++)
+				result += InvokeFCN(i, parameters);
+
+			return result;
+		}
+
+		if( !fPool ) fPool.reset( new detail::WorkerPool(nfcns) );
+
+		std::vector<double> partial_results(nfcns, 0.0);
+
+		fPool->Run(nfcns, [this, &parameters, &partial_results](size_t i){
+
+			detail::run_with_threads(fThreads[i], [this, &parameters, &partial_results, i](){
+
+				partial_results[i] = InvokeFCN(i, parameters);
+			});
+		});
+
+		for(auto partial_result: partial_results)
+			result += partial_result;
 
+		return result;
 	}
 
 	double fErrorDef;
 	estimator_type fFCNS;
 	UserParameters fUserParameters ;
+	bool fSequential;
+	std::vector<size_t> fThreads;
+	mutable std::vector<size_t> fNCalls;
+	mutable std::vector<double> fTotalTime;
+	mutable std::vector<double> fMaxTime;
+	mutable std::unique_ptr<detail::WorkerPool> fPool;
 
 };
 template<typename ...ESTIMATORS>
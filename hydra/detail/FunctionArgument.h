@@ -114,6 +114,26 @@ struct FunctionArgument
         return *this;
     }
 
+    //arguments of other types, e.g. double data stored in float columns
+    template<typename Derived2, typename Type2>
+    __hydra_host__ __hydra_device__
+    FunctionArgument(FunctionArgument<Derived2, Type2>const& other,
+    		typename std::enable_if<(!std::is_same<Type2, value_type>::value) &&
+    		std::is_convertible<Type2, value_type>::value, int>::type=0):
+     value(static_cast<value_type>(other()))
+     {}
+
+    template<typename Derived2, typename Type2>
+    __hydra_host__ __hydra_device__
+    typename std::enable_if<(!std::is_same<Type2, value_type>::value) &&
+    		std::is_convertible<Type2, value_type>::value, FunctionArgument<name_type, value_type>&>::type
+    operator=(FunctionArgument<Derived2, Type2>const& other)
+    {
+
+        value = static_cast<value_type>(other());
+        return *this;
+    }
+
       __hydra_host__ __hydra_device__
       operator value_type() const { return value; }
 
@@ -278,7 +298,9 @@ struct NAME : detail::FunctionArgument<NAME, TYPE>                     \
                                                                        \
   template<typename T,                                                 \
        typename = typename std::enable_if<                             \
-        std::is_base_of< detail::FunctionArgument<T, TYPE>, T>::value, \
+        std::is_base_of< detail::FunctionArgument<T,                   \
+                  typename T::value_type>, T>::value &&                \
+        std::is_convertible<typename T::value_type, TYPE>::value,      \
         void >::type >  											   \
 __hydra_host__ __hydra_device__										   \
   NAME( T const& other):                                               \
@@ -298,7 +320,9 @@ __hydra_host__ __hydra_device__										   \
                                                                        \
   template<typename T>                                                 \
   typename std::enable_if<                                             \
-        std::is_base_of< detail::FunctionArgument<T, TYPE>, T>::value, \
+        std::is_base_of< detail::FunctionArgument<T,                   \
+                  typename T::value_type>, T>::value &&                \
+        std::is_convertible<typename T::value_type, TYPE>::value,      \
         NAME& >::type                                                  \
   __hydra_host__ __hydra_device__                                      \
   operator=(T const& other)                                            \
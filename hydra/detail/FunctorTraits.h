@@ -30,7 +30,10 @@
 #define FUNCTORTRAITS_H_
 
 #include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Dual.h>
 #include <hydra/detail/utility/StaticAssert.h>
+#include <hydra/detail/utility/Generic.h>
 #include <hydra/detail/external/hydra_thrust/tuple.h>
 #include <hydra/detail/external/hydra_thrust/type_traits/void_t.h>
 #include <utility>
@@ -129,6 +132,32 @@ struct is_hydra_lambda<Functor,
    hydra_thrust::void_t<typename Functor::hydra_lambda_type,
                         typename Functor::argument_type ,
                         typename Functor::return_type > >: std::true_type{};
+
+/*
+ * A functor is differentiable with respect to its parameters if it implements
+ * template<typename Real> Real EvaluateWithParameters(Real const* par, Args... x) const,
+ * which BaseFunctor::CallWithParameters invokes with hydra::Dual parameters.
+ */
+template<typename Functor, typename Seq, typename T= hydra_thrust::void_t<> >
+struct has_evaluate_with_parameters:std::false_type{};
+
+template<typename Functor, size_t ...I>
+struct has_evaluate_with_parameters<Functor, index_sequence<I...>,
+   hydra_thrust::void_t<decltype( std::declval<Functor const&>().EvaluateWithParameters(
+		   std::declval< Dual<GReal_t, Functor::parameter_count> const*>(),
+		   std::declval<typename hydra_thrust::tuple_element<I, typename Functor::argument_type>::type>()...) )> >:
+		   std::true_type{};
+
+template<typename Functor, typename T= hydra_thrust::void_t<> >
+struct is_differentiable_functor:std::false_type{};
+
+template<typename Functor>
+struct is_differentiable_functor<Functor,
+   hydra_thrust::void_t<typename Functor::hydra_functor_type,
+                        typename Functor::argument_type,
+                        decltype(Functor::parameter_count) > >:
+   has_evaluate_with_parameters<Functor, typename make_index_sequence<Functor::arity>::type >{};
+
 }  // namespace detail
 
 }  // namespace hydra
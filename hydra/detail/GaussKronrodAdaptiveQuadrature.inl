@@ -34,144 +34,235 @@
 #include <cmath>
 #include <tuple>
 #include <limits>
-#include <hydra/detail/external/hydra_thrust/sort.h>
+#include <hydra/MemoryPool.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
 #include <hydra/detail/external/hydra_thrust/execution_policy.h>
 #include <hydra/detail/external/hydra_thrust/functional.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/discard_iterator.h>
 
 namespace hydra {
 
 template<size_t NRULE, size_t NBIN, hydra::detail::Backend BACKEND>
-std::pair<GReal_t, GReal_t>
-GaussKronrodAdaptiveQuadrature<NRULE,NBIN,hydra::detail::BackendPolicy<BACKEND>>::Accumulate()
+template<typename INTEGRAND>
+void GaussKronrodAdaptiveQuadrature<NRULE,NBIN,hydra::detail::BackendPolicy<BACKEND>>::ProcessNodes(
+		INTEGRAND const& integrand, std::vector<size_t> const& nodes)
 {
+	typedef hydra_thrust::tuple<double, double> call_t;
 
-	for(size_t index=0; index<fCallTableHost.size() ; index++ )
-		{
+	constexpr size_t ncalls = (NRULE+1)/2;
 
-			auto row = fCallTableHost[index];
+	size_t nnodes = nodes.size();
 
-			size_t  bin        = hydra_thrust::get<0>(row);
-			GReal_t bin_delta  = hydra_thrust::get<1>(row)-hydra_thrust::get<2>(row);
-			GReal_t bin_result = hydra_thrust::get<2>(row);
-			hydra_thrust::get<4>(fNodesTable[bin])   +=  bin_result;
-			hydra_thrust::get<5>(fNodesTable[bin])   +=  bin_delta;
-		}
+	//integral and limits of the nodes to process
+	std::vector<GUInt_t> integrals_h(nnodes);
+	std::vector<GReal_t> limits_h(2*nnodes);
+
+	for(size_t i=0; i<nnodes; i++)
+	{
+		node_t const& node = fNodesTable[nodes[i]];
+
+		integrals_h[i]   = hydra_thrust::get<0>(node);
+		limits_h[2*i]    = hydra_thrust::get<1>(node);
+		limits_h[2*i+1]  = hydra_thrust::get<2>(node);
+	}
+
+	auto integrals_d = hydra::detail::get_temporary_buffer<GUInt_t>(system_t(), nnodes);
+	auto limits_d    = hydra::detail::get_temporary_buffer<GReal_t>(system_t(), 2*nnodes);
+	auto results_d   = hydra::detail::get_temporary_buffer<call_t>(system_t(), nnodes);
 
-	GReal_t result=0;
-	GReal_t error2=0;
+	hydra_thrust::copy(integrals_h.begin(), integrals_h.end(), integrals_d.first);
+	hydra_thrust::copy(limits_h.begin(), limits_h.end(), limits_d.first);
 
-	//for(auto row: fNodesTable ) std::cout <<std::setprecision(10)<< row << std::endl;
+	//evaluate all rule calls in parallel and sum them up per node on the device
+	auto keys = hydra_thrust::make_transform_iterator(
+			hydra_thrust::counting_iterator<size_t>(0), GaussKronrodCallToNode<NRULE>());
 
-	for(size_t node=0; node<fNodesTable.size(); node++ )
+	auto calls = hydra_thrust::make_transform_iterator(
+			hydra_thrust::counting_iterator<size_t>(0),
+			ProcessGaussKronrodAdaptiveQuadrature<INTEGRAND, NRULE>(integrand,
+					hydra_thrust::raw_pointer_cast(integrals_d.first),
+					hydra_thrust::raw_pointer_cast(limits_d.first), fRule) );
+
+	hydra_thrust::reduce_by_key(system_t(), keys, keys + nnodes*ncalls, calls,
+			hydra_thrust::make_discard_iterator(), results_d.first,
+			hydra_thrust::equal_to<size_t>(), AddGaussKronrodCalls());
+
+	std::vector<call_t> results_h(nnodes);
+
+	hydra_thrust::copy(results_d.first, results_d.first + nnodes, results_h.begin());
+
+	hydra::detail::return_temporary_buffer(system_t(), integrals_d.first);
+	hydra::detail::return_temporary_buffer(system_t(), limits_d.first);
+	hydra::detail::return_temporary_buffer(system_t(), results_d.first);
+
+	for(size_t i=0; i<nnodes; i++)
 	{
-		//std::cout <<std::setprecision(10)<< fNodesTable[node]<< std::endl;
-		if(hydra_thrust::get<0>(fNodesTable[node])==1 )
-		{
-			hydra_thrust::get<5>(fNodesTable[node])= GetError(hydra_thrust::get<5>(fNodesTable[node]) );
-			hydra_thrust::get<0>(fNodesTable[node])=0;
-			//std::cout << "====>"<< std::setprecision(10)<< fNodesTable[node]<< std::endl;
-		}
+		node_t& node = fNodesTable[nodes[i]];
 
-		result     += hydra_thrust::get<4>(fNodesTable[node]);
-		error2    += hydra_thrust::get<5>(fNodesTable[node])*hydra_thrust::get<5>(fNodesTable[node]);
+		GReal_t gauss   = hydra_thrust::get<0>(results_h[i]);
+		GReal_t kronrod = hydra_thrust::get<1>(results_h[i]);
 
+		hydra_thrust::get<3>(node) = kronrod;
+		hydra_thrust::get<4>(node) = GetError(gauss - kronrod);
 	}
-
-	return std::pair<GReal_t, GReal_t>(result, sqrt(error2) );
 }
 
 template<size_t NRULE, size_t NBIN, hydra::detail::Backend BACKEND>
-template<typename FUNCTOR>
-std::pair<GReal_t, GReal_t>
-GaussKronrodAdaptiveQuadrature<NRULE,NBIN, hydra::detail::BackendPolicy<BACKEND>>::Integrate(FUNCTOR const& functor)
+bool GaussKronrodAdaptiveQuadrature<NRULE,NBIN,hydra::detail::BackendPolicy<BACKEND>>::SplitNodes(
+		node_heap_h& heap, GReal_t tolerance, std::vector<size_t>& nodes)
 {
-	std::pair<GReal_t, GReal_t> result(0,0);
+	/*
+	 * split the nodes with largest errors, at most fSplitsPerIteration,
+	 * skipping those which alone can not spoil the requested precision
+	 */
+	GReal_t threshold = tolerance/std::sqrt(GReal_t(heap.size()));
 
-	fIterationNumber=0;
-	GBool_t  condition1=0;
-	GBool_t  condition2=0;
+	size_t nsplits = 0;
 
-	InitNodes();
-	do{
+	while( !heap.empty() && nsplits < fSplitsPerIteration )
+	{
+		if( nsplits > 0 && heap.front().first < threshold ) break;
 
-		// do  not split nodes at first iteration
-		if( fIterationNumber>0 ) UpdateNodes();
+		std::pop_heap(heap.begin(), heap.end());
 
-		//set parameters table
-		SetParametersTable( );
+		size_t index = heap.back().second;
 
-		//set the call table to hold the evaluation results
-		fCallTableHost.resize( fParametersTable.size());
-		fCallTableDevice.resize( fParametersTable.size());
+		node_t node = fNodesTable[index];
 
-		//call function in parallel
-		hydra_thrust::transform(system_t(),fParametersTable.begin(), fParametersTable.end(),
-				fCallTableDevice.begin(),
-				ProcessGaussKronrodAdaptiveQuadrature<FUNCTOR>(functor) );
+		GReal_t lower  = hydra_thrust::get<1>(node);
+		GReal_t upper  = hydra_thrust::get<2>(node);
+		GReal_t middle = lower + (upper - lower)/2.0;
 
-		//copy to evaluation result back to the host
-		hydra_thrust::copy(fCallTableDevice.begin(),  fCallTableDevice.end(),
-				fCallTableHost.begin());
+		//interval can not be split further in double precision
+		if( !(lower < middle && middle < upper) ){
 
-		/**
-		 * \todo Re-implement Accumulate() using hydra_thrust::sort + thust::reduce_by_key, maybe not faster but
-		 * more scalable.
-		 */
-		result = Accumulate();
+			std::push_heap(heap.begin(), heap.end());
+			break;
+		}
 
-		fIterationNumber++;
+		heap.pop_back();
 
-		/*
-		 * keep iterating while the error is larger than the required or
-		 * larger than the numerical double precision
-		 */
+		fNodesTable[index] = node_t(hydra_thrust::get<0>(node), lower, middle, 0.0, 0.0);
+		fNodesTable.push_back( node_t(hydra_thrust::get<0>(node), middle, upper, 0.0, 0.0) );
 
-		condition1 =  result.second > sqrt(result.first*result.first)*fMaxRelativeError;
-		condition2 =  result.second > std::numeric_limits<GReal_t>::epsilon();
+		nodes.push_back(index);
+		nodes.push_back(fNodesTable.size()-1);
 
+		nsplits++;
 	}
-	while( condition1 &&  condition2 );
 
-	return result;
+	return nsplits > 0;
 }
 
-
 template<size_t NRULE, size_t NBIN, hydra::detail::Backend BACKEND>
-void GaussKronrodAdaptiveQuadrature<NRULE,NBIN,hydra::detail::BackendPolicy<BACKEND>>::UpdateNodes()
+template<typename INTEGRAND>
+std::vector<std::pair<GReal_t, GReal_t>>
+GaussKronrodAdaptiveQuadrature<NRULE,NBIN, hydra::detail::BackendPolicy<BACKEND>>::IntegrateNodes(
+		INTEGRAND const& integrand, size_t nintegrals)
 {
+	std::vector<std::pair<GReal_t, GReal_t>> results(nintegrals, std::pair<GReal_t, GReal_t>(0,0));
 
-	hydra_thrust::sort(hydra_thrust::host,
-				fNodesTable.begin(),
-			    fNodesTable.end(),
-				hydra::detail::CompareTuples<5,	hydra_thrust::greater >());
+	fIterationNumber=0;
 
-	auto node = fNodesTable[0];
+	if( nintegrals==0 ) return results;
 
-	GReal_t lower_limits = hydra_thrust::get<2>(node);
-	GReal_t upper_limits = hydra_thrust::get<3>(node);
-	GReal_t delta = upper_limits-lower_limits;
+	InitNodes(nintegrals);
 
-	GReal_t delta2 = delta/2.0;
-	node_t new_node1(1, 0, lower_limits ,lower_limits+delta2, 0, 0);
-	node_t new_node2(1, 0, lower_limits+delta2, upper_limits, 0, 0);
+	std::vector<node_heap_h> heaps(nintegrals);
+	std::vector<GBool_t>     converged(nintegrals, 0);
+	std::vector<GReal_t>     tolerances(nintegrals, 0.0);
 
-	fNodesTable[0] =  new_node1;
-	fNodesTable.push_back( new_node2);
+	// at the first iteration, process the initial nodes
+	std::vector<size_t> nodes(fNodesTable.size());
 
+	for(size_t i=0; i<nodes.size(); i++) nodes[i]=i;
 
-	hydra_thrust::sort(hydra_thrust::host,
-			fNodesTable.begin(),
-		    fNodesTable.end(),
-			hydra::detail::CompareTuples<2,	hydra_thrust::less >());
+	while( !nodes.empty() )
+	{
+		ProcessNodes(integrand, nodes);
 
+		for(auto index: nodes)
+		{
+			node_heap_h& heap = heaps[hydra_thrust::get<0>(fNodesTable[index])];
 
-	for(size_t  i = 0; i<fNodesTable.size(); i++)
-	{
-		hydra_thrust::get<1>(fNodesTable[i])=i;
+			heap.push_back( heap_entry_t(hydra_thrust::get<4>(fNodesTable[index]), index) );
+			std::push_heap(heap.begin(), heap.end());
+		}
+
+		fIterationNumber++;
+
+		std::vector<GReal_t> error2(nintegrals, 0.0);
+
+		for(auto& result: results) result = std::pair<GReal_t, GReal_t>(0,0);
+
+		for(auto const& node: fNodesTable)
+		{
+			size_t integral = hydra_thrust::get<0>(node);
+
+			results[integral].first += hydra_thrust::get<3>(node);
+			error2[integral]        += hydra_thrust::get<4>(node)*hydra_thrust::get<4>(node);
+		}
+
+		nodes.clear();
+
+		for(size_t integral=0; integral<nintegrals; integral++)
+		{
+			results[integral].second = std::sqrt(error2[integral]);
+
+			if( converged[integral] ) continue;
+
+			/*
+			 * keep iterating while the error is larger than the required or
+			 * larger than the numerical double precision
+			 */
+			tolerances[integral] = std::max( std::fabs(results[integral].first)*fMaxRelativeError,
+					std::numeric_limits<GReal_t>::epsilon());
+
+			converged[integral] = !( results[integral].second > tolerances[integral] );
+
+			if( !converged[integral] )
+				converged[integral] = !SplitNodes(heaps[integral], tolerances[integral], nodes);
+		}
 	}
 
-	//for(auto row: fNodesTable) std::cout << row << std::endl;
+	return results;
+}
+
+template<size_t NRULE, size_t NBIN, hydra::detail::Backend BACKEND>
+template<typename Iterator>
+std::vector<std::pair<GReal_t, GReal_t>>
+GaussKronrodAdaptiveQuadrature<NRULE,NBIN, hydra::detail::BackendPolicy<BACKEND>>::Integrate(Iterator begin, Iterator end)
+{
+	typedef typename std::iterator_traits<Iterator>::value_type functor_t;
+
+	std::vector<functor_t> functors_h(begin, end);
+
+	/*
+	 * functors on the device, copied byte by byte as for any kernel argument:
+	 * the wrapped lambdas can be copy constructed but not assigned
+	 */
+	const char* bytes = reinterpret_cast<const char*>(functors_h.data());
+
+	typename system_t::template container<char> functors(bytes, bytes + functors_h.size()*sizeof(functor_t));
+
+	GaussKronrodIntegrandArray<functor_t> integrand(
+			reinterpret_cast<functor_t const*>(hydra_thrust::raw_pointer_cast(functors.data())));
 
+	return IntegrateNodes(integrand, functors_h.size());
+}
+
+template<size_t NRULE, size_t NBIN, hydra::detail::Backend BACKEND>
+template<typename FUNCTOR>
+std::pair<GReal_t, GReal_t>
+GaussKronrodAdaptiveQuadrature<NRULE,NBIN, hydra::detail::BackendPolicy<BACKEND>>::Integrate(FUNCTOR const& functor)
+{
+	return IntegrateNodes(GaussKronrodIntegrand<FUNCTOR>(functor), 1)[0];
 }
 
 
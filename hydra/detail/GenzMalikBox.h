@@ -96,6 +96,50 @@ struct CompareGenzMalikBoxes
 	}
 };
 
+template<size_t N>
+struct GetGenzMalikBoxError
+{
+	__hydra_host__ __hydra_device__
+	GReal_t operator()( detail::GenzMalikBox<N> const& box ) const {
+		return box.GetError();
+	}
+};
+
+/*
+ * True for errors above a threshold.
+ */
+struct GenzMalikErrorAbove
+{
+	GenzMalikErrorAbove(GReal_t threshold):
+		fThreshold(threshold)
+	{}
+
+	__hydra_host__ __hydra_device__
+	bool operator()( GReal_t error ) const {
+		return error > fThreshold;
+	}
+
+	GReal_t fThreshold;
+};
+
+/*
+ * True for boxes with error not above a threshold, which are kept as they are.
+ */
+template<size_t N>
+struct GenzMalikBoxErrorBelow
+{
+	GenzMalikBoxErrorBelow(GReal_t threshold):
+		fThreshold(threshold)
+	{}
+
+	__hydra_host__ __hydra_device__
+	bool operator()( detail::GenzMalikBox<N> const& box ) const {
+		return !(box.GetError() > fThreshold);
+	}
+
+	GReal_t fThreshold;
+};
+
 template<typename Type>
 class GenzMalikBoxResult
 {
@@ -315,7 +359,10 @@ public:
 		this->fRule5 = hydra::get<0>(_pair.first ) ;
 		this->fRule7 = hydra::get<1>(_pair.first ) ;
 
-			this->fCutAxis = hydra::detail::max( _pair.second);
+			//the axis with the largest fourth difference, in absolute value
+			GReal_t max_difference = -1.0;
+
+			get_cut_axis(_pair.second, max_difference);
 
 			GReal_t factor = this->fVolume/::pow(2.0, N);
 
@@ -487,6 +534,27 @@ public:
 
 private:
 
+	template<size_t I=0, typename Tuple>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if< (I==N), void >::type
+	get_cut_axis(Tuple const&, GReal_t&){}
+
+	template<size_t I=0, typename Tuple>
+	__hydra_host__ __hydra_device__
+	inline typename std::enable_if< (I<N), void >::type
+	get_cut_axis(Tuple const& differences, GReal_t& max_difference)
+	{
+		GReal_t difference = ::fabs(hydra_thrust::get<I>(differences));
+
+		if( difference > max_difference ){
+
+			max_difference = difference;
+			fCutAxis = I;
+		}
+
+		get_cut_axis<I+1>(differences, max_difference);
+	}
+
 	__hydra_host__ __hydra_device__
 	void UpdateVolume(){
 		fVolume =1.0;
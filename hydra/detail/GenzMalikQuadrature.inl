@@ -39,10 +39,17 @@
 #include <hydra/Integrator.h>
 #include <hydra/detail/utility/Generic.h>
 #include <hydra/detail/functors/ProcessGenzMalikQuadrature.h>
+#include <hydra/MemoryPool.h>
 #include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/partition.h>
+#include <hydra/detail/external/hydra_thrust/count.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/for_each.h>
+#include <hydra/detail/external/hydra_thrust/functional.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <future>
 
 
 
@@ -205,15 +212,25 @@ void GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND>>::SetGeometry(
 
 template<size_t N, hydra::detail::Backend  BACKEND>
 GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND>>::GenzMalikQuadrature( GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND>> const& other):
-fBoxList(other.GetBoxList() ),
-fGenzMalikRule(other.GetGenzMalikRule() )
+fRelativeError(other.GetRelativeError()),
+fFraction(other.GetFraction()),
+fNBoxes(0),
+fNBoxesProcessed(0),
+fElapsedTime(0),
+fGenzMalikRule(other.GetGenzMalikRule() ),
+fBoxList(other.GetBoxList() )
 {}
 
 template<size_t N, hydra::detail::Backend  BACKEND>
 template<hydra::detail::Backend  BACKEND2>
 GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND>>::GenzMalikQuadrature( GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND2>> const& other):
-fBoxList(other.GetBoxList() ),
-fGenzMalikRule(other.GetGenzMalikRule() )
+fRelativeError(other.GetRelativeError()),
+fFraction(other.GetFraction()),
+fNBoxes(0),
+fNBoxesProcessed(0),
+fElapsedTime(0),
+fGenzMalikRule(other.GetGenzMalikRule() ),
+fBoxList(other.GetBoxList() )
 {}
 
 
@@ -223,6 +240,8 @@ GenzMalikQuadrature<N,hydra::detail::BackendPolicy<BACKEND>>::operator=( GenzMal
 {
 	if(this==&other) return *this;
 
+	this->fRelativeError = other.GetRelativeError();
+	this->fFraction = other.GetFraction();
 	this->fBoxList=other.GetBoxList() ;
 	this->fGenzMalikRule = other.GetGenzMalikRule() ;
 
@@ -236,6 +255,8 @@ GenzMalikQuadrature<N,hydra::detail::BackendPolicy<BACKEND>>::operator=( GenzMal
 {
 	if(this==&other) return *this;
 
+	this->fRelativeError = other.GetRelativeError();
+	this->fFraction = other.GetFraction();
 	this->fBoxList=other.GetBoxList() ;
 	this->fGenzMalikRule = other.GetGenzMalikRule() ;
 
@@ -246,102 +267,151 @@ template<size_t N, hydra::detail::Backend  BACKEND>
 template<typename FUNCTOR>
 std::pair<GReal_t, GReal_t> GenzMalikQuadrature<N,hydra::detail::BackendPolicy<BACKEND>>::Integrate(FUNCTOR const& functor)
 {
+	typedef std::chrono::high_resolution_clock clock_type;
+
+	fIterationTimes.clear();
+	fNBoxesProcessed = 0;
+	fElapsedTime     = 0;
+
+	auto start = clock_type::now();
 
 	device_box_list_type TempBoxList_d( fBoxList );
 
 	detail::ProcessGenzMalikBox<N, FUNCTOR, rule_iterator> process_box(functor,
 			fGenzMalikRule.begin(), fGenzMalikRule.end() ) ;
 
-	hydra_thrust::for_each(hydra::detail::BackendPolicy<BACKEND>{}, TempBoxList_d.begin(),
+	hydra_thrust::for_each(system_type(), TempBoxList_d.begin(),
 			TempBoxList_d.end(), process_box);
 
+	fNBoxesProcessed += TempBoxList_d.size();
 
 	std::pair<GReal_t, GReal_t> result = CalculateIntegral(TempBoxList_d);
 
-	if( result.second/result.first < fRelativeError)
+	auto stop = clock_type::now();
 
-		return result;
+	fIterationTimes.push_back( std::chrono::duration<GReal_t, std::milli>(stop - start).count() );
 
-	else{
+	GReal_t relative_error = result.second/std::fabs(result.first);
+
+	while( relative_error != 0 && relative_error > fRelativeError )
+	{
+		start = clock_type::now();
 
-		do{
-			//auto start = std::chrono::high_resolution_clock::now();
+		size_t nsplit = AdaptiveIntegration(functor, TempBoxList_d);
 
-			AdaptiveIntegration(functor, TempBoxList_d);
+		if( nsplit == 0 ) break;
 
-			//auto stop = std::chrono::high_resolution_clock::now();
-			//std::chrono::duration<double, std::milli> elapsed = stop - start;
-			//std::cout << "AdaptiveIntegration Time (ms): " << elapsed.count() <<std::endl;
+		fNBoxesProcessed += 2*nsplit;
 
-			result = CalculateIntegral(TempBoxList_d);
+		result = CalculateIntegral(TempBoxList_d);
 
-		} while( (result.second /result.first != 0) && result.second /result.first > fRelativeError );
+		stop = clock_type::now();
 
+		fIterationTimes.push_back( std::chrono::duration<GReal_t, std::milli>(stop - start).count() );
 
+		relative_error = result.second/std::fabs(result.first);
 	}
 
+	for(auto time: fIterationTimes) fElapsedTime += time;
+
+	fNBoxes = TempBoxList_d.size();
+
 	return  result;
 }
 
 template<size_t N, hydra::detail::Backend  BACKEND>
-template<typename FUNCTOR, typename Vector>
-void GenzMalikQuadrature<N,
-       hydra::detail::BackendPolicy<BACKEND>>::AdaptiveIntegration(FUNCTOR const& functor, Vector& BoxList) {
+template<typename Vector>
+GReal_t GenzMalikQuadrature<N, hydra::detail::BackendPolicy<BACKEND>>::GetSplitThreshold(Vector const& BoxList, size_t& nsplit)
+{
+	/*
+	 * Find by bisection an error threshold leaving above it about
+	 * the requested fraction of boxes, without sorting them.
+	 */
+	size_t nboxes = BoxList.size();
+	size_t ntarget = std::max<size_t>(1, nboxes*fFraction);
 
+	auto errors = hydra::detail::get_temporary_buffer<GReal_t>(system_type(), nboxes);
 
-	detail::ProcessGenzMalikBox<N, FUNCTOR, rule_iterator> process_box(functor,
-			fGenzMalikRule.begin(), fGenzMalikRule.end() ) ;
+	hydra_thrust::transform(system_type(), BoxList.begin(), BoxList.end(), errors.first,
+			detail::GetGenzMalikBoxError<N>());
+
+	GReal_t lower = 0.0;
+	GReal_t upper = hydra_thrust::reduce(system_type(), errors.first, errors.first + nboxes,
+			0.0, hydra_thrust::maximum<GReal_t>());
+
+	nsplit = hydra_thrust::count_if(system_type(), errors.first, errors.first + nboxes,
+			detail::GenzMalikErrorAbove(lower));
+
+	if( nsplit > ntarget + ntarget/8 ){
 
-	//sort by error in increasing order
-	//auto start = std::chrono::high_resolution_clock::now();
+		for(size_t iteration=0; iteration<64; iteration++)
+		{
+			GReal_t middle = 0.5*(lower + upper);
+
+			if( !(lower < middle && middle < upper) ) break;
 
-	hydra_thrust::sort(BoxList.begin(), BoxList.end(), detail::CompareGenzMalikBoxes<N>());
+			size_t count = hydra_thrust::count_if(system_type(), errors.first, errors.first + nboxes,
+					detail::GenzMalikErrorAbove(middle));
 
-	//auto stop = std::chrono::high_resolution_clock::now();
-	//std::chrono::duration<double, std::milli> elapsed = stop - start;
-	//std::cout << "Sort Time (ms): " << elapsed.count() <<std::endl;
+			if( count < ntarget ) upper = middle;
+			else {
 
-	size_t n = BoxList.size()*fFraction;
-	SplitBoxes(BoxList, n );
+				lower  = middle;
+				nsplit = count;
+
+				if( count <= ntarget + ntarget/8 ) break;
+			}
+		}
+	}
 
-	//launch calculation
-	hydra_thrust::for_each(BoxList.end()-2*n, BoxList.end(), process_box);
+	hydra::detail::return_temporary_buffer(system_type(), errors.first);
 
+	return lower;
 }
 
 template<size_t N, hydra::detail::Backend  BACKEND>
-template<typename Vector>
-void hydra::GenzMalikQuadrature<N,
-         hydra::detail::BackendPolicy<BACKEND> >::SplitBoxes( Vector& boxes, size_t n ){
+template<typename FUNCTOR, typename Vector>
+size_t GenzMalikQuadrature<N,
+       hydra::detail::BackendPolicy<BACKEND>>::AdaptiveIntegration(FUNCTOR const& functor, Vector& BoxList) {
 
-	Vector new_boxes;
-	new_boxes.reserve(2*n);
 
-	do{
-		detail::GenzMalikBox<N> highest_error_box(boxes.back());
-		boxes.pop_back();
+	detail::ProcessGenzMalikBox<N, FUNCTOR, rule_iterator> process_box(functor,
+			fGenzMalikRule.begin(), fGenzMalikRule.end() ) ;
 
-		auto sub_boxes=highest_error_box.Divide();
+	size_t nsplit = 0;
 
-        new_boxes.push_back(sub_boxes.first);
-        new_boxes.push_back(sub_boxes.second);
+	GReal_t threshold = GetSplitThreshold(BoxList, nsplit);
 
-	}while( --n );
+	if( nsplit == 0 ) return 0;
 
-	for(auto el:new_boxes)
-		boxes.push_back(el);
+	//move the boxes to split to the end
+	auto middle = hydra_thrust::partition(system_type(), BoxList.begin(), BoxList.end(),
+			detail::GenzMalikBoxErrorBelow<N>(threshold));
 
-}
+	size_t nkeep  = hydra_thrust::distance(BoxList.begin(), middle);
+	size_t nboxes = BoxList.size();
 
+	nsplit = nboxes - nkeep;
 
+	BoxList.resize(nboxes + nsplit);
 
+	//the lower halves replace the split boxes and the upper halves are appended
+	hydra_thrust::for_each(system_type(), hydra_thrust::counting_iterator<size_t>(0),
+			hydra_thrust::counting_iterator<size_t>(nsplit),
+			detail::SplitGenzMalikBox<N>( hydra_thrust::raw_pointer_cast(BoxList.data()) + nkeep, nsplit));
+
+	//launch calculation only for the new boxes
+	hydra_thrust::for_each(system_type(), BoxList.begin() + nkeep, BoxList.end(), process_box);
+
+	return nsplit;
+}
 
 template<size_t N, hydra::detail::Backend  BACKEND>
 template<typename Vector>
 std::pair<GReal_t, GReal_t>
 hydra::GenzMalikQuadrature<N,hydra::detail::BackendPolicy<BACKEND> >::CalculateIntegral( Vector const& BoxList){
 
-	detail::GenzMalikBoxResult<double> result = hydra_thrust::reduce(BoxList.begin(), BoxList.end(),
+	detail::GenzMalikBoxResult<double> result = hydra_thrust::reduce(system_type(), BoxList.begin(), BoxList.end(),
 			detail::GenzMalikBoxResult<double>(0.0,0.0) ,detail::AddResultGenzMalikBoxes() );
 
 	return result.GetPair();
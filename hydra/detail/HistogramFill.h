@@ -0,0 +1,462 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * HistogramFill.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef HISTOGRAMFILL_H_
+#define HISTOGRAMFILL_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/functors/FillPrivateHistogram.h>
+
+#include <hydra/detail/external/hydra_thrust/memory.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/fill.h>
+#include <hydra/detail/external/hydra_thrust/sort.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/merge.h>
+#include <hydra/detail/external/hydra_thrust/for_each.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/binary_search.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/permutation_iterator.h>
+#include <hydra/detail/external/hydra_thrust/functional.h>
+#include <hydra/detail/external/hydra_thrust/system/cpp/detail/execution_policy.h>
+#include <hydra/detail/external/hydra_thrust/system/omp/detail/execution_policy.h>
+#include <hydra/detail/external/hydra_thrust/system/tbb/detail/execution_policy.h>
+
+#include <type_traits>
+#include <thread>
+#include <utility>
+
+#if (HYDRA_THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == HYDRA_THRUST_TRUE)
+#include <omp.h>
+#endif
+
+#if (HYDRA_THRUST_DEVICE_SYSTEM == HYDRA_THRUST_DEVICE_SYSTEM_TBB) || (HYDRA_THRUST_HOST_SYSTEM == HYDRA_THRUST_HOST_SYSTEM_TBB)
+#include <tbb/task_arena.h>
+#endif
+
+/*
+ * Maximum number of bytes of scratch memory taken by the per-thread private
+ * copies of a histogram. The number of copies is reduced to stay below
+ * this limit. If not even one copy fits, the fill falls back to the sort
+ * based algorithm.
+ */
+#ifndef HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES
+#define HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES (size_t(1)<<26)
+#endif
+
+/*
+ * Minimum number of entries processed by each private histogram.
+ */
+#ifndef HYDRA_HISTOGRAM_MIN_SLOT_SIZE
+#define HYDRA_HISTOGRAM_MIN_SLOT_SIZE (size_t(1)<<12)
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+namespace histogram {
+
+//host based systems (cpp, omp and tbb) derive from cpp's execution policy
+template<typename Derived>
+std::true_type is_host_system_test(hydra_thrust::system::cpp::detail::execution_policy<Derived> const&);
+
+std::false_type is_host_system_test(...);
+
+template<typename Derived>
+std::true_type is_parallel_host_system_test(hydra_thrust::system::omp::detail::execution_policy<Derived> const&);
+
+template<typename Derived>
+std::true_type is_parallel_host_system_test(hydra_thrust::system::tbb::detail::execution_policy<Derived> const&);
+
+std::false_type is_parallel_host_system_test(...);
+
+template<typename Derived>
+std::true_type is_omp_system_test(hydra_thrust::system::omp::detail::execution_policy<Derived> const&);
+
+std::false_type is_omp_system_test(...);
+
+template<typename Derived>
+std::true_type is_tbb_system_test(hydra_thrust::system::tbb::detail::execution_policy<Derived> const&);
+
+std::false_type is_tbb_system_test(...);
+
+}  // namespace histogram
+
+template<typename System>
+struct is_privatizable_system:
+	decltype(histogram::is_host_system_test(std::declval<System>())){};
+
+template<typename System>
+struct is_parallel_host_system:
+	decltype(histogram::is_parallel_host_system_test(std::declval<System>())){};
+
+template<typename System>
+struct is_omp_system:
+	decltype(histogram::is_omp_system_test(std::declval<System>())){};
+
+template<typename System>
+struct is_tbb_system:
+	decltype(histogram::is_tbb_system_test(std::declval<System>())){};
+
+/**
+ * Number of threads the system \p System runs the parallel algorithms on:
+ * the OpenMP or TBB thread count, and one for the sequential systems.
+ */
+template<typename System>
+inline typename std::enable_if<is_omp_system<System>::value, size_t>::type
+backend_threads()
+{
+#if (HYDRA_THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == HYDRA_THRUST_TRUE)
+	int nthreads = omp_get_max_threads();
+#else
+	int nthreads = 1;
+#endif
+
+	return nthreads > 0 ? nthreads : 1;
+}
+
+template<typename System>
+inline typename std::enable_if<is_tbb_system<System>::value, size_t>::type
+backend_threads()
+{
+#if (HYDRA_THRUST_DEVICE_SYSTEM == HYDRA_THRUST_DEVICE_SYSTEM_TBB) || (HYDRA_THRUST_HOST_SYSTEM == HYDRA_THRUST_HOST_SYSTEM_TBB)
+	int nthreads = tbb::this_task_arena::max_concurrency();
+#else
+	int nthreads = std::thread::hardware_concurrency();
+#endif
+
+	return nthreads > 0 ? nthreads : 1;
+}
+
+template<typename System>
+inline typename std::enable_if<!(is_omp_system<System>::value || is_tbb_system<System>::value), size_t>::type
+backend_threads()
+{
+	return 1;
+}
+
+/**
+ * Number of private histograms used to fill a sample of size \p data_size
+ * with system \p System.
+ */
+template<typename System>
+inline size_t histogram_fill_slots(size_t data_size)
+{
+	size_t nthreads = backend_threads<System>();
+
+	size_t nslots = data_size/HYDRA_HISTOGRAM_MIN_SLOT_SIZE;
+
+	return nslots < 1 ? 1 : (nslots < nthreads ? nslots : nthreads);
+}
+
+/**
+ * Number of private histograms of \p nbins bins used to fill a sample of size \p data_size
+ * with system \p System, so that they take at most HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES.
+ * Zero if not even one fits.
+ */
+template<typename System>
+inline size_t histogram_fill_slots(size_t data_size, size_t nbins)
+{
+	size_t nslots   = histogram_fill_slots<System>(data_size);
+	size_t capacity = HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES/(sizeof(CompensatedSum<double>)*(nbins > 0 ? nbins : 1));
+
+	return nslots < capacity ? nslots : capacity;
+}
+
+/**
+ * Returns true if a histogram with \p nbins bins (including under- and overflow)
+ * can be filled with per-thread private copies on the system \p System.
+ */
+template<typename System>
+inline bool use_privatized_histogram_fill(size_t nbins, size_t data_size)
+{
+	return is_privatizable_system<System>::value && histogram_fill_slots<System>(data_size, nbins) > 0;
+}
+
+/*
+ * Private histograms: O(n) work and O(nbins x nslots) scratch,
+ * bounded by HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES.
+ * The private bins use compensated sums, so large weighted samples
+ * do not lose precision.
+ */
+template<typename System, typename KeyFunctor, typename Iterator, typename WeightIterator, typename Pointer>
+inline void fill_histogram_privatized(System const& policy, size_t nbins, KeyFunctor const& key_functor,
+		Iterator begin, Iterator end, WeightIterator wbegin,
+		Pointer bin_contents)
+{
+	typedef FillPrivateHistogram<KeyFunctor, Iterator, WeightIterator> fill_functor_t;
+
+	size_t data_size = hydra_thrust::distance(begin, end);
+	size_t nslots    = histogram_fill_slots<System>(data_size, nbins);
+
+	auto private_bins = hydra::detail::get_temporary_buffer<CompensatedSum<double>>(policy, nslots*nbins);
+
+	CompensatedSum<double>* private_bins_ptr = hydra_thrust::raw_pointer_cast(private_bins.first);
+
+	hydra_thrust::fill(policy, private_bins.first, private_bins.first + private_bins.second, CompensatedSum<double>());
+
+	hydra_thrust::for_each(policy,
+			hydra_thrust::counting_iterator<size_t>(0),
+			hydra_thrust::counting_iterator<size_t>(nslots),
+			fill_functor_t(key_functor, begin, wbegin, data_size, nslots, nbins, private_bins_ptr));
+
+	hydra_thrust::transform(policy,
+			hydra_thrust::counting_iterator<size_t>(0),
+			hydra_thrust::counting_iterator<size_t>(nbins),
+			bin_contents, bin_contents, MergePrivateHistograms<CompensatedSum<double>>(private_bins_ptr, nslots, nbins) );
+
+	hydra::detail::return_temporary_buffer(policy, private_bins.first);
+}
+
+/*
+ * Sort based fill: O(n log n) work and O(n) scratch.
+ */
+template<typename System, typename KeyFunctor, typename Iterator, typename WeightIterator, typename Pointer>
+inline void fill_histogram_sorted(System const& policy, size_t nbins, KeyFunctor const& key_functor,
+		Iterator begin, Iterator end, WeightIterator wbegin,
+		Pointer bin_contents)
+{
+	size_t data_size = hydra_thrust::distance(begin, end);
+
+	//work on local copy of weights
+	auto weights = hydra::detail::get_temporary_buffer<double>(policy, data_size);
+	hydra_thrust::copy(policy, wbegin, wbegin+data_size, weights.first);
+
+	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
+	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
+	auto key_buffer = hydra::detail::get_temporary_buffer<size_t>(policy, data_size);
+
+	hydra_thrust::copy(policy, keys_begin, keys_end, key_buffer.first);
+
+	hydra_thrust::sort_by_key(policy, key_buffer.first, key_buffer.first + data_size, weights.first );
+
+	auto reduced_values  = hydra::detail::get_temporary_buffer<double>(policy, data_size);
+	auto reduced_keys    = hydra::detail::get_temporary_buffer<size_t>(policy, data_size);
+
+	auto reduced_end = hydra_thrust::reduce_by_key(policy, key_buffer.first,
+			key_buffer.first + data_size, weights.first, reduced_keys.first, reduced_values.first);
+
+	//keys are sorted, so the entries out of the bin range are at the end
+	auto keys_last = hydra_thrust::lower_bound(policy, reduced_keys.first, reduced_end.first, nbins);
+
+	auto bins_begin = hydra_thrust::make_permutation_iterator(bin_contents, reduced_keys.first);
+
+	//keys are unique after the reduction, so each bin is updated only once
+	hydra_thrust::transform(policy, reduced_values.first,
+			reduced_values.first + hydra_thrust::distance(reduced_keys.first, keys_last),
+			bins_begin, bins_begin, hydra_thrust::plus<double>() );
+
+	hydra::detail::return_temporary_buffer(policy, reduced_values.first);
+	hydra::detail::return_temporary_buffer(policy, reduced_keys.first);
+	hydra::detail::return_temporary_buffer(policy, key_buffer.first);
+	hydra::detail::return_temporary_buffer(policy, weights.first);
+}
+
+/**
+ * Fills the \p nbins bins, pointed by \p output, with the weighted counts
+ * of the data in the range [begin, end). The algorithm is chosen according
+ * to the system and the number of bins. If \p accumulate is true, the counts
+ * are added to the current contents of \p output.
+ */
+template<typename System, typename KeyFunctor, typename Iterator, typename WeightIterator, typename OutputIterator>
+inline void fill_histogram(System const& policy, size_t nbins, KeyFunctor const& key_functor,
+		Iterator begin, Iterator end, WeightIterator wbegin, OutputIterator output, bool accumulate=false)
+{
+	auto bin_contents = hydra::detail::get_temporary_buffer<double>(policy, nbins);
+
+	if( accumulate )
+		hydra_thrust::copy(output, output + nbins, bin_contents.first);
+	else
+		hydra_thrust::fill(policy, bin_contents.first, bin_contents.first + nbins, 0.0);
+
+	if( use_privatized_histogram_fill<System>(nbins, hydra_thrust::distance(begin, end)) )
+		fill_histogram_privatized(policy, nbins, key_functor, begin, end, wbegin, bin_contents.first);
+	else
+		fill_histogram_sorted(policy, nbins, key_functor, begin, end, wbegin, bin_contents.first);
+
+	hydra_thrust::copy(bin_contents.first, bin_contents.first + nbins, output);
+
+	hydra::detail::return_temporary_buffer(policy, bin_contents.first);
+}
+
+/**
+ * Fills the sparse histogram stored in \p bins and \p contents with the weighted counts
+ * of the data in the range [begin, end). If \p accumulate is true, the new bins are merged
+ * into the current ones, which are expected to be sorted. Returns the number of populated bins.
+ */
+template<typename System, typename KeyFunctor, typename Iterator, typename WeightIterator,
+         typename KeysContainer, typename ContentsContainer>
+inline size_t fill_sparse_histogram(System const& policy, KeyFunctor const& key_functor,
+		Iterator begin, Iterator end, WeightIterator wbegin,
+		KeysContainer& bins, ContentsContainer& contents, bool accumulate=false)
+{
+	size_t data_size = hydra_thrust::distance(begin, end);
+
+	auto weights  = hydra::detail::get_temporary_buffer<double>(policy, data_size);
+	hydra_thrust::copy(policy, wbegin, wbegin+data_size, weights.first);
+
+	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
+	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
+	auto key_buffer = hydra::detail::get_temporary_buffer<size_t>(policy, data_size);
+
+	hydra_thrust::copy(policy, keys_begin, keys_end, key_buffer.first);
+	hydra_thrust::sort_by_key(policy, key_buffer.first, key_buffer.first+data_size, weights.first);
+
+	//bins content
+	auto reduced_values  = hydra::detail::get_temporary_buffer<double>(policy, data_size);
+	auto reduced_keys    = hydra::detail::get_temporary_buffer<size_t>(policy, data_size);
+
+	auto reduced_end = hydra_thrust::reduce_by_key(policy,
+			key_buffer.first, key_buffer.first + data_size,
+			weights.first, reduced_keys.first, reduced_values.first);
+
+	hydra::detail::return_temporary_buffer(policy, key_buffer.first);
+	hydra::detail::return_temporary_buffer(policy, weights.first);
+
+	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
+
+	if( !accumulate || bins.size()==0 ){
+
+		contents.resize(histogram_size);
+		bins.resize(histogram_size);
+
+		hydra_thrust::copy(reduced_keys.first, reduced_end.first,  bins.begin());
+		hydra_thrust::copy(reduced_values.first, reduced_end.second,  contents.begin());
+	}
+	else {
+
+		size_t current_size = bins.size();
+		size_t merged_size  = current_size + histogram_size;
+
+		auto current_keys    = hydra::detail::get_temporary_buffer<size_t>(policy, current_size);
+		auto current_values  = hydra::detail::get_temporary_buffer<double>(policy, current_size);
+
+		hydra_thrust::copy(bins.begin(), bins.end(), current_keys.first);
+		hydra_thrust::copy(contents.begin(), contents.end(), current_values.first);
+
+		auto merged_keys    = hydra::detail::get_temporary_buffer<size_t>(policy, merged_size);
+		auto merged_values  = hydra::detail::get_temporary_buffer<double>(policy, merged_size);
+
+		//both sequences are sorted, so merging keeps the keys sorted
+		hydra_thrust::merge_by_key(policy,
+				current_keys.first, current_keys.first + current_size,
+				reduced_keys.first, reduced_end.first,
+				current_values.first, reduced_values.first,
+				merged_keys.first, merged_values.first);
+
+		hydra::detail::return_temporary_buffer(policy, current_keys.first);
+		hydra::detail::return_temporary_buffer(policy, current_values.first);
+
+		//bins present in both sequences are adjacent after merging
+		auto merged_reduced_keys    = hydra::detail::get_temporary_buffer<size_t>(policy, merged_size);
+		auto merged_reduced_values  = hydra::detail::get_temporary_buffer<double>(policy, merged_size);
+
+		auto merged_end = hydra_thrust::reduce_by_key(policy,
+				merged_keys.first, merged_keys.first + merged_size, merged_values.first,
+				merged_reduced_keys.first, merged_reduced_values.first);
+
+		histogram_size = hydra_thrust::distance(merged_reduced_keys.first, merged_end.first);
+
+		contents.resize(histogram_size);
+		bins.resize(histogram_size);
+
+		hydra_thrust::copy(merged_reduced_keys.first, merged_end.first,  bins.begin());
+		hydra_thrust::copy(merged_reduced_values.first, merged_end.second,  contents.begin());
+
+		hydra::detail::return_temporary_buffer(policy, merged_keys.first);
+		hydra::detail::return_temporary_buffer(policy, merged_values.first);
+		hydra::detail::return_temporary_buffer(policy, merged_reduced_keys.first);
+		hydra::detail::return_temporary_buffer(policy, merged_reduced_values.first);
+	}
+
+	hydra::detail::return_temporary_buffer(policy, reduced_values.first);
+	hydra::detail::return_temporary_buffer(policy, reduced_keys.first);
+
+	return histogram_size;
+}
+
+namespace histogram {
+
+template<typename Generator, typename ...Iterators>
+auto is_chunk_generator_test(int) -> decltype(
+		size_t( std::declval<Generator&>()(std::declval<Iterators>()..., size_t()) ), std::true_type());
+
+template<typename Generator, typename ...Iterators>
+std::false_type is_chunk_generator_test(...);
+
+}  // namespace histogram
+
+/*
+ * Switches the accumulation of a histogram on for the lifetime of the guard
+ * and restores the previous setting on exit, also if a fill throws.
+ */
+class AccumulateGuard
+{
+public:
+
+	explicit AccumulateGuard(bool& accumulate):
+		fAccumulate(accumulate),
+		fSaved(accumulate)
+	{
+		fAccumulate = true;
+	}
+
+	AccumulateGuard(AccumulateGuard const&)=delete;
+
+	AccumulateGuard& operator=(AccumulateGuard const&)=delete;
+
+	~AccumulateGuard()
+	{
+		fAccumulate = fSaved;
+	}
+
+private:
+
+	bool& fAccumulate;
+	bool  fSaved;
+};
+
+/**
+ * Chunk generators are callables with signature
+ * size_t(Iterators... buffers, size_t capacity). They write at most \p capacity
+ * entries into the buffers and return the number of entries written. Zero signals
+ * the end of the stream.
+ */
+template<typename Generator, typename ...Iterators>
+struct is_chunk_generator:
+	decltype(histogram::is_chunk_generator_test<Generator, Iterators...>(0)){};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* HISTOGRAMFILL_H_ */
@@ -34,8 +34,12 @@
 #include <hydra/detail/utility/Generic.h>
 #include <hydra/Range.h>
 #include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/detail/utility/CompensatedSum.h>
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 #include <hydra/detail/external/hydra_thrust/inner_product.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 
 namespace hydra {
@@ -89,7 +93,7 @@ public:
 		hydra_thrust::counting_iterator<size_t> last = first + this->GetDataSize();
 
 		GReal_t final;
-		GReal_t init=0;
+		detail::CompensatedSum<GReal_t> init;
 
 		if (INFO >= Print::Level()  )
 		{
@@ -105,7 +109,7 @@ public:
 		auto NLL = detail::LogLikelihood1<functor_type>(this->GetPDF().GetFunctor());
 
 		final = hydra_thrust::transform_reduce(select_system(system),
-				this->begin(), this->end(), NLL, init, hydra_thrust::plus<GReal_t>());
+				this->begin(), this->end(), NLL, init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >()).Sum();
 
 		return (GReal_t)this->GetDataSize() -final ;
 	}
@@ -124,7 +128,7 @@ public:
 		hydra_thrust::counting_iterator<size_t> last = first + this->GetDataSize();
 
 		GReal_t final;
-		GReal_t init=0;
+		detail::CompensatedSum<GReal_t> init;
 
 		if (INFO >= Print::Level()  )
 		{
@@ -141,11 +145,220 @@ public:
 		auto NLL = detail::LogLikelihood2<functor_type>(this->GetPDF().GetFunctor());
 
 		final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(),this->wbegin(),
-				init,hydra_thrust::plus<GReal_t>(),NLL );
+				init,hydra_thrust::plus< detail::CompensatedSum<GReal_t> >(),NLL ).Sum();
 
 		return (GReal_t)this->GetDataSize() -final ;
 	}
 
+	/*
+	 * Value of the FCN, filling the derivatives with respect to the Minuit parameters in
+	 * gradient. Called by FCN::Gradient for functors implementing EvaluateWithParameters.
+	 */
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M==0), double >::type
+	EvalGradient( const std::vector<double>& parameters, std::vector<double>& gradient ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename hydra_thrust::iterator_system<IteratorD>::type System;
+		typedef typename Pdf<Functor,Integrator>::functor_type functor_type;
+		typedef typename detail::LogLikelihoodGradient1<functor_type>::dual_type dual_type;
+
+		System system;
+
+		const_cast< LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>* >(this)->GetPDF().SetParameters(parameters);
+
+		auto NLL = detail::LogLikelihoodGradient1<functor_type>(this->GetPDF().GetFunctor());
+
+		dual_type final = hydra_thrust::transform_reduce(select_system(system),
+				this->begin(), this->end(), NLL, dual_type(), hydra_thrust::plus<dual_type>());
+
+		return AddNormalization(parameters, final, gradient);
+	}
+
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M>0), double >::type
+	EvalGradient( const std::vector<double>& parameters, std::vector<double>& gradient ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename hydra_thrust::iterator_system<typename FCN<LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>>::iterator>::type System;
+		typedef typename Pdf<Functor,Integrator>::functor_type functor_type;
+		typedef typename detail::LogLikelihoodGradient2<functor_type>::dual_type dual_type;
+
+		System system;
+
+		const_cast< LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>* >(this)->GetPDF().SetParameters(parameters);
+
+		auto NLL = detail::LogLikelihoodGradient2<functor_type>(this->GetPDF().GetFunctor());
+
+		dual_type final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(),this->wbegin(),
+				dual_type(), hydra_thrust::plus<dual_type>(), NLL );
+
+		return AddNormalization(parameters, final, gradient);
+	}
+
+	/*
+	 * Values of the FCN at several parameter points. The pdf is evaluated at
+	 * HYDRA_FCN_BATCH_SIZE points per event, so the data is read once per batch
+	 * of points instead of once per point.
+	 */
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M==0), std::vector<double> >::type
+	Eval( const std::vector<std::vector<double>>& points ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename hydra_thrust::iterator_system<IteratorD>::type System;
+		typedef typename Pdf<Functor,Integrator>::functor_type functor_type;
+		typedef detail::LogLikelihoodBatch1<functor_type, HYDRA_FCN_BATCH_SIZE> batch_type;
+		typedef typename batch_type::value_type value_type;
+
+		System system;
+
+		std::vector<double> values(points.size());
+
+		for(size_t first=0; first < points.size(); first += HYDRA_FCN_BATCH_SIZE){
+
+			size_t last = std::min<size_t>(first + HYDRA_FCN_BATCH_SIZE, points.size());
+
+			auto NLL = batch_type( GetBatchFunctors(points, first, last) );
+
+			value_type final = hydra_thrust::transform_reduce(select_system(system),
+					this->begin(), this->end(), NLL, value_type(), hydra_thrust::plus<value_type>());
+
+			for(size_t i=first; i<last; i++)
+				values[i] = (GReal_t)this->GetDataSize() - final[i-first];
+		}
+
+		return values;
+	}
+
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M>0), std::vector<double> >::type
+	Eval( const std::vector<std::vector<double>>& points ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename hydra_thrust::iterator_system<typename FCN<LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>>::iterator>::type System;
+		typedef typename Pdf<Functor,Integrator>::functor_type functor_type;
+		typedef detail::LogLikelihoodBatch2<functor_type, HYDRA_FCN_BATCH_SIZE> batch_type;
+		typedef typename batch_type::value_type value_type;
+
+		System system;
+
+		std::vector<double> values(points.size());
+
+		for(size_t first=0; first < points.size(); first += HYDRA_FCN_BATCH_SIZE){
+
+			size_t last = std::min<size_t>(first + HYDRA_FCN_BATCH_SIZE, points.size());
+
+			auto NLL = batch_type( GetBatchFunctors(points, first, last) );
+
+			value_type final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(),this->wbegin(),
+					value_type(), hydra_thrust::plus<value_type>(), NLL );
+
+			for(size_t i=first; i<last; i++)
+				values[i] = (GReal_t)this->GetDataSize() - final[i-first];
+		}
+
+		return values;
+	}
+
+private:
+
+	/*
+	 * Copies of the normalized functor at the points [first, last).
+	 * The normalization integrals are computed here, on the host,
+	 * and go through the pdf cache. The pdf is left with the parameters
+	 * it had before the call.
+	 */
+	std::vector<typename Pdf<Functor,Integrator>::functor_type>
+	GetBatchFunctors( const std::vector<std::vector<double>>& points, size_t first, size_t last) const {
+
+		auto& pdf = const_cast< LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>* >(this)->GetPDF();
+
+		std::vector<double> current;
+
+		for(auto parameter: this->GetParameters().GetVariables())
+			current.push_back(parameter->GetValue());
+
+		std::vector<typename Pdf<Functor,Integrator>::functor_type> functors;
+
+		functors.reserve(last-first);
+
+		for(size_t i=first; i<last; i++){
+
+			if (INFO >= Print::Level()  )
+			{
+				std::ostringstream stringStream;
+				for(size_t j=0; j< points[i].size(); j++){
+					stringStream << "Parameter["<< j<<"] :  " << points[i][j]  << "  ";
+				}
+				HYDRA_LOG(INFO, stringStream.str().c_str() )
+			}
+
+			pdf.SetParameters(points[i]);
+
+			functors.push_back(pdf.GetFunctor());
+		}
+
+		pdf.SetParameters(current);
+
+		return functors;
+	}
+
+	/*
+	 * With S the (weighted) sum of log f over the data and W the data size,
+	 * FCN = W - S + W log(I), where I is the integral of the functor.
+	 * The derivatives of log(I) are taken by central differences of the
+	 * integrator, which does not need any pass over the data.
+	 */
+	template<typename Dual>
+	inline double AddNormalization( const std::vector<double>& parameters,
+			Dual const& sums, std::vector<double>& gradient ) const {
+
+		auto& pdf = const_cast< LogLikelihoodFCN< Pdf<Functor,Integrator>, IteratorD, IteratorW...>* >(this)->GetPDF();
+
+		const GReal_t W = this->GetDataSize();
+		const GReal_t I = pdf.GetNorm();
+
+		std::vector<bool> done(parameters.size(), false);
+		std::vector<double> shifted(parameters);
+
+		for(size_t k=0; k<Dual::size; k++){
+
+			hydra::Parameter const& par = pdf.GetFunctor().GetParameter(k);
+
+			if( par.IsFixed() ) continue;
+
+			size_t index = par.GetIndex();
+
+			gradient[index] -= sums.Derivative(k);
+
+			//parameters shared by several slots change the normalization once
+			if( done[index] ) continue;
+
+			done[index] = true;
+
+			GReal_t h = 1.0e-5*(std::fabs(parameters[index]) + par.GetError());
+
+			if( h == 0.0 ) h = 1.0e-8;
+
+			shifted[index] = parameters[index] + h;
+			pdf.SetParameters(shifted);
+			GReal_t I_up = pdf.GetNorm();
+
+			shifted[index] = parameters[index] - h;
+			pdf.SetParameters(shifted);
+			GReal_t I_down = pdf.GetNorm();
+
+			shifted[index] = parameters[index];
+
+			gradient[index] += W*(::log(I_up) - ::log(I_down))/(2.0*h);
+		}
+
+		pdf.SetParameters(parameters);
+
+		return W - sums.Value() + W*::log(I);
+	}
+
 };
 
 
@@ -32,6 +32,8 @@
 #include <hydra/FCN.h>
 #include <hydra/PDFSumExtendable.h>
 #include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/detail/utility/CompensatedSum.h>
+#include <hydra/detail/ComponentDensityCache.h>
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 #include <hydra/detail/external/hydra_thrust/inner_product.h>
 
@@ -45,15 +47,21 @@ public:
 
 	typedef void likelihood_estimator_type;
 
+	typedef typename hydra_thrust::iterator_system<IteratorD>::type data_system_type;
+
+	constexpr static size_t npdfs = PDFSumExtendable<Pdfs...>::npdfs;
+
 	LogLikelihoodFCN()=delete;
 
 
 	LogLikelihoodFCN(PDFSumExtendable<Pdfs...> const& functor, IteratorD begin, IteratorD end, IteratorW ...wbegin):
-		FCN<LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>, true>(functor,begin, end, wbegin...)
+		FCN<LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>, true>(functor,begin, end, wbegin...),
+		fComponentCaching(false)
 		{}
 
 	LogLikelihoodFCN(LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>const& other):
-		FCN<LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>, true>(other)
+		FCN<LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>, true>(other),
+		fComponentCaching(other.IsCachingComponents())
 		{}
 
 	LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>&
@@ -61,9 +69,36 @@ public:
 	{
 		if(this==&other) return  *this;
 		FCN<LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>, true>::operator=(other);
+		fComponentCaching = other.IsCachingComponents();
+		fComponentCache.Invalidate();
 		return  *this;
 	}
 
+	/**
+	 * \brief Enable or disable the caching of the per-event component densities.
+	 *
+	 * Disabled by default. When enabled, the normalized density of each component is kept for
+	 * every event on the back-end of the data, using memory for npdfs values per event,
+	 * and only the components whose parameters changed are evaluated again.
+	 * It pays off in fits where many steps vary only the yields or fractions.
+	 */
+	inline void SetComponentCaching(bool caching)
+	{
+		fComponentCaching = caching;
+
+		if( !caching ) fComponentCache.Release();
+	}
+
+	inline bool IsCachingComponents() const
+	{
+		return fComponentCaching;
+	}
+
+	inline detail::ComponentDensityCache<data_system_type, npdfs> const& GetComponentCache() const
+	{
+		return fComponentCache;
+	}
+
 	template<size_t M = sizeof...(IteratorW)>
 	inline typename std::enable_if<(M==0), double >::type
 	Eval( const std::vector<double>& parameters ) const{
@@ -76,10 +111,10 @@ public:
 
 		// create iterators
 		hydra_thrust::counting_iterator<size_t> first(0);
-		hydra_thrust::counting_iterator<size_t> last = first + this->GetDataSize();
+		hydra_thrust::counting_iterator<size_t> last = first + hydra_thrust::distance(this->begin(), this->end());
 
 		GReal_t final;
-		GReal_t init=0;
+		detail::CompensatedSum<GReal_t> init;
 
 		if (INFO >= Print::Level()  )
 		{
@@ -92,10 +127,25 @@ public:
 
 		const_cast< LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>*  >(this)->GetPDF().SetParameters(parameters);
 
-		auto NLL = detail::LogLikelihood1<functor_type>(this->GetPDF().GetFunctor());
+		if( fComponentCaching ){
+
+			auto functor = this->GetPDF().GetFunctor();
+
+			GReal_t const* columns = fComponentCache.Update(functor.GetFunctors(), this->begin(), this->end());
 
-		final = hydra_thrust::transform_reduce(select_system(system), this->begin(), this->end(),
-				NLL, init, hydra_thrust::plus<GReal_t>());
+			auto NLL = detail::LogLikelihoodComponents<npdfs>(columns, fComponentCache.GetNumberOfEntries(),
+					functor.GetCoefficients(), functor.GetCoefSum());
+
+			final = hydra_thrust::transform_reduce(select_system(system), first, last,
+					NLL, init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >()).Sum();
+		}
+		else {
+
+			auto NLL = detail::LogLikelihood1<functor_type>(this->GetPDF().GetFunctor());
+
+			final = hydra_thrust::transform_reduce(select_system(system), this->begin(), this->end(),
+					NLL, init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >()).Sum();
+		}
 
 		GReal_t  r = (GReal_t)this->GetDataSize() + this->GetPDF().IsExtended()*
 				( this->GetPDF().GetCoefSum() -	this->GetDataSize()*::log(this->GetPDF().GetCoefSum() ) ) - final;
@@ -115,10 +165,10 @@ public:
 
 		// create iterators
 		hydra_thrust::counting_iterator<size_t> first(0);
-		hydra_thrust::counting_iterator<size_t> last = first + this->GetDataSize();
+		hydra_thrust::counting_iterator<size_t> last = first + hydra_thrust::distance(this->begin(), this->end());
 
 		GReal_t final;
-		GReal_t init=0;
+		detail::CompensatedSum<GReal_t> init;
 
 		if (INFO >= Print::Level()  )
 		{
@@ -131,10 +181,25 @@ public:
 
 		const_cast< LogLikelihoodFCN<PDFSumExtendable<Pdfs...>, IteratorD, IteratorW...>*  >(this)->GetPDF().SetParameters(parameters);
 
-		auto NLL = detail::LogLikelihood2<functor_type>(this->GetPDF().GetFunctor());
+		if( fComponentCaching ){
+
+			auto functor = this->GetPDF().GetFunctor();
+
+			GReal_t const* columns = fComponentCache.Update(functor.GetFunctors(), this->begin(), this->end());
 
-		final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(),this->wbegin(),
-				 init,hydra_thrust::plus<GReal_t>(),NLL );
+			auto NLL = detail::LogLikelihoodComponents<npdfs>(columns, fComponentCache.GetNumberOfEntries(),
+					functor.GetCoefficients(), functor.GetCoefSum());
+
+			final = hydra_thrust::inner_product(select_system(system), first, last, this->wbegin(),
+					init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >(), NLL ).Sum();
+		}
+		else {
+
+			auto NLL = detail::LogLikelihood2<functor_type>(this->GetPDF().GetFunctor());
+
+			final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(),this->wbegin(),
+					init,hydra_thrust::plus< detail::CompensatedSum<GReal_t> >(),NLL ).Sum();
+		}
 
 		GReal_t  r = (GReal_t)this->GetDataSize() + this->GetPDF().IsExtended()*
 				( this->GetPDF().GetCoefSum() -	this->GetDataSize()*::log(this->GetPDF().GetCoefSum() ) ) - final;
@@ -142,6 +207,11 @@ public:
 		return r;
 
 	}
+
+private:
+
+	bool fComponentCaching;
+	mutable detail::ComponentDensityCache<data_system_type, npdfs> fComponentCache;
 };
 
 
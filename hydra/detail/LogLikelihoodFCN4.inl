@@ -0,0 +1,237 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+/*
+ * LogLikelihoodFCN4.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef LOGLIKELIHOODFCN4_INL_
+#define LOGLIKELIHOODFCN4_INL_
+
+
+#include <hydra/FCN.h>
+#include <hydra/CoherentSum.h>
+#include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/detail/utility/CompensatedSum.h>
+#include <hydra/detail/AmplitudeCache.h>
+#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+#include <hydra/detail/external/hydra_thrust/inner_product.h>
+
+namespace hydra {
+
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename IteratorD , typename ...IteratorW>
+class LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, IteratorD, IteratorW...>:
+	public FCN<LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, IteratorD, IteratorW ...>, true >
+{
+	typedef CoherentSum<IteratorN, IteratorWN, Amplitudes...> pdf_type;
+	typedef LogLikelihoodFCN< pdf_type, IteratorD, IteratorW...> this_type;
+	typedef FCN<this_type, true> super_type;
+
+public:
+
+	typedef void likelihood_estimator_type;
+
+	typedef typename hydra_thrust::iterator_system<IteratorD>::type data_system_type;
+
+	constexpr static size_t namplitudes = pdf_type::namplitudes;
+
+	LogLikelihoodFCN()=delete;
+
+	LogLikelihoodFCN(pdf_type const& pdf, IteratorD begin, IteratorD end, IteratorW ...wbegin):
+		super_type(pdf, begin, end, wbegin...),
+		fAmplitudeCaching(true)
+		{}
+
+	LogLikelihoodFCN(this_type const& other):
+		super_type(other),
+		fAmplitudeCaching(other.IsCachingAmplitudes())
+		{}
+
+	this_type& operator=(this_type const& other)
+	{
+		if(this==&other) return  *this;
+		super_type::operator=(other);
+		fAmplitudeCaching = other.IsCachingAmplitudes();
+		fAmplitudeCache.Invalidate();
+		return  *this;
+	}
+
+	/**
+	 * \brief Enable or disable the caching of the per-event amplitudes.
+	 *
+	 * When enabled (default), the complex amplitude of each component is kept for
+	 * every event on the back-end of the data, using memory for namplitudes complex
+	 * values per event, and only the amplitudes whose parameters changed are evaluated again.
+	 */
+	inline void SetAmplitudeCaching(bool caching)
+	{
+		fAmplitudeCaching = caching;
+
+		if( !caching ) fAmplitudeCache.Release();
+	}
+
+	inline bool IsCachingAmplitudes() const
+	{
+		return fAmplitudeCaching;
+	}
+
+	inline detail::AmplitudeCache<data_system_type, namplitudes> const& GetAmplitudeCache() const
+	{
+		return fAmplitudeCache;
+	}
+
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M==0), double >::type
+	Eval( const std::vector<double>& parameters ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename pdf_type::functor_type functor_type;
+		data_system_type system;
+
+		// create iterators
+		hydra_thrust::counting_iterator<size_t> first(0);
+		hydra_thrust::counting_iterator<size_t> last = first + hydra_thrust::distance(this->begin(), this->end());
+
+		GReal_t final;
+		detail::CompensatedSum<GReal_t> init;
+
+		if (INFO >= Print::Level()  )
+		{
+			std::ostringstream stringStream;
+			for(size_t i=0; i< parameters.size(); i++){
+				stringStream << "Parameter["<< i<<"] :  " << parameters[i]  << "  ";
+			}
+			HYDRA_LOG(INFO, stringStream.str().c_str() )
+		}
+
+		const_cast< this_type* >(this)->GetPDF().SetParameters(parameters);
+
+		auto functor = this->GetPDF().GetFunctor();
+
+		if( fAmplitudeCaching ){
+
+			hydra::complex<double> const* columns = fAmplitudeCache.Update(functor.GetFunctors(), this->begin(), this->end());
+
+			auto NLL = detail::LogLikelihoodAmplitudes<namplitudes>(columns, fAmplitudeCache.GetNumberOfEntries(),
+					functor.GetCoefficients(), functor.GetInverseNorm());
+
+			final = hydra_thrust::transform_reduce(select_system(system), first, last,
+					NLL, init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >()).Sum();
+		}
+		else {
+
+			auto NLL = detail::LogLikelihood1<functor_type>(functor);
+
+			final = hydra_thrust::transform_reduce(select_system(system), this->begin(), this->end(),
+					NLL, init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >()).Sum();
+		}
+
+		return -final;
+	}
+
+	template<size_t M = sizeof...(IteratorW)>
+	inline typename std::enable_if<(M>0), double >::type
+	Eval( const std::vector<double>& parameters ) const{
+
+		using   hydra_thrust::system::detail::generic::select_system;
+		typedef typename hydra_thrust::iterator_system<typename super_type::iterator>::type System;
+		typedef typename pdf_type::functor_type functor_type;
+		System system;
+
+		// create iterators
+		hydra_thrust::counting_iterator<size_t> first(0);
+		hydra_thrust::counting_iterator<size_t> last = first + hydra_thrust::distance(this->begin(), this->end());
+
+		GReal_t final;
+		detail::CompensatedSum<GReal_t> init;
+
+		if (INFO >= Print::Level()  )
+		{
+			std::ostringstream stringStream;
+			for(size_t i=0; i< parameters.size(); i++){
+				stringStream << "Parameter["<< i<<"] :  " << parameters[i]  << "  ";
+			}
+			HYDRA_LOG(INFO, stringStream.str().c_str() )
+		}
+
+		const_cast< this_type* >(this)->GetPDF().SetParameters(parameters);
+
+		auto functor = this->GetPDF().GetFunctor();
+
+		if( fAmplitudeCaching ){
+
+			hydra::complex<double> const* columns = fAmplitudeCache.Update(functor.GetFunctors(), this->begin(), this->end());
+
+			auto NLL = detail::LogLikelihoodAmplitudes<namplitudes>(columns, fAmplitudeCache.GetNumberOfEntries(),
+					functor.GetCoefficients(), functor.GetInverseNorm());
+
+			final = hydra_thrust::inner_product(select_system(system), first, last, this->wbegin(),
+					init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >(), NLL ).Sum();
+		}
+		else {
+
+			auto NLL = detail::LogLikelihood2<functor_type>(functor);
+
+			final = hydra_thrust::inner_product(select_system(system), this->begin(), this->end(), this->wbegin(),
+					init, hydra_thrust::plus< detail::CompensatedSum<GReal_t> >(), NLL ).Sum();
+		}
+
+		return -final;
+	}
+
+private:
+
+	bool fAmplitudeCaching;
+	mutable detail::AmplitudeCache<data_system_type, namplitudes> fAmplitudeCache;
+};
+
+
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename Iterator, typename ...Iterators >
+inline typename std::enable_if< hydra::detail::is_iterator<Iterator>::value  && detail::are_iterators<Iterators...>::value,
+LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, Iterator, Iterators... >>::type
+make_loglikehood_fcn(CoherentSum<IteratorN, IteratorWN, Amplitudes...> const& pdf, Iterator first, Iterator last, Iterators... weights )
+{
+	return LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>, Iterator, Iterators...>( pdf, first, last, weights...);
+}
+
+
+template<typename IteratorN, typename IteratorWN, typename ...Amplitudes, typename Iterable, typename ...Iterables >
+inline typename std::enable_if<   (!detail::is_iterator<Iterable>::value) &&
+                                  ((sizeof...(Iterables)==0) || !detail::are_iterators<Iterables...>::value) &&
+                                  (!hydra::detail::is_hydra_dense_histogram< typename std::remove_reference<Iterable>::type>::value) &&
+		                          (!hydra::detail::is_hydra_sparse_histogram<typename std::remove_reference<Iterable>::type>::value) &&
+								  detail::is_iterable<Iterable>::value && detail::are_iterables<Iterables...>::value  ,
+LogLikelihoodFCN< CoherentSum<IteratorN, IteratorWN, Amplitudes...>,
+                  decltype(std::declval<Iterable>().begin() ),
+                  decltype(std::declval<Iterables>().begin())... > >::type
+make_loglikehood_fcn(CoherentSum<IteratorN, IteratorWN, Amplitudes...> const& pdf, Iterable&& points, Iterables&&... weights ){
+
+	return make_loglikehood_fcn( pdf,
+			std::forward<Iterable>(points).begin(),
+			std::forward<Iterable>(points).end(),
+			std::forward<Iterables>(weights).begin() ...);
+}
+
+}  // namespace hydra
+
+#endif /* LOGLIKELIHOODFCN4_INL_ */
@@ -38,6 +38,7 @@
 #include <hydra/detail/utility/Utility_Tuple.h>
 #include <hydra/detail/base_functor.h>
 #include <hydra/detail/Constant.h>
+#include <hydra/detail/Hash.h>
 #include <hydra/Parameter.h>
 #include <hydra/Placeholders.h>
 
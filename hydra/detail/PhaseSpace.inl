@@ -444,6 +444,116 @@ void PhaseSpace<N,GRND>::Generate(hydra::detail::BackendPolicy<BACKEND> const& e
 }
 
 
+//========================
+template <size_t N, typename GRND>
+template<typename Trials, typename Pointer, hydra::detail::Backend BACKEND>
+inline void PhaseSpace<N,GRND>::GenerateChunk(hydra::detail::BackendPolicy<BACKEND> const& policy,
+		Vector4R const& mother, Trials& trials, Pointer weights, size_t first, size_t n) const
+{
+	detail::DecayMother<N,GRND> decayer(mother, fMasses, fMaxWeight, fECM, fSeed);
+
+	hydra_thrust::counting_iterator<size_t> index(first);
+
+	//the events keep their index in the whole sample, so the result does not depend on the chunk size
+	hydra_thrust::transform(policy, index, index + n, trials.begin(),
+			detail::WeightedDecayMother<N,GRND>(decayer, hydra_thrust::raw_pointer_cast(weights), first));
+}
+
+template <size_t N, typename GRND>
+template<typename Container, hydra::detail::Backend BACKEND>
+typename std::enable_if< hydra::detail::is_iterable<Container>::value,
+	hydra::Range<decltype(std::declval<Container&>().begin())>>::type
+PhaseSpace<N,GRND>::GenerateUnweighted(hydra::detail::BackendPolicy<BACKEND> const& policy, Vector4R const& mother,
+		size_t ntrials, Container& output, size_t seed, size_t chunk_size)
+{
+	typedef typename hydra_thrust::iterator_traits<decltype(output.begin())>::value_type value_type;
+
+	size_t offset = output.size();
+
+	chunk_size = chunk_size > 0 ? chunk_size : 1;
+
+	size_t ntrials_chunk = ntrials < chunk_size ? ntrials : chunk_size;
+
+	if( ntrials==0 ) return hydra::make_range(output.begin() + offset, output.end());
+
+	multivector<value_type, hydra::detail::BackendPolicy<BACKEND>> trials(ntrials_chunk);
+
+	auto weights = hydra::detail::get_temporary_buffer<double>(policy, ntrials_chunk);
+
+	for(size_t first = 0; first < ntrials; first += chunk_size ){
+
+		size_t n = chunk_size < ntrials - first ? chunk_size : ntrials - first;
+
+		GenerateChunk(policy, mother, trials, weights.first, first, n);
+
+		detail::append_accepted(policy, trials.begin(), weights.first, n, first, fMaxWeight, seed, output);
+	}
+
+	hydra::detail::return_temporary_buffer(policy, weights.first);
+
+	return hydra::make_range(output.begin() + offset, output.end());
+}
+
+template <size_t N, typename GRND>
+template<typename Functor, typename Container, hydra::detail::Backend BACKEND>
+typename std::enable_if< hydra::detail::is_iterable<Container>::value &&
+	(detail::is_hydra_functor<Functor>::value ||
+	 detail::is_hydra_lambda<Functor>::value  ||
+	 detail::is_hydra_composite_functor<Functor>::value),
+	hydra::Range<decltype(std::declval<Container&>().begin())>>::type
+PhaseSpace<N,GRND>::GenerateUnweighted(hydra::detail::BackendPolicy<BACKEND> const& policy, Vector4R const& mother,
+		size_t ntrials, Functor const& functor, Container& output, double max_weight, size_t seed, size_t chunk_size)
+{
+	typedef typename hydra_thrust::iterator_traits<decltype(output.begin())>::value_type value_type;
+
+	size_t offset = output.size();
+
+	chunk_size = chunk_size > 0 ? chunk_size : 1;
+
+	size_t ntrials_chunk = ntrials < chunk_size ? ntrials : chunk_size;
+
+	if( ntrials==0 ) return hydra::make_range(output.begin() + offset, output.end());
+
+	multivector<value_type, hydra::detail::BackendPolicy<BACKEND>> trials(ntrials_chunk);
+
+	auto weights = hydra::detail::get_temporary_buffer<double>(policy, ntrials_chunk);
+
+	detail::ApplyEventFunctor<Functor> reweight(functor);
+
+	if( !(max_weight > 0.0) ){
+
+		max_weight = 0.0;
+
+		for(size_t first = 0; first < ntrials; first += chunk_size ){
+
+			size_t n = chunk_size < ntrials - first ? chunk_size : ntrials - first;
+
+			GenerateChunk(policy, mother, trials, weights.first, first, n);
+
+			hydra_thrust::transform(policy, trials.begin(), trials.begin() + n, weights.first, weights.first, reweight);
+
+			double chunk_max = *(hydra_thrust::max_element(policy, weights.first, weights.first + n));
+
+			max_weight = chunk_max > max_weight ? chunk_max : max_weight;
+		}
+	}
+
+	for(size_t first = 0; first < ntrials; first += chunk_size ){
+
+		size_t n = chunk_size < ntrials - first ? chunk_size : ntrials - first;
+
+		GenerateChunk(policy, mother, trials, weights.first, first, n);
+
+		hydra_thrust::transform(policy, trials.begin(), trials.begin() + n, weights.first, weights.first, reweight);
+
+		detail::append_accepted(policy, trials.begin(), weights.first, n, first, max_weight, seed, output);
+	}
+
+	hydra::detail::return_temporary_buffer(policy, weights.first);
+
+	return hydra::make_range(output.begin() + offset, output.end());
+}
+
 template <size_t N, typename GRND>
 inline GInt_t PhaseSpace<N,GRND>::GetSeed() const	{
 	return fSeed;
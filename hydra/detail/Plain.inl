@@ -38,6 +38,7 @@ template<typename FUNCTOR>
 inline std::pair<GReal_t, GReal_t>
 Plain<N,hydra::detail::BackendPolicy<BACKEND>,GRND>::Integrate(FUNCTOR const& fFunctor)
 {
+	if( fQMCMode != QMC_NONE ) return IntegrateQMC(fFunctor);
 
 	// create iterators
 	hydra_thrust::counting_iterator<size_t> first(0);
@@ -58,6 +59,52 @@ Plain<N,hydra::detail::BackendPolicy<BACKEND>,GRND>::Integrate(FUNCTOR const& fF
 
 }
 
+template< size_t N,hydra::detail::Backend BACKEND, typename GRND>
+template<typename FUNCTOR>
+inline std::pair<GReal_t, GReal_t>
+Plain<N,hydra::detail::BackendPolicy<BACKEND>,GRND>::IntegrateQMC(FUNCTOR const& fFunctor)
+{
+	size_t npoints = fNCalls/fReplicas;
+
+	if( npoints == 0 )
+		throw std::invalid_argument("[hydra::Plain]: less calls than QMC replicas.");
+
+	if( !fDirections ) fDirections = detail::sobol_directions<N>(system_t());
+
+	hydra_thrust::counting_iterator<size_t> first(0);
+	hydra_thrust::counting_iterator<size_t> last = first + npoints;
+
+	uint64_t seed = fSeed;
+
+	// the replica estimates are combined as a sample of independent measurements
+	PlainState replicas;
+
+	for(size_t r=0; r<fReplicas; r++){
+
+		detail::ScrambledSobol<N> points(hydra_thrust::raw_pointer_cast(fDirections->data()),
+				hydra::random::splitmix<uint64_t>(seed), fQMCMode);
+
+		PlainState result = hydra_thrust::transform_reduce(system_t(), first, last,
+				detail::ProcessCallsPlainQMC<FUNCTOR,N>(const_cast<GReal_t*>(hydra_thrust::raw_pointer_cast(fXLow.data())),
+						const_cast<GReal_t*>(hydra_thrust::raw_pointer_cast(fDeltaX.data())), points, fFunctor),
+				PlainState(), detail::ProcessCallsPlainBinary() );
+
+		PlainState replica;
+		replica.fN    = 1;
+		replica.fMin  = result.fMean;
+		replica.fMax  = result.fMean;
+		replica.fMean = result.fMean;
+		replica.fM2   = 0;
+
+		replicas = r==0 ? replica : detail::ProcessCallsPlainBinary()(replicas, replica);
+	}
+
+	fResult   = fVolume*replicas.fMean;
+	fAbsError = fVolume*::sqrt( replicas.fM2/(fReplicas*(fReplicas-1)) );
+
+	return std::make_pair(fResult, fAbsError);
+}
+
 }
 
 //#endif /* PLAIN_INL_ */
@@ -35,10 +35,239 @@
 #ifndef RANDOM_INL_
 #define RANDOM_INL_
 
+#include <hydra/MemoryPool.h>
 #include <hydra/detail/external/hydra_thrust/memory.h>
 
 namespace hydra{
 
+namespace detail {
+
+namespace random {
+
+/*
+ * Maps the trial index to the position of its first number in
+ * the random stream, so trials drawing N numbers do not overlap.
+ */
+struct TrialIndex
+{
+	TrialIndex(size_t stride):
+		fStride(stride)
+	{}
+
+	__hydra_host__ __hydra_device__
+	TrialIndex(TrialIndex const& other):
+		fStride(other.fStride)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline size_t operator()(size_t index) const {
+		return fStride*index;
+	}
+
+	size_t fStride;
+};
+
+/*
+ * Batch generators for the exact-count unweighting. They fill the trials
+ * and their weights, starting from the trial number 'offset', and return
+ * the number of trials produced, which is zero when the source is exhausted.
+ */
+template<typename Sampler, size_t N>
+struct TrialGenerator
+{
+	TrialGenerator(Sampler const& sampler):
+		fSampler(sampler)
+	{}
+
+	template<typename System, typename Iterator, typename Pointer>
+	size_t operator()(System& system, Iterator trials, Pointer values, size_t offset, size_t n) const
+	{
+		auto index = hydra_thrust::make_transform_iterator(
+				hydra_thrust::counting_iterator<size_t>(offset), TrialIndex(N));
+
+		hydra_thrust::transform(system, index, index + n, trials, values, fSampler);
+
+		return n;
+	}
+
+	Sampler fSampler;
+};
+
+template<typename Iterator, typename Functor>
+struct FunctorDataGenerator
+{
+	FunctorDataGenerator(Iterator begin, Iterator end, Functor const& functor):
+		fBegin(begin),
+		fSize(hydra_thrust::distance(begin, end)),
+		fFunctor(functor)
+	{}
+
+	template<typename System, typename TrialIterator, typename Pointer>
+	size_t operator()(System& system, TrialIterator trials, Pointer values, size_t offset, size_t n) const
+	{
+		if(offset >= fSize) return 0;
+
+		n = n < fSize - offset ? n : fSize - offset;
+
+		hydra_thrust::copy(fBegin + offset, fBegin + offset + n, trials);
+		hydra_thrust::transform(system, trials, trials + n, values, fFunctor);
+
+		return n;
+	}
+
+	Iterator fBegin;
+	size_t   fSize;
+	Functor  fFunctor;
+};
+
+template<typename IteratorData, typename IteratorWeight>
+struct WeightedDataGenerator
+{
+	WeightedDataGenerator(IteratorData begin, IteratorData end, IteratorWeight weights):
+		fBegin(begin),
+		fWeights(weights),
+		fSize(hydra_thrust::distance(begin, end))
+	{}
+
+	template<typename System, typename TrialIterator, typename Pointer>
+	size_t operator()(System&, TrialIterator trials, Pointer values, size_t offset, size_t n) const
+	{
+		if(offset >= fSize) return 0;
+
+		n = n < fSize - offset ? n : fSize - offset;
+
+		hydra_thrust::copy(fBegin + offset, fBegin + offset + n, trials);
+		hydra_thrust::copy(fWeights + offset, fWeights + offset + n, values);
+
+		return n;
+	}
+
+	IteratorData   fBegin;
+	IteratorWeight fWeights;
+	size_t fSize;
+};
+
+/*
+ * Appends to 'output' exactly 'nevents' entries accepted from the batches
+ * produced by 'generator', or fewer if the generator runs out, or if a
+ * full batch of 'max_batch' trials is rejected before any entry is accepted
+ * (e.g. the weights are not positive, or NaN, everywhere).
+ * The batch size follows the running acceptance rate. If 'max_pdf' is
+ * not positive, the maximum weight is estimated on the fly and, when a
+ * batch raises it from M to M', the entries accepted before are kept
+ * with probability M/M', so each entry ends up accepted with probability
+ * w/M' as if M' had been used from the start.
+ */
+template<typename RNG, typename Container, typename Generator>
+Range< decltype(std::declval<Container&>().begin())>
+exact_unweight(Container& output, size_t nevents, Generator const& generator,
+		double max_pdf, size_t seed, size_t rng_jump, size_t max_batch)
+{
+	typedef typename hydra_thrust::iterator_system<decltype(output.begin())>::type system_type;
+	typedef hydra_thrust::pointer<double, system_type> pointer_type;
+	typedef detail::RndFlag<double, pointer_type, RNG> flagger_type;
+	typedef detail::RndFlag<double, hydra_thrust::constant_iterator<double>, RNG> thinner_type;
+
+	system_type system;
+
+	size_t offset = output.size();
+
+	if( nevents==0 ) return make_range(output.begin() + offset, output.begin() + offset);
+
+	output.resize(offset + nevents);
+
+	max_batch = max_batch > 0 ? max_batch : 1;
+
+	size_t batch = nevents < max_batch ? nevents : max_batch;
+
+	Container trials(batch);
+	auto values = hydra::detail::get_temporary_buffer<double>(system, batch);
+
+	bool   estimate  = !(max_pdf > 0.0);
+	double max_value = estimate ? 0.0 : max_pdf;
+
+	size_t naccepted = 0;
+	size_t ntrials   = 0;
+	size_t nthinned  = 0;
+
+	hydra_thrust::counting_iterator<size_t> first(0);
+
+	while( naccepted < nevents ){
+
+		if( batch > trials.size() ){
+
+			trials.resize(batch);
+
+			hydra::detail::return_temporary_buffer(system, values.first);
+			values = hydra::detail::get_temporary_buffer<double>(system, batch);
+		}
+
+		size_t n = generator(system, trials.begin(), values.first, ntrials, batch);
+
+		if( n==0 ) break;
+
+		size_t nnew = 0;
+
+		if( estimate ){
+
+			double batch_max = *( hydra_thrust::max_element(system, values.first, values.first + n) );
+
+			if( batch_max > max_value ){
+
+				if( naccepted > 0 ){
+
+					auto accepted = output.begin() + offset;
+
+					auto r = hydra_thrust::partition(system, accepted, accepted + naccepted, first,
+							thinner_type(seed + 2, rng_jump + nthinned, batch_max,
+									hydra_thrust::constant_iterator<double>(max_value)) );
+
+					nthinned += naccepted;
+					naccepted = hydra_thrust::distance(accepted, r);
+				}
+
+				max_value = batch_max;
+			}
+		}
+
+		if( max_value > 0.0 ){
+
+			auto r = hydra_thrust::partition(system, trials.begin(), trials.begin() + n, first,
+					flagger_type(seed + 1, rng_jump + ntrials, max_value, values.first) );
+
+			nnew = hydra_thrust::distance(trials.begin(), r);
+
+			nnew = nnew < nevents - naccepted ? nnew : nevents - naccepted;
+
+			hydra_thrust::copy(system, trials.begin(), trials.begin() + nnew,
+					output.begin() + offset + naccepted);
+
+			naccepted += nnew;
+		}
+
+		ntrials += n;
+
+		//nothing accepted in a full batch and before it: the weights are not usable
+		if( naccepted == 0 && nnew == 0 && n == max_batch ) break;
+
+		//size the next batch to complete the sample, with 10% of margin
+		size_t remaining = nevents - naccepted;
+
+		batch = naccepted > 0 ? size_t(1.1*remaining*double(ntrials)/naccepted) + 1 : 2*batch;
+		batch = batch < max_batch ? batch : max_batch;
+	}
+
+	hydra::detail::return_temporary_buffer(system, values.first);
+
+	output.resize(offset + naccepted);
+
+	return make_range(output.begin() + offset, output.begin() + offset + naccepted);
+}
+
+}  // namespace random
+
+}  // namespace detail
+
 template<typename RNG, typename DerivedPolicy, typename IteratorData, typename IteratorWeight>
 typename std::enable_if<
 	detail::random::is_iterator<IteratorData>::value && detail::random::is_iterator<IteratorWeight>::value,
@@ -65,7 +294,7 @@ unweight( hydra_thrust::detail::execution_policy_base<DerivedPolicy> const& poli
 	IteratorData r = hydra_thrust::partition(policy, data_begin, data_end, first,
 			flagger_type(rng_seed, rng_jump, max_value, weights_begin) );
 
-	return  make_range(begin , r);
+	return  make_range(data_begin , r);
 }
 
 
@@ -150,7 +379,7 @@ unweight(hydra_thrust::detail::execution_policy_base<DerivedPolicy>  const& poli
 
     size_t ntrials = hydra_thrust::distance( begin, end);
 
-    auto values = hydra_thrust::get_temporary_buffer<value_type>(policy, ntrials);
+    auto values = hydra::detail::get_temporary_buffer<value_type>(policy, ntrials);
 
 	// create iterators
 	hydra_thrust::counting_iterator<size_t> first(0);
@@ -165,8 +394,8 @@ unweight(hydra_thrust::detail::execution_policy_base<DerivedPolicy>  const& poli
 	Iterator r = hydra_thrust::partition(policy, begin, end, first,
 			flagger_type(rng_seed, rng_jump, max_value, values.first ) );
 
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(policy, values.first);
+	// deallocate storage with hydra::detail::return_temporary_buffer
+	hydra::detail::return_temporary_buffer(policy, values.first);
 
 	return  make_range(begin , r);
 
@@ -243,7 +472,7 @@ sample(hydra_thrust::detail::execution_policy_base<DerivedPolicy> const& policy,
 
     size_t ntrials = hydra_thrust::distance( begin, end);
 
-    auto values = hydra_thrust::get_temporary_buffer<value_type>( policy, ntrials);
+    auto values = hydra::detail::get_temporary_buffer<value_type>( policy, ntrials);
 
 	// create iterators
 	hydra_thrust::counting_iterator<size_t> first(0);
@@ -260,8 +489,8 @@ sample(hydra_thrust::detail::execution_policy_base<DerivedPolicy> const& policy,
 	Iterator r = hydra_thrust::partition(policy, begin, end, first,
 			flagger_type(seed, 2*rng_jump, max_value, values.first) );
 
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer( policy, values.first);
+	// deallocate storage with hydra::detail::return_temporary_buffer
+	hydra::detail::return_temporary_buffer( policy, values.first);
 
 	return make_range(begin , r);
 }
@@ -323,7 +552,7 @@ sample( hydra_thrust::detail::execution_policy_base<DerivedPolicy>  const& polic
     size_t ntrials = hydra_thrust::distance( begin, end);
 
 
-    auto values = hydra_thrust::get_temporary_buffer<value_type>(policy, ntrials);
+    auto values = hydra::detail::get_temporary_buffer<value_type>(policy, ntrials);
 
 	// create iterators
 	hydra_thrust::counting_iterator<size_t> first(0);
@@ -340,8 +569,8 @@ sample( hydra_thrust::detail::execution_policy_base<DerivedPolicy>  const& polic
 	Iterator r = hydra_thrust::partition(policy, begin, end, first,
 			flagger_type(seed, 2*rng_jump, max_value, values.first) );
 
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(policy, values.first);
+	// deallocate storage with hydra::detail::return_temporary_buffer
+	hydra::detail::return_temporary_buffer(policy, values.first);
 
 	return  make_range(begin , r);
 }
@@ -429,6 +658,72 @@ sample( Iterable&& output ,
 
 
 
+//---------------------------------------------------------------
+// exact-count sampling
+//---------------------------------------------------------------
+template<typename RNG, typename Functor, typename Container>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+sample(Container& output, size_t nevents, double min, double max,
+		Functor const& functor, size_t seed, size_t rng_jump, size_t max_batch)
+{
+	typedef detail::RndTrial<double, RNG, Functor, 1> sampler_type;
+
+	detail::random::TrialGenerator<sampler_type, 1> generator( sampler_type(seed, rng_jump, functor, min, max) );
+
+	return detail::random::exact_unweight<RNG>(output, nevents, generator, -1.0, seed, rng_jump, max_batch);
+}
+
+template<typename RNG, typename Functor, typename Container, size_t N>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+sample(Container& output, size_t nevents,
+		std::array<double,N>const& min, std::array<double,N>const& max,
+		Functor const& functor, size_t seed, size_t rng_jump, size_t max_batch)
+{
+	typedef detail::RndTrial<double, RNG, Functor, N> sampler_type;
+
+	detail::random::TrialGenerator<sampler_type, N> generator( sampler_type(seed, rng_jump, functor, min, max) );
+
+	return detail::random::exact_unweight<RNG>(output, nevents, generator, -1.0, seed, rng_jump, max_batch);
+}
+
+template<typename RNG, typename Functor, typename Iterable, typename Container>
+typename std::enable_if<
+detail::random::is_callable<Functor>::value && detail::random::is_iterable<Iterable>::value &&
+detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+unweight(Iterable&& data, Container& output, size_t nevents, Functor const& functor,
+		double max_pdf, size_t rng_seed, size_t rng_jump, size_t max_batch)
+{
+	typedef decltype(std::forward<Iterable>(data).begin()) iterator_type;
+
+	detail::random::FunctorDataGenerator<iterator_type, Functor> generator(
+			std::forward<Iterable>(data).begin(), std::forward<Iterable>(data).end(), functor);
+
+	return detail::random::exact_unweight<RNG>(output, nevents, generator, max_pdf, rng_seed, rng_jump, max_batch);
+}
+
+template<typename RNG, typename IterableData, typename IterableWeight, typename Container>
+typename std::enable_if<
+detail::random::is_iterable<IterableData>::value && detail::random::is_iterable<IterableWeight>::value &&
+detail::random::is_iterable<Container>::value,
+Range< decltype(std::declval<Container&>().begin())>>::type
+unweight(IterableData&& data, IterableWeight&& weights, Container& output, size_t nevents,
+		double max_pdf, size_t rng_seed, size_t rng_jump, size_t max_batch)
+{
+	typedef decltype(std::forward<IterableData>(data).begin()) iterator_type;
+	typedef decltype(std::forward<IterableWeight>(weights).begin()) weight_iterator_type;
+
+	detail::random::WeightedDataGenerator<iterator_type, weight_iterator_type> generator(
+			std::forward<IterableData>(data).begin(), std::forward<IterableData>(data).end(),
+			std::forward<IterableWeight>(weights).begin());
+
+	return detail::random::exact_unweight<RNG>(output, nevents, generator, max_pdf, rng_seed, rng_jump, max_batch);
+}
+
 }//namespace hydra
 
 
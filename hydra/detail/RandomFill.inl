@@ -40,6 +40,41 @@
 
 namespace hydra{
 
+namespace detail {
+
+namespace random {
+
+    /*
+     * Engines supporting block generation fill the range block by block
+     * on the host backends. The output is the same as detail::Sampler.
+     */
+    template<typename Engine, typename System, typename Iterator, typename FUNCTOR>
+    inline typename std::enable_if< hydra::detail::block_traits<Engine>::supported &&
+        !std::is_convertible<System, hydra_thrust::system::cuda::tag>::value, void>::type
+    fill_random(System const& system, Iterator begin, Iterator end, FUNCTOR const& functor,
+    		size_t seed, size_t rng_jump)
+    {
+        typedef detail::BlockSampler<FUNCTOR, Engine, Iterator> sampler_type;
+
+        sampler_type sampler(functor, begin, hydra_thrust::distance(begin, end), seed, rng_jump);
+
+        hydra_thrust::for_each(system, hydra_thrust::counting_iterator<size_t>(0),
+        		hydra_thrust::counting_iterator<size_t>(sampler.GetNumberOfBlocks()), sampler);
+    }
+
+    template<typename Engine, typename System, typename Iterator, typename FUNCTOR>
+    inline typename std::enable_if< !(hydra::detail::block_traits<Engine>::supported &&
+        !std::is_convertible<System, hydra_thrust::system::cuda::tag>::value), void>::type
+    fill_random(System const& system, Iterator begin, Iterator end, FUNCTOR const& functor,
+    		size_t seed, size_t rng_jump)
+    {
+        hydra_thrust::tabulate(system, begin, end, detail::Sampler<FUNCTOR,Engine>(functor, seed, rng_jump) );
+    }
+
+}  // namespace random
+
+}  // namespace detail
+
     /**
      * @brief Fill a range with numbers distributed according a user defined distribution using a RNG analytical formula
      * @param policy backend to perform the calculation.
@@ -64,7 +99,7 @@ namespace hydra{
         typedef  typename hydra_thrust::detail::remove_reference<
                     decltype(select_system( system, _policy ))>::type common_system_type;
  
-        hydra_thrust::tabulate( common_system_type(), begin, end, detail::Sampler<FUNCTOR,Engine>(functor, seed, rng_jump) );
+        detail::random::fill_random<Engine>(common_system_type(), begin, end, functor, seed, rng_jump);
 
     }
 
@@ -85,7 +120,7 @@ namespace hydra{
         typedef typename hydra_thrust::iterator_system<Iterator>::type system_t;
         system_t system;
 
-        hydra_thrust::tabulate(select_system(system), begin, end, detail::Sampler<FUNCTOR,Engine>(functor, seed, rng_jump) );
+        detail::random::fill_random<Engine>(select_system(system), begin, end, functor, seed, rng_jump);
     }
 
     /**
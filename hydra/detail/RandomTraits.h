@@ -43,6 +43,16 @@ namespace detail {
 
 template<typename Engine>
 struct random_traits;
+
+/*
+ * block_traits<Engine>::supported : the engine fills blocks with generate(first, last)
+ * block_traits<Engine>::stride    : numbers skipped by discard(1)
+ */
+template<typename Engine>
+struct block_traits
+{
+	enum{ supported=0, stride=1 };
+};
 /*
  * random_traits<T>::state_type { counter, state}
  * random_traits<T>::advance_type;
@@ -34,6 +34,7 @@
 #include <utility>
 #include <hydra/detail/external/hydra_thrust/sort.h>
 #include <hydra/Range.h>
+#include <hydra/MemoryPool.h>
 
 
 namespace hydra {
@@ -97,14 +98,14 @@ sort_by_key(Iterable& iterable, Range<Iterator_Key,Functor> keys){
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(system1, system2 ))>::type common_system_t;
 
-	auto key_buffer = hydra_thrust::get_temporary_buffer<Value_Key>(common_system_t(), iterable.size());
+	auto key_buffer = hydra::detail::get_temporary_buffer<Value_Key>(common_system_t(), iterable.size());
 
 	hydra_thrust::copy(common_system_t(), keys.begin(), keys.end(), key_buffer.first);
 
 	hydra_thrust::stable_sort_by_key(key_buffer.first, key_buffer.first +key_buffer.second, iterable.begin() );
 
 
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
+	hydra::detail::return_temporary_buffer(common_system_t(), key_buffer.first);
 
 	return make_range(iterable.begin(), iterable.end());
 }
@@ -34,6 +34,7 @@
 #include <hydra/detail/external/hydra_thrust/gather.h>
 #include <hydra/detail/external/hydra_thrust/scatter.h>
 #include <hydra/detail/functors/GetGlobalBin.h>
+#include <hydra/detail/HistogramFill.h>
 #include <hydra/Distance.h>
 #include <hydra/detail/external/hydra_thrust/iterator/constant_iterator.h>
 #include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
@@ -42,6 +43,7 @@
 #include <hydra/detail/external/hydra_thrust/memory.h>
 
 #include<utility>
+#include <stdexcept>
 
 namespace hydra {
 
@@ -58,49 +60,13 @@ SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>
 
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem,system1, system2 ))>::type common_system_t;
-	//----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
 
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key( common_system_t(), key_buffer.first, key_buffer.first+data_size, weights.first);
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first +  key_buffer.second,
-			weights.first, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(common_system_t(),reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(),reduced_values.first, reduced_end.second,  fContents.begin());
-
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, wbegin, fBins, fContents, fAccumulate);
 
 	return *this;
-
 }
 
 
@@ -118,49 +84,16 @@ SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>
 
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy,fSystem, system1, system2 ))>::type common_system_t;
-	//----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
 
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key( common_system_t(), key_buffer.first, key_buffer.first+data_size, weights.first);
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first +  key_buffer.second,
-			weights.first, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(common_system_t(),reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(),reduced_values.first, reduced_end.second,  fContents.begin());
-
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, wbegin, fBins, fContents, fAccumulate);
 
 	return *this;
 }
 
+
 template<typename T, size_t N,  hydra::detail::Backend BACKEND >
 template<typename Iterator>
 SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>&
@@ -173,108 +106,37 @@ SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem, system1 ))>::type common_system_t;
 
-
-	//----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( common_system_t(),keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort( common_system_t(),key_buffer.first, key_buffer.first+data_size );
-
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	//reduction_by_key
-	auto  weights    = hydra_thrust::constant_iterator<double>(1.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(reduced_values.first, reduced_end.second,  fContents.begin());
-
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fBins, fContents, fAccumulate);
 
 	return *this;
-
 }
 
+
 template<typename T,size_t N,  hydra::detail::Backend BACKEND >
 template<hydra::detail::Backend BACKEND2,typename Iterator>
 SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>&
 SparseHistogram<T, N,  detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(detail::BackendPolicy<BACKEND2> const& exec_policy,
 		Iterator begin, Iterator end )
 {
+	using hydra_thrust::system::detail::generic::select_system;
 	typedef  typename hydra_thrust::iterator_system<Iterator>::type system1_t;
 	system1_t system1;
 
 	typedef  typename hydra_thrust::detail::remove_reference<
 				decltype(select_system(exec_policy,fSystem, system1))>::type common_system_t;
-	//----------------
-
-	size_t data_size = hydra_thrust::distance(begin, end);
 
 	auto key_functor = detail::GetGlobalBin<N,T>(fGrid, fLowerLimits, fUpperLimits);
 
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy( common_system_t(),keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort( common_system_t(),key_buffer.first, key_buffer.first+data_size );
-
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	//reduction_by_key
-	auto  weights    = hydra_thrust::constant_iterator<double>(1.0);
-
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(reduced_values.first, reduced_end.second,  fContents.begin());
-
-	// deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-	hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fBins, fContents, fAccumulate);
 
 	return *this;
-
 }
 
+
 template<typename T, hydra::detail::Backend BACKEND >
 template<typename Iterator>
 SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>, detail::unidimensional>&
@@ -287,45 +149,12 @@ SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>, detail::unidimensional>::
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem, system1 ))>::type common_system_t;
 
-
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort(common_system_t(),key_buffer.first, key_buffer.first+data_size);
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-	auto weights         = hydra_thrust::constant_iterator<double>(1.0);
-
-	//reduction_by_key
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+key_buffer.second,
-			weights, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-    size_t histogram_size = hydra_thrust::distance(common_system_t(),reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(common_system_t(), reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(), reduced_values.first, reduced_end.second,  fContents.begin());
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fBins, fContents, fAccumulate);
 
 	return *this;
-
 }
 
 
@@ -335,48 +164,17 @@ SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>, detail::unidimensional>&
 SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(detail::BackendPolicy<BACKEND2> const& exec_policy,
 		Iterator begin, Iterator end )
 {
+	using hydra_thrust::system::detail::generic::select_system;
 	typedef  typename hydra_thrust::iterator_system<Iterator>::type system1_t;
 	system1_t system1;
 
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy,fSystem, system1))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort(common_system_t(),key_buffer.first, key_buffer.first+data_size);
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-	auto weights         = hydra_thrust::constant_iterator<double>(1.0);
-
-	//reduction_by_key
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+key_buffer.second,
-			weights, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(common_system_t(),reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-	hydra_thrust::copy(common_system_t(), reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(), reduced_values.first, reduced_end.second,  fContents.begin());
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
-
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, hydra_thrust::constant_iterator<double>(1.0), fBins, fContents, fAccumulate);
 
 	return *this;
 }
@@ -396,47 +194,10 @@ SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>, detail::unidimensional >:
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(fSystem,system1, system2 ))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(common_system_t(),wbegin, wbegin+data_size, weights.first);
-
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key(common_system_t(),key_buffer.first, key_buffer.first+data_size, weights.first);
-
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
-
-	//reduction_by_key
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights.first, reduced_keys.first, reduced_values.first);
-
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
-
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
-
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
-
-
-	hydra_thrust::copy(common_system_t(),reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(),reduced_values.first, reduced_end.second,  fContents.begin());
-
-
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, wbegin, fBins, fContents, fAccumulate);
 
 	return *this;
 }
@@ -457,47 +218,104 @@ SparseHistogram<T, 1,  detail::BackendPolicy<BACKEND>,detail::unidimensional >::
 	typedef  typename hydra_thrust::detail::remove_reference<
 			decltype(select_system(exec_policy,fSystem,system1, system2 ))>::type common_system_t;
 
-	size_t data_size = hydra_thrust::distance(begin, end);
-
 	auto key_functor = detail::GetGlobalBin<1,T>(fGrid, fLowerLimits, fUpperLimits);
 
-	//work on local copy of data
-	auto weights  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	hydra_thrust::copy(common_system_t(),wbegin, wbegin+data_size, weights.first);
+	fNBins = detail::fill_sparse_histogram(common_system_t(), key_functor,
+			begin, end, wbegin, fBins, fContents, fAccumulate);
+
+	return *this;
+}
+
+template<typename T, size_t N, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(Generator&& generator, Iterable&& buffer)
+{
+	if( !fAccumulate ) Reset();
+
+	detail::AccumulateGuard guard(fAccumulate);
+
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
+	size_t chunk_size = 0;
+
+	while( (chunk_size = generator(buffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size);
+
+	return *this;
+}
+
+template<typename T, size_t N, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable1, typename Iterable2>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+hydra::detail::is_iterable<Iterable2>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+                                  decltype(std::declval<Iterable2&>().begin())>::value,
+SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>& >::type
+SparseHistogram<T, N, detail::BackendPolicy<BACKEND>, detail::multidimensional>::Fill(Generator&& generator,
+		Iterable1&& buffer, Iterable2&& wbuffer)
+{
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
+
+	if( size_t(hydra_thrust::distance(wbuffer.begin(), wbuffer.end())) < capacity )
+		throw std::invalid_argument("hydra::SparseHistogram::Fill: the weight buffer is smaller than the data buffer.");
+
+	if( !fAccumulate ) Reset();
+
+	detail::AccumulateGuard guard(fAccumulate);
+
+	size_t chunk_size = 0;
+
+	while( (chunk_size = generator(buffer.begin(), wbuffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size, wbuffer.begin());
 
-	auto keys_begin = hydra_thrust::make_transform_iterator(begin, key_functor );
-	auto keys_end   = hydra_thrust::make_transform_iterator(end, key_functor);
-	auto key_buffer = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
+	return *this;
+}
 
-	hydra_thrust::copy(common_system_t(), keys_begin, keys_end, key_buffer.first);
-	hydra_thrust::sort_by_key(common_system_t(),key_buffer.first, key_buffer.first+data_size, weights.first);
+template<typename T, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable&>().begin())>::value,
+SparseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+SparseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(Generator&& generator, Iterable&& buffer)
+{
+	if( !fAccumulate ) Reset();
 
-	//bins content
-	auto reduced_values  = hydra_thrust::get_temporary_buffer<double>(common_system_t(), data_size);
-	auto reduced_keys    = hydra_thrust::get_temporary_buffer<size_t>(common_system_t(), data_size);
+	detail::AccumulateGuard guard(fAccumulate);
 
-	//reduction_by_key
-	auto reduced_end = hydra_thrust::reduce_by_key(common_system_t(),
-			key_buffer.first, key_buffer.first+data_size,
-			weights.first, reduced_keys.first, reduced_values.first);
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
+	size_t chunk_size = 0;
 
-	hydra_thrust::return_temporary_buffer(common_system_t(), key_buffer.first);
+	while( (chunk_size = generator(buffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size);
 
-	size_t histogram_size = hydra_thrust::distance(reduced_keys.first, reduced_end.first);
+	return *this;
+}
+
+template<typename T, hydra::detail::Backend BACKEND>
+template<typename Generator, typename Iterable1, typename Iterable2>
+inline typename std::enable_if< hydra::detail::is_iterable<Iterable1>::value &&
+hydra::detail::is_iterable<Iterable2>::value &&
+hydra::detail::is_chunk_generator<Generator, decltype(std::declval<Iterable1&>().begin()),
+                                  decltype(std::declval<Iterable2&>().begin())>::value,
+SparseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>& >::type
+SparseHistogram<T, 1, detail::BackendPolicy<BACKEND>, detail::unidimensional>::Fill(Generator&& generator,
+		Iterable1&& buffer, Iterable2&& wbuffer)
+{
+	size_t capacity = hydra_thrust::distance(buffer.begin(), buffer.end());
 
-	fContents.resize(histogram_size);
-	fBins.resize(histogram_size);
-	fNBins = histogram_size ;
+	if( size_t(hydra_thrust::distance(wbuffer.begin(), wbuffer.end())) < capacity )
+		throw std::invalid_argument("hydra::SparseHistogram::Fill: the weight buffer is smaller than the data buffer.");
 
+	if( !fAccumulate ) Reset();
 
-	hydra_thrust::copy(common_system_t(),reduced_keys.first, reduced_end.first,  fBins.begin());
-	hydra_thrust::copy(common_system_t(),reduced_values.first, reduced_end.second,  fContents.begin());
+	detail::AccumulateGuard guard(fAccumulate);
 
+	size_t chunk_size = 0;
 
-    // deallocate storage with hydra_thrust::return_temporary_buffer
-	hydra_thrust::return_temporary_buffer(common_system_t(), weights.first  );
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_values.first);
-    hydra_thrust::return_temporary_buffer(common_system_t(), reduced_keys.first);
+	while( (chunk_size = generator(buffer.begin(), wbuffer.begin(), capacity)) > 0 )
+		this->Fill(buffer.begin(), buffer.begin() + chunk_size, wbuffer.begin());
 
 	return *this;
 }
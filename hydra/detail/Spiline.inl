@@ -79,69 +79,139 @@ namespace hydra {
 
 
 
-		}  // namespace spiline
+		/*
+		 * Slope at the node k of the monotone interpolant (M. Steffen) through the n points (x[i], y[i]).
+		 * Only the nodes k-1, k and k+1 are accessed.
+		 */
+		template<typename IteratorX, typename IteratorY>
+		__hydra_host__ __hydra_device__
+		inline double slope(IteratorX x, IteratorY y, size_t k, size_t n)
+		{
+			using hydra_thrust::min;
 
-	}  // namespace detail
+			if( n < 3 ) return (y[1] - y[0])/(x[1] - x[0]);
 
+			if( k == 0 || k == n-1 ){
 
-template<typename Iterator1, typename Iterator2,typename Type>
-__hydra_host__ __hydra_device__
-inline typename std::enable_if< std::is_floating_point<typename hydra_thrust::iterator_traits<Iterator1>::value_type >::value &&
-                       std::is_floating_point<typename hydra_thrust::iterator_traits<Iterator2>::value_type >::value , Type>::type
-spiline(Iterator1 first, Iterator1 last,  Iterator2 measurements, Type value) {
+				//one sided estimate at the ends
+				size_t i = k == 0 ? 0 : n-2;
+				size_t j = k == 0 ? 1 : n-3;
 
-		using hydra_thrust::min;
+				const double h_i = x[i+1] - x[i];
+				const double h_j = x[j+1] - x[j];
+				const double s_i = (y[i+1] - y[i])/h_i;
+				const double s_j = (y[j+1] - y[j])/h_j;
 
-		auto iter = detail::spiline::lower_bound(first, last, value);
-		size_t dist_i = hydra_thrust::distance(first, iter);
-		size_t i = dist_i > 0 ? dist_i - 1: 0;
+				const double p = s_i*(1 + h_i/(h_i + h_j)) - s_j*h_i/(h_i + h_j);
 
-		size_t N = hydra_thrust::distance(first, last);
+				return (::copysign(1.0, p) + ::copysign(1.0, s_i))*min( ::fabs(s_i), 0.5*::fabs(p) );
+			}
 
-		//--------------------
+			const double h_m = x[k] - x[k-1];
+			const double h_p = x[k+1] - x[k];
+			const double s_m = (y[k] - y[k-1])/h_m;
+			const double s_p = (y[k+1] - y[k])/h_p;
 
-		const double y_i = measurements[i], y_ip = measurements[i+1], y_ipp = measurements[i+2], y_im =  measurements[i-1];
+			const double p = (s_m*h_p + s_p*h_m)/(h_m + h_p);
 
-		const 	double x_i = first[i]       , x_ip = first[i+1],    x_ipp = first[i+2], x_im = first[i-1] ;
+			return (::copysign(1.0, s_m) + ::copysign(1.0, s_p))
+					*min( min(::fabs(s_m), ::fabs(s_p)), 0.5*::fabs(p) );
+		}
+
+		/*
+		 * Coefficients (c, b, a) of the cubic X*(X*(a*X + b) + c) + y[i], X = x - x[i],
+		 * interpolating in the interval i.
+		 */
+		template<typename IteratorX, typename IteratorY>
+		__hydra_host__ __hydra_device__
+		inline void coefficients(IteratorX x, IteratorY y, size_t i, size_t n,
+				double& c, double& b, double& a)
+		{
+			const double h = x[i+1] - x[i];
+			const double s = (y[i+1] - y[i])/h;
+
+			const double c_i  = slope(x, y, i,   n);
+			const double c_ip = slope(x, y, i+1, n);
+
+			c = c_i;
+			b = (-2*c_i - c_ip + 3*s)/h;
+			a = (c_i + c_ip - 2*s)/(h*h);
+		}
 
-		//calculates s
-		const double  h_i  = x_ip -x_i;
-		const double  h_ip = x_ipp -x_ip;
-		const double  h_im = x_i  -x_im;
+		/*
+		 * True if the n abscissae starting at 'first' are evenly spaced.
+		 */
+		template<typename Iterator>
+		__hydra_host__ __hydra_device__
+		inline bool is_uniform(Iterator first, size_t n)
+		{
+			if( n < 2 ) return false;
 
-		const double  s_i  = (y_ip - y_i)/h_i;
-		const double  s_ip = (y_ipp - y_ip)/h_ip;
-		const double  s_im = (y_i - y_im)/h_im;
+			double min   = first[0];
+			double delta = (double(first[n-1]) - min)/(n - 1);
+			double tolerance = 1.0e-9*::fabs(double(first[n-1]) - min);
 
-		const double p_i  = i==0 ? ( s_i*(1 + h_i/(h_i + h_ip)) - s_ip*h_i/(h_i + h_ip) ):
-					i==N-2 ? ( s_i*(1 + h_i/(h_i + h_im)) - s_im*h_i/(h_i + h_im) )
-				: (s_im*h_i + s_i*h_im)/(h_i+ h_im);
+			for(size_t i=1; i<n; i++)
+				if( ::fabs( double(first[i]) - (min + i*delta) ) > tolerance ) return false;
 
-		const double p_ip = (s_i*h_ip + s_ip*h_i)/(h_ip+ h_i);
+			return true;
+		}
 
+		/*
+		 * Interval of the grid x[0..n-1] containing value, in [0, n-2]. On uniform grids
+		 * it is computed from the inverse of the spacing, otherwise by binary search.
+		 */
+		__hydra_host__ __hydra_device__
+		inline size_t locate(GReal_t const* x, size_t n, bool uniform, GReal_t inv_delta, GReal_t value)
+		{
+			size_t i = 0;
 
-		// calculates c
+			if( uniform ){
 
-		const double c_i =  i==0  ? (::copysign(1.0, p_i ) + ::copysign(1.0, s_i ))
-				*min( ::fabs(s_i) , 0.5*::fabs(p_i) ):
-				i==N-2 ? (::copysign(1.0, p_i ) + ::copysign(1.0, s_i ))
-						*min( ::fabs(s_i) , 0.5*::fabs(p_i) ):
-					(::copysign(1.0, s_im ) + ::copysign(1.0, s_i ))
-				        *min(min(::fabs(s_im), ::fabs(s_i)), 0.5*::fabs(p_i) );
+				GReal_t t = (value - x[0])*inv_delta;
+				i = t > 0 ? size_t(t) : 0;
+			}
+			else {
+
+				size_t dist_i = hydra_thrust::distance(x, lower_bound(x, x + n, value));
+				i = dist_i > 0 ? dist_i - 1: 0;
+			}
+
+			return i < n - 2 ? i : n - 2;
+		}
+
+		__hydra_host__ __hydra_device__
+		inline double horner(double X, double a, double b, double c, double d)
+		{
+			return X*( X*(a*X + b) + c) + d;
+		}
+
+		}  // namespace spiline
+
+	}  // namespace detail
+
+
+template<typename Iterator1, typename Iterator2,typename Type>
+__hydra_host__ __hydra_device__
+inline typename std::enable_if< std::is_floating_point<typename hydra_thrust::iterator_traits<Iterator1>::value_type >::value &&
+                       std::is_floating_point<typename hydra_thrust::iterator_traits<Iterator2>::value_type >::value , Type>::type
+spiline(Iterator1 first, Iterator1 last,  Iterator2 measurements, Type value) {
+
+		auto iter = detail::spiline::lower_bound(first, last, value);
+		size_t dist_i = hydra_thrust::distance(first, iter);
+		size_t i = dist_i > 0 ? dist_i - 1: 0;
+
+		size_t N = hydra_thrust::distance(first, last);
 
-		const double c_ip =  (::copysign(1.0, s_i ) + ::copysign(1.0, s_ip ))
-									*min(min(::fabs(s_ip), ::fabs(s_i)), 0.5*::fabs(p_ip) );
+		i = i < N-2 ? i : N-2;
 
-		//calculates b
-		const double b_i =  (-2*c_i - c_ip + 3*s_i)/h_i;
+		double c_i, b_i, a_i;
 
-		//calculates a
-		const double a_i = (c_i + c_ip - 2*s_i)/(h_i*h_i);
+		detail::spiline::coefficients(first, measurements, i, N, c_i, b_i, a_i);
 
-		//--------------------
 		const double X = (value-*(first+i));
 
-		return X*( X*(a_i*X + b_i) + c_i) + y_i;
+		return detail::spiline::horner(X, a_i, b_i, c_i, measurements[i]);
 	}
 
 template<typename Iterable1, typename Iterable2,typename Type>
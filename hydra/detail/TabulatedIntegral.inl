@@ -0,0 +1,334 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * TabulatedIntegral.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef TABULATEDINTEGRAL_INL_
+#define TABULATEDINTEGRAL_INL_
+
+#include <hydra/detail/Hash.h>
+#include <hydra/Spiline.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace hydra {
+
+template<typename Integrator, size_t N>
+TabulatedIntegral<Integrator, N>::TabulatedIntegral(Integrator const& integrator,
+		std::array<size_t, N> const& parameters,
+		std::array<GReal_t, N> const& min, std::array<GReal_t, N> const& max,
+		std::array<size_t, N> const& nodes, GReal_t tolerance):
+	fIntegrator(integrator),
+	fParameters(parameters),
+	fMin(min),
+	fMax(max),
+	fNNodes(nodes),
+	fTolerance(tolerance),
+	fKey(0),
+	fNInterpolations(0),
+	fNFallbacks(0),
+	fNUses(0),
+	fNRebuilds(0),
+	fBypassed(false)
+{
+	for(size_t i=0; i<N; i++){
+
+		if( fNNodes[i] < 2 )
+			throw std::invalid_argument("hydra::TabulatedIntegral: each parameter needs at least two nodes.");
+
+		if( !(fMin[i] < fMax[i]) )
+			throw std::invalid_argument("hydra::TabulatedIntegral: illegal parameter range, min >= max.");
+	}
+}
+
+template<typename Integrator, size_t N>
+TabulatedIntegral<Integrator, N>::TabulatedIntegral(TabulatedIntegral<Integrator, N> const& other):
+	fIntegrator(other.GetIntegrator()),
+	fParameters(other.fParameters),
+	fMin(other.fMin),
+	fMax(other.fMax),
+	fNNodes(other.fNNodes),
+	fTolerance(other.GetTolerance()),
+	fKey(other.fKey),
+	fNInterpolations(other.GetNumberOfInterpolations()),
+	fNFallbacks(other.GetNumberOfFallbacks()),
+	fNUses(other.fNUses),
+	fNRebuilds(other.fNRebuilds),
+	fBypassed(other.IsBypassed()),
+	fNodes(other.fNodes),
+	fCells(other.fCells)
+{}
+
+template<typename Integrator, size_t N>
+TabulatedIntegral<Integrator, N>&
+TabulatedIntegral<Integrator, N>::operator=(TabulatedIntegral<Integrator, N> const& other)
+{
+	if(this==&other) return *this;
+
+	fIntegrator      = other.GetIntegrator();
+	fParameters      = other.fParameters;
+	fMin             = other.fMin;
+	fMax             = other.fMax;
+	fNNodes          = other.fNNodes;
+	fTolerance       = other.GetTolerance();
+	fKey             = other.fKey;
+	fNInterpolations = other.GetNumberOfInterpolations();
+	fNFallbacks      = other.GetNumberOfFallbacks();
+	fNUses           = other.fNUses;
+	fNRebuilds       = other.fNRebuilds;
+	fBypassed        = other.IsBypassed();
+	fNodes           = other.fNodes;
+	fCells           = other.fCells;
+
+	return *this;
+}
+
+template<typename Integrator, size_t N>
+template<typename Functor>
+std::pair<GReal_t, GReal_t>
+TabulatedIntegral<Integrator, N>::Integrate(Functor const& functor)
+{
+	if( fBypassed ){
+
+		++fNFallbacks;
+		return fIntegrator(functor);
+	}
+
+	size_t key = OtherParametersKey(functor);
+
+	if( key != fKey ){
+
+		//integrator calls spent on the nodes and on the validation of the cells
+		size_t cost = fNodes.size() + (2*N + 1)*fCells.size();
+
+		fNRebuilds = fNUses < cost ? fNRebuilds + 1 : 0;
+		fBypassed  = fNRebuilds >= HYDRA_TABULATED_INTEGRAL_MAX_REBUILDS;
+
+		Clear();
+		fKey = key;
+
+		if( fBypassed ){
+
+			HYDRA_LOG(WARNING, "hydra::TabulatedIntegral: the table is rebuilt at almost every call, "
+					"as the untabulated parameters change. Calling the underlying integrator from now on.")
+
+			++fNFallbacks;
+			return fIntegrator(functor);
+		}
+	}
+
+	std::array<size_t, N>  index;
+	std::array<GReal_t, N> t;
+
+	for(size_t i=0; i<N; i++){
+
+		GReal_t value = functor.GetParameter(fParameters[i]).GetValue();
+
+		if( !(value >= fMin[i] && value <= fMax[i]) ){
+
+			++fNFallbacks;
+			return fIntegrator(functor);
+		}
+
+		GReal_t u = (value - fMin[i])*(fNNodes[i] - 1)/(fMax[i] - fMin[i]);
+
+		index[i] = std::min<size_t>(size_t(u), fNNodes[i] - 2);
+		t[i]     = u - index[i];
+	}
+
+	cell_type const& cell = Cell(functor, index);
+
+	if( !cell.fValid ){
+
+		++fNFallbacks;
+		return fIntegrator(functor);
+	}
+
+	node_type result = Interpolate(functor, index, t);
+
+	++fNInterpolations;
+	++fNUses;
+
+	return std::make_pair(result.fValue, result.fError + cell.fDeviation*std::fabs(result.fValue));
+}
+
+template<typename Integrator, size_t N>
+void TabulatedIntegral<Integrator, N>::Print() const
+{
+	HYDRA_CALLER ;
+	HYDRA_MSG << "TabulatedIntegral begin: " << HYDRA_ENDL;
+
+	for(size_t i=0; i<N; i++)
+		HYDRA_MSG << "Parameter #" << fParameters[i] << ": [" << fMin[i] << ", " << fMax[i]
+		          << "], nodes " << fNNodes[i] << HYDRA_ENDL;
+
+	HYDRA_MSG << "Tolerance: " << fTolerance << HYDRA_ENDL;
+	HYDRA_MSG << "Nodes calculated: " << fNodes.size() << HYDRA_ENDL;
+	HYDRA_MSG << "Cells validated: " << fCells.size() << HYDRA_ENDL;
+	HYDRA_MSG << "Interpolations: " << fNInterpolations << HYDRA_ENDL;
+	HYDRA_MSG << "Fallbacks: " << fNFallbacks << HYDRA_ENDL;
+	HYDRA_MSG << "Bypassed: " << (fBypassed ? "yes" : "no") << HYDRA_ENDL;
+	HYDRA_MSG << "TabulatedIntegral end. " << HYDRA_ENDL;
+}
+
+template<typename Integrator, size_t N>
+template<typename Functor>
+size_t TabulatedIntegral<Integrator, N>::OtherParametersKey(Functor const& functor) const
+{
+	std::vector<GReal_t> values;
+
+	for(size_t i=0; i<functor.GetNumberOfParameters(); i++)
+		if( std::find(fParameters.begin(), fParameters.end(), i) == fParameters.end() )
+			values.push_back( functor.GetParameter(i).GetValue() );
+
+	return detail::hash_range(values.begin(), values.end());
+}
+
+template<typename Integrator, size_t N>
+template<typename Functor>
+typename TabulatedIntegral<Integrator, N>::node_type const&
+TabulatedIntegral<Integrator, N>::Node(Functor const& functor, std::array<size_t, N> const& index)
+{
+	size_t flat = 0;
+
+	for(size_t i=N; i-- > 0; )
+		flat = flat*fNNodes[i] + index[i];
+
+	auto search = fNodes.find(flat);
+
+	if( search != fNodes.end() ) return search->second;
+
+	Functor node_functor(functor);
+
+	for(size_t i=0; i<N; i++)
+		node_functor.SetParameter(fParameters[i],
+				fMin[i] + index[i]*(fMax[i] - fMin[i])/(fNNodes[i] - 1));
+
+	auto integral = fIntegrator(node_functor);
+
+	node_type& node = fNodes[flat];
+
+	node.fValue = integral.first;
+	node.fError = integral.second;
+
+	return node;
+}
+
+template<typename Integrator, size_t N>
+template<typename Functor>
+typename TabulatedIntegral<Integrator, N>::cell_type const&
+TabulatedIntegral<Integrator, N>::Cell(Functor const& functor, std::array<size_t, N> const& index)
+{
+	size_t flat = 0;
+
+	for(size_t i=N; i-- > 0; )
+		flat = flat*(fNNodes[i] - 1) + index[i];
+
+	auto search = fCells.find(flat);
+
+	if( search != fCells.end() ) return search->second;
+
+	/*
+	 * the interpolation is compared with the integral at the center of the
+	 * cell and halfway between the center and each face, where the cubics
+	 * are the farthest from the nodes
+	 */
+	cell_type& cell = fCells[flat];
+
+	cell.fDeviation = 0.0;
+
+	for(size_t point=0; point < 2*N + 1; point++){
+
+		std::array<GReal_t, N> t;
+		Functor point_functor(functor);
+
+		for(size_t i=0; i<N; i++){
+
+			t[i] = 0.5;
+
+			if( point > 0 && (point - 1)/2 == i ) t[i] = (point - 1)%2 ? 0.75 : 0.25;
+
+			point_functor.SetParameter(fParameters[i],
+					fMin[i] + (index[i] + t[i])*(fMax[i] - fMin[i])/(fNNodes[i] - 1));
+		}
+
+		GReal_t exact = fIntegrator(point_functor).first;
+		GReal_t interpolated = Interpolate(functor, index, t).fValue;
+
+		GReal_t deviation = exact != 0.0 ? std::fabs(interpolated - exact)/std::fabs(exact)
+				: std::fabs(interpolated);
+
+		cell.fDeviation = std::max(cell.fDeviation, deviation);
+	}
+
+	//margin for the points between the samples
+	cell.fDeviation *= 2.0;
+
+	cell.fValid     = cell.fDeviation <= fTolerance;
+
+	return cell;
+}
+
+template<typename Integrator, size_t N>
+template<typename Functor>
+typename TabulatedIntegral<Integrator, N>::node_type
+TabulatedIntegral<Integrator, N>::Interpolate(Functor const& functor, std::array<size_t, N> const& index,
+		std::array<GReal_t, N> const& t, std::array<size_t, N>& node_index, size_t axis)
+{
+	if( axis == 0 ) return Node(functor, node_index);
+
+	const size_t i  = index[axis-1];
+	const size_t n  = fNNodes[axis-1];
+	const size_t lo = i > 0 ? i - 1 : 0;
+	const size_t hi = i + 2 < n ? i + 2 : n - 1;
+
+	//nodes are equally spaced, so they are placed at 0, 1, 2... along the axis
+	GReal_t x[4] = {0.0, 1.0, 2.0, 3.0};
+	GReal_t y[4];
+	GReal_t error = 0.0;
+
+	for(size_t j=lo; j<=hi; j++){
+
+		node_index[axis-1] = j;
+
+		node_type node = Interpolate(functor, index, t, node_index, axis-1);
+
+		y[j-lo] = node.fValue;
+		error   = std::max(error, node.fError);
+	}
+
+	double c, b, a;
+
+	detail::spiline::coefficients(x, y, i - lo, hi - lo + 1, c, b, a);
+
+	return node_type{ detail::spiline::horner(t[axis-1], a, b, c, y[i-lo]), error };
+}
+
+}  // namespace hydra
+
+#endif /* TABULATEDINTEGRAL_INL_ */
@@ -0,0 +1,244 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * UnweightCompaction.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup phsp
+ */
+
+#ifndef UNWEIGHTCOMPACTION_H_
+#define UNWEIGHTCOMPACTION_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/BackendPolicy.h>
+#include <hydra/Types.h>
+#include <hydra/Random.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/multivector.h>
+#include <hydra/detail/functors/DecayMother.h>
+
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/scan.h>
+#include <hydra/detail/external/hydra_thrust/scatter.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/random.h>
+
+#include <type_traits>
+
+/**
+ * Maximum number of trial events held in memory, together with their
+ * weights and flags, by the out-of-place unweighting of hydra::Decays
+ * and hydra::PhaseSpace.
+ */
+#ifndef HYDRA_UNWEIGHT_CHUNK_SIZE
+#define HYDRA_UNWEIGHT_CHUNK_SIZE 4194304
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Accept/reject flag of the event 'index' with weight 'w': 1 if w/max_weight > u.
+ * The uniform number is taken from the position 'index' of the stream
+ * of 'seed', as in FlagDaugthers, so the flags do not depend on how the
+ * events are split in chunks.
+ */
+struct FlagWeight
+{
+	FlagWeight(double max_weight, size_t seed):
+		fMaxWeight(max_weight),
+		fSeed(seed)
+	{}
+
+	__hydra_host__ __hydra_device__
+	FlagWeight(FlagWeight const& other):
+		fMaxWeight(other.fMaxWeight),
+		fSeed(other.fSeed)
+	{}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline size_t operator()(T x) const
+	{
+		size_t index  = hydra_thrust::get<0>(x);
+		double weight = hydra_thrust::get<1>(x);
+
+		hydra::default_random_engine randEng(fSeed);
+
+		randEng.discard(index);
+
+		hydra_thrust::uniform_real_distribution<double> uniDist(0.0, 1.0);
+
+		return weight/fMaxWeight > uniDist(randEng) ? 1 : 0;
+	}
+
+	double fMaxWeight;
+	size_t fSeed;
+};
+
+/*
+ * Multiplies the weight of an event by the value of a functor.
+ */
+template<typename Functor>
+struct ApplyEventFunctor
+{
+	ApplyEventFunctor(Functor const& functor):
+		fFunctor(functor)
+	{}
+
+	__hydra_host__ __hydra_device__
+	ApplyEventFunctor(ApplyEventFunctor<Functor> const& other):
+		fFunctor(other.fFunctor)
+	{}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline double operator()(T particles, double weight) const
+	{
+		return weight*fFunctor(particles);
+	}
+
+	Functor fFunctor;
+};
+
+/*
+ * Same as DecayMother, but the weight computed with the event is stored
+ * in 'weights', at the position of the event relative to 'first'.
+ */
+template <size_t N,  typename GRND>
+struct WeightedDecayMother: public DecayMother<N, GRND>
+{
+	typedef DecayMother<N, GRND> super_type;
+	typedef typename super_type::particles_tuple_type particles_tuple_type;
+
+	WeightedDecayMother(super_type const& decayer, double* weights, size_t first):
+		super_type(decayer),
+		fWeights(weights),
+		fFirst(first)
+	{}
+
+	__hydra_host__ __hydra_device__
+	WeightedDecayMother(WeightedDecayMother<N, GRND> const& other):
+		super_type(other),
+		fWeights(other.fWeights),
+		fFirst(other.fFirst)
+	{}
+
+	__hydra_host__  __hydra_device__
+	inline particles_tuple_type operator()(size_t evt)
+	{
+		Vector4R particles[N];
+
+		fWeights[evt - fFirst] = this->process(evt, particles);
+
+		particles_tuple_type result{};
+
+		assignArrayToTuple(result, particles);
+
+		return result;
+	}
+
+	double* fWeights;
+	size_t  fFirst;
+};
+
+template<typename System, typename Iterator, typename Pointer, typename OutputIterator>
+inline void scatter_accepted(System const& system, Iterator events, size_t n, Pointer flags, Pointer offsets,
+		size_t, OutputIterator output, std::true_type)
+{
+	hydra_thrust::scatter_if(system, events, events + n, offsets, flags, output);
+}
+
+template<typename System, typename Iterator, typename Pointer, typename OutputIterator>
+inline void scatter_accepted(System const& system, Iterator events, size_t n, Pointer flags, Pointer offsets,
+		size_t naccepted, OutputIterator output, std::false_type)
+{
+	typedef typename hydra_thrust::iterator_traits<Iterator>::value_type value_type;
+
+	//the accepted events are compacted on the back-end of the trials and then copied
+	multivector<value_type, System> accepted(naccepted);
+
+	hydra_thrust::scatter_if(system, events, events + n, offsets, flags, accepted.begin());
+
+	hydra_thrust::copy(accepted.begin(), accepted.end(), output);
+}
+
+/*
+ * Appends to 'output' the events in [events, events + n) accepted with
+ * probability weight/max_weight. The flags are set in one pass, their
+ * exclusive scan gives the position of each accepted event in the output,
+ * and the accepted events are scattered there. 'first_index' is the index of
+ * the first event in the whole sample. Returns the number of accepted events.
+ */
+template<hydra::detail::Backend BACKEND, typename Iterator, typename Pointer, typename Container>
+size_t append_accepted(hydra::detail::BackendPolicy<BACKEND> const& system,
+		Iterator events, Pointer weights, size_t n, size_t first_index,
+		double max_weight, size_t seed, Container& output)
+{
+	typedef typename hydra_thrust::iterator_system<Iterator>::type events_system;
+	typedef typename hydra_thrust::iterator_system<decltype(output.begin())>::type output_system;
+
+	if( n==0 ) return 0;
+
+	auto flags   = hydra::detail::get_temporary_buffer<size_t>(system, n);
+	auto offsets = hydra::detail::get_temporary_buffer<size_t>(system, n);
+
+	hydra_thrust::counting_iterator<size_t> index(first_index);
+
+	hydra_thrust::transform(system,
+			hydra_thrust::make_zip_iterator(hydra_thrust::make_tuple(index, weights)),
+			hydra_thrust::make_zip_iterator(hydra_thrust::make_tuple(index + n, weights + n)),
+			flags.first, FlagWeight(max_weight, seed));
+
+	hydra_thrust::exclusive_scan(system, flags.first, flags.first + n, offsets.first);
+
+	size_t naccepted = size_t(offsets.first[n-1]) + size_t(flags.first[n-1]);
+
+	size_t offset = output.size();
+
+	output.resize(offset + naccepted);
+
+	scatter_accepted(system, events, n, flags.first, offsets.first, naccepted, output.begin() + offset,
+			std::integral_constant<bool, std::is_same<events_system, output_system>::value>{});
+
+	hydra::detail::return_temporary_buffer(system, offsets.first);
+	hydra::detail::return_temporary_buffer(system, flags.first);
+
+	return naccepted;
+}
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* UNWEIGHTCOMPACTION_H_ */
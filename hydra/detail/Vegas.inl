@@ -36,6 +36,8 @@
 #include <hydra/VegasState.h>
 #include <hydra/detail/utility/StreamSTL.h>
 #include <hydra/detail/functors/ProcessCallsVegas.h>
+#include <hydra/detail/functors/FillPrivateHistogram.h>
+#include <hydra/detail/HistogramFill.h>
 
 //std
 #include <chrono>
@@ -46,6 +48,10 @@
 //thrust
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 #include <hydra/detail/external/hydra_thrust/sort.h>
+#include <hydra/detail/external/hydra_thrust/fill.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
 
 
 #define USE_ORIGINAL_CHISQ_FORMULA 0
@@ -105,7 +111,9 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 		if (fState.GetMode() != MODE_IMPORTANCE_ONLY) {
 			/* shooting for 2 calls/box */
 
-			boxes = floor( ::pow(fState.GetCalls(training )/2.0, 1.0 / N ));
+			// the Sobol points are already stratified, no boxes in QMC mode
+			if( fQMCMode == QMC_NONE )
+				boxes = floor( ::pow(fState.GetCalls(training )/2.0, 1.0 / N ));
 		//	if(boxes==1) boxes++;
 		//	std::cout << "boxes  " << boxes << " bins " <<fState.GetNBinsMax()<< std::endl;
 
@@ -115,7 +123,12 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 
 
 		/*size_t*/GReal_t tot_boxes = ::pow( (GReal_t)boxes,  N);
-		fState.SetCallsPerBox(std::max(  GInt_t(fState.GetCalls(training ) / tot_boxes), 2) );
+
+		if( fQMCMode == QMC_NONE )
+			fState.SetCallsPerBox(std::max(  GInt_t(fState.GetCalls(training ) / tot_boxes), 2) );
+		else // the calls are split evenly among the replicas
+			fState.SetCallsPerBox( std::max( fState.GetCalls(training )/fQMCReplicas, size_t(1) )*fQMCReplicas );
+
 		fState.SetCalls( training , fState.GetCallsPerBox() * tot_boxes);
 		//std::cout << "fState.GetCalls "<< fState.GetCalls()<< std::endl;
 
@@ -147,11 +160,6 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 
 	cum_int = 0.0;
 	cum_sig = 0.0;
-	size_t nkeys  = N*fState.GetCalls(training);
-	fFValInput.resize(nkeys);
-	fGlobalBinInput.resize(nkeys);
-	fFValOutput.resize(nkeys);
-	fGlobalBinOutput.resize(nkeys);
 
 	//for (size_t it = 0; it < fState.GetIterations()+fState.GetTrainingIterations(); it++)
 
@@ -162,12 +170,10 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 
 		GReal_t intgrl = 0.0;
 		GReal_t intgrl_sq = 0.0;
-		GReal_t tss = 0.0;
 		GReal_t wgt=0;
 		GReal_t var=0;
 		GReal_t sig=0;
 
-		size_t calls_per_box = fState.GetCallsPerBox();
 		GReal_t jacbin = fState.GetJacobian();
 
 		//if(it >=fState.GetTrainingIterations())	fState.SetItNum(fState.GetItStart() + it);
@@ -181,9 +187,13 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 		 * **********************************************
 		 */
 		auto start_fc = std::chrono::high_resolution_clock::now();
-		ProcessFuncionCalls( fFunctor,training, intgrl,  tss);
+		ProcessFuncionCalls( fFunctor,training, intgrl,  var);
 		auto end_fc = std::chrono::high_resolution_clock::now();
 		std::chrono::duration<double, std::milli> elapsed_fc = end_fc - start_fc;
+
+		auto start_grid = std::chrono::high_resolution_clock::now();
+		UpdateDistribution();
+		std::chrono::duration<double, std::milli> elapsed_grid = std::chrono::high_resolution_clock::now() - start_grid;
 		/*
 		 * Compute final results for this iteration
 		 */
@@ -191,8 +201,6 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 		if(!training)
 		{
 
-			var = tss / (calls_per_box - 1.0);
-
 
 			if (var > 0) {
 				wgt = 1.0 / var;
@@ -275,9 +283,13 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 			PrintDistribution();
 		}
 
+		start_grid = std::chrono::high_resolution_clock::now();
+
 		if(!training && !fState.IsTrainedGridFrozen() )
 		 RefineGrid();
 
+		elapsed_grid += std::chrono::high_resolution_clock::now() - start_grid;
+
 		if (fState.GetVerbose() > 1) {
 			PrintGrid();
 		}
@@ -295,6 +307,7 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 			fState.StoreCumulatedResult(cum_int, cum_sig);
 			fState.StoreIterationDuration( elapsed.count() );
 			fState.StoreFunctionCallsDuration( elapsed_fc.count() );
+			fState.StoreGridUpdateDuration( elapsed_grid.count() );
 		}
 		//if(it >=fState.GetTrainingIterations())
 		if(!training && it > 1)
@@ -310,11 +323,6 @@ Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::IntegIterator(FUNCTOR con
 
 	fState.SetStage(1);
 
-	fFValInput=rvector_backend();
-	fGlobalBinInput=uvector_backend();
-	fFValOutput=rvector_backend();
-	fGlobalBinOutput=uvector_backend();
-
 	return std::make_pair(cum_int, cum_sig);
 
 
@@ -601,47 +609,132 @@ void Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::RefineGrid() {
 
 template< size_t N, hydra::detail::Backend  BACKEND , typename GRND>
 template<typename FUNCTOR>
-void Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::ProcessFuncionCalls(FUNCTOR const& fFunctor, GBool_t training, GReal_t& integral, GReal_t& tss)
+void Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::ProcessFuncionCalls(FUNCTOR const& fFunctor, GBool_t training, GReal_t& integral, GReal_t& variance)
 {
 	typedef hydra::detail::BackendPolicy<BACKEND> system_t;
+	typedef detail::ProcessCallsVegas<FUNCTOR,N,system_t ,rvector_iterator,
+			uvector_iterator , GRND> process_calls_t;
+
 	size_t ncalls = fState.GetCalls(training);
 	size_t nkeys  = N*fState.GetCalls(training);
 
-	// create iterators
-	hydra_thrust::counting_iterator<size_t> first(0);
-	hydra_thrust::counting_iterator<size_t> last = first + ncalls;
-
-
 	fState.CopyStateToDevice();
 
-
 	detail::ResultVegas init = detail::ResultVegas();
-	detail::ResultVegas result = hydra_thrust::transform_reduce(system_t(), first, last,
-			detail::ProcessCallsVegas<FUNCTOR,N,system_t ,rvector_iterator,
-			uvector_iterator , GRND>(ncalls, fState, fGlobalBinInput.begin(),fFValInput.begin(), fFunctor)
-	, init,	detail::ProcessBoxesVegas());
-
 
 	/*
-	for(size_t i=0; i< hydra_thrust::distance( fGlobalBinInput.begin(),fGlobalBinInput.end() ); i++)
-			std::cout <<"<< " << i << " " << fGlobalBinInput[i] << " " << fFValInput[i] << std::endl;
+	 * In QMC mode the calls are split in fQMCReplicas ranges, each one sampled
+	 * with its own randomization of the Sobol sequence. All of them fill the
+	 * same grid distribution.
 	 */
+	size_t nreplicas = fQMCMode != QMC_NONE ? fQMCReplicas : 1;
+	size_t npoints   = ncalls/nreplicas;
 
-	hydra_thrust::sort_by_key(system_t(),fGlobalBinInput.begin(),fGlobalBinInput.end(), fFValInput.begin());
-	/*
-	for(size_t i=0; i< hydra_thrust::distance( fGlobalBin.begin(),fGlobalBin.end() ); i++)
-		std::cout <<"<< " << i << " " << fGlobalBin[i] << " " << fFVal[i] << std::endl;
-	 */
+	if( fQMCMode != QMC_NONE && !fDirections )
+		fDirections = detail::sobol_directions<N>(system_t());
+
+	//a new set of randomizations of the sequence for each pass
+	uint64_t seed = fQMCSeed + fQMCPass++;
+
+	size_t ndist = N*fState.GetNBins();
+
+	if( detail::use_privatized_histogram_fill<system_t>(ndist, npoints) ) {
+
+		/*
+		 * host back-ends: each slot accumulates the distribution of its chunk
+		 * of calls in a private copy, merged afterwards in UpdateDistribution()
+		 */
+		fNSlots = detail::histogram_fill_slots<system_t>(npoints, ndist);
+
+		fDistributionSlots.resize(fNSlots*ndist);
+		hydra_thrust::fill(system_t(), fDistributionSlots.begin(), fDistributionSlots.end(), 0.0);
+	}
+	else {
+
+		fNSlots = 0;
+
+		fFValInput.resize(nkeys);
+		fGlobalBinInput.resize(nkeys);
+		fFValOutput.resize(nkeys);
+		fGlobalBinOutput.resize(nkeys);
+	}
+
+	// replica estimates of the integral and their sum of squared deviations
+	GReal_t mean = 0.0;
+	GReal_t m2   = 0.0;
 
-	auto end_iterators = hydra_thrust::reduce_by_key(system_t(),fGlobalBinInput.begin(),fGlobalBinInput.end(),fFValInput.begin(),
-			fGlobalBinOutput.begin(),  fFValOutput.begin());
+	for(size_t r=0; r<nreplicas; r++){
 
+		size_t first_call = r*npoints;
 
+		detail::ScrambledSobol<N> points;
 
-	hydra_thrust::copy( fFValOutput.begin(), end_iterators.second, fState.GetDistribution().begin());
-	integral=result.fMean*result.fN  ;
-	tss=::sqrt( result.fM2 );
+		if( fQMCMode != QMC_NONE )
+			points = detail::ScrambledSobol<N>(hydra_thrust::raw_pointer_cast(fDirections->data()),
+					hydra::random::splitmix<uint64_t>(seed), fQMCMode);
+
+		process_calls_t process_calls(ncalls, fState, fGlobalBinInput.begin(),
+				fFValInput.begin(), fFunctor, points, first_call);
+
+		detail::ResultVegas result;
+
+		if( fNSlots > 0 ) {
+
+			result = hydra_thrust::transform_reduce(system_t(), hydra_thrust::counting_iterator<size_t>(0),
+					hydra_thrust::counting_iterator<size_t>(fNSlots),
+					detail::ProcessSlotsVegas<process_calls_t, N>(process_calls, first_call, npoints,
+							fNSlots, ndist, hydra_thrust::raw_pointer_cast(fDistributionSlots.data()) ),
+					init, detail::ProcessBoxesVegas());
+		}
+		else {
+
+			result = hydra_thrust::transform_reduce(system_t(),
+					hydra_thrust::counting_iterator<size_t>(first_call),
+					hydra_thrust::counting_iterator<size_t>(first_call + npoints),
+					process_calls, init, detail::ProcessBoxesVegas());
+		}
+
+		if( fQMCMode == QMC_NONE ) {
+
+			integral = result.fMean*result.fN;
+			variance = ::sqrt( result.fM2 )/(fState.GetCallsPerBox() - 1.0);
+
+			return;
+		}
+
+		// each replica alone estimates the integral with npoints calls
+		GReal_t replica = nreplicas*result.fMean*result.fN;
+		GReal_t delta   = replica - mean;
+
+		mean += delta/(r + 1);
+		m2   += delta*(replica - mean);
+	}
+
+	integral = mean;
+	variance = m2/(nreplicas*(nreplicas - 1.0));
+}
+
+template< size_t N, hydra::detail::Backend  BACKEND , typename GRND>
+void Vegas<N,hydra::detail::BackendPolicy<BACKEND>, GRND >::UpdateDistribution()
+{
+	typedef hydra::detail::BackendPolicy<BACKEND> system_t;
+
+	if( fNSlots > 0 ) {
+
+		size_t ndist = N*fState.GetNBins();
+
+		hydra_thrust::counting_iterator<size_t> first(0);
+
+		hydra_thrust::transform(system_t(), first, first + ndist,
+				fState.GetDistribution().begin(), fState.GetDistribution().begin(),
+				detail::MergePrivateHistograms<>( hydra_thrust::raw_pointer_cast(fDistributionSlots.data()),
+						fNSlots, ndist) );
+
+		return;
+	}
 
+	detail::reduce_vegas_distribution(system_t(), fGlobalBinInput.begin(), fGlobalBinInput.end(),
+			fFValInput.begin(), fGlobalBinOutput.begin(), fFValOutput.begin(), fState.GetDistribution());
 
 }
 
@@ -188,6 +188,8 @@ VegasState<N, hydra::detail::BackendPolicy<BACKEND>>::VegasState(VegasState<N,hy
 		fCumulatedResult(other.GetCumulatedResult()),
 		fCumulatedSigma(other.GetCumulatedSigma()),
 		fIterationDuration(other.GetIterationDuration()),
+		fFunctionCallsDuration(other.GetFunctionCallsDuration()),
+		fGridUpdateDuration(other.GetGridUpdateDuration()),
 		fBackendDeltaX(other.GetBackendDeltaX()),
 		fBackendXi(other.GetBackendXi()),
 		fBackendXLow(other.GetBackendXLow()),
@@ -237,6 +239,8 @@ VegasState( VegasState<N, hydra::detail::BackendPolicy <BACKEND2>> const& other)
 		fCumulatedResult(other.GetCumulatedResult()),
 		fCumulatedSigma(other.GetCumulatedSigma()),
 		fIterationDuration(other.GetIterationDuration()),
+		fFunctionCallsDuration(other.GetFunctionCallsDuration()),
+		fGridUpdateDuration(other.GetGridUpdateDuration()),
 		fBackendDeltaX(other.GetBackendDeltaX()),
 		fBackendXi(other.GetBackendXi()),
 		fBackendXLow(other.GetBackendXLow()),
@@ -289,6 +293,8 @@ VegasState<N, hydra::detail::BackendPolicy<BACKEND>>::operator=(VegasState<N,hyd
 		fCumulatedResult=other.GetCumulatedResult();
 		fCumulatedSigma=other.GetCumulatedSigma();
 		fIterationDuration=other.GetIterationDuration();
+		fFunctionCallsDuration=other.GetFunctionCallsDuration();
+		fGridUpdateDuration=other.GetGridUpdateDuration();
 		fBackendDeltaX=other.GetBackendDeltaX();
 		fBackendXi=other.GetBackendXi();
 		fBackendXLow=other.GetBackendXLow();
@@ -344,6 +350,8 @@ VegasState<N, hydra::detail::BackendPolicy<BACKEND>>::operator=( VegasState<N, h
 		fCumulatedResult=other.GetCumulatedResult();
 		fCumulatedSigma=other.GetCumulatedSigma();
 		fIterationDuration=other.GetIterationDuration();
+		fFunctionCallsDuration=other.GetFunctionCallsDuration();
+		fGridUpdateDuration=other.GetGridUpdateDuration();
 		fBackendDeltaX=other.GetBackendDeltaX();
 		fBackendXi=other.GetBackendXi();
 		fBackendXLow=other.GetBackendXLow();
@@ -364,6 +372,7 @@ void VegasState<N, hydra::detail::BackendPolicy<BACKEND>>::ClearStoredIterations
 	fCumulatedSigma.clear();
 	fIterationDuration.clear();
 	fFunctionCallsDuration.clear();
+	fGridUpdateDuration.clear();
 
 }
 }
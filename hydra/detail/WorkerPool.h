@@ -0,0 +1,194 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * WorkerPool.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+
+#include <hydra/detail/Config.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if (HYDRA_HOST_SYSTEM==TBB) || (HYDRA_DEVICE_SYSTEM==TBB)
+#include <tbb/task_arena.h>
+#endif
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Invokes f limiting the number of threads used by the OMP and TBB back-ends
+ * in the calling thread to nthreads. Zero means no limit.
+ */
+template<typename Function>
+inline void run_with_threads(size_t nthreads, Function&& f)
+{
+#if defined(_OPENMP)
+	//the number of threads is a per-thread setting
+	omp_set_num_threads( nthreads > 0 ? int(nthreads) : omp_get_num_procs() );
+#endif
+
+#if (HYDRA_HOST_SYSTEM==TBB) || (HYDRA_DEVICE_SYSTEM==TBB)
+	if( nthreads > 0 ){
+
+		tbb::task_arena arena( int(nthreads) );
+		arena.execute( f );
+
+		return;
+	}
+#endif
+
+	f();
+}
+
+/**
+ * \brief Fixed set of threads, kept alive between calls, running batches of indexed tasks.
+ *
+ * Run(ntasks, task) calls task(i) for each i in [0, ntasks), distributing the indexes
+ * among the workers, and returns when all of them are done. An exception thrown by
+ * a task is rethrown by Run().
+ */
+class WorkerPool
+{
+
+public:
+
+	WorkerPool(size_t nworkers):
+		fTask(nullptr),
+		fNTasks(0),
+		fNext(0),
+		fNFinished(0),
+		fStop(false)
+	{
+		nworkers = nworkers > 0 ? nworkers : 1;
+
+		for(size_t i=0; i<nworkers; i++)
+			fWorkers.emplace_back( &WorkerPool::Work, this );
+	}
+
+	WorkerPool(WorkerPool const&)=delete;
+
+	WorkerPool& operator=(WorkerPool const&)=delete;
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			fStop = true;
+		}
+
+		fStart.notify_all();
+
+		for(auto& worker: fWorkers)
+			worker.join();
+	}
+
+	inline size_t GetNumberOfWorkers() const { return fWorkers.size(); }
+
+	inline void Run(size_t ntasks, std::function<void(size_t)> const& task)
+	{
+		if( ntasks==0 ) return;
+
+		std::unique_lock<std::mutex> lock(fMutex);
+
+		fTask      = &task;
+		fNTasks    = ntasks;
+		fNext      = 0;
+		fNFinished = 0;
+		fError     = nullptr;
+
+		fStart.notify_all();
+
+		fDone.wait(lock, [this]{ return fNFinished == fNTasks; });
+
+		fTask   = nullptr;
+		fNTasks = 0;
+
+		if( fError ) std::rethrow_exception(fError);
+	}
+
+private:
+
+	void Work()
+	{
+		std::unique_lock<std::mutex> lock(fMutex);
+
+		while( true ){
+
+			fStart.wait(lock, [this]{ return fStop || fNext < fNTasks; });
+
+			if( fStop ) return;
+
+			size_t index = fNext++;
+			std::function<void(size_t)> const* task = fTask;
+
+			lock.unlock();
+
+			std::exception_ptr error = nullptr;
+
+			try {
+				(*task)(index);
+			}
+			catch(...) {
+				error = std::current_exception();
+			}
+
+			lock.lock();
+
+			if( error && !fError ) fError = error;
+
+			if( ++fNFinished == fNTasks ) fDone.notify_one();
+		}
+	}
+
+	std::vector<std::thread> fWorkers;
+	std::mutex fMutex;
+	std::condition_variable fStart;
+	std::condition_variable fDone;
+	std::function<void(size_t)> const* fTask;
+	size_t fNTasks;
+	size_t fNext;
+	size_t fNFinished;
+	bool   fStop;
+	std::exception_ptr fError;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* WORKERPOOL_H_ */
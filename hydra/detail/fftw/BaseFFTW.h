@@ -49,9 +49,14 @@
 
 //Hydra wrappers
 #include<hydra/detail/fftw/WrappersFFTW.h>
+#include<hydra/detail/fftw/PlanCacheFFTW.h>
 
 namespace hydra {
 
+/*
+ * The plans are taken from hydra::FFTWPlanCache, which owns them, and run
+ * on the buffers of each object through the new-array interface of FFTW.
+ */
 template<typename InputType, typename OutputType, typename PlannerType >
 class BaseFFTW
 {
@@ -78,12 +83,7 @@ public:
 
 		int logical_size = input_size > output_size ? input_size : output_size;
 
-		fPlan =  fPlanner( logical_size, fInput.get(), fOutput.get(), flags, sign);
-
-		if(fPlan==NULL){
-
-			throw std::runtime_error("hydra::BaseFFT : can not allocate fftw_plan");
-		}
+		MakePlan(logical_size);
 	}
 
 	BaseFFTW( BaseFFTW<InputType,OutputType,PlannerType>&& other):
@@ -91,13 +91,10 @@ public:
 		fSign(other.GetSign()),
 		fNInput(other.GetNInput()),
 		fNOutput(other.GetNOutput()),
+		fPlan(other.fPlan),
 		fInput(std::move(other.GetInput())),
 		fOutput(std::move(other.GetOutput()))
-	{
-		fDestroyer(fPlan);
-
-		fPlan = fPlanner( other.GetSize() , fInput.get(), fOutput.get(), fFlags, fSign);
-	}
+	{}
 
 	BaseFFTW<InputType,OutputType,PlannerType>&
 	operator=(BaseFFTW<InputType,OutputType,PlannerType>&& other)
@@ -108,13 +105,10 @@ public:
 		fSign   = other.GetSign();
 		fNInput = other.GetNInput();
 		fNOutput= other.GetNOutput();
+		fPlan   = other.fPlan;
 		fInput  = std::move(other.GetInput());
 		fOutput = std::move(other.GetOutput());
 
-		fDestroyer(fPlan);
-
-		fPlan =  fPlanner( other.GetSize(), fInput.get(), fOutput.get(), fFlags, fSign);
-
 		return *this;
 	}
 
@@ -144,7 +138,7 @@ public:
 
 	inline void Execute()
 	{
-		fExecutor(fPlan);
+		fExecutor(fPlan, fInput.get(), fOutput.get());
 	}
 
 	inline hydra::pair<input_tagged_ptr_type, int>
@@ -190,13 +184,11 @@ public:
 		fInput.reset(reinterpret_cast<InputType*>(fftw_malloc(sizeof(InputType)*ninput)));
 
 		fNOutput = noutput;
-		fOutput.reset(reinterpret_cast<OutputType*>(fftw_malloc(sizeof(OutputType)*ninput)));
-
-		fDestroyer(fPlan);
+		fOutput.reset(reinterpret_cast<OutputType*>(fftw_malloc(sizeof(OutputType)*noutput)));
 
 		int logical_size = ninput > noutput ? ninput : noutput;
 
-		fPlan =  fPlanner( logical_size, fInput.get(), fOutput.get(), fFlags, fSign);
+		MakePlan(logical_size);
 	}
 
 	int GetSign() const
@@ -230,13 +222,22 @@ public:
 
 	virtual void SetSize(int logical_size)=0;
 
-	virtual ~BaseFFTW(){
-		fDestroyer(fPlan);
-	}
+	virtual ~BaseFFTW(){}
 
 
 private:
 
+	void MakePlan(int logical_size)
+	{
+		fPlan = FFTWPlanCache::Instance().GetPlan(fPlanner, logical_size,
+				fInput.get(), fOutput.get(), fFlags, fSign);
+
+		if(fPlan==NULL){
+
+			throw std::runtime_error("hydra::BaseFFT : can not allocate fftw_plan");
+		}
+	}
+
 	inline input_ptr_type GetInput()
 	{
 		return std::move(fInput);
@@ -250,9 +251,6 @@ private:
 
 	void LoadInput(int size, const InputType* data )
 	{
-		std::cout << "size "<< size<<std::endl;
-		std::cout << "fNInput "<< fNInput<<std::endl;
-
 		assert(size <= fNInput);
 		memcpy(&fInput.get()[0], data, sizeof(InputType)*size);
 		memset(&fInput.get()[size], 0, sizeof(InputType)*( fNInput-size  ));
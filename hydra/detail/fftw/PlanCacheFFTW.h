@@ -0,0 +1,213 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * PlanCacheFFTW.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef PLANCACHEFFTW_H_
+#define PLANCACHEFFTW_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Complex.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+
+//FFTW3
+#include <fftw3.h>
+
+namespace hydra {
+
+/**
+ * \ingroup generic
+ * \brief Process-wide cache of FFTW plans.
+ *
+ * The FFTW planner is expensive, in particular with FFTW_MEASURE or FFTW_PATIENT, and is not
+ * thread safe. The FFT objects of Hydra request their plans to this cache, which calls the planner
+ * only the first time a (transform, size, sign, flags, alignment) combination is seen. The plans are
+ * executed with the new-array interface on the buffers of each object, so they are shared freely.
+ *
+ * If a wisdom file is set, its wisdom is imported right away and the accumulated wisdom is written
+ * back to it every time a new plan is made, so that the next runs plan from it at no cost.
+ * The file can also be set with the macro HYDRA_FFTW_WISDOM_FILE.
+ */
+class FFTWPlanCache
+{
+	//input type, output type, size, sign, flags, input alignment, output alignment
+	typedef std::tuple<std::type_index, std::type_index, int, int, unsigned, int, int> key_type;
+
+public:
+
+	FFTWPlanCache(FFTWPlanCache const&)=delete;
+
+	FFTWPlanCache& operator=(FFTWPlanCache const&)=delete;
+
+	static FFTWPlanCache& Instance()
+	{
+		static FFTWPlanCache* cache = new FFTWPlanCache();
+
+		return *cache;
+	}
+
+	/**
+	 * @brief Get a plan for the transform of @p n points from @p in to @p out, calling
+	 * @p planner only if no plan with the same key was made before.
+	 */
+	template<typename Planner, typename InputType, typename OutputType>
+	auto GetPlan(Planner& planner, int n, InputType* in, OutputType* out, unsigned flags, int sign)
+	-> decltype(planner(n, in, out, flags, sign))
+	{
+		typedef decltype(planner(n, in, out, flags, sign)) plan_type;
+
+		key_type key(std::type_index(typeid(InputType)), std::type_index(typeid(OutputType)),
+				n, sign, flags, Alignment(in), Alignment(out));
+
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		auto& plans = Plans(plan_type());
+
+		auto search = plans.find(key);
+
+		if( search != plans.end() ){
+
+			++fHits;
+			return search->second;
+		}
+
+		plan_type plan = planner(n, in, out, flags, sign);
+
+		if( plan != NULL ){
+
+			plans[key] = plan;
+			++fMisses;
+
+			if( !fWisdomFile.empty() ) ExportWisdom();
+		}
+
+		return plan;
+	}
+
+	/**
+	 * @brief Import the wisdom in @p filename, and write the wisdom there after each new plan.
+	 * @return true if the wisdom of both precisions was imported.
+	 */
+	bool SetWisdomFile(std::string const& filename)
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		fWisdomFile = filename;
+
+		if( fWisdomFile.empty() ) return false;
+
+		bool result = fftw_import_wisdom_from_filename(fWisdomFile.c_str()) != 0;
+
+		//float wisdom is kept in a separate file
+		result = (fftwf_import_wisdom_from_filename( (fWisdomFile + ".f32").c_str()) != 0) && result;
+
+		return result;
+	}
+
+	inline std::string GetWisdomFile() const { return fWisdomFile; }
+
+	/**
+	 * @brief Write the accumulated wisdom to the wisdom file.
+	 */
+	inline bool SaveWisdom()
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		return ExportWisdom();
+	}
+
+	/**
+	 * @brief Destroy all cached plans. The plans held by live FFT objects become invalid.
+	 */
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+
+		for(auto& plan: fPlans)  fftw_destroy_plan(plan.second);
+		for(auto& plan: fPlansF) fftwf_destroy_plan(plan.second);
+
+		fPlans.clear();
+		fPlansF.clear();
+	}
+
+	inline size_t GetSize() const { return fPlans.size() + fPlansF.size(); }
+
+	inline size_t GetHits() const { return fHits; }
+
+	inline size_t GetMisses() const { return fMisses; }
+
+private:
+
+	FFTWPlanCache():
+		fHits(0),
+		fMisses(0)
+	{
+#ifdef HYDRA_FFTW_WISDOM_FILE
+		SetWisdomFile(HYDRA_FFTW_WISDOM_FILE);
+#endif
+	}
+
+	inline bool ExportWisdom()
+	{
+		if( fWisdomFile.empty() ) return false;
+
+		bool result = fftw_export_wisdom_to_filename(fWisdomFile.c_str()) != 0;
+
+		result = (fftwf_export_wisdom_to_filename( (fWisdomFile + ".f32").c_str()) != 0) && result;
+
+		return result;
+	}
+
+	inline std::map<key_type, fftw_plan>&  Plans(fftw_plan)  { return fPlans;  }
+
+	inline std::map<key_type, fftwf_plan>& Plans(fftwf_plan) { return fPlansF; }
+
+	static inline int Alignment(double* p) { return fftw_alignment_of(p); }
+
+	static inline int Alignment(float* p) { return fftwf_alignment_of(p); }
+
+	static inline int Alignment(hydra::complex<double>* p) { return fftw_alignment_of(reinterpret_cast<double*>(p)); }
+
+	static inline int Alignment(hydra::complex<float>* p) { return fftwf_alignment_of(reinterpret_cast<float*>(p)); }
+
+	std::mutex  fMutex;
+	std::string fWisdomFile;
+	std::map<key_type, fftw_plan>  fPlans;
+	std::map<key_type, fftwf_plan> fPlansF;
+	size_t fHits;
+	size_t fMisses;
+};
+
+}  // namespace hydra
+
+#endif /* PLANCACHEFFTW_H_ */
@@ -177,6 +177,44 @@ namespace hydra {
 
 					fftwf_execute(plan);
 				}
+
+				// new-array execution, running a plan on buffers other than the planned ones
+
+				// Complex -> Complex
+				inline void operator()(fftw_plan& plan, hydra::complex<double>* in, hydra::complex<double>* out ){
+
+					fftw_execute_dft(plan, reinterpret_cast<fftw_complex*>(in), reinterpret_cast<fftw_complex*>(out));
+				}
+
+				// Real -> Complex
+				inline void operator()(fftw_plan& plan, double* in, hydra::complex<double>* out ){
+
+					fftw_execute_dft_r2c(plan, in, reinterpret_cast<fftw_complex*>(out));
+				}
+
+				// Complex -> Real
+				inline void operator()(fftw_plan& plan, hydra::complex<double>* in, double* out ){
+
+					fftw_execute_dft_c2r(plan, reinterpret_cast<fftw_complex*>(in), out);
+				}
+
+				// Complex -> Complex
+				inline void operator()(fftwf_plan& plan, hydra::complex<float>* in, hydra::complex<float>* out ){
+
+					fftwf_execute_dft(plan, reinterpret_cast<fftwf_complex*>(in), reinterpret_cast<fftwf_complex*>(out));
+				}
+
+				// Real -> Complex
+				inline void operator()(fftwf_plan& plan, float* in, hydra::complex<float>* out ){
+
+					fftwf_execute_dft_r2c(plan, in, reinterpret_cast<fftwf_complex*>(out));
+				}
+
+				// Complex -> Real
+				inline void operator()(fftwf_plan& plan, hydra::complex<float>* in, float* out ){
+
+					fftwf_execute_dft_c2r(plan, reinterpret_cast<fftwf_complex*>(in), out);
+				}
 			};
 
 
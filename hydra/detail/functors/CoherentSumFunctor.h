@@ -0,0 +1,230 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * CoherentSumFunctor.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COHERENTSUMFUNCTOR_H_
+#define COHERENTSUMFUNCTOR_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/Complex.h>
+#include <hydra/detail/Print.h>
+#include <hydra/detail/utility/Utility_Tuple.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
+#include <hydra/detail/external/hydra_thrust/detail/type_traits.h>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Normalized density |sum_k c_k A_k(x)|^2/I of a coherent sum,
+ * with the integral I computed by hydra::CoherentSum.
+ */
+template<typename Amplitude1, typename ...Amplitudes>
+struct CoherentSumFunctor
+{
+	typedef void hydra_composed_functor_type;
+
+	typedef hydra_thrust::tuple<Amplitude1, Amplitudes...> functors_tuple_type;
+
+	constexpr static size_t namplitudes = sizeof...(Amplitudes)+1;
+
+	CoherentSumFunctor()=delete;
+
+	CoherentSumFunctor(functors_tuple_type const& functors,
+			hydra::complex<double> const (&coefficients)[namplitudes], GReal_t inverse_norm):
+		fFunctors(functors),
+		fInverseNorm(inverse_norm)
+	{
+		for(size_t i=0; i<namplitudes; i++)
+			fCoefficients[i] = coefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__
+	CoherentSumFunctor(CoherentSumFunctor<Amplitude1, Amplitudes...> const& other):
+		fFunctors(other.GetFunctors()),
+		fInverseNorm(other.GetInverseNorm())
+	{
+		for(size_t i=0; i<namplitudes; i++)
+			fCoefficients[i] = other.GetCoefficients()[i];
+	}
+
+	__hydra_host__ __hydra_device__
+	CoherentSumFunctor<Amplitude1, Amplitudes...>&
+	operator=(CoherentSumFunctor<Amplitude1, Amplitudes...> const& other)
+	{
+		if(this==&other) return *this;
+
+		fFunctors    = other.GetFunctors();
+		fInverseNorm = other.GetInverseNorm();
+
+		for(size_t i=0; i<namplitudes; i++)
+			fCoefficients[i] = other.GetCoefficients()[i];
+
+		return *this;
+	}
+
+	__hydra_host__
+	void PrintRegisteredParameters()
+	{
+		HYDRA_CALLER ;
+		HYDRA_MSG << "Registered parameters begin:" << HYDRA_ENDL;
+		HYDRA_MSG << "Coefficients: "<< HYDRA_ENDL;
+		for(size_t i=0; i<namplitudes; i++)
+			HYDRA_MSG << "["<<i<<"]" << fCoefficients[i] << HYDRA_ENDL;
+		detail::print_parameters_in_tuple(fFunctors);
+		HYDRA_MSG <<"Registered parameters end."<< HYDRA_ENDL;
+		HYDRA_MSG << HYDRA_ENDL;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline hydra::complex<double> const* GetCoefficients() const { return fCoefficients; }
+
+	__hydra_host__ __hydra_device__
+	inline GReal_t GetInverseNorm() const { return fInverseNorm; }
+
+	//the density is already normalized
+	__hydra_host__ __hydra_device__
+	inline GReal_t GetNorm() const { return 1.0; }
+
+	__hydra_host__ __hydra_device__
+	inline functors_tuple_type const& GetFunctors() const { return fFunctors; }
+
+	/**
+	 * Coherent sum of the amplitudes at @p x, without normalization.
+	 */
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline hydra::complex<double> Amplitude(T&& x) const
+	{
+		hydra::complex<double> result(0.0, 0.0);
+
+		add_amplitudes(x, result);
+
+		return result;
+	}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline GReal_t operator()(T&& x) const
+	{
+		return hydra::norm(Amplitude(x))*fInverseNorm;
+	}
+
+private:
+
+	template<size_t I=0, typename T>
+	__hydra_host__ __hydra_device__
+	inline typename hydra_thrust::detail::enable_if<(I == namplitudes), void>::type
+	add_amplitudes(T&&, hydra::complex<double>&) const
+	{}
+
+	template<size_t I=0, typename T>
+	__hydra_host__ __hydra_device__
+	inline typename hydra_thrust::detail::enable_if<(I < namplitudes), void>::type
+	add_amplitudes(T&& x, hydra::complex<double>& result) const
+	{
+		result += fCoefficients[I]*hydra::complex<double>(hydra_thrust::get<I>(fFunctors)(x));
+
+		add_amplitudes<I+1>(x, result);
+	}
+
+	functors_tuple_type fFunctors;
+	hydra::complex<double> fCoefficients[namplitudes];
+	GReal_t fInverseNorm;
+};
+
+/*
+ * Row of the normalization matrix, I_jk for all k.
+ */
+template<size_t N>
+struct NormalizationRow
+{
+	__hydra_host__ __hydra_device__
+	NormalizationRow()
+	{
+		for(size_t k=0; k<N; k++) fValues[k] = hydra::complex<double>(0.0, 0.0);
+	}
+
+	__hydra_host__ __hydra_device__
+	inline NormalizationRow<N> operator+(NormalizationRow<N> const& other) const
+	{
+		NormalizationRow<N> r(*this);
+
+		for(size_t k=0; k<N; k++) r.fValues[k] += other.fValues[k];
+
+		return r;
+	}
+
+	hydra::complex<double> fValues[N];
+};
+
+/*
+ * Contribution w*A_j*conj(A_k) of an event to the row j of the normalization
+ * matrix, read from the columns of an AmplitudeCache.
+ */
+template<size_t N>
+struct AmplitudeProducts
+{
+	AmplitudeProducts(hydra::complex<double> const* columns, size_t nentries, size_t row):
+		fColumns(columns),
+		fNEntries(nentries),
+		fRow(row)
+	{}
+
+	__hydra_host__ __hydra_device__
+	AmplitudeProducts(AmplitudeProducts<N> const& other):
+		fColumns(other.fColumns),
+		fNEntries(other.fNEntries),
+		fRow(other.fRow)
+	{}
+
+	template<typename Weight>
+	__hydra_host__ __hydra_device__
+	inline NormalizationRow<N> operator()(size_t entry, Weight weight) const
+	{
+		NormalizationRow<N> r;
+
+		hydra::complex<double> a = double(weight)*fColumns[fRow*fNEntries + entry];
+
+		for(size_t k=0; k<N; k++)
+			r.fValues[k] = a*hydra::conj(fColumns[k*fNEntries + entry]);
+
+		return r;
+	}
+
+	hydra::complex<double> const* fColumns;
+	size_t fNEntries;
+	size_t fRow;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* COHERENTSUMFUNCTOR_H_ */
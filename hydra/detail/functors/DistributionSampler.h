@@ -34,6 +34,15 @@
 #include <hydra/detail/RngFormula.h>
 #include <hydra/Distribution.h>
 #include <hydra/detail/PRNGTypedefs.h>
+#include <hydra/detail/RandomTraits.h>
+
+/**
+ * Number of pseudo-random numbers generated at once by the engines
+ * supporting block generation, when filling ranges on the host backends.
+ */
+#ifndef HYDRA_RNG_BLOCK_SIZE
+#define HYDRA_RNG_BLOCK_SIZE 1024
+#endif
 
 namespace hydra {
 
@@ -91,6 +100,140 @@ private:
 	size_t  fJump;
 };
 
+/*
+ * Engine handing out a block of numbers generated in advance, and falling
+ * back to a copy of the engine positioned at the end of the block if the
+ * distribution asks for more.
+ */
+template<typename Engine>
+class BufferedEngine
+{
+public:
+
+	typedef typename Engine::result_type result_type;
+
+	__hydra_host__  __hydra_device__
+	BufferedEngine(result_type const* first, result_type const* last,
+			Engine& engine, Engine const& block_end):
+		fFirst(first),
+		fLast(last),
+		fEngine(engine),
+		fBlockEnd(block_end),
+		fRestored(false)
+	{}
+
+	__hydra_host__  __hydra_device__
+	inline result_type operator()(void)
+	{
+		if( fFirst != fLast ) return *fFirst++;
+
+		if( !fRestored ){
+
+			fEngine   = fBlockEnd;
+			fRestored = true;
+		}
+
+		return fEngine();
+	}
+
+	static const result_type HYDRA_PREVENT_MACRO_SUBSTITUTION min  = Engine::min;
+
+	static const result_type HYDRA_PREVENT_MACRO_SUBSTITUTION max = Engine::max;
+
+private:
+
+	result_type const* fFirst;
+	result_type const* fLast;
+	Engine&            fEngine;
+	Engine const&    fBlockEnd;
+	bool             fRestored;
+};
+
+/*
+ * Fills the elements of one block of the output with the same numbers as
+ * detail::Sampler, generating the pseudo-random numbers for all of them at once.
+ * The element i reads the sequence from the position it is discarded to,
+ * NCalls*(i+jump) times the stride of the engine.
+ */
+template< typename Functor, typename Engine, typename Iterator>
+struct BlockSampler
+{
+	typedef typename Engine::result_type result_type;
+
+	BlockSampler()=delete;
+
+	BlockSampler(Functor const& functor, Iterator output, size_t size, size_t seed, size_t jump) :
+		fFunctor(functor),
+		fOutput(output),
+		fSize(size),
+		fSeed(seed),
+		fJump(jump),
+		fNCalls( RngFormula<Functor>().NCalls(functor) ),
+		fBlockSize(0)
+	{
+		size_t unit = fNCalls*block_traits<Engine>::stride;
+
+		//room for distributions asking more numbers than NCalls
+		size_t slots = HYDRA_RNG_BLOCK_SIZE - HYDRA_RNG_BLOCK_SIZE/8;
+
+		fBlockSize = unit > 0 && unit < slots ? slots/unit : 1;
+	}
+
+	__hydra_host__  __hydra_device__
+	BlockSampler(BlockSampler<Functor, Engine, Iterator> const& other) :
+		fFunctor(other.fFunctor),
+		fOutput(other.fOutput),
+		fSize(other.fSize),
+		fSeed(other.fSeed),
+		fJump(other.fJump),
+		fNCalls(other.fNCalls),
+		fBlockSize(other.fBlockSize)
+	{}
+
+	inline size_t GetNumberOfBlocks() const
+	{
+		return (fSize + fBlockSize - 1)/fBlockSize;
+	}
+
+	__hydra_host__  __hydra_device__
+	void operator()(size_t block) const
+	{
+		const size_t first = block*fBlockSize;
+		const size_t count = first + fBlockSize < fSize ? fBlockSize : fSize - first;
+		const size_t unit  = fNCalls*block_traits<Engine>::stride;
+
+		size_t nnumbers = count*unit + HYDRA_RNG_BLOCK_SIZE/8;
+		nnumbers = nnumbers < HYDRA_RNG_BLOCK_SIZE ? nnumbers : HYDRA_RNG_BLOCK_SIZE;
+
+		result_type numbers[HYDRA_RNG_BLOCK_SIZE];
+
+		Engine engine(fSeed);
+		engine.discard( fNCalls*(first + fJump) );
+		engine.generate(numbers, numbers + nnumbers);
+
+		const Engine block_end(engine);
+
+		auto distribution = hydra::Distribution<Functor>();
+
+		for(size_t i=0; i<count; ++i){
+
+			BufferedEngine<Engine> rng(numbers + i*unit, numbers + nnumbers, engine, block_end);
+
+			fOutput[first + i] = distribution(rng, fFunctor);
+		}
+	}
+
+private:
+
+	Functor  fFunctor;
+	Iterator fOutput;
+	size_t   fSize;
+	size_t   fSeed;
+	size_t   fJump;
+	size_t   fNCalls;
+	size_t   fBlockSize;
+};
+
 }  // namespace detail
 
 }  // namespace hydra
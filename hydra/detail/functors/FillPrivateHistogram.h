@@ -0,0 +1,140 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * FillPrivateHistogram.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef FILLPRIVATEHISTOGRAM_H_
+#define FILLPRIVATEHISTOGRAM_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/utility/CompensatedSum.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Fills the private copy of the histogram owned by the slot passed
+ * to operator(). Each slot processes a contiguous chunk of the data
+ * and writes only to its own bin array, so no atomics are needed.
+ * The bins carry the rounding error of the weighted sums.
+ */
+template<typename KeyFunctor, typename Iterator, typename WeightIterator>
+struct FillPrivateHistogram
+{
+	typedef typename hydra_thrust::iterator_traits<Iterator>::value_type value_type;
+
+	FillPrivateHistogram(KeyFunctor key_functor, Iterator data, WeightIterator weights,
+			size_t data_size, size_t nslots, size_t nbins, CompensatedSum<double>* bins):
+		fKeyFunctor(key_functor),
+		fData(data),
+		fWeights(weights),
+		fDataSize(data_size),
+		fNSlots(nslots),
+		fNBins(nbins),
+		fBins(bins)
+	{}
+
+	__hydra_host__ __hydra_device__
+	FillPrivateHistogram( FillPrivateHistogram<KeyFunctor, Iterator, WeightIterator> const& other):
+		fKeyFunctor(other.fKeyFunctor),
+		fData(other.fData),
+		fWeights(other.fWeights),
+		fDataSize(other.fDataSize),
+		fNSlots(other.fNSlots),
+		fNBins(other.fNBins),
+		fBins(other.fBins)
+	{}
+
+	__hydra_host__ __hydra_device__
+	void operator()(size_t slot)
+	{
+		size_t chunk = (fDataSize + fNSlots - 1)/fNSlots;
+		size_t first = slot*chunk;
+		size_t last  = (first + chunk) < fDataSize ? first + chunk : fDataSize;
+
+		CompensatedSum<double>* bins = fBins + slot*fNBins;
+
+		for(size_t i=first; i<last; i++){
+
+			value_type value = fData[i];
+			size_t bin = fKeyFunctor(value);
+
+			if( bin < fNBins ) bins[bin] += double(fWeights[i]);
+		}
+	}
+
+	KeyFunctor     fKeyFunctor;
+	Iterator       fData;
+	WeightIterator fWeights;
+	size_t         fDataSize;
+	size_t         fNSlots;
+	size_t         fNBins;
+	CompensatedSum<double>* fBins;
+};
+
+/*
+ * Sums the contents of a given bin over all private histograms
+ * and adds it to the current content.
+ */
+template<typename Bin=double>
+struct MergePrivateHistograms
+{
+	MergePrivateHistograms(Bin* bins, size_t nslots, size_t nbins):
+		fBins(bins),
+		fNSlots(nslots),
+		fNBins(nbins)
+	{}
+
+	__hydra_host__ __hydra_device__
+	MergePrivateHistograms( MergePrivateHistograms<Bin> const& other):
+		fBins(other.fBins),
+		fNSlots(other.fNSlots),
+		fNBins(other.fNBins)
+	{}
+
+	__hydra_host__ __hydra_device__
+	double operator()(size_t bin, double content) const
+	{
+		CompensatedSum<double> sum(content);
+
+		for(size_t slot=0; slot<fNSlots; slot++)
+			sum += fBins[slot*fNBins + bin];
+
+		return sum.Sum();
+	}
+
+	Bin*    fBins;
+	size_t  fNSlots;
+	size_t  fNBins;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* FILLPRIVATEHISTOGRAM_H_ */
@@ -0,0 +1,108 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * GetSparseBinContent.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef GETSPARSEBINCONTENT_H_
+#define GETSPARSEBINCONTENT_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/detail/external/hydra_thrust/functional.h>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Looks up the content of a global bin in a sparse histogram
+ * by binary search over the sorted bin indexes. Bins not
+ * stored in the histogram have zero content.
+ */
+struct GetSparseBinContent: public hydra_thrust::unary_function<size_t, double>
+{
+	GetSparseBinContent(size_t const* bins, double const* contents, size_t size):
+		fBins(bins),
+		fContents(contents),
+		fSize(size)
+	{}
+
+	__hydra_host__ __hydra_device__
+	GetSparseBinContent( GetSparseBinContent const& other):
+		fBins(other.fBins),
+		fContents(other.fContents),
+		fSize(other.fSize)
+	{}
+
+	__hydra_host__ __hydra_device__
+	GetSparseBinContent& operator=( GetSparseBinContent const& other)
+	{
+		if(this==&other) return *this;
+
+		fBins     = other.fBins;
+		fContents = other.fContents;
+		fSize     = other.fSize;
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline size_t index(size_t bin) const
+	{
+		size_t first = 0;
+		size_t count = fSize;
+
+		while( count > 0 ){
+
+			size_t step = count/2;
+
+			if( fBins[first + step] < bin ){
+				first += step + 1;
+				count -= step + 1;
+			}
+			else count = step;
+		}
+
+		return (first < fSize && fBins[first]==bin) ? first : fSize;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(size_t bin) const
+	{
+		size_t i = index(bin);
+
+		return i < fSize ? fContents[i] : 0.0;
+	}
+
+	size_t const* fBins;
+	double const* fContents;
+	size_t fSize;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* GETSPARSEBINCONTENT_H_ */
@@ -38,12 +38,18 @@
 
 #include <hydra/detail/Config.h>
 #include <hydra/Types.h>
+#include <hydra/Complex.h>
 #include <hydra/detail/utility/Utility_Tuple.h>
 #include <hydra/detail/TypeTraits.h>
+#include <hydra/Dual.h>
+#include <hydra/detail/utility/Generic.h>
+#include <hydra/detail/utility/CompensatedSum.h>
 
 #include <hydra/detail/external/hydra_thrust/tuple.h>
 #include <hydra/detail/external/hydra_thrust/functional.h>
 
+#include <vector>
+
 
 
 namespace hydra{
@@ -108,6 +114,340 @@ struct LogLikelihood2
     const GReal_t fNorm;
 };
 
+/*
+ * Log of the functor and its derivatives with respect to the functor
+ * parameters, in one evaluation with dual numbers. The normalization is
+ * not included, its derivatives are added by the FCN.
+ */
+template<typename FUNCTOR>
+struct LogLikelihoodGradient1
+{
+	typedef Dual<GReal_t, FUNCTOR::parameter_count> dual_type;
+
+	LogLikelihoodGradient1(FUNCTOR const& functor):
+		fFunctor(functor)
+	{
+		for(size_t i=0; i<FUNCTOR::parameter_count; i++)
+			fParameters[i] = dual_type(functor[i], i);
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodGradient1( LogLikelihoodGradient1<FUNCTOR> const& other):
+	fFunctor(other.fFunctor)
+	{
+		for(size_t i=0; i<FUNCTOR::parameter_count; i++)
+			fParameters[i] = other.fParameters[i];
+	}
+
+	template<typename Type>
+	__hydra_host__ __hydra_device__ inline
+	dual_type operator()(Type x) const
+	{
+		return log(fFunctor.CallWithParameters(&fParameters[0], x ));
+	}
+
+	FUNCTOR  fFunctor;
+	dual_type fParameters[FUNCTOR::parameter_count];
+};
+
+template<typename FUNCTOR>
+struct LogLikelihoodGradient2
+{
+	typedef Dual<GReal_t, FUNCTOR::parameter_count> dual_type;
+
+	LogLikelihoodGradient2(FUNCTOR const& functor):
+		fFunctor(functor)
+	{
+		for(size_t i=0; i<FUNCTOR::parameter_count; i++)
+			fParameters[i] = dual_type(functor[i], i);
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodGradient2( LogLikelihoodGradient2<FUNCTOR> const& other):
+	fFunctor(other.fFunctor)
+	{
+		for(size_t i=0; i<FUNCTOR::parameter_count; i++)
+			fParameters[i] = other.fParameters[i];
+	}
+
+	template<typename Args, typename Weights>
+	__hydra_host__ __hydra_device__ inline
+	dual_type operator()(Args x, Weights w) const
+	{
+		double weight = 1.0;
+		multiply_tuple(weight, w );
+		return weight*log(fFunctor.CallWithParameters(&fParameters[0], x ));
+	}
+
+	FUNCTOR  fFunctor;
+	dual_type fParameters[FUNCTOR::parameter_count];
+};
+
+/*
+ * Values of the log-likelihood at N parameter points, accumulated
+ * together in one reduction.
+ */
+template<size_t N>
+struct LogLikelihoodValues
+{
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodValues(){}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodValues( LogLikelihoodValues<N> const& other)
+	{
+		for(size_t i=0; i<N; i++) fSums[i]=other.fSums[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodValues<N>& operator=( LogLikelihoodValues<N> const& other)
+	{
+		for(size_t i=0; i<N; i++) fSums[i]=other.fSums[i];
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodValues<N> operator+( LogLikelihoodValues<N> const& other) const
+	{
+		LogLikelihoodValues<N> r(*this);
+
+		for(size_t i=0; i<N; i++) r.fSums[i] += other.fSums[i];
+
+		return r;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator[](size_t i) const { return fSums[i].Sum(); }
+
+	CompensatedSum<GReal_t> fSums[N];
+};
+
+/*
+ * Log of up to N normalized copies of the functor, each one configured with
+ * a different set of parameters, evaluated on the same event. Slots beyond
+ * the number of points repeat the last functor and are not evaluated.
+ */
+template<typename FUNCTOR, size_t N>
+struct LogLikelihoodBatch1
+{
+	typedef LogLikelihoodValues<N> value_type;
+
+	LogLikelihoodBatch1(std::vector<FUNCTOR> const& functors):
+		LogLikelihoodBatch1(functors, make_index_sequence<N>{})
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodBatch1( LogLikelihoodBatch1<FUNCTOR, N> const& other):
+		LogLikelihoodBatch1(other, make_index_sequence<N>{})
+	{}
+
+	template<typename Type>
+	__hydra_host__ __hydra_device__ inline
+	value_type operator()(Type x) const
+	{
+		value_type r;
+
+		for(size_t i=0; i<fCount; i++)
+			r.fSums[i] = ::log(fNorm[i]*fFunctors[i]( x ));
+
+		return r;
+	}
+
+	FUNCTOR fFunctors[N];
+	GReal_t fNorm[N];
+	size_t  fCount;
+
+private:
+
+	template<size_t ...I>
+	LogLikelihoodBatch1(std::vector<FUNCTOR> const& functors, index_sequence<I...>):
+		fFunctors{ functors[ I < functors.size() ? I : functors.size()-1 ]... },
+		fCount(functors.size())
+	{
+		for(size_t i=0; i<N; i++) fNorm[i] = fFunctors[i].GetNorm();
+	}
+
+	template<size_t ...I>
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodBatch1( LogLikelihoodBatch1<FUNCTOR, N> const& other, index_sequence<I...>):
+		fFunctors{ other.fFunctors[I]... },
+		fCount(other.fCount)
+	{
+		for(size_t i=0; i<N; i++) fNorm[i] = other.fNorm[i];
+	}
+};
+
+template<typename FUNCTOR, size_t N>
+struct LogLikelihoodBatch2
+{
+	typedef LogLikelihoodValues<N> value_type;
+
+	LogLikelihoodBatch2(std::vector<FUNCTOR> const& functors):
+		fBatch(functors)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodBatch2( LogLikelihoodBatch2<FUNCTOR, N> const& other):
+		fBatch(other.fBatch)
+	{}
+
+	template<typename Args, typename Weights>
+	__hydra_host__ __hydra_device__ inline
+	value_type operator()(Args x, Weights w) const
+	{
+		double weight = 1.0;
+		multiply_tuple(weight, w );
+
+		value_type r;
+
+		for(size_t i=0; i<fBatch.fCount; i++)
+			r.fSums[i] = weight*::log(fBatch.fNorm[i]*fBatch.fFunctors[i]( x ));
+
+		return r;
+	}
+
+	LogLikelihoodBatch1<FUNCTOR, N> fBatch;
+};
+
+/*
+ * Log-likelihood of a pdf sum, evaluated from per-event
+ * component densities stored in N columns of 'nentries' elements.
+ */
+template<size_t N>
+struct LogLikelihoodComponents
+{
+	LogLikelihoodComponents(GReal_t const* columns, size_t nentries,
+			GReal_t const* coefficients, GReal_t coef_sum):
+		fColumns(columns),
+		fNEntries(nentries),
+		fCoefSum(coef_sum)
+	{
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = coefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodComponents( LogLikelihoodComponents<N> const& other):
+		fColumns(other.fColumns),
+		fNEntries(other.fNEntries),
+		fCoefSum(other.fCoefSum)
+	{
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodComponents<N>& operator=( LogLikelihoodComponents<N> const& other)
+	{
+		if(this == &other) return *this;
+
+		fColumns  = other.fColumns;
+		fNEntries = other.fNEntries;
+		fCoefSum  = other.fCoefSum;
+
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(size_t entry) const
+	{
+		GReal_t result = 0;
+
+		for(size_t i=0; i<N; i++)
+			result += fCoefficients[i]*fColumns[i*fNEntries + entry];
+
+		return ::log(result*fCoefSum);
+	}
+
+	template<typename Weights>
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(size_t entry, Weights w) const
+	{
+		double weight = 1.0;
+		multiply_tuple(weight, w );
+
+		return weight*this->operator()(entry);
+	}
+
+	GReal_t const* fColumns;
+	size_t  fNEntries;
+	GReal_t fCoefSum;
+	GReal_t fCoefficients[N];
+};
+
+/*
+ * Log-likelihood of a coherent sum, evaluated from per-event
+ * amplitudes stored in N columns of 'nentries' elements.
+ */
+template<size_t N>
+struct LogLikelihoodAmplitudes
+{
+	LogLikelihoodAmplitudes(hydra::complex<double> const* columns, size_t nentries,
+			hydra::complex<double> const* coefficients, GReal_t inverse_norm):
+		fColumns(columns),
+		fNEntries(nentries),
+		fInverseNorm(inverse_norm)
+	{
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = coefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodAmplitudes( LogLikelihoodAmplitudes<N> const& other):
+		fColumns(other.fColumns),
+		fNEntries(other.fNEntries),
+		fInverseNorm(other.fInverseNorm)
+	{
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	LogLikelihoodAmplitudes<N>& operator=( LogLikelihoodAmplitudes<N> const& other)
+	{
+		if(this == &other) return *this;
+
+		fColumns     = other.fColumns;
+		fNEntries    = other.fNEntries;
+		fInverseNorm = other.fInverseNorm;
+
+		for(size_t i=0; i<N; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(size_t entry) const
+	{
+		hydra::complex<double> result(0.0, 0.0);
+
+		for(size_t i=0; i<N; i++)
+			result += fCoefficients[i]*fColumns[i*fNEntries + entry];
+
+		return ::log(hydra::norm(result)*fInverseNorm);
+	}
+
+	template<typename Weights>
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(size_t entry, Weights w) const
+	{
+		double weight = 1.0;
+		multiply_tuple(weight, w );
+
+		return weight*this->operator()(entry);
+	}
+
+	hydra::complex<double> const* fColumns;
+	size_t  fNEntries;
+	GReal_t fInverseNorm;
+	hydra::complex<double> fCoefficients[N];
+};
+
 }//namespace detail
 
 
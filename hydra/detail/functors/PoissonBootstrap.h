@@ -0,0 +1,292 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * PoissonBootstrap.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+/**
+ * \file
+ * \ingroup random
+ */
+
+#ifndef POISSONBOOTSTRAP_H_
+#define POISSONBOOTSTRAP_H_
+
+#include <hydra/detail/Config.h>
+#include <hydra/Types.h>
+#include <hydra/detail/external/hydra_thrust/random.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Poisson(1) weight of an event in a bootstrap replica. Each replica has its
+ * own stream, and the weight of an event is drawn from the position 'event'
+ * of it, so it depends only on the seed, the replica and the event.
+ * RNG needs a discard() of constant complexity (counter based engines).
+ */
+template<typename RNG>
+struct PoissonBootstrapWeight
+{
+	PoissonBootstrapWeight(size_t seed):
+		fSeed(seed)
+	{}
+
+	__hydra_host__ __hydra_device__
+	PoissonBootstrapWeight(PoissonBootstrapWeight<RNG> const& other):
+		fSeed(other.fSeed)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline unsigned operator()(size_t event, size_t replica) const
+	{
+		RNG engine(fSeed + replica*0x9e3779b97f4a7c15);
+		engine.discard(event);
+
+		hydra_thrust::uniform_real_distribution<GReal_t> uniform(0.0, 1.0);
+
+		GReal_t u = uniform(engine);
+
+		//inversion of the cumulative distribution, P(k) = e^{-1}/k!
+		GReal_t p = 0.36787944117144233;
+		GReal_t cdf = p;
+		unsigned k = 0;
+
+		while( u > cdf && k < 20 ){
+			++k;
+			p   /= k;
+			cdf += p;
+		}
+
+		return k;
+	}
+
+	size_t fSeed;
+};
+
+/*
+ * Accumulates a block of contiguous events into the sums of all replicas.
+ * The sums of block b start at b*nreplicas*nslots, the ones of replica r
+ * of that block at r*nslots.
+ */
+template<typename RNG, typename Iterator, typename Accumulator>
+struct PoissonBootstrapBlock
+{
+	typedef typename hydra_thrust::iterator_traits<Iterator>::value_type value_type;
+
+	PoissonBootstrapBlock(Iterator first, size_t nevents, size_t block_size,
+			size_t nreplicas, size_t nslots, size_t seed,
+			GReal_t* sums, Accumulator const& accumulator):
+		fFirst(first),
+		fNEvents(nevents),
+		fBlockSize(block_size),
+		fNReplicas(nreplicas),
+		fNSlots(nslots),
+		fWeight(seed),
+		fSums(sums),
+		fAccumulator(accumulator)
+	{}
+
+	__hydra_host__ __hydra_device__
+	PoissonBootstrapBlock(PoissonBootstrapBlock<RNG, Iterator, Accumulator> const& other):
+		fFirst(other.fFirst),
+		fNEvents(other.fNEvents),
+		fBlockSize(other.fBlockSize),
+		fNReplicas(other.fNReplicas),
+		fNSlots(other.fNSlots),
+		fWeight(other.fWeight),
+		fSums(other.fSums),
+		fAccumulator(other.fAccumulator)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline void operator()(size_t block) const
+	{
+		GReal_t* sums = fSums + block*fNReplicas*fNSlots;
+
+		for(size_t i=0; i<fNReplicas*fNSlots; i++) sums[i]=0.0;
+
+		size_t first = block*fBlockSize;
+		size_t last  = first + fBlockSize < fNEvents ? first + fBlockSize : fNEvents;
+
+		for(size_t event=first; event<last; event++){
+
+			value_type x = fFirst[event];
+
+			for(size_t replica=0; replica<fNReplicas; replica++){
+
+				unsigned weight = fWeight(event, replica);
+
+				if( weight > 0 )
+					fAccumulator(x, GReal_t(weight), sums + replica*fNSlots);
+			}
+		}
+	}
+
+	Iterator fFirst;
+	size_t fNEvents;
+	size_t fBlockSize;
+	size_t fNReplicas;
+	size_t fNSlots;
+	PoissonBootstrapWeight<RNG> fWeight;
+	GReal_t* fSums;
+	Accumulator fAccumulator;
+};
+
+/*
+ * Sum over the blocks of the element i of the replica sums.
+ */
+struct SumPoissonBootstrapBlocks
+{
+	SumPoissonBootstrapBlocks(GReal_t const* sums, size_t nblocks, size_t stride):
+		fSums(sums),
+		fNBlocks(nblocks),
+		fStride(stride)
+	{}
+
+	__hydra_host__ __hydra_device__
+	SumPoissonBootstrapBlocks(SumPoissonBootstrapBlocks const& other):
+		fSums(other.fSums),
+		fNBlocks(other.fNBlocks),
+		fStride(other.fStride)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline GReal_t operator()(size_t i) const
+	{
+		GReal_t result = 0.0;
+
+		for(size_t block=0; block<fNBlocks; block++)
+			result += fSums[block*fStride + i];
+
+		return result;
+	}
+
+	GReal_t const* fSums;
+	size_t fNBlocks;
+	size_t fStride;
+};
+
+/*
+ * Accumulators. Each one adds the contribution of an event with
+ * weight w to the sums of a replica.
+ */
+
+//sum of w*f(x) and sum of w
+template<typename Functor>
+struct BootstrapMeanAccumulator
+{
+	BootstrapMeanAccumulator(Functor const& functor):
+		fFunctor(functor)
+	{}
+
+	__hydra_host__ __hydra_device__
+	BootstrapMeanAccumulator(BootstrapMeanAccumulator<Functor> const& other):
+		fFunctor(other.fFunctor)
+	{}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline void operator()(T& x, GReal_t weight, GReal_t* sums) const
+	{
+		sums[0] += weight*fFunctor(x);
+		sums[1] += weight;
+	}
+
+	Functor fFunctor;
+};
+
+//sum of w in the bin of f(x)
+template<typename Functor>
+struct BootstrapHistogramAccumulator
+{
+	BootstrapHistogramAccumulator(Functor const& functor, size_t nbins, GReal_t min, GReal_t max):
+		fFunctor(functor),
+		fNBins(nbins),
+		fMin(min),
+		fMax(max)
+	{}
+
+	__hydra_host__ __hydra_device__
+	BootstrapHistogramAccumulator(BootstrapHistogramAccumulator<Functor> const& other):
+		fFunctor(other.fFunctor),
+		fNBins(other.fNBins),
+		fMin(other.fMin),
+		fMax(other.fMax)
+	{}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline void operator()(T& x, GReal_t weight, GReal_t* sums) const
+	{
+		GReal_t value = fFunctor(x);
+
+		if( !(value >= fMin && value < fMax) ) return;
+
+		size_t bin = size_t( fNBins*(value - fMin)/(fMax - fMin) );
+
+		sums[bin < fNBins ? bin : fNBins - 1] += weight;
+	}
+
+	Functor fFunctor;
+	size_t  fNBins;
+	GReal_t fMin;
+	GReal_t fMax;
+};
+
+//sum of w*log(pdf(x)) and sum of w
+template<typename Functor>
+struct BootstrapLogLikelihoodAccumulator
+{
+	BootstrapLogLikelihoodAccumulator(Functor const& functor):
+		fFunctor(functor),
+		fNorm(functor.GetNorm())
+	{}
+
+	__hydra_host__ __hydra_device__
+	BootstrapLogLikelihoodAccumulator(BootstrapLogLikelihoodAccumulator<Functor> const& other):
+		fFunctor(other.fFunctor),
+		fNorm(other.fNorm)
+	{}
+
+	template<typename T>
+	__hydra_host__ __hydra_device__
+	inline void operator()(T& x, GReal_t weight, GReal_t* sums) const
+	{
+		sums[0] += weight*::log(fNorm*fFunctor(x));
+		sums[1] += weight;
+	}
+
+	Functor fFunctor;
+	GReal_t fNorm;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* POISSONBOOTSTRAP_H_ */
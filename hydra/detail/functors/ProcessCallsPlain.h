@@ -38,6 +38,7 @@
 #include <hydra/detail/Config.h>
 #include <hydra/Types.h>
 #include <hydra/PlainState.h>
+#include <hydra/ScrambledSobol.h>
 #include <hydra/detail/external/hydra_thrust/functional.h>
 #include <hydra/detail/external/hydra_thrust/extrema.h>
 #include <hydra/detail/utility/Utility_Tuple.h>
@@ -114,6 +115,57 @@ struct ProcessCallsPlainUnary
 
 
 
+// ProcessCallsPlainQMC is the quasi-random counterpart of ProcessCallsPlainUnary:
+// the point \p index is taken from a randomized Sobol sequence.
+template <typename FUNCTOR, size_t N>
+struct ProcessCallsPlainQMC
+{
+
+	ProcessCallsPlainQMC(GReal_t* XLow, GReal_t  *DeltaX, ScrambledSobol<N> const& points,
+			FUNCTOR const& functor):
+		fPoints(points),
+		fXLow(XLow),
+		fDeltaX(DeltaX),
+		fFunctor(functor)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	ProcessCallsPlainQMC( ProcessCallsPlainQMC<FUNCTOR,N> const& other):
+	fPoints(other.fPoints),
+	fXLow(other.fXLow),
+	fDeltaX(other.fDeltaX),
+	fFunctor(other.fFunctor)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	PlainState operator()(size_t index)
+	 {
+		GReal_t x[N];
+
+		fPoints(index, x);
+
+		for (size_t j = 0; j < N; j++)
+			x[j] = fXLow[j] + x[j]*fDeltaX[j];
+
+		GReal_t fval = fFunctor( detail::arrayToTuple<GReal_t, N>(x));
+
+		PlainState result;
+		result.fN    = 1;
+		result.fMin  = fval;
+		result.fMax  = fval;
+		result.fMean = fval;
+		result.fM2   = 0;
+
+		return result;
+	}
+
+	ScrambledSobol<N> fPoints;
+	FUNCTOR fFunctor;
+	GReal_t* __restrict__ fXLow;
+	GReal_t* __restrict__ fDeltaX;
+};
+
+
 // ProcessCallsPlainBinary is a functor that accepts two PlainState
 // structs and returns a new summary_stats_data which are an
 // approximation to the summary_stats for
@@ -42,6 +42,16 @@
 #include <hydra/detail/external/hydra_thrust/functional.h>
 #include <hydra/detail/external/hydra_thrust/random.h>
 #include <hydra/VegasState.h>
+#include <hydra/ScrambledSobol.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/external/hydra_thrust/sort.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/fill.h>
+#include <hydra/detail/external/hydra_thrust/scatter.h>
+#include <hydra/detail/external/hydra_thrust/copy.h>
+#include <hydra/detail/external/hydra_thrust/distance.h>
+
+#include <vector>
 
 
 namespace hydra{
@@ -70,6 +80,8 @@ struct ProcessBoxesVegas
 
         GReal_t n  = x.fN + y.fN;
 
+        if( n == 0 ) return x;
+
         GReal_t delta  = y.fMean - x.fMean;
         GReal_t delta2 = delta  * delta;
 
@@ -105,7 +117,8 @@ IteratorBackendReal,  IteratorBackendUInt, GRND>
 public :
 
 	ProcessCallsVegas( size_t NBoxes, state_t& fState,	IteratorBackendUInt begin_bins,
-			IteratorBackendReal begin_real,  FUNCTOR const& functor):
+			IteratorBackendReal begin_real,  FUNCTOR const& functor,
+			ScrambledSobol<NDimensions> const& points=ScrambledSobol<NDimensions>(), size_t first_point=0):
 				fNBoxes( NBoxes ),
 				fSeed(fState.GetItNum()),
 				fNBins(fState.GetNBins()),
@@ -117,7 +130,9 @@ public :
 				fDeltaX( fState.GetBackendDeltaX().begin() ),
 				fGlobalBin( begin_bins ),
 				fFVals( begin_real ),
-				fFunctor(functor)
+				fFunctor(functor),
+				fPoints(points),
+				fFirstPoint(first_point)
 				{}
 
 	__hydra_host__ __hydra_device__
@@ -133,7 +148,9 @@ public :
 	fDeltaX(other.fDeltaX),
 	fGlobalBin(other.fGlobalBin),
 	fFVals(other.fFVals),
-	fFunctor(other.fFunctor)
+	fFunctor(other.fFunctor),
+	fPoints(other.fPoints),
+	fFirstPoint(other.fFirstPoint)
 	{}
 
 
@@ -172,13 +189,20 @@ public :
 
 		size_t box = index/fNCallsPerBox;
 
-		GRND randEng( hash(fSeed,index) );
-		//randEng.discard(index);
-		hydra_thrust::uniform_real_distribution<GReal_t> uniDist(0.0, 1.0);
+		//each replica samples the sequence from its beginning
+		if( fPoints.IsEnabled() ) fPoints(index - fFirstPoint, x);
+		else {
+
+			GRND randEng( hash(fSeed,index) );
+			//randEng.discard(index);
+			hydra_thrust::uniform_real_distribution<GReal_t> uniDist(0.0, 1.0);
+
+			for (size_t j = 0; j < NDimensions; j++)
+				x[j] = uniDist(randEng);
+		}
 
 		for (size_t j = 0; j < NDimensions; j++)
 		{
-			x[j] = uniDist(randEng);
 
 			GInt_t b = fNBoxesPerDimension > 1? GetBoxCoordinate(box, NDimensions, fNBoxesPerDimension, j):box;
 
@@ -214,18 +238,29 @@ public :
 	{ return bin * NDimensions + dim; }
 
 
+	/*
+	 * Samples the point \p index and returns the weighted function value,
+	 * storing the grid bin of each coordinate in \p bin.
+	 */
 	__hydra_host__ __hydra_device__ inline
-	ResultVegas operator()( size_t index)
+	GReal_t evaluate( size_t index, GInt_t (&bin)[NDimensions])
 	{
-
 		GReal_t volume = 1.0;
 		GReal_t x[NDimensions];
-		GInt_t bin[NDimensions];
-		ResultVegas result;
 
 		get_point( index, volume, bin, x );
 
-		GReal_t fval = fJacobian*volume*fFunctor( detail::arrayToTuple<GReal_t, NDimensions>(x));
+		return fJacobian*volume*fFunctor( detail::arrayToTuple<GReal_t, NDimensions>(x));
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	ResultVegas operator()( size_t index)
+	{
+
+		GInt_t bin[NDimensions];
+		ResultVegas result;
+
+		GReal_t fval = evaluate( index, bin );
 
 		for (GUInt_t j = 0; j < NDimensions; j++)
 		{
@@ -259,11 +294,110 @@ private:
 	IteratorBackendReal  fDeltaX;
 
 	FUNCTOR fFunctor;
+	ScrambledSobol<NDimensions> fPoints;
+	size_t fFirstPoint;
 
+};
 
+/*
+ * Processes a contiguous chunk of the calls [first_call, first_call + ncalls)
+ * per slot, accumulating the grid distribution of the chunk in the slot's
+ * private copy instead of storing one (bin, value) pair per call and dimension.
+ */
+template<typename ProcessCalls, size_t NDimensions>
+struct ProcessSlotsVegas
+{
+	ProcessSlotsVegas(ProcessCalls const& process_calls, size_t first_call, size_t ncalls,
+			size_t nslots, size_t nkeys, GReal_t* distribution):
+		fProcessCalls(process_calls),
+		fFirstCall(first_call),
+		fNCalls(ncalls),
+		fNSlots(nslots),
+		fNKeys(nkeys),
+		fDistribution(distribution)
+	{}
+
+	__hydra_host__ __hydra_device__
+	ProcessSlotsVegas( ProcessSlotsVegas<ProcessCalls, NDimensions> const& other):
+		fProcessCalls(other.fProcessCalls),
+		fFirstCall(other.fFirstCall),
+		fNCalls(other.fNCalls),
+		fNSlots(other.fNSlots),
+		fNKeys(other.fNKeys),
+		fDistribution(other.fDistribution)
+	{}
 
+	__hydra_host__ __hydra_device__ inline
+	ResultVegas operator()( size_t slot)
+	{
+		size_t chunk = (fNCalls + fNSlots - 1)/fNSlots;
+		size_t first = slot*chunk < fNCalls ? fFirstCall + slot*chunk : fFirstCall + fNCalls;
+		size_t last  = (first + chunk) < fFirstCall + fNCalls ? first + chunk : fFirstCall + fNCalls;
+
+		GReal_t* distribution = fDistribution + slot*fNKeys;
+
+		ResultVegas result = ResultVegas();
+
+		for(size_t index=first; index<last; index++){
+
+			GInt_t bin[NDimensions];
+
+			GReal_t fval = fProcessCalls.evaluate(index, bin);
+
+			for (GUInt_t j = 0; j < NDimensions; j++)
+				distribution[ fProcessCalls.GetDistributionKey(bin[j], j) ] += fval*fval;
+
+			ResultVegas call;
+			call.fN    = 1.0;
+			call.fMean = fval;
+			call.fM2   = 0.0;
+
+			result = ProcessBoxesVegas()(result, call);
+		}
+
+		return result;
+	}
+
+	ProcessCalls fProcessCalls;
+	size_t   fFirstCall;
+	size_t   fNCalls;
+	size_t   fNSlots;
+	size_t   fNKeys;
+	GReal_t* fDistribution;
 };
 
+/*
+ * Sort based accumulation of the grid distribution, for the back-ends
+ * without private copies: the values stored by ProcessCallsVegas, one per
+ * call and dimension, are summed by distribution key on the back-end and
+ * scattered to a zeroed buffer, which is copied to \p distribution at once.
+ * The input keys and values are reordered, the output ones are scratch.
+ */
+template<typename System, typename KeyIterator, typename ValueIterator>
+inline void reduce_vegas_distribution(System const& system,
+		KeyIterator keys, KeyIterator keys_end, ValueIterator values,
+		KeyIterator keys_output, ValueIterator values_output,
+		std::vector<GReal_t>& distribution)
+{
+	hydra_thrust::sort_by_key(system, keys, keys_end, values);
+
+	auto end_iterators = hydra_thrust::reduce_by_key(system, keys, keys_end, values,
+			keys_output, values_output);
+
+	//bins without calls are not in the output, so the values are stored by key
+	size_t nreduced = hydra_thrust::distance(keys_output, end_iterators.first);
+
+	auto buffer = hydra::detail::get_temporary_buffer<GReal_t>(system, distribution.size());
+
+	hydra_thrust::fill(system, buffer.first, buffer.first + distribution.size(), 0.0);
+
+	hydra_thrust::scatter(system, values_output, values_output + nreduced, keys_output, buffer.first);
+
+	hydra_thrust::copy(buffer.first, buffer.first + distribution.size(), distribution.begin());
+
+	hydra::detail::return_temporary_buffer(system, buffer.first);
+}
+
 }// namespace detail
 
 }// namespace hydra
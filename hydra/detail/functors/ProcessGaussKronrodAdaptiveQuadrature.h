@@ -31,59 +31,158 @@
 
 #include <hydra/detail/Config.h>
 #include <hydra/Types.h>
+#include <hydra/GaussKronrodRule.h>
+#include <hydra/detail/external/hydra_thrust/tuple.h>
 
 namespace hydra {
 
+/*
+ * Integrands of the adaptive quadrature: a single functor, or
+ * an array of functors, one per integral, in the back-end memory.
+ */
+template <typename FUNCTOR>
+struct GaussKronrodIntegrand
+{
+	GaussKronrodIntegrand(FUNCTOR const& functor):
+		fFunctor(functor)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	GaussKronrodIntegrand(GaussKronrodIntegrand<FUNCTOR> const& other ):
+		fFunctor(other.fFunctor)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(GUInt_t, GReal_t x) const
+	{
+		return fFunctor(x);
+	}
+
+	FUNCTOR fFunctor;
+};
 
 template <typename FUNCTOR>
+struct GaussKronrodIntegrandArray
+{
+	GaussKronrodIntegrandArray(FUNCTOR const* functors):
+		fFunctors(functors)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	GaussKronrodIntegrandArray(GaussKronrodIntegrandArray<FUNCTOR> const& other ):
+		fFunctors(other.fFunctors)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	GReal_t operator()(GUInt_t integral, GReal_t x) const
+	{
+		return fFunctors[integral](x);
+	}
+
+	FUNCTOR const* fFunctors;
+};
+
+/*
+ * Evaluates the call 'index' of the Gauss-Kronrod rule applied to the
+ * sub-interval index/ncalls. The limits of the sub-intervals are stored in
+ * 'limits' as (lower, upper) pairs and 'integrals' holds, for each sub-interval,
+ * the index of the integral it belongs to. Returns the contributions to the
+ * Gauss and Kronrod estimates.
+ */
+template <typename INTEGRAND, size_t NRULE>
 struct ProcessGaussKronrodAdaptiveQuadrature
 {
-	typedef hydra_thrust::tuple<GUInt_t, double, double> result_row_t;
+	typedef hydra_thrust::tuple<double, double> result_row_t;
+
+	constexpr static size_t ncalls = (NRULE+1)/2;
 
 	ProcessGaussKronrodAdaptiveQuadrature()=delete;
 
-	ProcessGaussKronrodAdaptiveQuadrature(FUNCTOR functor):
-		fFunctor(functor)
+	ProcessGaussKronrodAdaptiveQuadrature(INTEGRAND const& integrand, GUInt_t const* integrals,
+			GReal_t const* limits, GaussKronrodRule<NRULE> const& rule):
+		fIntegrand(integrand),
+		fIntegrals(integrals),
+		fLimits(limits),
+		fRule(rule)
 	{}
 
 	__hydra_host__ __hydra_device__ inline
-	ProcessGaussKronrodAdaptiveQuadrature(ProcessGaussKronrodAdaptiveQuadrature<FUNCTOR> const& other ):
-	fFunctor(other.fFunctor)
+	ProcessGaussKronrodAdaptiveQuadrature(ProcessGaussKronrodAdaptiveQuadrature<INTEGRAND, NRULE> const& other ):
+		fIntegrand(other.fIntegrand),
+		fIntegrals(other.fIntegrals),
+		fLimits(other.fLimits),
+		fRule(other.fRule)
 	{}
 
 	__hydra_host__ __hydra_device__ inline
 	ProcessGaussKronrodAdaptiveQuadrature&
-	operator=(ProcessGaussKronrodAdaptiveQuadrature<FUNCTOR> const& other )
+	operator=(ProcessGaussKronrodAdaptiveQuadrature<INTEGRAND, NRULE> const& other )
 	{
 		if( this== &other) return *this;
 
-		fFunctor=other.fFunctor;
+		fIntegrand = other.fIntegrand;
+		fIntegrals = other.fIntegrals;
+		fLimits    = other.fLimits;
+		fRule      = other.fRule;
+
 		return *this;
 	}
 
-	template<typename T>
 	__hydra_host__ __hydra_device__ inline
-	result_row_t operator()(T row)
+	result_row_t operator()(size_t index) const
 	{
-		GUInt_t bin                      = hydra_thrust::get<0>(row);
-		GReal_t abscissa_X_P             = hydra_thrust::get<1>(row);
-		GReal_t abscissa_X_M             = hydra_thrust::get<2>(row);
-		GReal_t abscissa_Weight          = hydra_thrust::get<3>(row);
-		GReal_t rule_GaussKronrod_Weight = hydra_thrust::get<4>(row);
-		GReal_t rule_Gauss_Weight        = hydra_thrust::get<5>(row);
-
-	//	GaussKronrodCall result;
-
-		GReal_t function_call    = abscissa_Weight*(fFunctor(abscissa_X_P)
-				+ fFunctor(abscissa_X_M) ) ;
-		GReal_t fGaussCall        = function_call*rule_Gauss_Weight;
-		GReal_t fGaussKronrodCall = function_call*rule_GaussKronrod_Weight;
-
-		//printf("%d %f %f\n", bin, fGaussCall, fGaussKronrodCall);
-		return result_row_t(bin, fGaussCall, fGaussKronrodCall);
+		size_t node = index/ncalls;
+		size_t call = index%ncalls;
+
+		GReal_t abscissa_X_P    = 0;
+		GReal_t abscissa_X_M    = 0;
+		GReal_t abscissa_Weight = 0;
+
+		hydra_thrust::tie(abscissa_X_P, abscissa_X_M, abscissa_Weight)
+			= fRule.GetAbscissa(call, fLimits[2*node], fLimits[2*node+1]);
+
+		GUInt_t integral = fIntegrals[node];
+
+		GReal_t function_call = abscissa_Weight*(fIntegrand(integral, abscissa_X_P)
+				+ fIntegrand(integral, abscissa_X_M));
+
+		return result_row_t(function_call*fRule.GaussWeight[call],
+				function_call*fRule.KronrodWeight[call]);
 	}
 
-	FUNCTOR fFunctor;
+	INTEGRAND fIntegrand;
+	GUInt_t const* fIntegrals;
+	GReal_t const* fLimits;
+	GaussKronrodRule<NRULE> fRule;
+};
+
+/*
+ * Index of the sub-interval of a rule call.
+ */
+template <size_t NRULE>
+struct GaussKronrodCallToNode
+{
+	__hydra_host__ __hydra_device__ inline
+	size_t operator()(size_t index) const
+	{
+		return index/((NRULE+1)/2);
+	}
+};
+
+/*
+ * Sums the Gauss and Kronrod contributions of the calls of a sub-interval.
+ */
+struct AddGaussKronrodCalls
+{
+	__hydra_host__ __hydra_device__ inline
+	hydra_thrust::tuple<double, double>
+	operator()(hydra_thrust::tuple<double, double> const& a,
+			hydra_thrust::tuple<double, double> const& b) const
+	{
+		return hydra_thrust::tuple<double, double>(
+				hydra_thrust::get<0>(a) + hydra_thrust::get<0>(b),
+				hydra_thrust::get<1>(a) + hydra_thrust::get<1>(b));
+	}
 };
 
 
@@ -338,6 +338,54 @@ struct ProcessGenzMalikBox
 };
 
 
+/*
+ * Divides the box first + index along its cut axis, keeping the lower half in place
+ * and writing the upper half to first + nboxes + index.
+ */
+template <size_t N>
+struct SplitGenzMalikBox
+{
+	SplitGenzMalikBox(GenzMalikBox<N>* first, size_t nboxes):
+		fFirst(first),
+		fNBoxes(nboxes)
+	{}
+
+	__hydra_host__ __hydra_device__
+	SplitGenzMalikBox(SplitGenzMalikBox<N> const& other ):
+		fFirst(other.fFirst),
+		fNBoxes(other.fNBoxes)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline void operator()(size_t index) const
+	{
+		GenzMalikBox<N>& box = fFirst[index];
+
+		int axis = box.GetCutAxis();
+
+		GReal_t middle = 0.5*(box.GetUpperLimit(axis) - box.GetLowerLimit(axis)) + box.GetLowerLimit(axis);
+
+		GenzMalikBox<N> upper_box(box);
+
+		upper_box.SetLowerLimit(axis, middle);
+		upper_box.SetCutAxis(-1);
+		upper_box.SetError(0.0);
+		upper_box.SetErrorSq(0.0);
+		upper_box.SetIntegral(0.0);
+
+		box.SetUpperLimit(axis, middle);
+		box.SetCutAxis(-1);
+		box.SetError(0.0);
+		box.SetErrorSq(0.0);
+		box.SetIntegral(0.0);
+
+		fFirst[fNBoxes + index] = upper_box;
+	}
+
+	GenzMalikBox<N>* fFirst;
+	size_t fNBoxes;
+};
+
 //-----------------------------------------------------
 //
 //
@@ -216,6 +216,128 @@ struct SWeights
 	cmatrix_t  fICovMatrix;
 };
 
+/*
+ * Fused covariance pass: evaluates the components once per event, stores
+ * their values in the columns (the column of the i-th component starts at
+ * i*nentries) and returns the contribution of the event to the matrix.
+ * The argument is a tuple (index, event).
+ */
+template<typename F1, typename F2, typename ...Fs >
+struct CovMatrixStore
+{
+	typedef hydra::tuple<F1, F2, Fs...> functors_tuple_type;
+	constexpr static size_t nfunctors = sizeof...(Fs)+2;
+	typedef Eigen::Matrix<double, nfunctors, nfunctors> cmatrix_t;
+
+	CovMatrixStore( Parameter(&coeficients)[nfunctors], functors_tuple_type const& functors,
+			GReal_t* columns, size_t nentries ):
+		fFunctors(functors),
+		fColumns(columns),
+		fNEntries(nentries)
+	{
+		for(size_t i=0;i<nfunctors; i++)
+				fCoefficients[i] = coeficients[i].GetValue();
+	}
+
+	__hydra_host__ __hydra_device__
+	CovMatrixStore( CovMatrixStore<F1, F2, Fs...> const& other ):
+		fFunctors( other.fFunctors ),
+		fColumns( other.fColumns ),
+		fNEntries( other.fNEntries )
+	{
+		for(size_t i=0;i<nfunctors; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+	}
+
+	template<typename Type>
+	__hydra_host__ __hydra_device__ inline
+	cmatrix_t operator()(Type x)
+	{
+		size_t entry = hydra_thrust::get<0>(x);
+
+		auto fvalues  = detail::invoke_normalized(hydra_thrust::get<1>(x), fFunctors);
+		double values[nfunctors];
+		detail::tupleToArray(fvalues, values);
+
+		GReal_t denominator = 0;
+
+		for(size_t i=0; i<nfunctors; i++){
+
+			fColumns[i*fNEntries + entry] = values[i];
+			denominator += fCoefficients[i]*values[i];
+		}
+
+		denominator *= denominator;
+
+		cmatrix_t fCovMatrix;
+
+		for(size_t i=0; i<nfunctors; i++)
+			for(size_t j=0; j<nfunctors; j++)
+				fCovMatrix(i, j) = values[i]*values[j]/denominator;
+
+		return fCovMatrix;
+	}
+
+	GReal_t    fCoefficients[nfunctors];
+	functors_tuple_type fFunctors;
+	GReal_t*   fColumns;
+	size_t     fNEntries;
+};
+
+/*
+ * sWeights of all species of the event with the given index,
+ * from the component values stored by CovMatrixStore.
+ */
+template<size_t N>
+struct SWeightsColumns
+{
+	typedef Eigen::Matrix<double, N, N> cmatrix_t;
+	typedef typename hydra::detail::tuple_type<N, double>::type tuple_t;
+
+	SWeightsColumns(const  Parameter(&coeficients)[N], GReal_t const* columns, size_t nentries,
+			cmatrix_t icmatrix ):
+		fColumns(columns),
+		fNEntries(nentries),
+		fICovMatrix( icmatrix )
+	{
+		for(size_t i=0;i<N; i++)
+			fCoefficients[i] = coeficients[i].GetValue();
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	SWeightsColumns(SWeightsColumns<N> const& other ):
+		fColumns(other.fColumns),
+		fNEntries(other.fNEntries),
+		fICovMatrix( other.fICovMatrix )
+	{
+		for(size_t i=0;i<N; i++)
+			fCoefficients[i] = other.fCoefficients[i];
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	tuple_t operator()(size_t entry) const
+	{
+		Eigen::Matrix<double, N, 1> values_vector;
+		GReal_t denominator = 0.0;
+
+		for(size_t i=0; i<N; i++){
+
+			values_vector(i) = fColumns[i*fNEntries + entry];
+			denominator += fCoefficients[i]*values_vector(i);
+		}
+
+		Eigen::Matrix<double, N, 1> sweights(fICovMatrix*values_vector);
+		sweights /= denominator;
+
+		return detail::arrayToTuple<double, N>(sweights.data());
+	}
+
+	GReal_t const* fColumns;
+	size_t     fNEntries;
+	GReal_t    fCoefficients[N];
+	cmatrix_t  fICovMatrix;
+};
+
 }  // namespace detail
 
 }  // namespace hydra
@@ -165,6 +165,34 @@ public:
 		return result;
 	}
 
+	/*
+	 * Writes the next last-first numbers of the sequence, leaving the engine
+	 * as the same number of calls to operator() would. Whole counter blocks
+	 * are written directly, without going through the cache.
+	 */
+	__hydra_host__ __hydra_device__
+	inline void generate(result_type* first, result_type* last)
+	{
+		//numbers left in the cache
+		while( fTrigger < arity && first != last )
+			*first++ = fCache[fTrigger++];
+
+		const size_t nblocks = (last - first)/arity;
+
+		for(size_t i=0; i<nblocks; ++i){
+
+			state_type block = fEngine(fState.incr(), fSeed);
+
+			for(unsigned j=0; j<arity; ++j)
+				first[i*arity + j] = block[j];
+		}
+
+		first += nblocks*arity;
+
+		while( first != last )
+			*first++ = this->operator()();
+	}
+
 	__hydra_host__ __hydra_device__
 	inline void discard( advance_type n){
 
@@ -232,6 +260,20 @@ private:
 	trigger_type fTrigger;
 };
 
+}  // namespace random
+
+namespace detail {
+
+template<typename Engine>
+struct block_traits< hydra::random::EngineR123<Engine> >
+{
+	enum{ supported=1, stride=hydra::random::EngineR123<Engine>::arity };
+};
+
+}  // namespace detail
+
+namespace random {
+
 #if R123_USE_AES_NI
 typedef EngineR123<hydra_r123::ARS4x32>           ars;
 #else
@@ -32,6 +32,7 @@
 
 
 #include <hydra/detail/Config.h>
+#include <hydra/detail/RandomTraits.h>
 #include <stdint.h>
 #include <hydra/detail/random/detail/squares_key.h>
 
@@ -104,18 +105,25 @@ public:
 	__hydra_host__ __hydra_device__
 	inline result_type operator()(void)
 	{
-		uint64_t x, y, z;
-
-		y = x = fSeed*fState ; z = y + fSeed;
-
-		x = x*x + y; x = (x>>32) | (x<<32);       /* round 1 */
-
-		x = x*x + z; x = (x>>32) | (x<<32);       /* round 2 */
+		return draw(fSeed, fState++);
+	}
 
-		++fState;                                 /* advance state */
+	/*
+	 * Writes the next last-first numbers of the sequence, leaving the engine
+	 * as the same number of calls to operator() would. The counters are
+	 * independent, so the loop is vectorized by the compiler.
+	 */
+	__hydra_host__ __hydra_device__
+	inline void generate(result_type* first, result_type* last)
+	{
+		const seed_type  seed  = fSeed;
+		const state_type state = fState;
+		const state_type n     = last - first;
 
-		return (x*x + y) >> 32;                   /* round 3 */
+		for(state_type i=0; i<n; ++i)
+			first[i] = draw(seed, state + i);
 
+		fState += n;
 	}
 
 	__hydra_host__ __hydra_device__
@@ -154,12 +162,36 @@ public:
 
 private:
 
+	__hydra_host__ __hydra_device__
+	static inline result_type draw(seed_type seed, state_type ctr)
+	{
+		uint64_t x, y, z;
+
+		y = x = seed*ctr ; z = y + seed;
+
+		x = x*x + y; x = (x>>32) | (x<<32);       /* round 1 */
+
+		x = x*x + z; x = (x>>32) | (x<<32);       /* round 2 */
+
+		return (x*x + y) >> 32;                   /* round 3 */
+	}
+
 	state_type fState;
 	seed_type   fSeed;
 };
 
 }  // namespace random
 
+namespace detail {
+
+template<>
+struct block_traits<hydra::random::squares3>
+{
+	enum{ supported=1, stride=1 };
+};
+
+}  // namespace detail
+
 }  // namespace hydra
 
 
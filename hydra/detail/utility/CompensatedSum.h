@@ -0,0 +1,93 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * CompensatedSum.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef COMPENSATEDSUM_H_
+#define COMPENSATEDSUM_H_
+
+#include <hydra/detail/Config.h>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Running sum carrying the rounding error of the additions (Kahan-Babuska-Neumaier).
+ * Each addition recovers its exact error with Knuth's two-sum, so the order of the
+ * operands does not matter and partial sums can be combined in any tree, as
+ * parallel reductions do. The result is as accurate as a sum done in twice the
+ * precision of T. Compiling with -ffast-math (or --use_fast_math) allows the
+ * compiler to drop the correction.
+ */
+template<typename T>
+struct CompensatedSum
+{
+	__hydra_host__ __hydra_device__ inline
+	CompensatedSum():
+		fSum(0),
+		fCorrection(0)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	CompensatedSum(T value):
+		fSum(value),
+		fCorrection(0)
+	{}
+
+	__hydra_host__ __hydra_device__ inline
+	CompensatedSum<T>& operator+=( CompensatedSum<T> const& other)
+	{
+		T sum   = fSum + other.fSum;
+		T other_part = sum - fSum;
+		T error = (fSum - (sum - other_part)) + (other.fSum - other_part);
+
+		fSum = sum;
+		fCorrection += error + other.fCorrection;
+
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	CompensatedSum<T> operator+( CompensatedSum<T> const& other) const
+	{
+		CompensatedSum<T> r(*this);
+
+		return r += other;
+	}
+
+	__hydra_host__ __hydra_device__ inline
+	T Sum() const { return fSum + fCorrection; }
+
+	T fSum;
+	T fCorrection;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* COMPENSATEDSUM_H_ */
@@ -0,0 +1,96 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * DataRange.h
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#ifndef DATARANGE_H_
+#define DATARANGE_H_
+
+#include <hydra/detail/Config.h>
+
+#include <memory>
+#include <utility>
+#include <typeinfo>
+#include <typeindex>
+
+namespace hydra {
+
+namespace detail {
+
+/*
+ * Remembers the last range [begin, end) given to a cache, whatever the type
+ * of its iterators, so the cache can tell when it is called on other data.
+ * Only the iterators are compared: changes to the content of the same range
+ * are not detected.
+ */
+class DataRange
+{
+
+public:
+
+	DataRange():
+		fRange(),
+		fType(typeid(void))
+	{}
+
+	/*
+	 * True if [begin, end) is not the range of the last call, which is replaced.
+	 */
+	template<typename Iterator>
+	inline bool Rebind(Iterator begin, Iterator end)
+	{
+		typedef std::pair<Iterator, Iterator> range_type;
+
+		if( fRange && fType == std::type_index(typeid(range_type)) ){
+
+			range_type const& range = *static_cast<range_type const*>(fRange.get());
+
+			if( range.first == begin && range.second == end ) return false;
+		}
+
+		fRange = std::make_shared<range_type>(begin, end);
+		fType  = std::type_index(typeid(range_type));
+
+		return true;
+	}
+
+	inline void Reset()
+	{
+		fRange.reset();
+		fType = std::type_index(typeid(void));
+	}
+
+private:
+
+	std::shared_ptr<void> fRange;
+	std::type_index fType;
+};
+
+}  // namespace detail
+
+}  // namespace hydra
+
+#endif /* DATARANGE_H_ */
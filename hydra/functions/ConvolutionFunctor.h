@@ -38,6 +38,7 @@
 #include <hydra/Range.h>
 #include <hydra/Spiline.h>
 #include <hydra/Convolution.h>
+#include <hydra/MemoryPool.h>
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
 #include <hydra/detail/FFTPolicy.h>
 #include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
@@ -158,6 +159,8 @@ class ConvolutionFunctor< Functor, Kernel, detail::BackendPolicy<BACKEND>,
 	typedef hydra_thrust::pointer<value_type, raw_host_system_type>      host_pointer_type;
 	typedef hydra_thrust::pointer<value_type, raw_device_system_type>  device_pointer_type;
 	typedef hydra_thrust::pointer<value_type, raw_fft_system_type>        fft_pointer_type;
+	typedef hydra_thrust::pointer<hydra::complex<value_type>, raw_fft_system_type> spectrum_pointer_type;
+	typedef hydra_thrust::pointer<size_t, raw_host_system_type>          key_pointer_type;
 
 	//iterator
 	typedef hydra_thrust::transform_iterator< detail::convolution::_delta<value_type>,
@@ -183,16 +186,21 @@ typedef typename detail::convolution::_traits<hydra_thrust::tuple<Functor, Kerne
 	{
 		//std::cout << ">>ConvolutionFunctor()"<<std::endl;
 
-		using hydra_thrust::get_temporary_buffer;
-
 		fXMin = abiscissae_type(hydra_thrust::counting_iterator<unsigned>(0),
 				        detail::convolution::_delta<value_type>(kmin, (kmax-kmin)/fNSamples) );
 		fXMax = fXMin + fNSamples;
 
-		fFFTData   = get_temporary_buffer<value_type>(raw_fft_system_type(), fNSamples).first;
-		fHostData  = get_temporary_buffer<value_type>(raw_host_system_type(), fNSamples).first;
+		fFFTData   = hydra::detail::get_temporary_buffer<value_type>(raw_fft_system_type(), fNSamples).first;
+		fHostData  = hydra::detail::get_temporary_buffer<value_type>(raw_host_system_type(), fNSamples).first;
+
+		fDeviceData= hydra::detail::get_temporary_buffer<value_type>(raw_device_system_type(), fNSamples).first;
 
-		fDeviceData= get_temporary_buffer<value_type>(raw_device_system_type(), fNSamples).first;
+		fFunctorSpectrum = hydra::detail::get_temporary_buffer<hydra::complex<value_type>>(raw_fft_system_type(), fNSamples+1).first;
+		fKernelSpectrum  = hydra::detail::get_temporary_buffer<hydra::complex<value_type>>(raw_fft_system_type(), fNSamples+1).first;
+
+		//parameter keys of the functor and kernel held in the spectra, shared by the copies
+		fSpectraKeys = hydra::detail::get_temporary_buffer<size_t>(raw_host_system_type(), 3).first;
+		fSpectraKeys[2] = 0;
 
 
 		Update();
@@ -211,7 +219,10 @@ typedef typename detail::convolution::_traits<hydra_thrust::tuple<Functor, Kerne
 	fInterpolate(other.IsInterpolated()),
 	fDeviceData(other.GetDeviceData()),
 	fHostData(other.GetHostData()),
-	fFFTData(other.GetFFTData())
+	fFFTData(other.GetFFTData()),
+	fFunctorSpectrum(other.GetFunctorSpectrum()),
+	fKernelSpectrum(other.GetKernelSpectrum()),
+	fSpectraKeys(other.GetSpectraKeys())
 	{}
 
 	__hydra_host__ __hydra_device__
@@ -230,6 +241,9 @@ typedef typename detail::convolution::_traits<hydra_thrust::tuple<Functor, Kerne
 		fDeviceData  = other.GetDeviceData();
 		fHostData    = other.GetHostData();
 		fFFTData     = other.GetFFTData();
+		fFunctorSpectrum = other.GetFunctorSpectrum();
+		fKernelSpectrum  = other.GetKernelSpectrum();
+		fSpectraKeys     = other.GetSpectraKeys();
 
 		return *this;
 	}
@@ -258,22 +272,50 @@ typedef typename detail::convolution::_traits<hydra_thrust::tuple<Functor, Kerne
 
 
 
+	/*
+	 * Only the spectrum of the functor or kernel whose parameters changed
+	 * since the last call is sampled and transformed again.
+	 */
 	virtual void Update() override
 	{
+		Functor functor = hydra_thrust::get<0>(this->GetFunctors());
+		Kernel  kernel  = hydra_thrust::get<1>(this->GetFunctors());
 
-		//std::cout << ">>Update()"<<std::endl;
+		size_t functor_key = functor.GetParametersKey();
+		size_t kernel_key  = kernel.GetParametersKey();
 
-		auto data = make_range(fFFTData, fFFTData + fNSamples );
+		bool valid = fSpectraKeys[2] != 0;
 
-		hydra::convolute(fft_system_type(), fft_type(),
-				hydra_thrust::get<0>(this->GetFunctors()),
-				hydra_thrust::get<1>(this->GetFunctors()),
-				fMin, fMax, data, false);
+		if( valid && functor_key == fSpectraKeys[0] && kernel_key == fSpectraKeys[1] ) return;
 
-		sync_data<FFT>();
+		value_type delta = (fMax - fMin)/fNSamples;
+
+		if( !valid || kernel_key != fSpectraKeys[1] ){
+
+			detail::convolution::forward_transform(fft_system_type(), fft_type(),
+					detail::convolution::KernelSampler<Kernel>(kernel, fNSamples, delta),
+					fNSamples, fKernelSpectrum);
+
+			fSpectraKeys[1] = kernel_key;
+		}
+
+		if( !valid || functor_key != fSpectraKeys[0] ){
+
+			detail::convolution::forward_transform(fft_system_type(), fft_type(),
+					detail::convolution::FunctorSampler<Functor>(functor, fNSamples, fMin, delta),
+					fNSamples, fFunctorSpectrum);
+
+			fSpectraKeys[0] = functor_key;
+		}
 
-		//std::cout << "<< Update()"<<std::endl;
+		fSpectraKeys[2] = 1;
 
+		auto data = make_range(fFFTData, fFFTData + fNSamples );
+
+		detail::convolution::inverse_transform(fft_system_type(), fft_type(),
+				fFunctorSpectrum, fKernelSpectrum, fNSamples, data);
+
+		sync_data<FFT>();
 	}
 
 
@@ -312,11 +354,13 @@ typedef typename detail::convolution::_traits<hydra_thrust::tuple<Functor, Kerne
 	}
 
 void Dispose(){
-		using hydra_thrust::return_temporary_buffer;
 
-		return_temporary_buffer(  device_system_type(), fDeviceData );
-		return_temporary_buffer(  host_system_type(),   fHostData );
-		return_temporary_buffer(  fft_system_type()  , fFFTData );
+		hydra::detail::return_temporary_buffer( raw_device_system_type(), fDeviceData );
+		hydra::detail::return_temporary_buffer( raw_host_system_type(),   fHostData );
+		hydra::detail::return_temporary_buffer( raw_fft_system_type()  ,  fFFTData );
+		hydra::detail::return_temporary_buffer( raw_fft_system_type()  ,  fFunctorSpectrum );
+		hydra::detail::return_temporary_buffer( raw_fft_system_type()  ,  fKernelSpectrum );
+		hydra::detail::return_temporary_buffer( raw_host_system_type() ,  fSpectraKeys );
 
 	}
 
@@ -342,6 +386,21 @@ void Dispose(){
 	const host_pointer_type& GetHostData() const {
 		return fHostData;
 	}
+
+	__hydra_host__ __hydra_device__
+	const spectrum_pointer_type& GetFunctorSpectrum() const {
+		return fFunctorSpectrum;
+	}
+
+	__hydra_host__ __hydra_device__
+	const spectrum_pointer_type& GetKernelSpectrum() const {
+		return fKernelSpectrum;
+	}
+
+	__hydra_host__ __hydra_device__
+	const key_pointer_type& GetSpectraKeys() const {
+		return fSpectraKeys;
+	}
 private:
 
 
@@ -370,6 +429,9 @@ private:
     device_pointer_type fDeviceData;
     host_pointer_type   fHostData;
     fft_pointer_type    fFFTData ;
+    spectrum_pointer_type fFunctorSpectrum;
+    spectrum_pointer_type fKernelSpectrum;
+    key_pointer_type      fSpectraKeys;
 
 
 };
@@ -97,8 +97,8 @@ public:
 		double abs_alpha = fabs(alpha);
 
 
-		double r = (t >= -abs_alpha) ? exp(-0.5*t*t):
-				pow(N/abs_alpha, N)*exp(-0.5*abs_alpha*abs_alpha)/pow(N/abs_alpha - abs_alpha- t, N);
+		double r = (t >= -abs_alpha) ? ::exp(-0.5*t*t):
+				::pow(N/abs_alpha, N)*::exp(-0.5*abs_alpha*abs_alpha)/::pow(N/abs_alpha - abs_alpha- t, N);
 
 		return CHECK_VALUE(r, "par[0]=%f, par[1]=%f, par[2]=%f, par[3]=%f", _par[0], _par[1], _par[2], _par[3]  );
 	}
@@ -155,27 +155,27 @@ private:
 			result += sig*sqrtPiOver2*(   erf(tmax/sqrt2) - erf(tmin/sqrt2) );
 		}
 		else if( tmax <= -absAlpha ) {
-			double a = pow(n/absAlpha,n)*exp(-0.5*absAlpha*absAlpha);
+			double a = ::pow(n/absAlpha,n)*::exp(-0.5*absAlpha*absAlpha);
 			double b = n/absAlpha - absAlpha;
 
 			if(useLog) {
-				result += a*sig*( log(b-tmin) - log(b-tmax) );
+				result += a*sig*( ::log(b-tmin) - ::log(b-tmax) );
 			}
 			else {
-				result += a*sig/(1.0-n)*(   1.0/(pow(b-tmin,n-1.0)) - 1.0/(pow(b-tmax,n-1.0)) );
+				result += a*sig/(1.0-n)*(   1.0/(::pow(b-tmin,n-1.0)) - 1.0/(::pow(b-tmax,n-1.0)) );
 			}
 		}
 		else {
 
-			double a = pow(n/absAlpha,n)*exp(-0.5*absAlpha*absAlpha);
+			double a = ::pow(n/absAlpha,n)*::exp(-0.5*absAlpha*absAlpha);
 			double b = n/absAlpha - absAlpha;
 
 			double term1 = 0.0;
 			if(useLog) {
-				term1 = a*sig*(  log(b-tmin) - log(n/absAlpha));
+				term1 = a*sig*(  ::log(b-tmin) - ::log(n/absAlpha));
 			}
 			else {
-				term1 = a*sig/(1.0-n)*( 1.0/(pow(b-tmin,n-1.0)) - 1.0/(pow(n/absAlpha,n-1.0)) );
+				term1 = a*sig/(1.0-n)*( 1.0/(::pow(b-tmin,n-1.0)) - 1.0/(::pow(n/absAlpha,n-1.0)) );
 			}
 
 			double term2 = sig*sqrtPiOver2*(erf(tmax/sqrt2) - erf(-absAlpha/sqrt2) );
@@ -85,6 +85,17 @@ public:
 		return  CHECK_VALUE(::exp(-x*_par[0] ),"par[0]=%f ", _par[0] ) ;
 	}
 
+	template<typename Real>
+	__hydra_host__ __hydra_device__
+	inline Real EvaluateWithParameters(Real const* par, ArgType x)  const
+	{
+		using std::exp;
+
+		double X = x;
+
+		return exp(-X*par[0]);
+	}
+
 
 
 };
@@ -131,7 +142,7 @@ struct RngFormula< Exponential<ArgType> >
 	{
 		double tau  = functor[0];
 
-		return static_cast<value_type>(-tau*log(RngBase::uniform(rng)));
+		return static_cast<value_type>(-tau*::log(RngBase::uniform(rng)));
 	}
 
 	template<typename Engine, typename T>
@@ -140,7 +151,7 @@ struct RngFormula< Exponential<ArgType> >
 	{
 		double tau  = pars.begin()[0];
 
-		return static_cast<value_type>(-tau*log(RngBase::uniform(rng)));
+		return static_cast<value_type>(-tau*::log(RngBase::uniform(rng)));
 	}
 
 };
@@ -93,6 +93,20 @@ public:
 
 	}
 
+	template<typename Real>
+	__hydra_host__ __hydra_device__
+	inline Real EvaluateWithParameters(Real const* par, ArgType x)  const
+	{
+		using std::exp;
+
+		double X = x;
+
+		Real m2 = ( X - par[0])*(X - par[0] );
+		Real s2 = par[1]*par[1];
+
+		return exp(-m2/(2.0 * s2 ));
+	}
+
 };
 
 template<typename ArgType>
@@ -44,6 +44,8 @@
 #include <hydra/Parameter.h>
 #include <hydra/CubicSpiline.h>
 #include <hydra/Tuple.h>
+#include <hydra/detail/FFTPolicy.h>
+#include <hydra/detail/external/hydra_thrust/iterator/iterator_traits.h>
 #include <tuple>
 #include <limits>
 #include <stdexcept>
@@ -94,7 +96,7 @@ public:
 		inline 	double operator()(double x){
 
 			double m = (x - fX)/fH;
-			return  hydra::math_constants::inverse_sqrt2Pi*exp(-0.5*m*m);
+			return  hydra::math_constants::inverse_sqrt2Pi*::exp(-0.5*m*m);
 		}
 
 		double fX;
@@ -106,13 +108,60 @@ public:
 
 	GaussianKDE() = delete;
 
+	/**
+	 * Builds the KDE summing the kernel over the sample directly, in parallel on the
+	 * back-end of the data. Suitable for small samples, the cost is O(N x NBins).
+	 *
+	 * @param min lower limit of the spline nodes.
+	 * @param max upper limit of the spline nodes.
+	 * @param h bandwidth.
+	 * @param begin iterator pointing to the first entry of the sample.
+	 * @param end iterator pointing to the end of the sample.
+	 */
 	template<typename Iterator>
 	GaussianKDE(double min, double max, double h, Iterator begin, Iterator end):
 	BaseFunctor<GaussianKDE<NBins, ArgType>, Signature, 0>()
 	{
-		fSpiline=BuildKDE(min, max, h, begin, end);
+		typedef typename hydra_thrust::iterator_system<Iterator>::type system_t;
+
+		fSpiline=BuildKDE(system_t(), min, max, h, begin, end);
+	}
+
+	/**
+	 * Builds the KDE summing the kernel over the sample directly on the back-end \p policy.
+	 * If \p adaptive is true, the fixed bandwidth estimate is used as pilot to assign
+	 * each entry the bandwidth h*sqrt(g/f(x_i)), where g is the geometric mean of the
+	 * pilot density over the sample (Abramson's square root law).
+	 */
+	template<hydra::detail::Backend BACKEND, typename Iterator>
+	GaussianKDE(hydra::detail::BackendPolicy<BACKEND> const& policy,
+			double min, double max, double h, Iterator begin, Iterator end, bool adaptive=false):
+	BaseFunctor<GaussianKDE<NBins, ArgType>, Signature, 0>()
+	{
+		fSpiline=BuildKDE(policy, min, max, h, begin, end);
+
+		if(adaptive) fSpiline=BuildAdaptiveKDE(policy, min, max, h, begin, end);
 	}
 
+	/**
+	 * Builds the KDE binning the sample once on a regular grid (linear binning) and
+	 * convolving it with the Gaussian kernel using the FFT back-end \p fft_policy.
+	 * The cost is O(N + M log M), with M the number of grid points, so this is the method
+	 * of choice for large samples. If \p adaptive is true, the binned estimate is used as
+	 * pilot for the adaptive bandwidth estimate, as in the direct-sum constructor. The adaptive
+	 * pass is binned as well: the entries binned on a grid point share the bandwidth
+	 * at that point, which costs O(N + M x NBins).
+	 */
+	template<hydra::detail::Backend BACKEND, typename T, hydra::detail::FFTCalculator FFTBackend, typename Iterator>
+	GaussianKDE(hydra::detail::BackendPolicy<BACKEND> const& policy,
+			hydra::detail::FFTPolicy<T, FFTBackend> const& fft_policy,
+			double min, double max, double h, Iterator begin, Iterator end, bool adaptive=false):
+	BaseFunctor<GaussianKDE<NBins, ArgType>, Signature, 0>()
+	{
+		fSpiline=BuildBinnedKDE(policy, fft_policy, min, max, h, begin, end);
+
+		if(adaptive) fSpiline=BuildBinnedAdaptiveKDE(policy, min, max, h, begin, end);
+	}
 
 	__hydra_host__ __hydra_device__
 	GaussianKDE(GaussianKDE<NBins, ArgType> const& other):
@@ -136,7 +185,7 @@ public:
 	}
 
 	__hydra_host__ __hydra_device__
-	inline double Evaluate(unsigned int n, ArgType x)  const {
+	inline double Evaluate(ArgType x)  const {
 
 		GReal_t r = fSpiline(x);
 
@@ -146,11 +195,20 @@ public:
 
 private:
 
-	template<typename Iterator>
-	__hydra_host__ __hydra_device__
-	inline 	CubicSpiline<NBins>  BuildKDE(double min, double max, double h, Iterator begin, Iterator end);
+	template<typename Policy, typename Iterator>
+	inline 	CubicSpiline<NBins, ArgType>  BuildKDE(Policy const& policy, double min, double max, double h, Iterator begin, Iterator end);
+
+	template<typename Policy, typename T, hydra::detail::FFTCalculator FFTBackend, typename Iterator>
+	inline 	CubicSpiline<NBins, ArgType>  BuildBinnedKDE(Policy const& policy, hydra::detail::FFTPolicy<T, FFTBackend> const& fft_policy,
+			double min, double max, double h, Iterator begin, Iterator end);
+
+	template<typename Policy, typename Iterator>
+	inline 	CubicSpiline<NBins, ArgType>  BuildAdaptiveKDE(Policy const& policy, double min, double max, double h, Iterator begin, Iterator end);
+
+	template<typename Policy, typename Iterator>
+	inline 	CubicSpiline<NBins, ArgType>  BuildBinnedAdaptiveKDE(Policy const& policy, double min, double max, double h, Iterator begin, Iterator end);
 
-	CubicSpiline<NBins> fSpiline;
+	CubicSpiline<NBins, ArgType> fSpiline;
 
 
 };
@@ -36,7 +36,7 @@
 
 #include <hydra/detail/Config.h>
 #include <hydra/detail/BackendPolicy.h>
-#include <hydra/cpp/System.h>
+#include <hydra/device/System.h>
 
 #include <hydra/Types.h>
 #include <hydra/Function.h>
@@ -88,11 +88,17 @@ public:
 	    	exit(0);
 	    }
 
+	    Update();
 		}
 
   __hydra_host__ __hydra_device__
   Ipatia( Ipatia<ArgType> const& other):
-    BaseFunctor< Ipatia<ArgType>, Signature, 8>(other)
+    BaseFunctor< Ipatia<ArgType>, Signature, 8>(other),
+    fDelta2(other.fDelta2),
+    fLeftA(other.fLeftA),
+    fLeftB(other.fLeftB),
+    fRightA(other.fRightA),
+    fRightB(other.fRightB)
   		{}
 
 
@@ -102,9 +108,32 @@ public:
 	  if(this ==&other) return *this;
 
 	  BaseFunctor< Ipatia<ArgType>, Signature, 8>::operator=(other);
+
+	  fDelta2 = other.fDelta2;
+	  fLeftA  = other.fLeftA;
+	  fLeftB  = other.fLeftB;
+	  fRightA = other.fRightA;
+	  fRightB = other.fRightB;
+
 	  return *this;
     }
 
+  /**
+   * Calculates the constants of the tails, which depend only on the parameters,
+   * so that each evaluation computes only the branch it falls in.
+   */
+  virtual void Update() override
+  {
+	  double sigma = _par[1];
+	  double l     = _par[6];
+
+	  fDelta2 = (l>=-1.0)? sigma : sigma *::sqrt(-2.0 - 2.*l);
+	  fDelta2 *= fDelta2;
+
+	  tail(-1.0, _par[2]*sigma, _par[3], l, _par[7], fLeftA,  fLeftB);
+	  tail( 1.0, _par[4]*sigma, _par[5], l, _par[7], fRightA, fRightB);
+  }
+
 
   __hydra_host__ __hydra_device__
   inline double Evaluate(ArgType x)  const	{
@@ -144,6 +173,14 @@ private:
   inline  double center(const double d,const double sigma,
 	         const double l, const double beta ) const;
 
+  inline void tail(const double side, const double asigma, const double n,
+		  const double l, const double beta, double& A, double& B) const;
+
+  double fDelta2;
+  double fLeftA;
+  double fLeftB;
+  double fRightA;
+  double fRightB;
 
 };
 
@@ -173,7 +210,7 @@ protected:
 
 			}
 
-			hydra::GaussKronrodQuadrature<61,500, hydra::cpp::sys_t> fNumIntegrator(LowerLimit, UpperLimit);
+			hydra::GaussKronrodQuadrature<61,500, hydra::device::sys_t> fNumIntegrator(LowerLimit, UpperLimit);
 
 			return fNumIntegrator(functor);
 		}
@@ -37,49 +37,550 @@
 #include <hydra/detail/BackendPolicy.h>
 #include <hydra/Types.h>
 #include <hydra/Function.h>
+#include <hydra/Complex.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/detail/HistogramFill.h>
+#include <hydra/detail/Convolution.inl>
 #include <hydra/detail/external/hydra_thrust/transform_reduce.h>
-#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/detail/external/hydra_thrust/fill.h>
+#include <hydra/detail/external/hydra_thrust/memory.h>
 #include <hydra/detail/external/hydra_thrust/extrema.h>
+#include <hydra/detail/external/hydra_thrust/functional.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/transform_iterator.h>
+#include <hydra/detail/external/hydra_thrust/iterator/zip_iterator.h>
 
 #include <math.h>
 #include <algorithm>
+#include <array>
+
+/*
+ * Half width of the region around [min, max], in units of the bandwidth,
+ * where the binned KDE accounts for the data.
+ */
+#ifndef HYDRA_KDE_KERNEL_SUPPORT
+#define HYDRA_KDE_KERNEL_SUPPORT 8.0
+#endif
+
+/*
+ * Minimum number of grid points per bandwidth used by the binned KDE.
+ * The grid is refined beyond the spline nodes if these are too sparse.
+ */
+#ifndef HYDRA_KDE_GRID_POINTS_PER_BANDWIDTH
+#define HYDRA_KDE_GRID_POINTS_PER_BANDWIDTH 8.0
+#endif
+
+/*
+ * Maximum number of points of the grid used by the binned adaptive KDE.
+ * The refinement is clamped to keep the grid within this size, and the
+ * entries beyond the margin it leaves around [min, max] are dropped.
+ */
+#ifndef HYDRA_KDE_MAX_GRID_POINTS
+#define HYDRA_KDE_MAX_GRID_POINTS 4194304
+#endif
 
 namespace hydra {
 
-template< size_t NBins, typename ArgType>
-template<typename Iterator>
-__hydra_host__ __hydra_device__
-inline CubicSpiline<NBins> GaussianKDE<NBins, ArgType>::BuildKDE(double min, double max, double h, Iterator begin, Iterator end) {
+namespace detail {
+
+namespace kde {
+
+/*
+ * Linear binning: each entry is shared between its left and right
+ * neighbours on the grid, proportionally to the distance to each one.
+ */
+struct LinearBinning
+{
+	LinearBinning(double xmin, double delta, size_t npoints, bool right):
+		fXMin(xmin),
+		fDelta(delta),
+		fNPoints(npoints),
+		fRight(right)
+	{}
+
+	__hydra_host__ __hydra_device__
+	LinearBinning(LinearBinning const& other):
+		fXMin(other.fXMin),
+		fDelta(other.fDelta),
+		fNPoints(other.fNPoints),
+		fRight(other.fRight)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline bool in_grid(double t) const {
+		return t >= 0.0 && t < fNPoints - 1.0;
+	}
+
+	double fXMin;
+	double fDelta;
+	size_t fNPoints;
+	bool   fRight;
+};
+
+struct LinearBinningKey: LinearBinning
+{
+	LinearBinningKey(double xmin, double delta, size_t npoints, bool right):
+		LinearBinning(xmin, delta, npoints, right)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline size_t operator()(double x) const {
+
+		double t = (x - fXMin)/fDelta;
+
+		if( !in_grid(t) ) return fNPoints;
+
+		return fRight ? size_t(t) + 1 : size_t(t);
+	}
+};
+
+struct LinearBinningWeight: LinearBinning
+{
+	LinearBinningWeight(double xmin, double delta, size_t npoints, bool right):
+		LinearBinning(xmin, delta, npoints, right)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(double x) const {
+
+		double t = (x - fXMin)/fDelta;
+
+		if( !in_grid(t) ) return 0.0;
+
+		double f = t - ::floor(t);
+
+		return fRight ? f : 1.0 - f;
+	}
+};
+
+/*
+ * Gaussian kernel sampled on the grid, wrapped around for the circular convolution.
+ */
+struct KernelSampler
+{
+	KernelSampler(double delta, double h, size_t npoints):
+		fDelta(delta),
+		fH(h),
+		fNPoints(npoints)
+	{}
+
+	__hydra_host__ __hydra_device__
+	KernelSampler(KernelSampler const& other):
+		fDelta(other.fDelta),
+		fH(other.fH),
+		fNPoints(other.fNPoints)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(size_t i) const {
+
+		size_t d = i <= fNPoints/2 ? i : fNPoints - i;
+		double u = d*fDelta/fH;
+
+		return hydra::math_constants::inverse_sqrt2Pi*::exp(-0.5*u*u);
+	}
+
+	double fDelta;
+	double fH;
+	size_t fNPoints;
+};
+
+/*
+ * Logarithm of the pilot density, bounded from below by fFloor
+ * to keep the bandwidth finite in the tails.
+ */
+template<typename Pilot>
+struct LogPilotDensity
+{
+	LogPilotDensity(Pilot const& pilot, double floor):
+		fPilot(pilot),
+		fFloor(floor)
+	{}
+
+	__hydra_host__ __hydra_device__
+	LogPilotDensity(LogPilotDensity<Pilot> const& other):
+		fPilot(other.fPilot),
+		fFloor(other.fFloor)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(double x) const {
+
+		double f = fPilot(x);
+
+		return ::log( f > fFloor ? f : fFloor );
+	}
+
+	Pilot  fPilot;
+	double fFloor;
+};
+
+/*
+ * Per-entry bandwidth h*sqrt(g/f(x_i)), with log(g) the mean of log(f(x_i)).
+ */
+struct AdaptiveBandwidth
+{
+	AdaptiveBandwidth(double h, double log_g):
+		fH(h),
+		fLogG(log_g)
+	{}
+
+	__hydra_host__ __hydra_device__
+	AdaptiveBandwidth(AdaptiveBandwidth const& other):
+		fH(other.fH),
+		fLogG(other.fLogG)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(double log_f) const {
+
+		return fH*::exp(0.5*(fLogG - log_f));
+	}
+
+	double fH;
+	double fLogG;
+};
+
+struct AdaptiveKernel
+{
+	AdaptiveKernel(double x):
+		fX(x)
+	{}
+
+	__hydra_host__ __hydra_device__
+	AdaptiveKernel(AdaptiveKernel const& other):
+		fX(other.fX)
+	{}
+
+	template<typename Entry>
+	__hydra_host__ __hydra_device__
+	inline double operator()(Entry const& entry) const {
+
+		double x = hydra::get<0>(entry);
+		double h = hydra::get<1>(entry);
+		double m = (fX - x)/h;
+
+		return hydra::math_constants::inverse_sqrt2Pi*::exp(-0.5*m*m)/h;
+	}
+
+	double fX;
+};
+
+/*
+ * Kernel of the entries binned on a grid point: the tuple holds the abscissa
+ * of the grid point, the bandwidth there and the binned content.
+ */
+struct BinnedAdaptiveKernel: AdaptiveKernel
+{
+	BinnedAdaptiveKernel(double x):
+		AdaptiveKernel(x)
+	{}
+
+	__hydra_host__ __hydra_device__
+	BinnedAdaptiveKernel(BinnedAdaptiveKernel const& other):
+		AdaptiveKernel(other)
+	{}
+
+	template<typename Entry>
+	__hydra_host__ __hydra_device__
+	inline double operator()(Entry const& entry) const {
+
+		double w = hydra::get<2>(entry);
+
+		return w == 0.0 ? 0.0 : w*AdaptiveKernel::operator()(entry);
+	}
+};
+
+struct GridAbscissa
+{
+	GridAbscissa(double xmin, double delta):
+		fXMin(xmin),
+		fDelta(delta)
+	{}
+
+	__hydra_host__ __hydra_device__
+	GridAbscissa(GridAbscissa const& other):
+		fXMin(other.fXMin),
+		fDelta(other.fDelta)
+	{}
+
+	__hydra_host__ __hydra_device__
+	inline double operator()(size_t i) const {
+
+		return fXMin + i*fDelta;
+	}
+
+	double fXMin;
+	double fDelta;
+};
+
+}  // namespace kde
+
+}  // namespace detail
+
 
-	auto _KDE = [=](double x){
+template< size_t NBins, typename ArgType, typename Signature>
+template<typename Policy, typename Iterator>
+inline CubicSpiline<NBins, ArgType> GaussianKDE<NBins, ArgType, Signature>::BuildKDE(Policy const& policy,
+		double min, double max, double h, Iterator begin, Iterator end) {
 
-		double init = 0;
+	double bin_width = (max-min)/(NBins);
+	double n = hydra_thrust::distance(begin, end);
+
+	std::array<double, NBins> X;
+	std::array<double, NBins> D;
+
+	for(size_t i=0; i<NBins; i++){
 
-		double sum  = hydra_thrust::transform_reduce(begin, end,
-				GaussianKDE<NBins, ArgType>::Kernel(h,x), 0.0,
+		X[i] = min + i*bin_width;
+
+		double sum  = hydra_thrust::transform_reduce(policy, begin, end,
+				typename GaussianKDE<NBins, ArgType, Signature>::Kernel(h, X[i]), 0.0,
 				hydra_thrust::plus<double>() );
 
-		return  sum/(h*hydra_thrust::distance(begin, end) ) ;
-	};
+		D[i] = sum/(h*n);
+	}
+
+	return CubicSpiline<NBins, ArgType>(X.begin(), D.begin());
+}
+
+template< size_t NBins, typename ArgType, typename Signature>
+template<typename Policy, typename T, hydra::detail::FFTCalculator FFTBackend, typename Iterator>
+inline CubicSpiline<NBins, ArgType> GaussianKDE<NBins, ArgType, Signature>::BuildBinnedKDE(Policy const& policy,
+		hydra::detail::FFTPolicy<T, FFTBackend> const&,
+		double min, double max, double h, Iterator begin, Iterator end) {
+
+	typedef hydra::complex<T> complex_type;
+	typedef typename detail::FFTPolicy<T, FFTBackend>::R2C _RealToComplexFFT;
+	typedef typename detail::FFTPolicy<T, FFTBackend>::C2R _ComplexToRealFFT;
+
+	double node_width = (max-min)/(NBins);
+	double n = hydra_thrust::distance(begin, end);
+
+	// each node interval is split in refine grid cells, so the
+	// linear binning error stays small compared to the bandwidth
+	size_t refine    = size_t(::ceil(HYDRA_KDE_GRID_POINTS_PER_BANDWIDTH*node_width/h));
+	double bin_width = node_width/refine;
+
+	// the grid extends beyond [min, max] to account for the entries
+	// in the kernel's reach. It is zero-padded to at least twice its size,
+	// so the circular convolution does not wrap around.
+	size_t margin  = size_t(::ceil(HYDRA_KDE_KERNEL_SUPPORT*h/bin_width));
+	size_t ngrid   = NBins*refine + 2*margin;
+	size_t nfft    = hydra::detail::convolution::upper_power_of_two(2*ngrid);
+	double xmin    = min - margin*bin_width;
+
+	auto grid_samples   = hydra::detail::get_temporary_buffer<T>(policy, nfft);
+	auto kernel_samples = hydra::detail::get_temporary_buffer<T>(policy, nfft);
+	auto complex_buffer = hydra::detail::get_temporary_buffer<complex_type>(policy, nfft/2+1);
+
+	// linear binning of the data
+	hydra_thrust::fill(policy, grid_samples.first, grid_samples.first + nfft, T(0.0));
+
+	for(bool right : {false, true}){
+
+		detail::fill_histogram(policy, ngrid,
+				detail::kde::LinearBinningKey(xmin, bin_width, ngrid, right), begin, end,
+				hydra_thrust::make_transform_iterator(begin,
+						detail::kde::LinearBinningWeight(xmin, bin_width, ngrid, right)),
+				grid_samples.first, true);
+	}
+
+	// sample kernel
+	hydra_thrust::counting_iterator<size_t> first(0);
+
+	hydra_thrust::transform(policy, first, first + nfft, kernel_samples.first,
+			detail::kde::KernelSampler(bin_width, h, nfft));
+
+	//transform kernel
+	auto fft_kernel = _RealToComplexFFT( nfft );
+
+	fft_kernel.LoadInputData( nfft, kernel_samples.first);
+	fft_kernel.Execute();
+
+	auto fft_kernel_output =  fft_kernel.GetOutputData();
+	auto fft_kernel_range  = make_range( fft_kernel_output.first,
+			fft_kernel_output.first + fft_kernel_output.second);
+
+	//transform binned data
+	auto fft_grid = _RealToComplexFFT( nfft );
+
+	fft_grid.LoadInputData( nfft, grid_samples.first);
+	fft_grid.Execute();
+
+	auto fft_grid_output =  fft_grid.GetOutputData();
+	auto fft_grid_range  = make_range( fft_grid_output.first,
+			fft_grid_output.first + fft_grid_output.second);
+
+	//element wise product
+	auto ffts = hydra::zip(fft_grid_range,  fft_kernel_range );
+
+	hydra_thrust::transform( policy, ffts.begin(),  ffts.end(),
+			complex_buffer.first, detail::convolution::MultiplyFFT<T>());
+
+	//transform product back to real
+	auto fft_product = _ComplexToRealFFT( nfft );
+
+	fft_product.LoadInputData(nfft/2+1, complex_buffer.first);
+	fft_product.Execute();
+
+	auto fft_product_output =  fft_product.GetOutputData();
+
+	auto normalize = detail::convolution::NormalizeFFT<T>(T(nfft)*n*h);
+
+	auto product_first = hydra_thrust::make_transform_iterator(
+			fft_product_output.first + margin, normalize);
+
+	std::array<double, NBins> X;
+	std::array<double, NBins> D;
+
+	for(size_t i=0; i<NBins; i++){
+		X[i] = min + i*node_width;
+		D[i] = product_first[i*refine];
+	}
+
+	hydra::detail::return_temporary_buffer( policy, grid_samples.first );
+	hydra::detail::return_temporary_buffer( policy, kernel_samples.first );
+	hydra::detail::return_temporary_buffer( policy, complex_buffer.first );
+
+	return CubicSpiline<NBins, ArgType>(X.begin(), D.begin());
+}
+
+template< size_t NBins, typename ArgType, typename Signature>
+template<typename Policy, typename Iterator>
+inline CubicSpiline<NBins, ArgType> GaussianKDE<NBins, ArgType, Signature>::BuildAdaptiveKDE(Policy const& policy,
+		double min, double max, double h, Iterator begin, Iterator end) {
 
 	double bin_width = (max-min)/(NBins);
+	size_t n = hydra_thrust::distance(begin, end);
+
+	// the current spline is the pilot estimate
+	auto bandwidth = hydra::detail::get_temporary_buffer<double>(policy, n);
+
+	hydra_thrust::transform(policy, begin, end, bandwidth.first,
+			detail::kde::LogPilotDensity<CubicSpiline<NBins, ArgType>>(fSpiline, 1.0e-6/(max-min)));
+
+	double log_g = hydra_thrust::reduce(policy, bandwidth.first, bandwidth.first + n, 0.0)/n;
+
+	hydra_thrust::transform(policy, bandwidth.first, bandwidth.first + n, bandwidth.first,
+			detail::kde::AdaptiveBandwidth(h, log_g));
+
+	auto entries_first = hydra_thrust::make_zip_iterator(hydra_thrust::make_tuple(begin, bandwidth.first));
+	auto entries_last  = entries_first + n;
+
+	std::array<double, NBins> X;
+	std::array<double, NBins> D;
+
+	for(size_t i=0; i<NBins; i++){
+
+		X[i] = min + i*bin_width;
+
+		D[i] = hydra_thrust::transform_reduce(policy, entries_first, entries_last,
+				detail::kde::AdaptiveKernel(X[i]), 0.0, hydra_thrust::plus<double>() )/n;
+	}
+
+	hydra::detail::return_temporary_buffer( policy, bandwidth.first );
+
+	return CubicSpiline<NBins, ArgType>(X.begin(), D.begin());
+}
+
+template< size_t NBins, typename ArgType, typename Signature>
+template<typename Policy, typename Iterator>
+inline CubicSpiline<NBins, ArgType> GaussianKDE<NBins, ArgType, Signature>::BuildBinnedAdaptiveKDE(Policy const& policy,
+		double min, double max, double h, Iterator begin, Iterator end) {
+
+	typedef detail::kde::LogPilotDensity<CubicSpiline<NBins, ArgType>> log_pilot_type;
+
+	double node_width = (max-min)/(NBins);
+	double n = hydra_thrust::distance(begin, end);
+
+	// the current spline is the pilot estimate
+	log_pilot_type log_pilot(fSpiline, 1.0e-6/(max-min));
+
+	double log_g = hydra_thrust::transform_reduce(policy, begin, end, log_pilot, 0.0,
+			hydra_thrust::plus<double>())/n;
+
+	// the grid spacing is kept small compared to the narrowest kernel,
+	// found where the pilot density is the largest
+	double log_f_max = log_pilot(min);
+
+	for(size_t i=1; i<NBins; i++)
+		log_f_max = std::max(log_f_max, log_pilot(min + i*node_width));
+
+	double h_min = detail::kde::AdaptiveBandwidth(h, log_g)(log_f_max);
+
+	size_t refine    = size_t(::ceil(HYDRA_KDE_GRID_POINTS_PER_BANDWIDTH*node_width/h_min));
+
+	// at least half of the grid is left for the margins
+	refine = std::max<size_t>(1, std::min<size_t>(refine, HYDRA_KDE_MAX_GRID_POINTS/(2*NBins)));
+
+	double bin_width = node_width/refine;
+
+	// the widest kernels sit in the tails, where the pilot density is the smallest.
+	// The margin reaches as far as them, but not beyond the data.
+	double log_f_min = hydra_thrust::transform_reduce(policy, begin, end, log_pilot,
+			log_f_max, hydra_thrust::minimum<double>());
+
+	double h_max = detail::kde::AdaptiveBandwidth(h, log_g)(log_f_min);
+
+	auto extrema = hydra_thrust::minmax_element(policy, begin, end);
+
+	double reach = std::min( HYDRA_KDE_KERNEL_SUPPORT*h_max,
+			std::max( min - double(*extrema.first), double(*extrema.second) - max ) );
+
+	// one more point, so the linear binning keeps the outermost entries
+	size_t margin  = reach > 0.0 ? size_t(::ceil(reach/bin_width)) + 1 : 1;
+
+	margin = std::min<size_t>(margin, (HYDRA_KDE_MAX_GRID_POINTS - NBins*refine)/2);
+
+	size_t ngrid   = NBins*refine + 2*margin;
+	double xmin    = min - margin*bin_width;
+
+	auto counts    = hydra::detail::get_temporary_buffer<double>(policy, ngrid);
+	auto bandwidth = hydra::detail::get_temporary_buffer<double>(policy, ngrid);
+
+	// linear binning of the data
+	hydra_thrust::fill(policy, counts.first, counts.first + ngrid, 0.0);
+
+	for(bool right : {false, true}){
+
+		detail::fill_histogram(policy, ngrid,
+				detail::kde::LinearBinningKey(xmin, bin_width, ngrid, right), begin, end,
+				hydra_thrust::make_transform_iterator(begin,
+						detail::kde::LinearBinningWeight(xmin, bin_width, ngrid, right)),
+				counts.first, true);
+	}
+
+	// the entries binned on a grid point share the bandwidth of that point
+	auto abscissae = hydra_thrust::make_transform_iterator(
+			hydra_thrust::counting_iterator<size_t>(0), detail::kde::GridAbscissa(xmin, bin_width));
+
+	hydra_thrust::transform(policy, abscissae, abscissae + ngrid, bandwidth.first, log_pilot);
 
-	auto _X = [=](size_t index){
+	hydra_thrust::transform(policy, bandwidth.first, bandwidth.first + ngrid, bandwidth.first,
+			detail::kde::AdaptiveBandwidth(h, log_g));
 
-		return min + index*bin_width;
-	};
+	auto entries_first = hydra_thrust::make_zip_iterator(
+			hydra_thrust::make_tuple(abscissae, bandwidth.first, counts.first));
+	auto entries_last  = entries_first + ngrid;
 
-	typedef hydra_thrust::counting_iterator<size_t> citerator;
-	citerator counter(0);
+	std::array<double, NBins> X;
+	std::array<double, NBins> D;
 
-	typedef hydra_thrust::transform_iterator<decltype(_X),   citerator> xiterator;
-	xiterator Xiterator(counter,  _X);
+	for(size_t i=0; i<NBins; i++){
 
-	hydra_thrust::transform_iterator<decltype(_KDE), xiterator> diterator(Xiterator,  _KDE);
+		X[i] = min + i*node_width;
 
-	return CubicSpiline<NBins>(Xiterator, diterator);
+		D[i] = hydra_thrust::transform_reduce(policy, entries_first, entries_last,
+				detail::kde::BinnedAdaptiveKernel(X[i]), 0.0, hydra_thrust::plus<double>() )/n;
+	}
 
+	hydra::detail::return_temporary_buffer( policy, counts.first );
+	hydra::detail::return_temporary_buffer( policy, bandwidth.first );
 
+	return CubicSpiline<NBins, ArgType>(X.begin(), D.begin());
 }
 
 }  // namespace hydra
@@ -43,108 +43,54 @@ __hydra_host__ __hydra_device__
 
 	 double d = x-mu;
 
-
-	 double _left_   = (d < -A1*sigma );
-	 double _right_  = (d > A2*sigma );
-	 double _center_ = (d >= -A1*sigma) && (d <= A2*sigma );
-
-
-	 return    _left_*left(d, sigma, A1, N1, l, beta) +
-			  _right_*right(d, sigma, A2, N2, l, beta) +
-			 _center_*center(d, sigma, l, beta );
+	 return  (d < -A1*sigma) ? left(d, sigma, A1, N1, l, beta) :
+			 (d >  A2*sigma) ? right(d, sigma, A2, N2, l, beta) :
+					 center(d, sigma, l, beta );
 
  }
 
 template<typename ArgType,typename Signature>
 __hydra_host__ __hydra_device__
  inline  double Ipatia<ArgType, Signature>::left(const double d, const double sigma,
-	 const double A1, const double N1, const double l,  const double beta) const {
+	 const double A1, const double N1, const double, const double) const {
 
-	 const double  asigma = A1*sigma;
-
-	 double  delta2 = (l>=-1.0)? sigma : sigma *::sqrt(-2.0 - 2.*l) ;
-
-	 delta2 *= delta2;
-
-	 const double   cons1 = ::exp(-beta*asigma);
-	 const double   phi = 1.0 + asigma*asigma/delta2;
-	 const double   k1  = cons1*::pow(phi,l-0.5);
-	 const double   k2  = beta*k1- cons1*(l-0.5)*::pow(phi,l-1.5)*2.0*asigma/delta2;
-	 const double   B   = -asigma + N1*k1/k2;
-	 const double   A   = k1*::pow(B+asigma,N1);
-
-	 /*
-	 std::cout << std::endl
-			 << "d " <<  d << std::endl
-			 << "asigma " <<  asigma << std::endl
-			 << "delta2 " << delta2 << std::endl
-			 << "cons1 " << ::exp(-beta*asigma) << std::endl
-			 << "phi " << 1.0 + asigma*asigma/delta2 << std::endl
-			 << "k1 "  << cons1*::pow(phi,l-0.5) << std::endl
-	         << "k2 "  << beta*k1- cons1*(l-0.5)*::pow(phi,l-1.5)*2.0*asigma/delta2 << std::endl
-	         << "B "    << -asigma + N1*k1/k2 << std::endl
-	         << "A "    << k1*::pow(B+asigma,N1) << std::endl
-	         << "A*::pow(B-d,-N1) " << A*::pow(B-d,-N1)
-			 << std::endl;
-	  */
-
-	 return (d < -A1*sigma )? A*::pow(B-d,-N1):0.0;
+	 return (d < -A1*sigma )? fLeftA*::pow(fLeftB-d,-N1):0.0;
 
  }
 
 template<typename ArgType,typename Signature>
 __hydra_host__ __hydra_device__
  inline  double Ipatia<ArgType, Signature>::right(const double d,const double sigma,
-		const double A2, const double N2, const double l,  const double beta) const{
-
-	 const  double asigma = A2*sigma;
-
-	 double  delta2 = (l>=-1.0)? sigma : sigma *::sqrt(-2.0 - 2.*l) ;
-
-	 delta2 *= delta2;
-
-	 const double   cons1 = ::exp(beta*asigma);
-	 const double   phi = 1.0 + asigma*asigma/delta2;
-	 const double   k1  = cons1*::pow(phi,l-0.5);
-	 const double   k2  = beta*k1 + cons1*(l-0.5)*::pow(phi,l-1.5)*2.0*asigma/delta2;
-	 const double   B   = - asigma - N2*k1/k2;
-	 const double   A   = k1*::pow(B+asigma,N2);
-
-	 /*
-
-	 std::cout << std::endl
-				 << "d " <<  d << std::endl
-				 << "asigma " <<  asigma << std::endl
-				 << "delta2 " << delta2 << std::endl
-				 << "cons1 " << ::exp(-beta*asigma) << std::endl
-				 << "phi " << 1.0 + asigma*asigma/delta2 << std::endl
-				 << "k1 "  << cons1*::pow(phi,l-0.5) << std::endl
-		         << "k2 "  << beta*k1- cons1*(l-0.5)*::pow(phi,l-1.5)*2.0*asigma/delta2 << std::endl
-		         << "B "    << - asigma - N2*k1/k2 << std::endl
-		         << "A "    <<  k1*::pow(B+asigma,N2)<< std::endl
-		         << "A*::pow(B+d,-N2) " << A*::pow(B+d,-N2)
-				 << std::endl;
+		const double A2, const double N2, const double,  const double) const{
 
-	  */
-
-	 return (d > A2*sigma )? A*::pow(B+d,-N2):0.0;
+	 return (d > A2*sigma )? fRightA*::pow(fRightB+d,-N2):0.0;
 
  }
 
 template<typename ArgType,typename Signature>
 __hydra_host__ __hydra_device__
- inline  double Ipatia<ArgType, Signature>::center(const double d,const double sigma,
+ inline  double Ipatia<ArgType, Signature>::center(const double d,const double,
 		 const double l, const double beta ) const {
 
+	  return  ::exp(beta*d)*::pow(1. + d*d/fDelta2,l-0.5)  ;
 
+ }
 
-	 double   delta2 = (l>=-1.0) ? sigma: sigma*::sqrt(-2.0 -2.*l);
-
-	 delta2 *= delta2;
-
+/*
+ * Power law tail continuing the core and its derivative at d = side*asigma,
+ * A*(B + side*d)^(-n), with side=-1 for the left tail and side=1 for the right one.
+ */
+template<typename ArgType,typename Signature>
+ inline  void Ipatia<ArgType, Signature>::tail(const double side, const double asigma, const double n,
+		 const double l, const double beta, double& A, double& B) const {
 
-	  return  ::exp(beta*d)*::pow(1. + d*d/delta2,l-0.5)  ;
+	 const double   cons1 = ::exp(side*beta*asigma);
+	 const double   phi = 1.0 + asigma*asigma/fDelta2;
+	 const double   k1  = cons1*::pow(phi,l-0.5);
+	 const double   k2  = beta*k1 + side*cons1*(l-0.5)*::pow(phi,l-1.5)*2.0*asigma/fDelta2;
 
+	 B = -asigma - side*n*k1/k2;
+	 A = k1*::pow(B+asigma,n);
  }
 
 }  // namespace hydra
@@ -0,0 +1,183 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * bounded_cache.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <vector>
+
+#include <hydra/detail/BoundedCache.h>
+#include <hydra/Pdf.h>
+#include <hydra/Parameter.h>
+#include <hydra/functions/Gaussian.h>
+
+TEST_CASE( "bounded LRU cache","hydra::detail::BoundedCache" ) {
+
+	typedef hydra::detail::BoundedCache<double> cache_t;
+
+	const std::vector<double> none;
+
+	SECTION( "least recently used entries are evicted" )
+	{
+		cache_t cache(3);
+
+		for(size_t key=0; key<3; key++) cache.Insert(key, none, 10.0*key);
+
+		double value = 0.0;
+
+		//key 0 becomes the most recently used, so key 1 goes first
+		REQUIRE( cache.Get(0, none, value) );
+		REQUIRE( value == 0.0 );
+
+		cache.Insert(3, none, 30.0);
+
+		REQUIRE( cache.GetSize() == 3 );
+		REQUIRE_FALSE( cache.Get(1, none, value) );
+		REQUIRE( cache.Get(2, none, value) );
+		REQUIRE( value == 20.0 );
+
+		//an existing key is overwritten, not added
+		cache.Insert(3, none, 31.0);
+
+		REQUIRE( cache.GetSize() == 3 );
+		REQUIRE( cache.Get(3, none, value) );
+		REQUIRE( value == 31.0 );
+
+		REQUIRE( cache.GetHits() == 3 );
+		REQUIRE( cache.GetMisses() == 1 );
+
+		//shrinking keeps the most recently used: 3 then 2
+		cache.SetCapacity(2);
+
+		REQUIRE( cache.GetSize() == 2 );
+		REQUIRE_FALSE( cache.Get(0, none, value) );
+		REQUIRE( cache.Get(2, none, value) );
+
+		//the copy has its own index over its own entries
+		cache_t copy(cache);
+
+		cache.Clear();
+
+		REQUIRE( copy.GetSize() == 2 );
+		REQUIRE( copy.Get(3, none, value) );
+		REQUIRE( value == 31.0 );
+		REQUIRE( copy.GetHits() == cache.GetHits() + 1 );
+
+		copy.Insert(4, none, 40.0);
+
+		REQUIRE( copy.GetSize() == 2 );
+		REQUIRE_FALSE( copy.Get(2, none, value) );
+	}
+
+	SECTION( "zero capacity disables caching" )
+	{
+		cache_t cache(0);
+
+		cache.Insert(1, none, 1.0);
+
+		double value = 0.0;
+
+		REQUIRE( cache.GetSize() == 0 );
+		REQUIRE_FALSE( cache.Get(1, none, value) );
+	}
+
+	SECTION( "verification turns collisions into misses" )
+	{
+		cache_t cache(4, true);
+
+		const std::vector<double> point{1.0, 2.0};
+		const std::vector<double> other{1.0, 2.5};
+
+		cache.Insert(7, point, 5.0);
+
+		double value = 0.0;
+
+		REQUIRE( cache.Get(7, point, value) );
+		REQUIRE( value == 5.0 );
+
+		//same key, different point
+		REQUIRE_FALSE( cache.Get(7, other, value) );
+		REQUIRE( cache.GetCollisions() == 1 );
+
+		//without verification the key alone decides
+		cache.SetVerify(false);
+
+		REQUIRE( cache.GetSize() == 0 );
+
+		cache.Insert(7, point, 5.0);
+
+		REQUIRE( cache.Get(7, other, value) );
+		REQUIRE( value == 5.0 );
+
+		cache.ResetCounters();
+
+		REQUIRE( cache.GetHits() == 0 );
+		REQUIRE( cache.GetMisses() == 0 );
+		REQUIRE( cache.GetCollisions() == 0 );
+	}
+
+	SECTION( "pdf normalization" )
+	{
+		auto mean  = hydra::Parameter::Create("BC_mean").Value(0.0);
+		auto sigma = hydra::Parameter::Create("BC_sigma").Value(1.0);
+
+		auto pdf = hydra::make_pdf( hydra::Gaussian<double>(mean, sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<double>>(-5.0, 5.0));
+
+		pdf.GetNormCache().SetCapacity(2);
+		pdf.GetNormCache().Clear();
+		pdf.GetNormCache().ResetCounters();
+
+		std::vector<double> norms;
+
+		for(double width : {1.0, 1.5, 2.0}){
+
+			pdf.GetFunctor().SetParameter(1, width);
+			pdf.Normalize();
+
+			norms.push_back(pdf.GetNorm());
+		}
+
+		REQUIRE( pdf.GetNormCache().GetSize() == 2 );
+		REQUIRE( pdf.GetNormCache().GetMisses() == 3 );
+
+		//still cached
+		pdf.GetFunctor().SetParameter(1, 2.0);
+		pdf.Normalize();
+
+		REQUIRE( pdf.GetNormCache().GetHits() == 1 );
+		REQUIRE( pdf.GetNorm() == norms[2] );
+
+		//evicted, so integrated again to the same value
+		pdf.GetFunctor().SetParameter(1, 1.0);
+		pdf.Normalize();
+
+		REQUIRE( pdf.GetNormCache().GetMisses() == 4 );
+		REQUIRE( pdf.GetNorm() == norms[0] );
+	}
+}
@@ -0,0 +1,270 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * coherent_sum.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include <hydra/Function.h>
+#include <hydra/Complex.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/CoherentSum.h>
+#include <hydra/functions/UniformShape.h>
+#include <hydra/device/System.h>
+#include <hydra/detail/AmplitudeCache.h>
+#include <hydra/detail/utility/CompensatedSum.h>
+#include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+
+declarg(Mass_arg, double)
+
+namespace coherent_sum_test {
+
+//non-relativistic Breit-Wigner amplitude
+class BreitWigner: public hydra::BaseFunctor<BreitWigner, hydra::complex<double>(hydra::arguments::Mass_arg), 2>
+{
+	typedef hydra::BaseFunctor<BreitWigner, hydra::complex<double>(hydra::arguments::Mass_arg), 2> super_type;
+
+	using super_type::_par;
+
+public:
+
+	BreitWigner(hydra::Parameter const& mass, hydra::Parameter const& width):
+		super_type({mass, width})
+	{}
+
+	__hydra_host__ __hydra_device__
+	BreitWigner(BreitWigner const& other):
+		super_type(other)
+	{}
+
+	__hydra_host__ __hydra_device__
+	BreitWigner& operator=(BreitWigner const& other)
+	{
+		if(this==&other) return *this;
+		super_type::operator=(other);
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline hydra::complex<double> Evaluate(hydra::arguments::Mass_arg m) const
+	{
+		return 1.0/hydra::complex<double>(m - _par[0], 0.5*_par[1]);
+	}
+};
+
+class Flat: public hydra::BaseFunctor<Flat, hydra::complex<double>(hydra::arguments::Mass_arg), 0>
+{
+	typedef hydra::BaseFunctor<Flat, hydra::complex<double>(hydra::arguments::Mass_arg), 0> super_type;
+
+public:
+
+	Flat()=default;
+
+	__hydra_host__ __hydra_device__
+	Flat(Flat const& other):
+		super_type(other)
+	{}
+
+	__hydra_host__ __hydra_device__
+	Flat& operator=(Flat const& other)
+	{
+		if(this==&other) return *this;
+		super_type::operator=(other);
+		return *this;
+	}
+
+	__hydra_host__ __hydra_device__
+	inline hydra::complex<double> Evaluate(hydra::arguments::Mass_arg) const
+	{
+		return hydra::complex<double>(1.0, 0.0);
+	}
+};
+
+}  // namespace coherent_sum_test
+
+TEST_CASE( "coherent sum of amplitudes","hydra::CoherentSum" ) {
+
+	using hydra::arguments::Mass_arg;
+
+	typedef hydra::detail::CompensatedSum<double> sum_t;
+
+	auto mass1  = hydra::Parameter::Create("mass1").Value(0.8).Error(0.01);
+	auto width1 = hydra::Parameter::Create("width1").Value(0.15).Error(0.01);
+	auto mass2  = hydra::Parameter::Create("mass2").Value(1.4).Error(0.01);
+	auto width2 = hydra::Parameter::Create("width2").Value(0.10).Error(0.01);
+
+	std::array<hydra::Parameter, 6> coefficients{
+		hydra::Parameter::Create("re1").Value(1.0).Error(0.01),
+		hydra::Parameter::Create("im1").Value(0.0).Error(0.01),
+		hydra::Parameter::Create("re2").Value(0.5).Error(0.01),
+		hydra::Parameter::Create("im2").Value(0.7).Error(0.01),
+		hydra::Parameter::Create("re3").Value(2.0).Error(0.01),
+		hydra::Parameter::Create("im3").Value(-1.0).Error(0.01) };
+
+	coherent_sum_test::BreitWigner bw1(mass1, width1);
+	coherent_sum_test::BreitWigner bw2(mass2, width2);
+	coherent_sum_test::Flat flat;
+
+	//flat normalization sample
+	const size_t nentries = 200000;
+
+	hydra::device::vector<Mass_arg> mc(nentries);
+
+	hydra::copy(hydra::random_range(hydra::UniformShape<Mass_arg>(0.0, 2.0), 753951, nentries), mc);
+
+	auto model = hydra::make_coherent_sum(coefficients, mc, bw1, bw2, flat);
+
+	//parameters in the order of AddUserParameters:
+	//6 coefficients, then mass and width of each Breit-Wigner
+	auto set_indexes = [](decltype(model)& pdf){
+
+		std::vector<hydra::Parameter*> variables;
+		pdf.AddUserParameters(variables);
+
+		for(size_t i=0; i<variables.size(); i++)
+			variables[i]->SetIndex(i);
+
+		return variables;
+	};
+
+	std::vector<hydra::Parameter*> variables = set_indexes(model);
+
+	std::vector<double> parameters;
+	for(auto variable: variables)
+		parameters.push_back(variable->GetValue());
+
+	SECTION( "normalization" )
+	{
+		REQUIRE( variables.size() == 10 );
+		REQUIRE( model.GetNormalizationCache().GetNumberOfUpdates() == 3 );
+
+		//the pdf averages to one over the normalization sample
+		double mean = hydra_thrust::transform_reduce(mc.begin(), mc.end(), model.GetFunctor(),
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum()/nentries;
+
+		REQUIRE( mean == Approx(1.0).epsilon(1.0e-10) );
+
+		double fractions = 0;
+		for(size_t i=0; i<3; i++) fractions += model.GetFitFraction(i);
+
+		REQUIRE( model.GetIntegral(0, 1) == hydra::conj(model.GetIntegral(1, 0)) );
+		REQUIRE( model.GetIntegral(2, 2).real() == Approx(1.0).epsilon(1.0e-12) );
+		REQUIRE( fractions > 0.0 );
+	}
+
+	SECTION( "incremental updates" )
+	{
+		//coefficients only: the normalization events are not evaluated again
+		parameters[3] = -0.4;
+		parameters[5] =  1.5;
+
+		model.SetParameters(parameters);
+
+		REQUIRE( model.GetNormalizationCache().GetNumberOfUpdates() == 3 );
+
+		auto fresh = hydra::make_coherent_sum(coefficients, mc, bw1, bw2, flat);
+
+		set_indexes(fresh);
+		fresh.SetParameters(parameters);
+
+		REQUIRE( model.GetNorm() == Approx(fresh.GetNorm()).epsilon(1.0e-12) );
+
+		//shape of the second resonance: only its column and row are recomputed
+		parameters[8] = 1.45;
+
+		model.SetParameters(parameters);
+		fresh.SetParameters(parameters);
+
+		REQUIRE( model.GetNormalizationCache().GetNumberOfUpdates() == 4 );
+		REQUIRE( model.GetNormalizationCache().IsUpdated(1) );
+		REQUIRE( !model.GetNormalizationCache().IsUpdated(0) );
+		REQUIRE( model.GetNorm() == Approx(fresh.GetNorm()).epsilon(1.0e-12) );
+		REQUIRE( model.GetIntegral(0, 1).real() == Approx(fresh.GetIntegral(0, 1).real()).epsilon(1.0e-12) );
+	}
+
+	SECTION( "log-likelihood from cached amplitudes" )
+	{
+		hydra::device::vector<Mass_arg> data(50000);
+
+		hydra::copy(hydra::random_range(hydra::UniformShape<Mass_arg>(0.0, 2.0), 159753, data.size()), data);
+
+		typedef typename decltype(model)::functor_type functor_type;
+
+		auto functor = model.GetFunctor();
+
+		typedef typename hydra_thrust::iterator_system<decltype(data.begin())>::type system_t;
+
+		hydra::detail::AmplitudeCache<system_t, 3> cache;
+
+		hydra::complex<double> const* columns = cache.Update(functor.GetFunctors(), data.begin(), data.end());
+
+		auto nll_cached = hydra::detail::LogLikelihoodAmplitudes<3>(columns, cache.GetNumberOfEntries(),
+				functor.GetCoefficients(), functor.GetInverseNorm());
+
+		auto nll_direct = hydra::detail::LogLikelihood1<functor_type>(functor);
+
+		double cached = hydra_thrust::transform_reduce(hydra_thrust::counting_iterator<size_t>(0),
+				hydra_thrust::counting_iterator<size_t>(data.size()), nll_cached,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		double direct = hydra_thrust::transform_reduce(data.begin(), data.end(), nll_direct,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		REQUIRE( cached == Approx(direct).epsilon(1.0e-12) );
+
+		//other events of the same size: all the columns are recomputed
+		hydra::device::vector<Mass_arg> other_data(data.size());
+
+		hydra::copy(hydra::random_range(hydra::UniformShape<Mass_arg>(0.0, 2.0), 357951, other_data.size()), other_data);
+
+		REQUIRE( cache.Update(functor.GetFunctors(), data.begin(), data.end()) == columns );
+		REQUIRE( cache.GetNumberOfUpdates() == 3 );
+
+		columns = cache.Update(functor.GetFunctors(), other_data.begin(), other_data.end());
+
+		REQUIRE( cache.GetNumberOfUpdates() == 6 );
+
+		nll_cached = hydra::detail::LogLikelihoodAmplitudes<3>(columns, cache.GetNumberOfEntries(),
+				functor.GetCoefficients(), functor.GetInverseNorm());
+
+		cached = hydra_thrust::transform_reduce(hydra_thrust::counting_iterator<size_t>(0),
+				hydra_thrust::counting_iterator<size_t>(other_data.size()), nll_cached,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		direct = hydra_thrust::transform_reduce(other_data.begin(), other_data.end(), nll_direct,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		REQUIRE( cached == Approx(direct).epsilon(1.0e-12) );
+	}
+}
@@ -0,0 +1,190 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * columnar.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cstdio>
+#include <string>
+#include <stdexcept>
+
+#include <hydra/multivector.h>
+#include <hydra/multiarray.h>
+#include <hydra/ColumnarFile.h>
+#include <hydra/ColumnarWriter.h>
+#include <hydra/Tuple.h>
+#include <hydra/Placeholders.h>
+#include <hydra/device/System.h>
+#include <hydra/host/System.h>
+#include <hydra/detail/external/hydra_thrust/equal.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+
+namespace columnar_test {
+
+inline void remove_dataset(std::string const& path, size_t ncolumns)
+{
+	std::remove(path.c_str());
+
+	for(size_t i=0; i<ncolumns; i++)
+		std::remove( (path + "." + std::to_string(i)).c_str() );
+}
+
+}  // namespace columnar_test
+
+TEST_CASE( "columnar file","hydra::ColumnarFile" ) {
+
+	using namespace hydra::placeholders;
+
+	typedef hydra::tuple<unsigned int, int, float, double> tuple_t;
+
+	typedef hydra::multivector<tuple_t, hydra::device::sys_t> table_d;
+
+	const std::string path = "hydra_columnar_test.hcol";
+	const size_t nrows = 10007;
+
+	table_d table(nrows);
+
+	for(size_t i=0; i< table.size(); i++ )
+		table[i] = hydra::make_tuple(i, -int(i), 0.5f*i, 0.25*i);
+
+	SECTION( "write, map and upload" )
+	{
+		{
+			//small buffer, so that the writer goes through several chunks
+			hydra::ColumnarWriter<tuple_t> writer(path, false, 1000);
+
+			writer.Append(table.begin(), table.begin() + 5000);
+			writer.Append(table[5000]);
+			writer.Append(table.begin() + 5001, table.end());
+
+			REQUIRE( writer.size() == nrows );
+		}
+
+		//the header is replaced by renaming the temporary file
+		REQUIRE_FALSE( hydra::detail::columnar::header_exists(path + ".tmp") );
+
+		hydra::ColumnarFile<tuple_t> file(path);
+
+		REQUIRE( file.size() == nrows );
+		REQUIRE( hydra_thrust::equal(file.begin(), file.end(), table.begin()) );
+
+		REQUIRE( file.begin(_3)[nrows-1] == Approx(0.25*(nrows-1)) );
+		REQUIRE( hydra_thrust::reduce(file.begin(_0), file.end(_0), size_t(0)) == nrows*(nrows-1)/2 );
+
+		table_d uploaded;
+
+		auto future = file.Upload(uploaded, 999);
+
+		REQUIRE( future.get() == nrows );
+		REQUIRE( uploaded.size() == nrows );
+		REQUIRE( hydra_thrust::equal(uploaded.begin(), uploaded.end(), table.begin()) );
+
+		//the upload outlives the file it was started from
+		table_d other(nrows);
+
+		{
+			hydra::ColumnarFile<tuple_t> moved(path);
+
+			future = moved.Upload(other.begin(), 100);
+
+			hydra::ColumnarFile<tuple_t> target(std::move(moved));
+
+			target.Close();
+		}
+
+		REQUIRE( future.get() == nrows );
+		REQUIRE( hydra_thrust::equal(other.begin(), other.end(), table.begin()) );
+
+		columnar_test::remove_dataset(path, 4);
+	}
+
+	SECTION( "append" )
+	{
+		{
+			hydra::ColumnarWriter<tuple_t> writer(path);
+
+			writer.Append(table.begin(), table.begin() + 3000);
+		}
+
+		{
+			hydra::ColumnarWriter<tuple_t> writer(path, true, 512);
+
+			REQUIRE( writer.size() == 3000 );
+
+			writer.Append(table.begin() + 3000, table.end());
+
+			//readable while the writer is open
+			writer.Flush();
+
+			hydra::ColumnarFile<tuple_t> partial(path);
+
+			REQUIRE( partial.size() == nrows );
+		}
+
+		hydra::ColumnarFile<tuple_t> file(path);
+
+		REQUIRE( file.size() == nrows );
+		REQUIRE( hydra_thrust::equal(file.begin(), file.end(), table.begin()) );
+
+		columnar_test::remove_dataset(path, 4);
+	}
+
+	SECTION( "multiarray and type signature" )
+	{
+		typedef hydra::multiarray<double, 3, hydra::device::sys_t> array_d;
+		typedef typename array_d::value_type value_t;
+
+		array_d data(nrows);
+
+		for(size_t i=0; i< data.size(); i++ )
+			data[i] = hydra::make_tuple(double(i), -double(i), 2.0*i);
+
+		{
+			hydra::ColumnarWriter<value_t> writer(path);
+
+			writer.Append(data);
+		}
+
+		hydra::ColumnarFile<value_t> file(path);
+
+		REQUIRE( hydra_thrust::equal(file.begin(), file.end(), data.begin()) );
+
+		array_d uploaded;
+
+		REQUIRE( file.Upload(uploaded).get() == nrows );
+		REQUIRE( hydra_thrust::equal(uploaded.begin(), uploaded.end(), data.begin()) );
+
+		//wrong element type and wrong number of columns
+		REQUIRE_THROWS_AS( (hydra::ColumnarFile<hydra::tuple<double, double, float>>(path)), std::runtime_error );
+		REQUIRE_THROWS_AS( (hydra::ColumnarFile<hydra::tuple<double, double>>(path)), std::runtime_error );
+		REQUIRE_THROWS_AS( (hydra::ColumnarWriter<hydra::tuple<int, double, double>>(path, true)), std::runtime_error );
+
+		columnar_test::remove_dataset(path, 3);
+	}
+
+}
@@ -0,0 +1,156 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * convolution.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+//the convolution tests need FFTW
+#if defined(HYDRA_TESTS_WITH_FFTW)
+
+#include <catch/catch.hpp>
+#include <cmath>
+
+#include <hydra/Function.h>
+#include <hydra/Convolution.h>
+#include <hydra/FFTW.h>
+#include <hydra/MemoryPool.h>
+#include <hydra/Placeholders.h>
+#include <hydra/functions/ConvolutionFunctor.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/device/System.h>
+
+namespace convolution_test {
+
+//largest difference between two convolutions over the range, relative to the maximum of the first one
+template<typename Convolution1, typename Convolution2>
+double max_difference(Convolution1 const& first, Convolution2 const& second)
+{
+	double diff = 0.0, max = 0.0;
+
+	for(double x=-3.0; x<3.0; x += 0.01){
+
+		diff = std::max(diff, std::fabs(first(x) - second(x)));
+		max  = std::max(max, std::fabs(first(x)));
+	}
+
+	return diff/max;
+}
+
+}  // namespace convolution_test
+
+TEST_CASE( "FFTW convolution","hydra::ConvolutionFunctor" ) {
+
+	using namespace hydra::placeholders;
+
+	auto mean  = hydra::Parameter::Create("C_mean").Value(0.5);
+	auto sigma = hydra::Parameter::Create("C_sigma").Value(0.3);
+	auto zero  = hydra::Parameter::Create("C_zero").Value(0.0);
+	auto width = hydra::Parameter::Create("C_width").Value(0.2);
+
+	hydra::Gaussian<double> signal(mean, sigma);
+	hydra::Gaussian<double> kernel(zero, width);
+
+	auto& cache = hydra::FFTWPlanCache::Instance();
+
+	SECTION( "cached plans" )
+	{
+		auto convolution = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+				signal, kernel, -4.0, 4.0, 512);
+
+		size_t misses = cache.GetMisses();
+		size_t hits   = cache.GetHits();
+
+		//same sizes: the plans are taken from the cache
+		auto other = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+				signal, kernel, -4.0, 4.0, 512);
+
+		REQUIRE( cache.GetMisses() == misses );
+		REQUIRE( cache.GetHits() > hits );
+		REQUIRE( convolution_test::max_difference(convolution, other) == 0.0 );
+
+		//planned again from scratch
+		cache.Clear();
+
+		auto replanned = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+				signal, kernel, -4.0, 4.0, 512);
+
+		REQUIRE( cache.GetMisses() > misses );
+		REQUIRE( convolution_test::max_difference(convolution, replanned) < 1.0e-12 );
+
+		convolution.Dispose();
+		other.Dispose();
+		replanned.Dispose();
+	}
+
+	SECTION( "buffers from the memory pool" )
+	{
+		auto& pool = hydra::memory_pool(hydra::device::sys);
+
+		size_t in_use = pool.GetBytesInUse();
+
+		auto convolution = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+				signal, kernel, -4.0, 4.0, 512);
+
+		REQUIRE( pool.GetBytesInUse() > in_use );
+
+		convolution.Dispose();
+
+		REQUIRE( pool.GetBytesInUse() == in_use );
+	}
+
+	SECTION( "spectra kept across updates" )
+	{
+		auto convolution = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+				signal, kernel, -4.0, 4.0, 512);
+
+		//only the signal changes, then only the kernel
+		for(size_t i : {0, 1}){
+
+			if( i == 0 ) convolution.GetFunctor(_0).SetParameter(1, 0.35);
+			else         convolution.GetFunctor(_1).SetParameter(1, 0.15);
+
+			convolution.Update();
+
+			hydra::Gaussian<double> new_signal(mean, sigma);
+			hydra::Gaussian<double> new_kernel(zero, width);
+
+			new_signal.SetParameter(1, 0.35);
+			if( i == 1 ) new_kernel.SetParameter(1, 0.15);
+
+			auto fresh = hydra::make_convolution<double>(hydra::device::sys, hydra::fft::fftw_f64,
+					new_signal, new_kernel, -4.0, 4.0, 512);
+
+			REQUIRE( convolution_test::max_difference(fresh, convolution) < 1.0e-12 );
+
+			fresh.Dispose();
+		}
+
+		convolution.Dispose();
+	}
+}
+
+#endif //HYDRA_TESTS_WITH_FFTW
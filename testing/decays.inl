@@ -0,0 +1,158 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * decays.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+
+#include <hydra/Vector4R.h>
+#include <hydra/PhaseSpace.h>
+#include <hydra/Decays.h>
+#include <hydra/Lambda.h>
+#include <hydra/device/System.h>
+#include <hydra/host/System.h>
+#include <hydra/detail/external/hydra_thrust/equal.h>
+
+declarg(Daughter1_arg, hydra::Vector4R)
+declarg(Daughter2_arg, hydra::Vector4R)
+declarg(Daughter3_arg, hydra::Vector4R)
+
+namespace decays_test {
+
+struct SameEvent
+{
+	template<typename T1, typename T2>
+	__hydra_host__ __hydra_device__
+	inline bool operator()(T1 a, T2 b) const
+	{
+		return same(hydra::get<0>(a), hydra::get<0>(b)) &&
+			   same(hydra::get<1>(a), hydra::get<1>(b)) &&
+			   same(hydra::get<2>(a), hydra::get<2>(b));
+	}
+
+	__hydra_host__ __hydra_device__
+	inline bool same(hydra::Vector4R const& p, hydra::Vector4R const& q) const
+	{
+		return p.get(0)==q.get(0) && p.get(1)==q.get(1) && p.get(2)==q.get(2) && p.get(3)==q.get(3);
+	}
+};
+
+}  // namespace decays_test
+
+TEST_CASE( "out-of-place unweighting of decays","hydra::Decays" ) {
+
+	using hydra::arguments::Daughter1_arg;
+	using hydra::arguments::Daughter2_arg;
+	using hydra::arguments::Daughter3_arg;
+
+	typedef hydra::tuple<Daughter1_arg, Daughter2_arg, Daughter3_arg> particles_t;
+
+	const double mother_mass = 5.279;
+	const double masses[3]{ 3.0969, 0.493677, 0.13957 };
+	const size_t ntrials = 100000;
+	const size_t seed    = 0x5eed;
+
+	hydra::Vector4R mother(mother_mass, 0.0, 0.0, 0.0);
+
+	hydra::PhaseSpace<3> phsp{mother_mass, masses};
+
+	hydra::Decays<particles_t, hydra::device::sys_t> events(mother_mass, masses, ntrials);
+
+	phsp.Generate(mother, events);
+
+	hydra::Decays<particles_t, hydra::device::sys_t> original(events);
+
+	auto dalitz_weight = hydra::wrap_lambda(
+			[] __hydra_dual__ (Daughter1_arg, Daughter2_arg b, Daughter3_arg c) {
+
+		double m2 = (b + c).mass2() - 0.8;
+
+		return 1.0/(m2*m2 + 0.01);
+	});
+
+	SECTION( "phase-space weight" )
+	{
+		hydra::Decays<particles_t, hydra::device::sys_t> in_place(events);
+
+		auto accepted = in_place.Unweight(seed);
+
+		hydra::Decays<particles_t, hydra::device::sys_t> output(mother_mass, masses);
+
+		auto range = events.Unweight(output, seed, 7777);
+
+		REQUIRE( range.size() > 0 );
+		REQUIRE( range.size() == accepted.size() );
+		REQUIRE( hydra_thrust::equal(range.begin(), range.end(), accepted.begin(), decays_test::SameEvent()) );
+
+		//the source is not modified
+		REQUIRE( hydra_thrust::equal(events.begin(), events.end(), original.begin(), decays_test::SameEvent()) );
+
+		//another back-end, appending to the existing content
+		hydra::Decays<particles_t, hydra::host::sys_t> host_output(mother_mass, masses);
+
+		events.Unweight(host_output, seed);
+		events.Unweight(host_output, seed, 1000);
+
+		hydra::Decays<particles_t, hydra::device::sys_t> copy(host_output);
+
+		REQUIRE( copy.size() == 2*accepted.size() );
+		REQUIRE( hydra_thrust::equal(accepted.begin(), accepted.end(), copy.begin(), decays_test::SameEvent()) );
+		REQUIRE( hydra_thrust::equal(accepted.begin(), accepted.end(), copy.begin() + accepted.size(), decays_test::SameEvent()) );
+
+		//streaming generation gives the same events, without storing the trials
+		hydra::Decays<particles_t, hydra::device::sys_t> streamed(mother_mass, masses);
+
+		phsp.GenerateUnweighted(hydra::device::sys, mother, ntrials, streamed, seed, 9999);
+
+		REQUIRE( streamed.size() == accepted.size() );
+		REQUIRE( hydra_thrust::equal(streamed.begin(), streamed.end(), accepted.begin(), decays_test::SameEvent()) );
+	}
+
+	SECTION( "phase-space weight times functor" )
+	{
+		hydra::Decays<particles_t, hydra::device::sys_t> in_place(events);
+
+		auto accepted = in_place.Unweight(dalitz_weight, -1.0, seed);
+
+		//maximum weight estimated from the stored weight column
+		hydra::Decays<particles_t, hydra::device::sys_t> output(mother_mass, masses);
+
+		auto range = events.Unweight(dalitz_weight, output, -1.0, seed, 3333);
+
+		REQUIRE( range.size() > 0 );
+		REQUIRE( range.size() == accepted.size() );
+		REQUIRE( hydra_thrust::equal(range.begin(), range.end(), accepted.begin(), decays_test::SameEvent()) );
+
+		hydra::Decays<particles_t, hydra::device::sys_t> streamed(mother_mass, masses);
+
+		phsp.GenerateUnweighted(hydra::device::sys, mother, ntrials, dalitz_weight, streamed, -1.0, seed, 9999);
+
+		REQUIRE( streamed.size() == accepted.size() );
+		REQUIRE( hydra_thrust::equal(streamed.begin(), streamed.end(), accepted.begin(), decays_test::SameEvent()) );
+	}
+}
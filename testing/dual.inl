@@ -0,0 +1,106 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * dual.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+
+#include <hydra/Dual.h>
+#include <hydra/Parameter.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/BreitWignerNR.h>
+#include <hydra/detail/FunctorTraits.h>
+#include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/device/System.h>
+#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+
+declarg(D_arg, double)
+
+TEST_CASE( "dual numbers","hydra::Dual" ) {
+
+	typedef hydra::Dual<double, 2> dual_t;
+
+	SECTION( "arithmetic and functions" )
+	{
+		dual_t x(2.0, 0), y(3.0, 1);
+
+		dual_t z = exp(x*y)/y + pow(x, 2.0) - sqrt(y);
+
+		REQUIRE( z.Value()      == Approx( std::exp(6.0)/3.0 + 4.0 - std::sqrt(3.0) ) );
+		REQUIRE( z.Derivative(0)== Approx( std::exp(6.0) + 4.0 ) );
+		REQUIRE( z.Derivative(1)== Approx( 2.0*std::exp(6.0)/3.0 - std::exp(6.0)/9.0 - 0.5/std::sqrt(3.0) ) );
+	}
+
+	SECTION( "functor derivatives with respect to the parameters" )
+	{
+		using hydra::arguments::D_arg;
+
+		REQUIRE( hydra::detail::is_differentiable_functor< hydra::Gaussian<D_arg> >::value );
+		REQUIRE_FALSE( hydra::detail::is_differentiable_functor< hydra::BreitWignerNR<D_arg> >::value );
+
+		auto mean  = hydra::Parameter::Create("mean").Value(0.5).Error(0.01);
+		auto sigma = hydra::Parameter::Create("sigma").Value(1.5).Error(0.01);
+
+		hydra::Gaussian<D_arg> gauss(mean, sigma);
+
+		dual_t par[2] = { dual_t(0.5, 0), dual_t(1.5, 1) };
+
+		const double x = 1.25;
+		const double g = std::exp(-(x-0.5)*(x-0.5)/(2.0*1.5*1.5));
+
+		dual_t value = gauss.CallWithParameters(&par[0], D_arg(x));
+
+		REQUIRE( value.Value()       == Approx( gauss(D_arg(x)) ) );
+		REQUIRE( value.Derivative(0) == Approx( g*(x-0.5)/(1.5*1.5) ) );
+		REQUIRE( value.Derivative(1) == Approx( g*(x-0.5)*(x-0.5)/(1.5*1.5*1.5) ) );
+
+		//sum of the log-derivatives over a dataset in the back-end
+		hydra::device::vector<D_arg> data(1001);
+
+		for(size_t i=0; i< data.size(); i++ ) data[i] = -3.0 + 6.0*i/1000.0;
+
+		auto functor = hydra::detail::LogLikelihoodGradient1< hydra::Gaussian<D_arg> >(gauss);
+
+		dual_t sums = hydra_thrust::transform_reduce(data.begin(), data.end(), functor,
+				dual_t(), hydra_thrust::plus<dual_t>());
+
+		double dmean = 0.0, dsigma = 0.0;
+
+		for(size_t i=0; i< data.size(); i++ ){
+
+			double xi = -3.0 + 6.0*i/1000.0;
+
+			dmean  += (xi-0.5)/(1.5*1.5);
+			dsigma += (xi-0.5)*(xi-0.5)/(1.5*1.5*1.5);
+		}
+
+		REQUIRE( sums.Derivative(0) == Approx(dmean) );
+		REQUIRE( sums.Derivative(1) == Approx(dsigma) );
+	}
+}
@@ -0,0 +1,113 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * functions.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+
+/*
+ * Every header in hydra/functions, in the same translation unit as
+ * hydra/Dual.h, so a math overload that hides ::exp etc. in namespace
+ * hydra fails here. DoubleExponential.h, GaussianResolutionModel.h,
+ * M12PhaseSpaceLineShape.h, M12SqPhaseSpaceLineShape.h and
+ * PlanesDeltaAngle.h are not buildable and are not included.
+ */
+#include <hydra/Dual.h>
+#include <hydra/detail/FunctorTraits.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Vector4R.h>
+#include <hydra/Complex.h>
+
+#include <hydra/functions/ArgusShape.h>
+#include <hydra/functions/BifurcatedGaussian.h>
+#include <hydra/functions/BlattWeisskopfFunctions.h>
+#include <hydra/functions/BreitWignerLineShape.h>
+#include <hydra/functions/BreitWignerNR.h>
+#include <hydra/functions/Chebychev.h>
+#include <hydra/functions/ChiSquare.h>
+#include <hydra/functions/ConvolutionFunctor.h>
+#include <hydra/functions/CosHelicityAngle.h>
+#include <hydra/functions/CrystalBallShape.h>
+#include <hydra/functions/Exponential.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/GaussianKDE.h>
+#include <hydra/functions/JohnsonSUShape.h>
+#include <hydra/functions/LogNormal.h>
+#include <hydra/functions/Math.h>
+#include <hydra/functions/Polynomial.h>
+#include <hydra/functions/SpilineFunctor.h>
+#include <hydra/functions/ThreeBodyMassThresholdBackground.h>
+#include <hydra/functions/TrapezoidalShape.h>
+#include <hydra/functions/TriangularShape.h>
+#include <hydra/functions/UniformShape.h>
+#include <hydra/functions/Utils.h>
+#include <hydra/functions/WignerDMatrix.h>
+#include <hydra/functions/ZemachFunctions.h>
+
+#if defined(__has_include)
+#if __has_include(<gsl/gsl_sf_gamma.h>) && __has_include(<gsl/gsl_sf_hyperg.h>)
+#include <hydra/functions/DeltaDMassBackground.h>
+#include <hydra/functions/GeneralizedGamma.h>
+#include <hydra/functions/Ipatia.h>
+#endif
+#endif
+
+declarg(F_arg, double)
+
+TEST_CASE( "functions next to dual numbers","hydra::functions" ) {
+
+	using hydra::arguments::F_arg;
+
+	auto mean   = hydra::Parameter::Create("mean").Value(0.5).Error(0.01);
+	auto sigma  = hydra::Parameter::Create("sigma").Value(1.5).Error(0.01);
+	auto sigma2 = hydra::Parameter::Create("sigma2").Value(0.5).Error(0.01);
+	auto alpha  = hydra::Parameter::Create("alpha").Value(1.0).Error(0.01);
+	auto n      = hydra::Parameter::Create("n").Value(2.0).Error(0.01);
+	auto tau    = hydra::Parameter::Create("tau").Value(0.7).Error(0.01);
+
+	const double x = 1.25;
+
+	hydra::CrystalBallShape<F_arg> crystal_ball(mean, sigma, alpha, n);
+	hydra::BifurcatedGaussian<F_arg> bifurcated(mean, sigma, sigma2);
+	hydra::Exponential<F_arg> exponential(tau);
+
+	REQUIRE( crystal_ball(F_arg(x)) == Approx( std::exp(-0.5*(x-0.5)*(x-0.5)/(1.5*1.5)) ) );
+	REQUIRE( bifurcated(F_arg(x))   == Approx( std::exp(-0.5*(x-0.5)*(x-0.5)/(0.5*0.5)) ) );
+	REQUIRE( bifurcated(F_arg(0.0)) == Approx( std::exp(-0.5*0.5*0.5/(1.5*1.5)) ) );
+	REQUIRE( exponential(F_arg(x))  == Approx( std::exp(-0.7*x) ) );
+
+	//the Dual overloads are still found for dual arguments
+	hydra::Dual<double, 1> par[1] = { hydra::Dual<double, 1>(0.7, 0) };
+
+	auto value = exponential.CallWithParameters(&par[0], F_arg(x));
+
+	REQUIRE( value.Value()       == Approx( std::exp(-0.7*x) ) );
+	REQUIRE( value.Derivative(0) == Approx( -x*std::exp(-0.7*x) ) );
+}
@@ -0,0 +1,295 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * histogram.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <hydra/DenseHistogram.h>
+#include <hydra/SparseHistogram.h>
+#include <hydra/multivector.h>
+#include <hydra/Tuple.h>
+#include <hydra/device/System.h>
+#include <hydra/detail/external/hydra_thrust/sequence.h>
+#include <hydra/detail/external/hydra_thrust/reduce.h>
+#include <hydra/host/System.h>
+
+TEST_CASE( "DenseHistogram","hydra::DenseHistogram" ) {
+
+	const size_t nentries = 100000;
+
+	//deterministic samples covering the range, underflow and overflow
+	std::vector<double> x_h(nentries);
+	std::vector<double> w_h(nentries);
+
+	for(size_t i=0; i<nentries; i++){
+		x_h[i] = -1.0 + 12.0*double((i*7919)%nentries)/nentries;
+		w_h[i] = 0.5 + (i%3);
+	}
+
+	hydra::device::vector<double> x_d(x_h.begin(), x_h.end());
+	hydra::device::vector<double> w_d(w_h.begin(), w_h.end());
+
+	//reference contents: bins + underflow + overflow
+	std::vector<double> counts(12, 0.0), weights(12, 0.0);
+
+	for(size_t i=0; i<nentries; i++){
+
+		size_t bin = x_h[i] < 0.0 ? 10 : ( x_h[i] >= 10.0 ? 11 : size_t(x_h[i]) );
+		counts[bin]  += 1.0;
+		weights[bin] += w_h[i];
+	}
+
+	SECTION( "1D unweighted fill" )
+	{
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist(10, 0.0, 10.0);
+
+		hist.Fill(x_d.begin(), x_d.end());
+
+		for(size_t i=0; i<12; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(counts[i]) );
+	}
+
+	SECTION( "1D weighted fill" )
+	{
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist(10, 0.0, 10.0);
+
+		hist.Fill(x_d.begin(), x_d.end(), w_d.begin());
+
+		for(size_t i=0; i<12; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(weights[i]) );
+	}
+
+	SECTION( "1D accumulated fill" )
+	{
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist(10, 0.0, 10.0);
+
+		hist.SetAccumulate(true);
+
+		hist.Fill(x_d.begin(), x_d.begin() + nentries/3, w_d.begin());
+		hist.Fill(x_d.begin() + nentries/3, x_d.end(), w_d.begin() + nentries/3);
+
+		for(size_t i=0; i<12; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(weights[i]) );
+
+		hist.SetAccumulate(false);
+		hist.Fill(x_d.begin(), x_d.end());
+
+		for(size_t i=0; i<12; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(counts[i]) );
+	}
+
+	SECTION( "1D chunked fill" )
+	{
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist(10, 0.0, 10.0);
+
+		hydra::device::vector<double> buffer(999);
+		hydra::device::vector<double> wbuffer(999);
+
+		size_t position = 0;
+
+		hist.Fill( [&](hydra::device::vector<double>::iterator first,
+				hydra::device::vector<double>::iterator wfirst, size_t capacity){
+
+			size_t n = std::min(capacity, nentries - position);
+
+			hydra_thrust::copy(x_d.begin() + position, x_d.begin() + position + n, first);
+			hydra_thrust::copy(w_d.begin() + position, w_d.begin() + position + n, wfirst);
+
+			position += n;
+
+			return n;
+		}, buffer, wbuffer);
+
+		for(size_t i=0; i<12; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(weights[i]) );
+
+		REQUIRE_FALSE( hist.IsAccumulating() );
+
+		//the accumulation setting survives a failing generator
+		REQUIRE_THROWS_AS( hist.Fill( [](hydra::device::vector<double>::iterator, size_t) -> size_t {
+
+			throw std::runtime_error("generator");
+		}, buffer), std::runtime_error );
+
+		REQUIRE_FALSE( hist.IsAccumulating() );
+
+		//the weights of a chunk need to fit
+		hydra::device::vector<double> small(10);
+
+		REQUIRE_THROWS_AS( hist.Fill( [](hydra::device::vector<double>::iterator,
+				hydra::device::vector<double>::iterator, size_t){ return size_t(0); }, buffer, small),
+				std::invalid_argument );
+	}
+
+	SECTION( "2D fill" )
+	{
+		hydra::multivector<hydra::tuple<double,double>, hydra::device::sys_t> data(nentries);
+
+		for(size_t i=0; i<nentries; i++)
+			data[i] = hydra::make_tuple( 0.5 + 9.0*double((i*7919)%nentries)/nentries,
+					0.5 + 9.0*double((i*104729)%nentries)/nentries );
+
+		hydra::DenseHistogram<double, 2, hydra::device::sys_t> hist( {10, 10}, {0.0, 0.0}, {10.0, 10.0});
+
+		hist.Fill(data.begin(), data.end());
+
+		std::vector<double> reference(102, 0.0);
+
+		for(size_t i=0; i<nentries; i++){
+			double x = hydra::get<0>(data[i]);
+			double y = hydra::get<1>(data[i]);
+			reference[ size_t(x)*10 + size_t(y) ] += 1.0;
+		}
+
+		double total = 0.0;
+
+		for(size_t i=0; i<100; i++){
+			REQUIRE( hist.GetBinContent(i) == Approx(reference[i]) );
+			total += hist.GetBinContent(i);
+		}
+
+		REQUIRE( total == Approx(nentries) );
+	}
+
+	SECTION( "1D fill above the private scratch limit" )
+	{
+		//one private copy of the bins, plus under- and overflow, does not fit
+		const size_t nbins = HYDRA_HISTOGRAM_MAX_PRIVATE_BYTES/sizeof(hydra::detail::CompensatedSum<double>);
+
+		REQUIRE( hydra::detail::histogram_fill_slots<hydra::device::sys_t>(nentries, 12) > 0 );
+		REQUIRE( hydra::detail::histogram_fill_slots<hydra::device::sys_t>(nentries, nbins + 2) == 0 );
+		REQUIRE_FALSE( hydra::detail::use_privatized_histogram_fill<hydra::device::sys_t>(nbins + 2, nentries) );
+
+		//each entry in its own bin
+		std::vector<double> y_h(nentries);
+
+		for(size_t i=0; i<nentries; i++)
+			y_h[i] = double( ((i*7919)%nentries)*(nbins/nentries) ) + 0.5;
+
+		hydra::device::vector<double> y_d(y_h.begin(), y_h.end());
+
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist(nbins, 0.0, double(nbins));
+
+		hist.Fill(y_d.begin(), y_d.end(), w_d.begin());
+
+		for(size_t i=0; i<nentries; i+=997)
+			REQUIRE( hist.GetBinContent( size_t(y_h[i]) ) == Approx(w_h[i]) );
+
+		double total = hydra_thrust::reduce(hist.GetBinsContents().begin(), hist.GetBinsContents().end(), 0.0);
+
+		REQUIRE( total == Approx( std::accumulate(w_h.begin(), w_h.end(), 0.0) ) );
+	}
+}
+
+TEST_CASE( "SparseHistogram","hydra::SparseHistogram" ) {
+
+	const size_t nentries = 10000;
+
+	hydra::multivector<hydra::tuple<double,double>, hydra::device::sys_t> data(nentries);
+
+	for(size_t i=0; i<nentries; i++)
+		data[i] = hydra::make_tuple( 0.5 + 9.0*double((i*7919)%nentries)/nentries,
+				0.5 + 9.0*double((i*104729)%nentries)/nentries );
+
+	std::vector<double> reference(100, 0.0);
+
+	for(size_t i=0; i<nentries; i++)
+		reference[ size_t(hydra::get<0>(data[i]))*10 + size_t(hydra::get<1>(data[i])) ] += 1.0;
+
+	SECTION( "accumulated fill merges the bins" )
+	{
+		hydra::SparseHistogram<double, 2, hydra::device::sys_t> hist( {10, 10}, {0.0, 0.0}, {10.0, 10.0});
+
+		hist.SetAccumulate(true);
+
+		hist.Fill(data.begin(), data.begin() + nentries/4);
+		hist.Fill(data.begin() + nentries/4, data.end());
+
+		for(size_t i=0; i<100; i++)
+			REQUIRE( hist.GetBinContent(i) == Approx(reference[i]) );
+
+		REQUIRE( hydra_thrust::is_sorted(hist.GetBins().begin(), hist.GetBins().end()) );
+	}
+
+	SECTION( "single and batched bin lookup" )
+	{
+		hydra::SparseHistogram<double, 2, hydra::device::sys_t> hist( {10, 10}, {0.0, 0.0}, {10.0, 10.0});
+
+		hist.Fill(data.begin(), data.begin() + nentries/100);
+
+		std::vector<double> partial(102, 0.0);
+
+		for(size_t i=0; i<nentries/100; i++)
+			partial[ size_t(hydra::get<0>(data[i]))*10 + size_t(hydra::get<1>(data[i])) ] += 1.0;
+
+		hydra::device::vector<size_t> bins(102);
+		hydra_thrust::sequence(bins.begin(), bins.end());
+
+		hydra::device::vector<double> contents = hist.GetBinContents(bins);
+
+		for(size_t i=0; i<102; i++){
+			REQUIRE( hist.GetBinContent(i) == Approx(partial[i]) );
+			REQUIRE( contents[i] == Approx(partial[i]) );
+		}
+	}
+
+	SECTION( "1D bin lookup" )
+	{
+		hydra::device::vector<double> x(nentries);
+
+		for(size_t i=0; i<nentries; i++)
+			x[i] = 2.0*hydra::get<0>(data[i]);
+
+		hydra::SparseHistogram<double, 1, hydra::device::sys_t> hist( 20, 0.0, 20.0);
+
+		hist.Fill(x.begin(), x.end());
+
+		std::vector<double> counts(22, 0.0);
+
+		for(size_t i=0; i<nentries; i++)
+			counts[ size_t(x[i]) ] += 1.0;
+
+		std::vector<size_t> bins(22);
+		std::vector<double> contents(22);
+
+		for(size_t i=0; i<22; i++) bins[i] = i;
+
+		hist.GetBinContents(bins.begin(), bins.end(), contents.begin());
+
+		for(size_t i=0; i<22; i++){
+			REQUIRE( hist.GetBinContent(i) == Approx(counts[i]) );
+			REQUIRE( contents[i] == Approx(counts[i]) );
+		}
+	}
+}
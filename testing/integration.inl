@@ -0,0 +1,443 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * integration.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+
+#include <hydra/Lambda.h>
+#include <hydra/Plain.h>
+#include <hydra/Vegas.h>
+#include <hydra/Parameter.h>
+#include <hydra/GaussKronrodAdaptiveQuadrature.h>
+#include <hydra/GenzMalikQuadrature.h>
+#include <hydra/GaussKronrodQuadrature.h>
+#include <hydra/TabulatedIntegral.h>
+#include <hydra/functions/CrystalBallShape.h>
+#include <hydra/VegasState.h>
+#include <hydra/ScrambledSobol.h>
+#include <hydra/device/System.h>
+#include <hydra/host/System.h>
+#include <hydra/detail/functors/ProcessCallsVegas.h>
+#include <hydra/detail/functors/FillPrivateHistogram.h>
+#include <hydra/detail/external/hydra_thrust/transform.h>
+#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+#include <hydra/detail/external/hydra_thrust/iterator/counting_iterator.h>
+
+TEST_CASE( "quasi-Monte Carlo integration","hydra::Plain and hydra::Vegas" ) {
+
+	//exp(-x-y-z) over the unit cube
+	auto integrand = hydra::wrap_lambda( [] __hydra_dual__ (double x, double y, double z) {
+
+		return ::exp(-x - y - z);
+	});
+
+	const double exact = ::pow(1.0 - ::exp(-1.0), 3);
+
+	const size_t calls = 1<<16;
+
+	std::array<double, 3> min{ 0.0, 0.0, 0.0 };
+	std::array<double, 3> max{ 1.0, 1.0, 1.0 };
+
+	SECTION( "plain" )
+	{
+		hydra::Plain<3, hydra::device::sys_t> mc(min, max, calls);
+
+		auto mc_result = mc.Integrate(integrand);
+
+		for(auto mode : {hydra::QMC_DIGITAL_SHIFT, hydra::QMC_OWEN}){
+
+			hydra::Plain<3, hydra::device::sys_t> qmc(min, max, calls);
+
+			qmc.SetQMC(mode);
+
+			auto result = qmc.Integrate(integrand);
+
+			REQUIRE( result.second > 0.0 );
+			REQUIRE( result.second < mc_result.second );
+			REQUIRE( std::fabs(result.first - exact) < 5.0*result.second );
+		}
+
+		REQUIRE_THROWS_AS( mc.SetQMC(hydra::QMC_OWEN, 1), std::invalid_argument );
+	}
+
+	SECTION( "vegas" )
+	{
+		hydra::VegasState<3, hydra::device::sys_t> state(min, max);
+		state.SetVerbose(-2);
+		state.SetIterations(5);
+		state.SetTrainingIterations(1);
+		state.SetCalls(calls);
+		state.SetTrainingCalls(calls/8);
+
+		hydra::Vegas<3, hydra::device::sys_t> mc(state);
+
+		auto mc_result = mc.Integrate(integrand);
+
+		REQUIRE( std::fabs(mc_result.first - exact) < 5.0*mc_result.second );
+
+		for(auto mode : {hydra::QMC_DIGITAL_SHIFT, hydra::QMC_OWEN}){
+
+			hydra::Vegas<3, hydra::device::sys_t> qmc(state);
+
+			qmc.SetQMC(mode);
+
+			auto result = qmc.Integrate(integrand);
+
+			REQUIRE( result.second > 0.0 );
+			REQUIRE( result.second < mc_result.second );
+			REQUIRE( std::fabs(result.first - exact) < 5.0*result.second );
+
+			//the iterations are independent estimates
+			REQUIRE( qmc.GetState().GetChiSquare() < 5.0 );
+		}
+
+		REQUIRE_THROWS_AS( mc.SetQMC(hydra::QMC_OWEN, 7, 1), std::invalid_argument );
+	}
+}
+
+TEST_CASE( "vegas grid distribution","hydra::detail::ProcessSlotsVegas" ) {
+
+	//exp(-x-y-z) over the unit cube
+	auto integrand = hydra::wrap_lambda( [] __hydra_dual__ (double x, double y, double z) {
+
+		return ::exp(-x - y - z);
+	});
+
+	const size_t calls = 1<<16;
+
+	std::array<double, 3> min{ 0.0, 0.0, 0.0 };
+	std::array<double, 3> max{ 1.0, 1.0, 1.0 };
+
+	typedef hydra::device::vector<double>::iterator  real_iterator;
+	typedef hydra::device::vector<hydra::GUInt_t>::iterator uint_iterator;
+	typedef hydra::detail::ProcessCallsVegas<decltype(integrand), 3, hydra::device::sys_t,
+			real_iterator, uint_iterator> process_calls_t;
+
+	hydra::VegasState<3, hydra::device::sys_t> state(min, max);
+	state.SetVerbose(-2);
+	state.SetIterations(2);
+	state.SetTrainingIterations(1);
+	state.SetCalls(calls/4);
+	state.SetTrainingCalls(calls/8);
+
+	hydra::Vegas<3, hydra::device::sys_t> vegas(state);
+
+	vegas.Integrate(integrand);
+
+	auto& trained = vegas.GetState();
+	trained.CopyStateToDevice();
+
+	const size_t ncalls = trained.GetCalls(false);
+	const size_t ndist  = 3*trained.GetNBins();
+
+	hydra::detail::ResultVegas init = hydra::detail::ResultVegas();
+
+	//one (key, value) pair per call and dimension, summed by key
+	hydra::device::vector<hydra::GUInt_t> keys(3*ncalls), keys_output(3*ncalls);
+	hydra::device::vector<double>  values(3*ncalls), values_output(3*ncalls);
+
+	process_calls_t process_calls(ncalls, trained, keys.begin(), values.begin(), integrand);
+
+	auto by_key = hydra_thrust::transform_reduce(hydra::device::sys,
+			hydra_thrust::counting_iterator<size_t>(0), hydra_thrust::counting_iterator<size_t>(ncalls),
+			process_calls, init, hydra::detail::ProcessBoxesVegas());
+
+	std::vector<double> distribution_by_key(ndist, 0.0);
+
+	hydra::detail::reduce_vegas_distribution(hydra::device::sys, keys.begin(), keys.end(), values.begin(),
+			keys_output.begin(), values_output.begin(), distribution_by_key);
+
+	//private copies of the distribution, one per slot, merged afterwards
+	const size_t nslots = 7;
+
+	hydra::device::vector<double> slots(nslots*ndist, 0.0);
+
+	auto privatized = hydra_thrust::transform_reduce(hydra::device::sys,
+			hydra_thrust::counting_iterator<size_t>(0), hydra_thrust::counting_iterator<size_t>(nslots),
+			hydra::detail::ProcessSlotsVegas<process_calls_t, 3>(process_calls, 0, ncalls, nslots, ndist,
+					hydra_thrust::raw_pointer_cast(slots.data())),
+			init, hydra::detail::ProcessBoxesVegas());
+
+	hydra::host::vector<double> merged(slots);
+	std::vector<double> distribution(ndist, 0.0);
+
+	hydra_thrust::transform(hydra_thrust::counting_iterator<size_t>(0), hydra_thrust::counting_iterator<size_t>(ndist),
+			distribution.begin(), distribution.begin(),
+			hydra::detail::MergePrivateHistograms<>(hydra_thrust::raw_pointer_cast(merged.data()), nslots, ndist));
+
+	REQUIRE( privatized.fN == by_key.fN );
+	REQUIRE( privatized.fMean == Approx(by_key.fMean).epsilon(1.0e-12) );
+
+	bool all_match = true;
+
+	for(size_t i=0; i<ndist; i++)
+		all_match &= distribution[i] == Approx(distribution_by_key[i]).epsilon(1.0e-12);
+
+	REQUIRE( all_match );
+}
+
+TEST_CASE( "adaptive Gauss-Kronrod quadrature","hydra::GaussKronrodAdaptiveQuadrature" ) {
+
+	const double min = 0.0;
+	const double max = 10.0;
+	const double tolerance = 1.0e-8;
+
+	//narrow Lorentzian, peaked at x0 with half width g
+	auto make_peak = [](double x0, double g){
+
+		auto position = hydra::Parameter::Create("x0").Value(x0);
+		auto width    = hydra::Parameter::Create("g").Value(g);
+
+		return hydra::wrap_lambda( [] __hydra_dual__ (size_t n, const hydra::Parameter* pars, double x) {
+
+			double x0 = pars[0];
+			double g  = pars[1];
+
+			return g/((x - x0)*(x - x0) + g*g);
+		}, position, width);
+	};
+
+	auto exact = [=](double x0, double g){ return ::atan((max - x0)/g) + ::atan((x0 - min)/g); };
+
+	SECTION( "peaked integrand" )
+	{
+		//three narrow peaks, refined in the same passes when several nodes are split
+		auto peaks = hydra::wrap_lambda( [] __hydra_dual__ (double x) {
+
+			double g = 1.0e-3;
+
+			return g/((x - 2.1)*(x - 2.1) + g*g) + g/((x - 5.3)*(x - 5.3) + g*g) + g/((x - 8.7)*(x - 8.7) + g*g);
+		});
+
+		const double expected = exact(2.1, 1.0e-3) + exact(5.3, 1.0e-3) + exact(8.7, 1.0e-3);
+
+		hydra::GaussKronrodAdaptiveQuadrature<61, 10, hydra::device::sys_t> one_split(min, max, tolerance, 1);
+		hydra::GaussKronrodAdaptiveQuadrature<61, 10, hydra::device::sys_t> multi_split(min, max, tolerance);
+
+		auto one   = one_split.Integrate(peaks);
+		auto multi = multi_split.Integrate(peaks);
+
+		for(auto result : {one, multi}){
+
+			REQUIRE( result.second < tolerance*result.first );
+			REQUIRE( result.first == Approx(expected).epsilon(tolerance) );
+		}
+
+		REQUIRE( multi_split.GetIterationNumber() < one_split.GetIterationNumber() );
+
+		//a single peak
+		auto peak = make_peak(3.3, 1.0e-3);
+
+		auto result = multi_split.Integrate(peak);
+
+		REQUIRE( result.second < tolerance*result.first );
+		REQUIRE( result.first == Approx(exact(3.3, 1.0e-3)).epsilon(tolerance) );
+	}
+
+	SECTION( "batch of integrals" )
+	{
+		std::vector<decltype(make_peak(0.0, 1.0))> peaks;
+
+		for(size_t i=0; i<5; i++)
+			peaks.push_back( make_peak(1.0 + 1.7*i, 1.0e-3*(i + 1)) );
+
+		hydra::GaussKronrodAdaptiveQuadrature<61, 10, hydra::device::sys_t> quadrature(min, max, tolerance);
+
+		auto results = quadrature.Integrate(peaks.begin(), peaks.end());
+
+		REQUIRE( results.size() == peaks.size() );
+
+		for(size_t i=0; i<peaks.size(); i++){
+
+			auto single = quadrature.Integrate(peaks[i]);
+
+			REQUIRE( results[i].first  == single.first );
+			REQUIRE( results[i].second == single.second );
+			REQUIRE( results[i].first == Approx(exact(1.0 + 1.7*i, 1.0e-3*(i + 1))).epsilon(tolerance) );
+		}
+	}
+}
+
+TEST_CASE( "adaptive Genz-Malik quadrature","hydra::GenzMalikQuadrature" ) {
+
+	const double sigma = 0.05;
+
+	//narrow normalized Gaussian in the unit cube
+	auto gaussian = hydra::wrap_lambda( [=] __hydra_dual__ (double x, double y, double z) {
+
+		double r2 = (x - 0.3)*(x - 0.3) + (y - 0.45)*(y - 0.45) + (z - 0.6)*(z - 0.6);
+
+		return ::exp(-r2/(2.0*sigma*sigma))/::pow(::sqrt(2.0*PI)*sigma, 3);
+	});
+
+	auto fraction_inside = [=](double mean){
+
+		return 0.5*(::erf((1.0 - mean)/(::sqrt(2.0)*sigma)) + ::erf(mean/(::sqrt(2.0)*sigma)));
+	};
+
+	const double exact = fraction_inside(0.3)*fraction_inside(0.45)*fraction_inside(0.6);
+
+	std::array<double, 3> min{ 0.0, 0.0, 0.0 };
+	std::array<double, 3> max{ 1.0, 1.0, 1.0 };
+	std::array<size_t, 3> grid{ 4, 4, 4 };
+
+	hydra::GenzMalikQuadrature<3, hydra::device::sys_t> quadrature(min, max, grid, 0.25, 1.0e-5);
+
+	auto result = quadrature.Integrate(gaussian);
+
+	REQUIRE( result.second < 1.0e-5*result.first );
+	REQUIRE( result.first == Approx(exact).epsilon(1.0e-5) );
+
+	//the boxes are split over several iterations, all reported
+	REQUIRE( quadrature.GetNumberOfIterations() > 1 );
+	REQUIRE( quadrature.GetIterationTimes().size() == quadrature.GetNumberOfIterations() );
+	REQUIRE( quadrature.GetNumberOfBoxes() > 64 );
+	REQUIRE( quadrature.GetBoxesPerSecond() > 0.0 );
+
+	//the copies keep the settings and give the same result
+	hydra::GenzMalikQuadrature<3, hydra::host::sys_t> copy(quadrature);
+
+	REQUIRE( copy.GetRelativeError() == quadrature.GetRelativeError() );
+	REQUIRE( copy.GetFraction() == quadrature.GetFraction() );
+
+	auto copy_result = copy.Integrate(gaussian);
+
+	REQUIRE( copy_result.first == Approx(result.first).epsilon(1.0e-12) );
+	REQUIRE( copy.GetNumberOfBoxes() == quadrature.GetNumberOfBoxes() );
+}
+
+TEST_CASE( "tabulated integral","hydra::TabulatedIntegral" ) {
+
+	const double tolerance = 1.0e-6;
+
+	auto mean  = hydra::Parameter::Create("T_mean").Value(5.28);
+	auto sigma = hydra::Parameter::Create("T_sigma").Value(0.01);
+	auto alpha = hydra::Parameter::Create("T_alpha").Value(1.5);
+	auto n     = hydra::Parameter::Create("T_n").Value(2.0);
+
+	hydra::CrystalBallShape<double> shape(mean, sigma, alpha, n);
+
+	hydra::GaussKronrodQuadrature<61, 100, hydra::device::sys_t> quadrature(5.2, 5.36);
+
+	//mean and sigma tabulated
+	hydra::TabulatedIntegral<decltype(quadrature), 2> tabulated(quadrature,
+			{{0, 1}}, {{5.25, 0.008}}, {{5.31, 0.014}}, {{13, 13}}, tolerance);
+
+	SECTION( "interpolation within the tolerance" )
+	{
+		bool all_match = true;
+
+		for(double m=5.2513; m<5.31; m += 0.0027)
+			for(double s=0.00805; s<0.014; s += 0.00037){
+
+				shape.SetParameter(0, m);
+				shape.SetParameter(1, s);
+
+				double value    = tabulated.Integrate(shape).first;
+				double expected = quadrature.Integrate(shape).first;
+
+				all_match &= std::fabs(value - expected) <= tolerance*std::fabs(expected);
+			}
+
+		REQUIRE( all_match );
+		REQUIRE( tabulated.GetNumberOfInterpolations() > 0 );
+		REQUIRE( tabulated.GetNumberOfNodes() <= 13*13 );
+	}
+
+	SECTION( "fallbacks and other parameters" )
+	{
+		shape.SetParameter(0, 5.2712);
+		shape.SetParameter(1, 0.0101);
+
+		tabulated.Integrate(shape);
+
+		size_t nodes = tabulated.GetNumberOfNodes();
+		size_t fallbacks = tabulated.GetNumberOfFallbacks();
+
+		REQUIRE( nodes > 0 );
+
+		//outside the grid: the integrator is called
+		shape.SetParameter(1, 0.02);
+
+		REQUIRE( tabulated.Integrate(shape).first == quadrature.Integrate(shape).first );
+		REQUIRE( tabulated.GetNumberOfFallbacks() == fallbacks + 1 );
+		REQUIRE( tabulated.GetNumberOfNodes() == nodes );
+
+		//an untabulated parameter changes: the table is rebuilt
+		shape.SetParameter(1, 0.0101);
+		shape.SetParameter(2, 1.2);
+
+		REQUIRE( tabulated.Integrate(shape).first == Approx(quadrature.Integrate(shape).first).epsilon(tolerance) );
+		REQUIRE( tabulated.GetNumberOfNodes() <= nodes );
+
+		REQUIRE_THROWS_AS( (hydra::TabulatedIntegral<decltype(quadrature), 1>(quadrature, {{0}}, {{5.25}}, {{5.31}}, {{1}})),
+				std::invalid_argument );
+	}
+
+	SECTION( "untabulated parameter changing at every call" )
+	{
+		shape.SetParameter(0, 5.2712);
+		shape.SetParameter(1, 0.0101);
+
+		bool all_match = true;
+
+		for(size_t i=0; i<HYDRA_TABULATED_INTEGRAL_MAX_REBUILDS + 3; i++){
+
+			shape.SetParameter(2, 1.2 + 0.05*i);
+
+			double value    = tabulated.Integrate(shape).first;
+			double expected = quadrature.Integrate(shape).first;
+
+			all_match &= std::fabs(value - expected) <= tolerance*std::fabs(expected);
+		}
+
+		//each table served one call: the integrator is called directly
+		REQUIRE( all_match );
+		REQUIRE( tabulated.IsBypassed() );
+		REQUIRE( tabulated.GetNumberOfNodes() == 0 );
+
+		size_t fallbacks = tabulated.GetNumberOfFallbacks();
+
+		REQUIRE( tabulated.Integrate(shape).first == quadrature.Integrate(shape).first );
+		REQUIRE( tabulated.GetNumberOfFallbacks() == fallbacks + 1 );
+		REQUIRE( tabulated.GetNumberOfNodes() == 0 );
+
+		//the tabulation resumes
+		tabulated.Reset();
+
+		REQUIRE_FALSE( tabulated.IsBypassed() );
+
+		tabulated.Integrate(shape);
+
+		REQUIRE( tabulated.GetNumberOfNodes() > 0 );
+	}
+}
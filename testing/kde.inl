@@ -0,0 +1,155 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * kde.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <hydra/functions/GaussianKDE.h>
+#include <hydra/device/System.h>
+
+#if defined(HYDRA_TESTS_WITH_FFTW)
+#include <hydra/FFTW.h>
+#endif
+
+declarg(KDE_arg, double)
+
+namespace kde_test {
+
+/*
+ * Largest difference between two KDEs at the spline nodes,
+ * relative to the maximum of the first one.
+ */
+template<typename KDE1, typename KDE2>
+double max_difference(KDE1 const& kde1, KDE2 const& kde2)
+{
+	double diff = 0.0, max = 0.0;
+
+	for(size_t i=0; i<64; i++){
+
+		double x  = kde1.GetSpiline().GetX()[i];
+		double f1 = kde1.GetSpiline().GetD()[i];
+		double f2 = kde2.GetSpiline().GetD()[i];
+
+		REQUIRE( kde2.GetSpiline().GetX()[i] == Approx(x) );
+
+		diff = std::max(diff, std::fabs(f1 - f2));
+		max  = std::max(max, f1);
+	}
+
+	return diff/max;
+}
+
+}  // namespace kde_test
+
+TEST_CASE( "kernel density estimation","hydra::GaussianKDE" ) {
+
+	using hydra::arguments::KDE_arg;
+
+	typedef hydra::GaussianKDE<64, KDE_arg> kde_t;
+
+	const double min = -4.0;
+	const double max =  4.0;
+	const double h   =  0.25;
+
+	std::mt19937 engine(1234);
+	std::normal_distribution<double> gauss(0.0, 1.0);
+
+	std::vector<double> sample(20000);
+
+	for(auto& x : sample) x = gauss(engine);
+
+	hydra::device::vector<double> data(sample.begin(), sample.end());
+
+	kde_t direct(hydra::device::sys, min, max, h, data.begin(), data.end());
+
+	SECTION( "direct sum" )
+	{
+		for(size_t i=0; i<64; i+=7){
+
+			double x   = direct.GetSpiline().GetX()[i];
+			double sum = 0.0;
+
+			for(auto s : sample) sum += std::exp(-0.5*(x-s)*(x-s)/(h*h));
+
+			REQUIRE( direct.GetSpiline().GetD()[i] == Approx( sum/(std::sqrt(2.0*M_PI)*h*sample.size()) ) );
+		}
+	}
+
+#if defined(HYDRA_TESTS_WITH_FFTW)
+
+	SECTION( "binned estimate against the direct sum" )
+	{
+		kde_t binned(hydra::device::sys, hydra::fft::fftw_f64, min, max, h, data.begin(), data.end());
+
+		REQUIRE( kde_test::max_difference(direct, binned) < 5.0e-4 );
+	}
+
+	SECTION( "binned adaptive estimate against the direct sum" )
+	{
+		kde_t direct_adaptive(hydra::device::sys, min, max, h, data.begin(), data.end(), true);
+
+		kde_t binned_adaptive(hydra::device::sys, hydra::fft::fftw_f64, min, max, h, data.begin(), data.end(), true);
+
+		REQUIRE( kde_test::max_difference(direct_adaptive, binned_adaptive) < 5.0e-4 );
+
+		//the adaptive estimate differs from the fixed bandwidth one
+		REQUIRE( kde_test::max_difference(direct, binned_adaptive) > 1.0e-2 );
+	}
+
+	SECTION( "binned adaptive estimate in heavy tails" )
+	{
+		//the kernels of the entries beyond the range are wider than the pilot bandwidth
+		std::cauchy_distribution<double> cauchy(0.0, 1.0);
+
+		for(auto& x : sample) x = cauchy(engine);
+
+		hydra::device::vector<double> tails(sample.begin(), sample.end());
+
+		kde_t direct_adaptive(hydra::device::sys, min, max, 0.1, tails.begin(), tails.end(), true);
+
+		kde_t binned_adaptive(hydra::device::sys, hydra::fft::fftw_f64, min, max, 0.1, tails.begin(), tails.end(), true);
+
+		double diff = 0.0;
+
+		for(size_t i=0; i<64; i++){
+
+			double f = direct_adaptive.GetSpiline().GetD()[i];
+
+			diff = std::max(diff, std::fabs(binned_adaptive.GetSpiline().GetD()[i] - f)/f);
+		}
+
+		REQUIRE( diff < 2.0e-4 );
+	}
+
+#endif
+}
@@ -0,0 +1,276 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * likelihood.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+//the likelihood FCNs need Minuit2
+#if defined(HYDRA_TESTS_WITH_MINUIT2)
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <hydra/Pdf.h>
+#include <hydra/AddPdf.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/LogLikelihoodFCN.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/Exponential.h>
+#include <hydra/functions/UniformShape.h>
+#include <hydra/device/System.h>
+
+declarg(L_arg, double)
+
+TEST_CASE( "likelihood of pdf sums","hydra::LogLikelihoodFCN" ) {
+
+	using hydra::arguments::L_arg;
+
+	const double min = 0.0;
+	const double max = 10.0;
+	const size_t nentries = 100000;
+
+	auto mean  = hydra::Parameter::Create("L_mean").Value(3.0).Error(0.01);
+	auto sigma = hydra::Parameter::Create("L_sigma").Value(0.8).Error(0.01);
+	auto tau   = hydra::Parameter::Create("L_tau").Value(-0.3).Error(0.01);
+	auto n_sig = hydra::Parameter::Create("L_nsig").Value(0.4*nentries).Error(10.0);
+	auto n_bkg = hydra::Parameter::Create("L_nbkg").Value(0.6*nentries).Error(10.0);
+
+	auto signal = hydra::make_pdf( hydra::Gaussian<L_arg>(mean, sigma),
+			hydra::AnalyticalIntegral<hydra::Gaussian<L_arg>>(min, max));
+
+	auto background = hydra::make_pdf( hydra::Exponential<L_arg>(tau),
+			hydra::AnalyticalIntegral<hydra::Exponential<L_arg>>(min, max));
+
+	auto model = hydra::add_pdfs( {n_sig, n_bkg}, signal, background);
+	model.SetExtended(1);
+
+	hydra::device::vector<L_arg> data(nentries);
+	hydra::device::vector<L_arg> other_data(nentries);
+
+	//two samples uniformly distributed in the range
+	hydra::copy(hydra::random_range(hydra::UniformShape<L_arg>(min, max), 159753, nentries), data);
+	hydra::copy(hydra::random_range(hydra::UniformShape<L_arg>(min, max), 357951, nentries), other_data);
+
+	SECTION( "cached component densities" )
+	{
+		auto reference = hydra::make_loglikehood_fcn(model, data.begin(), data.end());
+
+		REQUIRE_FALSE( reference.IsCachingComponents() );
+
+		auto fcn = reference;
+		fcn.SetComponentCaching(true);
+
+		std::vector<double> parameters;
+		size_t i_mean = 0, i_nsig = 0;
+
+		for(auto parameter : fcn.GetParameters().GetVariables()){
+
+			if( parameter->GetName() == "L_mean" ) i_mean = parameters.size();
+			if( parameter->GetName() == "L_nsig" ) i_nsig = parameters.size();
+
+			parameters.push_back(parameter->GetValue());
+		}
+
+		REQUIRE( fcn.Eval(parameters) == Approx(reference.Eval(parameters)).epsilon(1.0e-12) );
+		REQUIRE( fcn.GetComponentCache().GetNumberOfUpdates() == 2 );
+
+		//only the yields: no component evaluated again
+		parameters[i_nsig] *= 1.1;
+
+		REQUIRE( fcn.Eval(parameters) == Approx(reference.Eval(parameters)).epsilon(1.0e-12) );
+		REQUIRE( fcn.GetComponentCache().GetNumberOfUpdates() == 2 );
+
+		//one parameter of one component
+		parameters[i_mean] += 0.05;
+
+		REQUIRE( fcn.Eval(parameters) == Approx(reference.Eval(parameters)).epsilon(1.0e-12) );
+		REQUIRE( fcn.GetComponentCache().GetNumberOfUpdates() == 3 );
+
+		//other data, same parameters
+		fcn.SetBegin(other_data.begin());
+		fcn.SetEnd(other_data.end());
+
+		reference.SetBegin(other_data.begin());
+		reference.SetEnd(other_data.end());
+
+		REQUIRE( fcn(parameters) == Approx(reference(parameters)).epsilon(1.0e-12) );
+		REQUIRE( fcn.GetComponentCache().GetNumberOfUpdates() == 5 );
+	}
+
+	SECTION( "values at several points" )
+	{
+		auto fcn = hydra::make_loglikehood_fcn(signal, data.begin(), data.end());
+
+		std::vector<double> current;
+
+		for(auto parameter : fcn.GetParameters().GetVariables())
+			current.push_back(parameter->GetValue());
+
+		std::vector<std::vector<double>> points;
+
+		for(size_t i=0; i<11; i++)
+			points.push_back({ 2.5 + 0.1*i, 0.6 + 0.05*i });
+
+		auto reference = fcn;
+		reference.SetFcnCache(hydra::detail::BoundedCache<double>(0));
+
+		std::vector<double> values = fcn.GetFCNValues(points);
+
+		bool all_match = true;
+
+		for(size_t i=0; i<points.size(); i++)
+			all_match &= values[i] == Approx(reference(points[i])).epsilon(1.0e-12);
+
+		REQUIRE( all_match );
+
+		//the pdf keeps its parameters
+		for(size_t i=0; i<current.size(); i++)
+			REQUIRE( fcn.GetParameters().GetVariables()[i]->GetValue() == current[i] );
+
+		//an invalid point is given the largest value, also when it comes first in the batch
+		std::vector<std::vector<double>> invalid{ {3.0, 0.0}, {3.0, 0.1}, points[0] };
+
+		auto fresh = hydra::make_loglikehood_fcn(signal, data.begin(), data.end());
+
+		values = fresh.GetFCNValues(invalid);
+
+		REQUIRE( values[0] == std::max(values[1], values[2]) );
+		REQUIRE( fresh.GetFCNValues({ invalid[0] })[0] == values[0] );
+	}
+}
+
+namespace likelihood_test {
+
+/*
+ * Largest difference between the gradient of the FCN and the central
+ * differences of its value, relative to the largest derivative.
+ * The derivatives along the fixed parameters must be zero.
+ */
+template<typename FCN>
+double gradient_difference(FCN const& fcn)
+{
+	std::vector<double> parameters;
+
+	for(auto parameter : fcn.GetParameters().GetVariables())
+		parameters.push_back(parameter->GetValue());
+
+	std::vector<double> gradient = fcn.Gradient(parameters);
+
+	double diff = 0.0, max = 0.0;
+
+	for(auto parameter : fcn.GetParameters().GetVariables()){
+
+		size_t index = parameter->GetIndex();
+
+		if( parameter->IsFixed() ){
+
+			diff = std::max(diff, std::fabs(gradient[index]));
+			continue;
+		}
+
+		double h = 1.0e-4*(std::fabs(parameters[index]) + parameter->GetError());
+
+		std::vector<double> up(parameters), down(parameters);
+
+		up[index]   += h;
+		down[index] -= h;
+
+		double numerical = (fcn(up) - fcn(down))/(2.0*h);
+
+		diff = std::max(diff, std::fabs(gradient[index] - numerical));
+		max  = std::max(max, std::fabs(numerical));
+	}
+
+	return diff/max;
+}
+
+}  // namespace likelihood_test
+
+TEST_CASE( "analytic gradient of the likelihood","hydra::LogLikelihoodFCN" ) {
+
+	using hydra::arguments::L_arg;
+
+	const double min = 0.0;
+	const double max = 10.0;
+	const size_t nentries = 100000;
+
+	auto mean  = hydra::Parameter::Create("G_mean").Value(3.0).Error(0.01);
+	auto sigma = hydra::Parameter::Create("G_sigma").Value(1.5).Error(0.01);
+	auto tau   = hydra::Parameter::Create("G_tau").Value(-0.3).Error(0.01);
+
+	hydra::device::vector<L_arg> data(nentries);
+	hydra::device::vector<double> weights(nentries);
+
+	hydra::copy(hydra::random_range(hydra::UniformShape<L_arg>(min, max), 951159, nentries), data);
+	hydra::copy(hydra::random_range(hydra::UniformShape<double>(0.5, 1.5), 159951, nentries), weights);
+
+	SECTION( "free parameters" )
+	{
+		auto gaussian = hydra::make_pdf( hydra::Gaussian<L_arg>(mean, sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<L_arg>>(min, max));
+
+		auto exponential = hydra::make_pdf( hydra::Exponential<L_arg>(tau),
+				hydra::AnalyticalIntegral<hydra::Exponential<L_arg>>(min, max));
+
+		REQUIRE( likelihood_test::gradient_difference(
+				hydra::make_loglikehood_fcn(gaussian, data.begin(), data.end())) < 1.0e-5 );
+
+		REQUIRE( likelihood_test::gradient_difference(
+				hydra::make_loglikehood_fcn(exponential, data.begin(), data.end())) < 1.0e-5 );
+
+		//weighted data
+		REQUIRE( likelihood_test::gradient_difference(
+				hydra::make_loglikehood_fcn(gaussian, data.begin(), data.end(), weights.begin())) < 1.0e-5 );
+	}
+
+	SECTION( "fixed parameters" )
+	{
+		auto fixed_sigma = hydra::Parameter::Create("G_fixed_sigma").Value(1.5).Error(0.01).Fixed();
+
+		auto gaussian = hydra::make_pdf( hydra::Gaussian<L_arg>(mean, fixed_sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<L_arg>>(min, max));
+
+		REQUIRE( likelihood_test::gradient_difference(
+				hydra::make_loglikehood_fcn(gaussian, data.begin(), data.end())) < 1.0e-5 );
+	}
+
+	SECTION( "shared parameters" )
+	{
+		//the same parameter as mean and width
+		auto gaussian = hydra::make_pdf( hydra::Gaussian<L_arg>(sigma, sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<L_arg>>(min, max));
+
+		REQUIRE( likelihood_test::gradient_difference(
+				hydra::make_loglikehood_fcn(gaussian, data.begin(), data.end())) < 1.0e-5 );
+	}
+}
+
+#endif //HYDRA_TESTS_WITH_MINUIT2
@@ -30,7 +30,24 @@
 #define LIST_TESTS_INL_
 
 #include <testing/multivector.inl>
+#include <testing/memory_pool.inl>
 #include <testing/lambda.inl>
+#include <testing/histogram.inl>
+#include <testing/random.inl>
+#include <testing/columnar.inl>
+#include <testing/dual.inl>
+#include <testing/functions.inl>
+#include <testing/kde.inl>
+#include <testing/convolution.inl>
+#include <testing/spiline.inl>
+#include <testing/bounded_cache.inl>
+#include <testing/likelihood.inl>
+#include <testing/simultaneous_fcn.inl>
+#include <testing/splot.inl>
+#include <testing/integration.inl>
+#include <testing/precision.inl>
+#include <testing/coherent_sum.inl>
+#include <testing/decays.inl>
 //#include <testing/multiarray.inl>
 
 #endif /* LIST_TESTS_INL_ */
@@ -0,0 +1,167 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * memory_pool.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <utility>
+#include <type_traits>
+
+#include <hydra/MemoryPool.h>
+#include <hydra/ScopedBuffer.h>
+#include <hydra/host/System.h>
+
+TEST_CASE( "memory pool","hydra::MemoryPool" ) {
+
+	typedef std::remove_reference<decltype(hydra::memory_pool(hydra::host::sys))>::type pool_type;
+
+	auto& pool = hydra::memory_pool(hydra::host::sys);
+
+	pool.Release();
+
+	const size_t in_use = pool.GetBytesInUse();
+
+	SECTION( "size classes" )
+	{
+		REQUIRE( pool_type::SizeClass(1)    == 256 );
+		REQUIRE( pool_type::SizeClass(256)  == 256 );
+		REQUIRE( pool_type::SizeClass(257)  == 320 );
+		REQUIRE( pool_type::SizeClass(1000) == 1024 );
+		REQUIRE( pool_type::SizeClass(1024) == 1024 );
+		REQUIRE( pool_type::SizeClass(1025) == 1280 );
+
+		for(size_t n=1; n<100000; n+=997){
+
+			size_t size = pool_type::SizeClass(n);
+
+			REQUIRE( size >= n );
+			REQUIRE( size <= n + n/4 + 256 );
+		}
+	}
+
+	SECTION( "reuse of returned blocks" )
+	{
+		void* block = pool.Allocate(1000);
+
+		REQUIRE( pool.GetBytesInUse() == in_use + 1024 );
+
+		pool.Deallocate(block);
+
+		REQUIRE( pool.GetBytesInUse() == in_use );
+		REQUIRE( pool.GetBytesCached() == 1024 );
+
+		//same size class: served from the free list
+		size_t hits = pool.GetHits();
+
+		void* same = pool.Allocate(1024);
+
+		REQUIRE( same == block );
+		REQUIRE( pool.GetHits() == hits + 1 );
+		REQUIRE( pool.GetBytesCached() == 0 );
+
+		//another size class: new block
+		size_t misses = pool.GetMisses();
+
+		void* other = pool.Allocate(4000);
+
+		REQUIRE( other != block );
+		REQUIRE( pool.GetMisses() == misses + 1 );
+
+		pool.Deallocate(same);
+		pool.Deallocate(other);
+
+		REQUIRE( pool.GetBytesCached() == 1024 + pool_type::SizeClass(4000) );
+		REQUIRE( pool.GetPeakBytes() >= in_use + 1024 + pool_type::SizeClass(4000) );
+	}
+
+	SECTION( "release and high-water mark" )
+	{
+		void* block = pool.Allocate(1000);
+		void* kept  = pool.Allocate(5000);
+
+		pool.Deallocate(block);
+
+		REQUIRE( pool.GetBytesCached() == 1024 );
+
+		//cached blocks are freed, blocks in use are not affected
+		pool.Release();
+
+		REQUIRE( pool.GetBytesCached() == 0 );
+		REQUIRE( pool.GetBytesInUse() == in_use + pool_type::SizeClass(5000) );
+
+		//with a zero high-water mark nothing is cached
+		size_t mark = pool.GetHighWaterMark();
+
+		pool.SetHighWaterMark(0);
+
+		pool.Deallocate(kept);
+
+		REQUIRE( pool.GetBytesCached() == 0 );
+		REQUIRE( pool.GetBytesInUse() == in_use );
+
+		pool.SetHighWaterMark(mark);
+	}
+
+	SECTION( "scoped buffers" )
+	{
+		size_t size = pool_type::SizeClass(1000*sizeof(double));
+
+		{
+			hydra::ScopedBuffer<double, hydra::host::sys_t> buffer(1000);
+
+			REQUIRE( buffer.GetSize() == 1000 );
+			REQUIRE( pool.GetBytesInUse() == in_use + size );
+
+			double* data = hydra_thrust::raw_pointer_cast(buffer.GetPointer());
+
+			for(size_t i=0; i<1000; i++) data[i] = i;
+
+			//the block moves with the buffer and is returned once
+			hydra::ScopedBuffer<double, hydra::host::sys_t> moved(std::move(buffer));
+
+			REQUIRE( buffer.GetSize() == 0 );
+			REQUIRE( moved.GetSize() == 1000 );
+			REQUIRE( hydra_thrust::raw_pointer_cast(moved.GetPointer()) == data );
+			REQUIRE( data[999] == 999.0 );
+			REQUIRE( pool.GetBytesInUse() == in_use + size );
+		}
+
+		REQUIRE( pool.GetBytesInUse() == in_use );
+		REQUIRE( pool.GetBytesCached() == size );
+
+		//a buffer of the same size class reuses the block
+		size_t hits = pool.GetHits();
+
+		hydra::ScopedBuffer<double, hydra::host::sys_t> buffer(990);
+
+		REQUIRE( pool.GetHits() == hits + 1 );
+		REQUIRE( pool.GetBytesCached() == 0 );
+	}
+
+	pool.Release();
+}
@@ -0,0 +1,124 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * precision.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include <hydra/Pdf.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/DenseHistogram.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/device/System.h>
+#include <hydra/detail/utility/CompensatedSum.h>
+#include <hydra/detail/functors/LogLikelihood1.h>
+#include <hydra/detail/external/hydra_thrust/transform_reduce.h>
+
+declarg(P_arg, double)
+declarg(Pf_arg, float)
+
+TEST_CASE( "float storage and compensated sums","hydra::detail::CompensatedSum" ) {
+
+	using hydra::arguments::P_arg;
+	using hydra::arguments::Pf_arg;
+
+	typedef hydra::detail::CompensatedSum<double> sum_t;
+
+	SECTION( "compensated sum" )
+	{
+		//1 + 1e-16 + ... is not representable in double, the plain sum stays at 1
+		const size_t n = 1000000;
+
+		hydra::device::vector<double> values(n+1, 1.0e-16);
+		values[0] = 1.0;
+
+		double plain = hydra_thrust::reduce(values.begin(), values.end(), 0.0);
+		double compensated = hydra_thrust::reduce(values.begin(), values.end(),
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		REQUIRE( plain == 1.0 );
+		REQUIRE( compensated == Approx(1.0 + 1.0e-10).epsilon(1.0e-15) );
+	}
+
+	auto mean  = hydra::Parameter::Create("mean").Value(0.1).Error(0.01);
+	auto sigma = hydra::Parameter::Create("sigma").Value(1.2).Error(0.01);
+
+	const size_t nentries = 1000000;
+
+	hydra::device::vector<P_arg> data_d(nentries);
+
+	hydra::copy(hydra::random_range(hydra::Gaussian<P_arg>(mean, sigma), 159753, nentries), data_d);
+
+	//narrowing copy to the float columns
+	hydra::device::vector<Pf_arg> data_f(nentries);
+
+	hydra::copy(data_d, data_f);
+
+	SECTION( "log-likelihood with float storage" )
+	{
+		auto model_d = hydra::make_pdf(hydra::Gaussian<P_arg>(mean, sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<P_arg>>(-6.0, 6.0));
+
+		auto model_f = hydra::make_pdf(hydra::Gaussian<Pf_arg>(mean, sigma),
+				hydra::AnalyticalIntegral<hydra::Gaussian<Pf_arg>>(-6.0, 6.0));
+
+		auto nll_d = hydra::detail::LogLikelihood1<typename decltype(model_d)::functor_type>(model_d.GetFunctor());
+		auto nll_f = hydra::detail::LogLikelihood1<typename decltype(model_f)::functor_type>(model_f.GetFunctor());
+
+		double sum_d = hydra_thrust::transform_reduce(data_d.begin(), data_d.end(), nll_d,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		double sum_f = hydra_thrust::transform_reduce(data_f.begin(), data_f.end(), nll_f,
+				sum_t(), hydra_thrust::plus<sum_t>()).Sum();
+
+		//the data rounding moves the likelihood far less than the Minuit tolerance
+		REQUIRE( std::fabs(sum_d - sum_f) < 1.0e-3 );
+	}
+
+	SECTION( "histogram of float data" )
+	{
+		hydra::DenseHistogram<double, 1, hydra::device::sys_t> hist_d(100, -6.0, 6.0);
+		hydra::DenseHistogram<float,  1, hydra::device::sys_t> hist_f(100, -6.0, 6.0);
+
+		hist_d.Fill(data_d.begin(), data_d.end());
+		hist_f.Fill(data_f.begin(), data_f.end());
+
+		double moved = 0;
+
+		for(size_t i=0; i<100; i++)
+			moved += std::fabs(hist_d.GetBinContent(i) - hist_f.GetBinContent(i));
+
+		//only entries within a float rounding of a bin edge can change bin
+		REQUIRE( moved <= 10.0 );
+		REQUIRE( hist_f.GetBinContent(50) == Approx(hist_d.GetBinContent(50)).epsilon(1.0e-3) );
+	}
+}
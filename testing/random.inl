@@ -0,0 +1,294 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * random.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <limits>
+#include <array>
+#include <cmath>
+
+#include <hydra/Random.h>
+#include <hydra/Bootstrap.h>
+#include <hydra/Lambda.h>
+#include <hydra/multiarray.h>
+#include <hydra/device/System.h>
+#include <hydra/Parameter.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/UniformShape.h>
+#include <vector>
+
+declarg(R_arg, double)
+
+namespace block_test {
+
+	template<typename Engine>
+	bool same_sequence(size_t n)
+	{
+		Engine scalar(0x1234), block(0x1234);
+
+		scalar.discard(5); block.discard(5);
+		scalar(); block();
+
+		std::vector<typename Engine::result_type> a(n), b(n);
+
+		for(auto& x: a) x = scalar();
+
+		block.generate(b.data(), b.data() + n);
+
+		return a == b && scalar() == block();
+	}
+
+	template<typename Engine, typename Functor>
+	bool same_fill(Functor const& functor, size_t n)
+	{
+		hydra::device::vector<double> a(n), b(n);
+
+		hydra_thrust::tabulate(hydra::device::sys, a.begin(), a.end(),
+				hydra::detail::Sampler<Functor, Engine>(functor, 0x1234, 3));
+
+		hydra::fill_random<Engine>(hydra::device::sys, b.begin(), b.end(), functor, 0x1234, 3);
+
+		return a == b;
+	}
+
+}  // namespace block_test
+
+TEST_CASE( "exact-count sampling","hydra::sample" ) {
+
+	auto gaussian = hydra::wrap_lambda( [] __hydra_dual__ (double x){
+		return exp(-0.5*x*x);
+	});
+
+	SECTION( "1D sample is appended with the requested size" )
+	{
+		hydra::device::vector<double> data(10, 100.0);
+
+		//small batches to exercise the batching and the maximum update
+		auto range = hydra::sample(data, 50000, -6.0, 6.0, gaussian, 0x1234, 0, 4096);
+
+		REQUIRE( range.size() == 50000 );
+		REQUIRE( data.size() == 50010 );
+		REQUIRE( data[9] == 100.0 );
+
+		double mean = 0.0, var = 0.0;
+
+		for(auto x: range){ mean += x; var += x*x; }
+
+		mean /= range.size();
+		var   = var/range.size() - mean*mean;
+
+		REQUIRE( std::fabs(mean) < 0.03 );
+		REQUIRE( var == Approx(1.0).epsilon(0.03) );
+	}
+
+	SECTION( "3D sample" )
+	{
+		auto gaussian3 = hydra::wrap_lambda( [] __hydra_dual__ (double x, double y, double z){
+			return exp(-0.5*(x*x + y*y + z*z));
+		});
+
+		std::array<double, 3> min{-6.0, -6.0, -6.0};
+		std::array<double, 3> max{ 6.0,  6.0,  6.0};
+
+		hydra::multiarray<double, 3, hydra::device::sys_t> data;
+
+		auto range = hydra::sample(data, 20000, min, max, gaussian3);
+
+		REQUIRE( range.size() == 20000 );
+	}
+
+	SECTION( "unweighting stops at the requested size or at the end of the data" )
+	{
+		hydra::device::vector<double> flat(100000);
+
+		for(size_t i=0; i<flat.size(); i++)
+			flat[i] = -6.0 + 12.0*double((i*7919)%flat.size())/flat.size();
+
+		hydra::device::vector<double> output;
+
+		REQUIRE( hydra::unweight(flat, output, 1000, gaussian).size() == 1000 );
+
+		output.clear();
+
+		auto range = hydra::unweight(flat, output, flat.size(), gaussian);
+
+		REQUIRE( range.size() > 0 );
+		REQUIRE( range.size() < flat.size() );
+	}
+
+	SECTION( "the requested size is met for any batch size" )
+	{
+		for(size_t max_batch : {1, 7, 100, 4096, 1000000}){
+
+			for(size_t nevents : {1, 99, 4097}){
+
+				hydra::device::vector<double> data;
+
+				auto range = hydra::sample(data, nevents, -6.0, 6.0, gaussian, 0x1234 + nevents, 0, max_batch);
+
+				REQUIRE( range.size() == nevents );
+				REQUIRE( data.size() == nevents );
+
+				bool inside = true;
+
+				for(auto x: range) inside = inside && std::fabs(x) <= 6.0;
+
+				REQUIRE( inside );
+			}
+		}
+
+		//maximum given by the caller
+		hydra::device::vector<double> flat(100000);
+
+		for(size_t i=0; i<flat.size(); i++)
+			flat[i] = -6.0 + 12.0*double((i*7919)%flat.size())/flat.size();
+
+		hydra::device::vector<double> output;
+
+		REQUIRE( hydra::unweight(flat, output, 2500, gaussian, 1.0, 0x5678, 0, 333).size() == 2500 );
+	}
+
+	SECTION( "sampling stops if nothing can be accepted" )
+	{
+		auto negative = hydra::wrap_lambda( [] __hydra_dual__ (double x){
+			return -1.0 - x*x;
+		});
+
+		auto not_a_number = hydra::wrap_lambda( [] __hydra_dual__ (double x){
+			return std::numeric_limits<double>::quiet_NaN()*x;
+		});
+
+		hydra::device::vector<double> data(10, 100.0);
+
+		REQUIRE( hydra::sample(data, 1000, -6.0, 6.0, negative, 0x1234, 0, 4096).size() == 0 );
+		REQUIRE( hydra::sample(data, 1000, -6.0, 6.0, not_a_number, 0x1234, 0, 4096).size() == 0 );
+
+		std::array<double, 2> min{-6.0, -6.0};
+		std::array<double, 2> max{ 6.0,  6.0};
+
+		auto zero = hydra::wrap_lambda( [] __hydra_dual__ (double x, double y){
+			return 0.0*x*y;
+		});
+
+		hydra::multiarray<double, 2, hydra::device::sys_t> data2;
+
+		REQUIRE( hydra::sample(data2, 1000, min, max, zero, 0x1234, 0, 4096).size() == 0 );
+
+		REQUIRE( data.size() == 10 );
+		REQUIRE( data2.size() == 0 );
+	}
+}
+
+TEST_CASE( "single pass Poisson bootstrap","hydra::bootstrap_mean" ) {
+
+	auto identity = hydra::wrap_lambda( [] __hydra_dual__ (double x){ return x; });
+
+	size_t nevents = 20000;
+
+	hydra::device::vector<double> data(nevents);
+
+	for(size_t i=0; i<nevents; i++)
+		data[i] = -1.0 + 2.0*double((i*7919)%nevents)/nevents;
+
+	SECTION( "replica means spread as the error on the mean" )
+	{
+		size_t nreplicas = 400;
+
+		auto replicas = hydra::bootstrap_mean(data, identity, nreplicas, 0x1234);
+
+		REQUIRE( replicas.size() == nreplicas );
+
+		double mean = 0.0, var = 0.0, sumw = 0.0;
+
+		for(size_t r=0; r<nreplicas; r++){
+
+			double m = hydra::get<0>(replicas[r]);
+
+			mean += m; var += m*m;
+			sumw += hydra::get<1>(replicas[r]);
+		}
+
+		mean /= nreplicas;
+		var   = var/nreplicas - mean*mean;
+
+		//uniform in [-1,1]: sigma^2 = 1/3
+		REQUIRE( std::sqrt(var) == Approx(std::sqrt(1.0/(3.0*nevents))).epsilon(0.15) );
+		REQUIRE( sumw/nreplicas == Approx(nevents).epsilon(0.01) );
+
+		//a replica does not depend on how many are requested with it
+		auto first = hydra::bootstrap_mean(data, identity, 3, 0x1234);
+
+		REQUIRE( hydra::get<0>(first[2]) == hydra::get<0>(replicas[2]) );
+	}
+
+	SECTION( "replica histograms" )
+	{
+		auto histograms = hydra::bootstrap_histogram(data, identity, 10, -1.0, 1.0, 5, 0x1234);
+
+		REQUIRE( histograms.size() == 50 );
+
+		auto means = hydra::bootstrap_mean(data, identity, 5, 0x1234);
+
+		for(size_t r=0; r<5; r++){
+
+			double total = 0.0;
+
+			for(size_t b=0; b<10; b++) total += hydra::get<1>(histograms[r*10 + b]);
+
+			REQUIRE( total == Approx(hydra::get<1>(means[r])) );
+		}
+	}
+}
+
+TEST_CASE( "block generation","hydra::fill_random" ) {
+
+	SECTION( "engines fill blocks with the same sequence" )
+	{
+		REQUIRE( block_test::same_sequence<hydra::squares3>(1001) );
+		REQUIRE( block_test::same_sequence<hydra::squares4>(1001) );
+		REQUIRE( block_test::same_sequence<hydra::philox>(1001) );
+		REQUIRE( block_test::same_sequence<hydra::threefry_long>(1001) );
+	}
+
+	SECTION( "fill_random matches the element by element sampler" )
+	{
+		auto mean  = hydra::Parameter::Create("mean").Value(0.5);
+		auto sigma = hydra::Parameter::Create("sigma").Value(1.5);
+		auto min   = hydra::Parameter::Create("min").Value(-1.0);
+		auto max   = hydra::Parameter::Create("max").Value(3.0);
+
+		hydra::Gaussian<hydra::arguments::R_arg> gaussian(mean, sigma);
+		hydra::UniformShape<hydra::arguments::R_arg> uniform(min, max);
+
+		REQUIRE( block_test::same_fill<hydra::squares3>(gaussian, 10007) );
+		REQUIRE( block_test::same_fill<hydra::squares4>(uniform, 10007) );
+		REQUIRE( block_test::same_fill<hydra::philox>(gaussian, 10007) );
+		REQUIRE( block_test::same_fill<hydra::threefry_long>(uniform, 10007) );
+	}
+}
@@ -0,0 +1,192 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * simultaneous_fcn.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+#include <hydra/detail/WorkerPool.h>
+
+TEST_CASE( "worker pool","hydra::detail::WorkerPool" ) {
+
+	hydra::detail::WorkerPool pool(3);
+
+	REQUIRE( pool.GetNumberOfWorkers() == 3 );
+
+	SECTION( "batches of tasks on the same threads" )
+	{
+		std::vector<size_t> counts(7, 0);
+
+		//more tasks than workers, several batches
+		for(size_t batch=0; batch<50; batch++)
+			pool.Run(counts.size(), [&counts](size_t i){ counts[i] += i; });
+
+		bool all_match = true;
+
+		for(size_t i=0; i<counts.size(); i++)
+			all_match &= counts[i] == 50*i;
+
+		REQUIRE( all_match );
+
+		std::atomic<size_t> ncalls(0);
+
+		pool.Run(0, [&ncalls](size_t){ ++ncalls; });
+
+		REQUIRE( ncalls == 0 );
+	}
+
+	SECTION( "exceptions reach the caller" )
+	{
+		std::atomic<size_t> ncalls(0);
+
+		REQUIRE_THROWS_AS( pool.Run(5, [&ncalls](size_t i){
+
+			++ncalls;
+
+			if( i==2 ) throw std::runtime_error("task 2");
+		}), std::runtime_error );
+
+		//all the tasks of the batch have run and the pool is still usable
+		REQUIRE( ncalls == 5 );
+
+		pool.Run(4, [&ncalls](size_t){ ++ncalls; });
+
+		REQUIRE( ncalls == 9 );
+	}
+}
+
+//the simultaneous FCN needs Minuit2
+#if defined(HYDRA_TESTS_WITH_MINUIT2)
+
+#include <hydra/Pdf.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/LogLikelihoodFCN.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/UniformShape.h>
+#include <hydra/device/System.h>
+
+declarg(SF_arg, double)
+
+TEST_CASE( "simultaneous likelihood","hydra::FCN" ) {
+
+	using hydra::arguments::SF_arg;
+
+	const double min = 0.0;
+	const double max = 10.0;
+	const size_t nentries = 50000;
+
+	auto mean   = hydra::Parameter::Create("SF_mean").Value(3.0).Error(0.01);
+	auto sigma1 = hydra::Parameter::Create("SF_sigma1").Value(0.8).Error(0.01);
+	auto sigma2 = hydra::Parameter::Create("SF_sigma2").Value(1.2).Error(0.01);
+
+	//the mean is shared by the two samples
+	auto pdf1 = hydra::make_pdf( hydra::Gaussian<SF_arg>(mean, sigma1),
+			hydra::AnalyticalIntegral<hydra::Gaussian<SF_arg>>(min, max));
+
+	auto pdf2 = hydra::make_pdf( hydra::Gaussian<SF_arg>(mean, sigma2),
+			hydra::AnalyticalIntegral<hydra::Gaussian<SF_arg>>(min, max));
+
+	hydra::device::vector<SF_arg> data1(nentries);
+	hydra::device::vector<SF_arg> data2(2*nentries);
+
+	hydra::copy(hydra::random_range(hydra::UniformShape<SF_arg>(min, max), 951357, nentries), data1);
+	hydra::copy(hydra::random_range(hydra::UniformShape<SF_arg>(min, max), 357159, 2*nentries), data2);
+
+	auto fcn1 = hydra::make_loglikehood_fcn(pdf1, data1.begin(), data1.end());
+	auto fcn2 = hydra::make_loglikehood_fcn(pdf2, data2.begin(), data2.end());
+
+	auto fcn = hydra::make_simultaneous_fcn(fcn1, fcn2);
+
+	std::vector<double> parameters;
+
+	for(auto parameter : fcn.GetParameters().GetVariables())
+		parameters.push_back(parameter->GetValue());
+
+	SECTION( "pool, sequential and sum of the sub-FCNs" )
+	{
+		auto sequential = fcn;
+		sequential.SetSequential(true);
+
+		REQUIRE( sequential.GetThreads() == fcn.GetThreads() );
+
+		for(size_t i=0; i<5; i++){
+
+			parameters[0] += 0.01;
+
+			double expected = hydra::get<0>(fcn.GetFCNS())(parameters)
+					+ hydra::get<1>(fcn.GetFCNS())(parameters);
+
+			REQUIRE( fcn(parameters) == Approx(expected).epsilon(1.0e-12) );
+			REQUIRE( sequential(parameters) == Approx(expected).epsilon(1.0e-12) );
+		}
+
+		for(size_t i=0; i<2; i++){
+
+			REQUIRE( fcn.GetNumberOfCalls(i) == 5 );
+			REQUIRE( sequential.GetNumberOfCalls(i) == 5 );
+			REQUIRE( fcn.GetMaxTime(i) <= fcn.GetTotalTime(i) );
+			REQUIRE( fcn.GetMeanTime(i) == Approx(fcn.GetTotalTime(i)/5) );
+		}
+
+		fcn.ResetTimers();
+
+		REQUIRE( fcn.GetNumberOfCalls(0) == 0 );
+		REQUIRE( fcn.GetTotalTime(1) == 0.0 );
+	}
+
+	SECTION( "share of the cores" )
+	{
+		fcn.SetThreads({1, 3});
+
+		REQUIRE( fcn.GetThreads() == std::vector<size_t>{1, 3} );
+
+		//ignored: one count per sub-FCN is needed
+		fcn.SetThreads({2});
+
+		REQUIRE( fcn.GetThreads() == std::vector<size_t>{1, 3} );
+
+		double value = fcn(parameters);
+
+		fcn.SetThreads({0, 0});
+
+		REQUIRE( fcn(parameters) == Approx(value).epsilon(1.0e-12) );
+
+		//every sub-FCN keeps at least one thread
+		fcn.RebalanceThreads();
+
+		REQUIRE( fcn.GetThreads()[0] > 0 );
+		REQUIRE( fcn.GetThreads()[1] > 0 );
+	}
+}
+
+#endif //HYDRA_TESTS_WITH_MINUIT2
@@ -0,0 +1,234 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * spiline.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <hydra/Spiline.h>
+#include <hydra/SpilineTable.h>
+#include <hydra/device/System.h>
+#include <hydra/host/System.h>
+
+declarg(S0_arg, double)
+declarg(S1_arg, double)
+declarg(S2_arg, double)
+
+namespace spiline_test {
+
+inline double f(double x, double y=0.0, double z=0.0)
+{
+	return ::sin(x) + 0.5*::cos(2.0*y)*(1.0 + x) + ::exp(-z*z) + 0.1*x*y*z;
+}
+
+inline std::vector<double> uniform(double min, double max, size_t n)
+{
+	std::vector<double> x(n);
+
+	for(size_t i=0; i<n; i++) x[i] = min + i*(max - min)/(n - 1);
+
+	return x;
+}
+
+inline std::vector<double> non_uniform(double min, double max, size_t n)
+{
+	std::vector<double> x(n);
+
+	for(size_t i=0; i<n; i++){
+
+		double u = double(i)/(n - 1);
+
+		x[i] = min + u*u*(max - min);
+	}
+
+	return x;
+}
+
+//successive one dimensional interpolations, the first axis running fastest
+inline double reference(std::vector<double> const& x0, std::vector<double> const& y, double X0)
+{
+	return hydra::spiline(x0.begin(), x0.end(), y.begin(), X0);
+}
+
+inline double reference(std::vector<double> const& x0, std::vector<double> const& x1,
+		std::vector<double> const& y, double X0, double X1)
+{
+	std::vector<double> column(x1.size());
+
+	for(size_t j=0; j<x1.size(); j++)
+		column[j] = reference(x0, std::vector<double>(y.begin() + j*x0.size(), y.begin() + (j+1)*x0.size()), X0);
+
+	return hydra::spiline(x1.begin(), x1.end(), column.begin(), X1);
+}
+
+inline double reference(std::vector<double> const& x0, std::vector<double> const& x1, std::vector<double> const& x2,
+		std::vector<double> const& y, double X0, double X1, double X2)
+{
+	size_t n = x0.size()*x1.size();
+
+	std::vector<double> column(x2.size());
+
+	for(size_t k=0; k<x2.size(); k++)
+		column[k] = reference(x0, x1, std::vector<double>(y.begin() + k*n, y.begin() + (k+1)*n), X0, X1);
+
+	return hydra::spiline(x2.begin(), x2.end(), column.begin(), X2);
+}
+
+}  // namespace spiline_test
+
+TEST_CASE( "tabulated spline","hydra::SpilineTable" ) {
+
+	using hydra::arguments::S0_arg;
+	using hydra::arguments::S1_arg;
+	using hydra::arguments::S2_arg;
+
+	using spiline_test::f;
+	using spiline_test::reference;
+
+	SECTION( "1D, uniform and non-uniform grids" )
+	{
+		for(bool uniform : {true, false}){
+
+			auto x = uniform ? spiline_test::uniform(-1.0, 2.0, 40) : spiline_test::non_uniform(-1.0, 2.0, 40);
+
+			std::vector<double> y(x.size());
+
+			for(size_t i=0; i<x.size(); i++) y[i] = f(x[i]);
+
+			hydra::SpilineTable<hydra::device::sys_t, S0_arg> table(x, y);
+
+			REQUIRE( table.IsUniform(0) == uniform );
+
+			const size_t n = 1000;
+
+			hydra::device::vector<S0_arg> points(n);
+			hydra::device::vector<double> values(n);
+
+			//including points outside the grid, clamped to the border
+			for(size_t i=0; i<n; i++) points[i] = -1.5 + i*4.0/(n - 1);
+
+			table.Interpolate(points, values);
+
+			bool all_match = true;
+
+			for(size_t i=0; i<n; i++){
+
+				S0_arg X = points[i];
+				double expected = reference(x, y, std::min(std::max(double(X), x.front()), x.back()));
+
+				all_match &= std::fabs(values[i] - expected) < 1.0e-12 && values[i] == table(X);
+			}
+
+			REQUIRE( all_match );
+
+			for(size_t i=0; i<x.size(); i++)
+				REQUIRE( table(S0_arg(x[i])) == Approx(y[i]).epsilon(1.0e-12) );
+		}
+	}
+
+	SECTION( "2D" )
+	{
+		auto x0 = spiline_test::uniform(-1.0, 2.0, 20);
+		auto x1 = spiline_test::non_uniform(0.0, 1.5, 15);
+
+		std::vector<double> y(x0.size()*x1.size());
+
+		for(size_t j=0; j<x1.size(); j++)
+			for(size_t i=0; i<x0.size(); i++)
+				y[i + x0.size()*j] = f(x0[i], x1[j]);
+
+		hydra::SpilineTable<hydra::device::sys_t, S0_arg, S1_arg> table(x0, x1, y);
+
+		bool all_match = true;
+
+		for(double X0=-0.95; X0<2.0; X0 += 0.137)
+			for(double X1=0.01; X1<1.5; X1 += 0.093)
+				all_match &= std::fabs(table(S0_arg(X0), S1_arg(X1)) - reference(x0, x1, y, X0, X1)) < 1.0e-12;
+
+		REQUIRE( all_match );
+	}
+
+	SECTION( "3D" )
+	{
+		auto x0 = spiline_test::uniform(-1.0, 2.0, 12);
+		auto x1 = spiline_test::uniform(0.0, 1.5, 10);
+		auto x2 = spiline_test::non_uniform(-1.0, 1.0, 9);
+
+		std::vector<double> y(x0.size()*x1.size()*x2.size());
+
+		for(size_t k=0; k<x2.size(); k++)
+			for(size_t j=0; j<x1.size(); j++)
+				for(size_t i=0; i<x0.size(); i++)
+					y[i + x0.size()*(j + x1.size()*k)] = f(x0[i], x1[j], x2[k]);
+
+		hydra::SpilineTable<hydra::device::sys_t, S0_arg, S1_arg, S2_arg> table(x0, x1, x2, y);
+
+		bool all_match = true;
+
+		for(double X0=-0.95; X0<2.0; X0 += 0.31)
+			for(double X1=0.01; X1<1.5; X1 += 0.23)
+				for(double X2=-0.99; X2<1.0; X2 += 0.17)
+					all_match &= std::fabs(table(S0_arg(X0), S1_arg(X1), S2_arg(X2))
+							- reference(x0, x1, x2, y, X0, X1, X2)) < 1.0e-12;
+
+		REQUIRE( all_match );
+	}
+
+	SECTION( "ownership and validation" )
+	{
+		auto x = spiline_test::uniform(0.0, 1.0, 10);
+
+		std::vector<double> y(x.size());
+
+		for(size_t i=0; i<x.size(); i++) y[i] = f(x[i]);
+
+		auto copy = [&](){
+
+			hydra::SpilineTable<hydra::host::sys_t, S0_arg> table(x, y);
+
+			//the copies share the table, which outlives the original
+			hydra::SpilineTable<hydra::host::sys_t, S0_arg> other(table);
+
+			REQUIRE( other.GetData() == table.GetData() );
+
+			return other;
+		}();
+
+		REQUIRE( copy(S0_arg(0.55)) == Approx(reference(x, y, 0.55)).epsilon(1.0e-12) );
+
+		std::vector<double> short_y(y.begin(), y.end() - 1);
+
+		REQUIRE_THROWS_AS( (hydra::SpilineTable<hydra::host::sys_t, S0_arg>(x, short_y)), std::invalid_argument );
+		REQUIRE_THROWS_AS( (hydra::SpilineTable<hydra::host::sys_t, S0_arg, S1_arg>(x, std::vector<double>{1.0}, y)),
+				std::invalid_argument );
+	}
+}
@@ -0,0 +1,145 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * splot.inl
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ */
+
+#pragma once
+
+#include <catch/catch.hpp>
+#include <cmath>
+
+#include <hydra/Pdf.h>
+#include <hydra/AddPdf.h>
+#include <hydra/Parameter.h>
+#include <hydra/Random.h>
+#include <hydra/Algorithm.h>
+#include <hydra/SPlot.h>
+#include <hydra/multivector.h>
+#include <hydra/Placeholders.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/Exponential.h>
+#include <hydra/functions/UniformShape.h>
+#include <hydra/device/System.h>
+#include <hydra/host/System.h>
+
+declarg(SP_arg, double)
+
+TEST_CASE( "sPlot","hydra::SPlot" ) {
+
+	using hydra::arguments::SP_arg;
+	using namespace hydra::placeholders;
+
+	typedef hydra::multivector<hydra::tuple<double, double>, hydra::device::sys_t> sweights_t;
+
+	const double min = 0.0;
+	const double max = 10.0;
+	const size_t nsignal     = 20000;
+	const size_t nbackground = 30000;
+	const size_t nentries    = nsignal + nbackground;
+
+	auto mean  = hydra::Parameter::Create("SP_mean").Value(3.0);
+	auto sigma = hydra::Parameter::Create("SP_sigma").Value(0.8);
+	auto tau   = hydra::Parameter::Create("SP_tau").Value(-0.3);
+	auto n_sig = hydra::Parameter::Create("SP_nsig").Value(nsignal);
+	auto n_bkg = hydra::Parameter::Create("SP_nbkg").Value(nbackground);
+
+	auto signal = hydra::make_pdf( hydra::Gaussian<SP_arg>(mean, sigma),
+			hydra::AnalyticalIntegral<hydra::Gaussian<SP_arg>>(min, max));
+
+	auto background = hydra::make_pdf( hydra::Exponential<SP_arg>(tau),
+			hydra::AnalyticalIntegral<hydra::Exponential<SP_arg>>(min, max));
+
+	auto model = hydra::add_pdfs( {n_sig, n_bkg}, signal, background);
+
+	hydra::device::vector<SP_arg> data(nentries);
+
+	hydra::copy(hydra::random_range(hydra::UniformShape<SP_arg>(min, max), 753159, nentries), data);
+
+	//reference: one s-weight at a time, through the per-species iterators
+	auto reference = hydra::make_splot(model, data);
+
+	hydra::host::vector<double> signal_weights(reference.begin(_0), reference.end(_0));
+	hydra::host::vector<double> background_weights(reference.begin(_1), reference.end(_1));
+
+	auto matches = [&](sweights_t const& sweights, double tolerance){
+
+		bool all_match = sweights.size() == nentries;
+
+		for(size_t i=0; i<nentries && all_match; i++){
+
+			hydra::tuple<double, double> weights = sweights[i];
+
+			all_match &= std::fabs(hydra::get<0>(weights) - signal_weights[i]) <= tolerance &&
+					std::fabs(hydra::get<1>(weights) - background_weights[i]) <= tolerance;
+		}
+
+		return all_match;
+	};
+
+	SECTION( "all species in one pass" )
+	{
+		sweights_t sweights(nentries);
+
+		reference.Fill(sweights);
+
+		REQUIRE( matches(sweights, 0.0) );
+	}
+
+	SECTION( "cached component values" )
+	{
+		auto cached = hydra::make_splot(model, data, true);
+
+		REQUIRE( cached.IsCached() );
+		REQUIRE( (cached.GetCovMatrix() - reference.GetCovMatrix()).norm() == Approx(0.0).margin(1.0e-9) );
+
+		sweights_t sweights(nentries);
+
+		cached.Fill(sweights);
+
+		REQUIRE( matches(sweights, 1.0e-12) );
+	}
+
+	SECTION( "chunks on another back-end" )
+	{
+		//the chunk size does not divide the sample
+		auto chunked = hydra::make_splot(model, data, hydra::host::sys, 7777);
+
+		REQUIRE( (chunked.GetCovMatrix() - reference.GetCovMatrix()).norm() <=
+				1.0e-12*reference.GetCovMatrix().norm() );
+
+		sweights_t sweights(nentries);
+
+		auto end = chunked.Fill(hydra::host::sys, sweights.begin(), 7777);
+
+		REQUIRE( end == sweights.end() );
+		REQUIRE( matches(sweights, 1.0e-12) );
+
+		auto from_iterators = hydra::make_splot(model, data.begin(), data.end(), hydra::host::sys, nentries);
+
+		REQUIRE( (from_iterators.GetCovMatrix() - reference.GetCovMatrix()).norm() <=
+				1.0e-12*reference.GetCovMatrix().norm() );
+	}
+}
@@ -0,0 +1,185 @@
+/*----------------------------------------------------------------------------
+ *
+ *   Copyright (C) 2016 - 2023 Antonio Augusto Alves Junior
+ *
+ *   This file is part of Hydra Data Analysis Framework.
+ *
+ *   Hydra is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Hydra is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Hydra.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *---------------------------------------------------------------------------*/
+
+/*
+ * timing_block.cpp
+ *
+ *  Created on: 18/10/2026
+ *      Author: Antonio Augusto Alves Junior
+ *
+ *  Timing of the block generation of the counter based engines, to be
+ *  compared with timing_baseline (std::mt19937). The TestU01 timings go to
+ *  hydra_timing_block_TestU01_log.txt, the hydra::fill_random timings to
+ *  the standard output.
+ */
+
+
+#include <stdio.h>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <chrono>
+#include <vector>
+
+//hydra
+#include <hydra/device/System.h>
+#include <hydra/Random.h>
+#include <hydra/Parameter.h>
+#include <hydra/functions/Gaussian.h>
+#include <hydra/functions/UniformShape.h>
+
+extern "C"
+{
+    #include "unif01.h"
+    #include "bbattery.h"
+    #include "util.h"
+}
+
+declarg(xvar, double)
+
+//set a global seed
+static const uint64_t seed= 0x548c9decbce65297 ;
+
+static  std::mt19937 RNG32(seed);
+
+static hydra::squares3 Squares3(seed);
+static hydra::philox   Philox(seed);
+
+static std::vector<uint32_t> Squares3Buffer(HYDRA_RNG_BLOCK_SIZE);
+static std::vector<uint64_t> PhiloxBuffer(HYDRA_RNG_BLOCK_SIZE);
+
+static size_t Squares3Position = HYDRA_RNG_BLOCK_SIZE;
+static size_t PhiloxPosition   = HYDRA_RNG_BLOCK_SIZE;
+
+uint32_t mersenne32(void){
+
+	return RNG32();
+}
+
+uint32_t squares3(void){
+
+	return Squares3();
+}
+
+uint32_t squares3_block(void){
+
+	if(Squares3Position == HYDRA_RNG_BLOCK_SIZE){
+
+		Squares3.generate(Squares3Buffer.data(), Squares3Buffer.data() + HYDRA_RNG_BLOCK_SIZE);
+		Squares3Position = 0;
+	}
+
+	return Squares3Buffer[Squares3Position++];
+}
+
+uint32_t philox(void){
+
+	return uint32_t(Philox());
+}
+
+uint32_t philox_block(void){
+
+	if(PhiloxPosition == HYDRA_RNG_BLOCK_SIZE){
+
+		Philox.generate(PhiloxBuffer.data(), PhiloxBuffer.data() + HYDRA_RNG_BLOCK_SIZE);
+		PhiloxPosition = 0;
+	}
+
+	return uint32_t(PhiloxBuffer[PhiloxPosition++]);
+}
+
+template<typename Engine, typename Functor>
+void time_fill(const char* name, Functor const& functor, size_t nevents)
+{
+	hydra::device::vector<double> data(nevents);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	hydra_thrust::tabulate(hydra::device::sys, data.begin(), data.end(),
+			hydra::detail::Sampler<Functor, Engine>(functor, seed, 0));
+
+	auto middle = std::chrono::high_resolution_clock::now();
+
+	hydra::fill_random<Engine>(hydra::device::sys, data.begin(), data.end(), functor, seed, 0);
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<double, std::milli> scalar = middle - start;
+	std::chrono::duration<double, std::milli> block  = end - middle;
+
+	std::cout << name << ": element by element " << scalar.count() << " ms, "
+			  << "block " << block.count() << " ms" << std::endl;
+}
+
+int main(int argv, char** argc)
+{
+
+   unif01_Gen* gen_a ;
+
+   std::ostringstream filename;
+   filename << "hydra_timing_block_TestU01_log.txt" ;
+
+   auto mean  = hydra::Parameter::Create("mean").Value(0.0);
+   auto sigma = hydra::Parameter::Create("sigma").Value(1.0);
+   auto min   = hydra::Parameter::Create("min").Value(0.0);
+   auto max   = hydra::Parameter::Create("max").Value(1.0);
+
+   hydra::Gaussian<hydra::arguments::xvar> gaussian(mean, sigma);
+   hydra::UniformShape<hydra::arguments::xvar> uniform(min, max);
+
+   std::cout << "------------------- [ hydra::fill_random with 100M events ] -------------------"  << std::endl;
+
+   time_fill<hydra::squares3>("Uniform, squares3",   uniform, 100000000);
+   time_fill<hydra::squares3>("Gaussian, squares3", gaussian, 100000000);
+   time_fill<hydra::philox>("Uniform, philox",   uniform, 100000000);
+   time_fill<hydra::philox>("Gaussian, philox", gaussian, 100000000);
+
+   std::cout << "------------------- [ Measuring timing for 1G events, scalar and block generation ] -------------------"  << std::endl;
+
+   freopen(filename.str().c_str(), "w", stdout);
+
+   gen_a = unif01_CreateExternGenBits(const_cast<char*>("mersenne32"), mersenne32 );
+   unif01_TimerGenWr(gen_a, 1000000000, 0);
+   unif01_DeleteExternGenBits(gen_a);
+
+   gen_a = unif01_CreateExternGenBits(const_cast<char*>("squares3"), squares3 );
+   unif01_TimerGenWr(gen_a, 1000000000, 0);
+   unif01_DeleteExternGenBits(gen_a);
+
+   gen_a = unif01_CreateExternGenBits(const_cast<char*>("squares3_block"), squares3_block );
+   unif01_TimerGenWr(gen_a, 1000000000, 0);
+   unif01_DeleteExternGenBits(gen_a);
+
+   gen_a = unif01_CreateExternGenBits(const_cast<char*>("philox"), philox );
+   unif01_TimerGenWr(gen_a, 1000000000, 0);
+   unif01_DeleteExternGenBits(gen_a);
+
+   gen_a = unif01_CreateExternGenBits(const_cast<char*>("philox_block"), philox_block );
+   unif01_TimerGenWr(gen_a, 1000000000, 0);
+   unif01_DeleteExternGenBits(gen_a);
+
+   fclose(stdout);
+
+
+   return 0;
+
+}